@@ -0,0 +1,155 @@
+#include "stdafx.h"
+#include "benchmark.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+using json = nlohmann::json;
+
+CBenchmark::CBenchmark(const TBenchConfig& config) : m_Config(config)
+{
+}
+
+bool CBenchmark::IsSelected(const std::string& stSuite, const std::string& stName) const
+{
+	if (m_Config.stFilter.empty())
+	{
+		return (true);
+	}
+
+	return ((stSuite + "/" + stName).find(m_Config.stFilter) != std::string::npos);
+}
+
+void CBenchmark::Run(const std::string& stSuite, const std::string& stName, GLint iMapSize, uint64_t ulItems, const std::function<double()>& body, const std::function<void()>& setup)
+{
+	if (!IsSelected(stSuite, stName))
+	{
+		return;
+	}
+
+	double dChecksum = 0.0;
+	for (uint32_t i = 0; i < m_Config.uiWarmup; i++)
+	{
+		if (setup)
+		{
+			setup();
+		}
+		dChecksum = body();
+	}
+
+	std::vector<double> vTimes;
+	vTimes.reserve(m_Config.uiIterations);
+
+	for (uint32_t i = 0; i < m_Config.uiIterations; i++)
+	{
+		if (setup)
+		{
+			setup();
+		}
+
+		const auto tStart = std::chrono::steady_clock::now();
+		dChecksum = body();
+		const auto tEnd = std::chrono::steady_clock::now();
+
+		vTimes.push_back(std::chrono::duration<double, std::milli>(tEnd - tStart).count());
+	}
+
+	TBenchResult result{};
+	result.stSuite = stSuite;
+	result.stName = stName;
+	result.iMapSize = iMapSize;
+	result.uiIterations = static_cast<uint32_t>(vTimes.size());
+	result.ulItems = ulItems;
+	result.dChecksum = dChecksum;
+
+	if (!vTimes.empty())
+	{
+		std::sort(vTimes.begin(), vTimes.end());
+
+		double dSum = 0.0;
+		for (double dTime : vTimes)
+		{
+			dSum += dTime;
+		}
+
+		const size_t uiMid = vTimes.size() / 2;
+		result.dMin = vTimes.front();
+		result.dMax = vTimes.back();
+		result.dMean = dSum / static_cast<double>(vTimes.size());
+		result.dMedian = (vTimes.size() % 2) ? vTimes[uiMid] : (vTimes[uiMid - 1] + vTimes[uiMid]) * 0.5;
+	}
+
+	sys_log("%-8s %-26s %5d  median %10.3f ms  min %10.3f ms", stSuite.c_str(), stName.c_str(), iMapSize, result.dMedian, result.dMin);
+	m_vResults.push_back(result);
+}
+
+void CBenchmark::PrintTable() const
+{
+	sys_log("");
+	sys_log("%-8s %-26s %5s %10s %10s %10s %10s %12s %14s", "suite", "name", "size", "min ms", "median ms", "mean ms", "max ms", "items", "Mitems/s");
+
+	for (const TBenchResult& result : m_vResults)
+	{
+		const double dThroughput = result.dMedian > 0.0 ? static_cast<double>(result.ulItems) / (result.dMedian * 1000.0) : 0.0;
+		sys_log("%-8s %-26s %5d %10.3f %10.3f %10.3f %10.3f %12llu %14.2f", result.stSuite.c_str(), result.stName.c_str(), result.iMapSize,
+			result.dMin, result.dMedian, result.dMean, result.dMax, static_cast<unsigned long long>(result.ulItems), dThroughput);
+	}
+}
+
+bool CBenchmark::WriteJson(const std::string& stFileName) const
+{
+	json results = json::array();
+	for (const TBenchResult& result : m_vResults)
+	{
+		results.push_back({
+			{ "suite", result.stSuite },
+			{ "name", result.stName },
+			{ "map_size", result.iMapSize },
+			{ "iterations", result.uiIterations },
+			{ "min_ms", result.dMin },
+			{ "median_ms", result.dMedian },
+			{ "mean_ms", result.dMean },
+			{ "max_ms", result.dMax },
+			{ "items", result.ulItems },
+			{ "checksum", result.dChecksum } });
+	}
+
+	json root;
+	root["config"] = {
+		{ "map_sizes", m_Config.vMapSizes },
+		{ "patch_size", m_Config.iPatchSize },
+		{ "iterations", m_Config.uiIterations },
+		{ "warmup", m_Config.uiWarmup },
+		{ "seed", m_Config.ulSeed },
+		{ "filter", m_Config.stFilter } };
+	root["results"] = std::move(results);
+
+	std::ofstream file(stFileName);
+	if (!file.is_open())
+	{
+		sys_err("CBenchmark::WriteJson: Failed to open %s for writing", stFileName.c_str());
+		return (false);
+	}
+
+	file << root.dump(4) << std::endl;
+
+	if (!file.good())
+	{
+		sys_err("CBenchmark::WriteJson: Failed to write %s", stFileName.c_str());
+		return (false);
+	}
+
+	sys_log("CBenchmark::WriteJson: Wrote %s", stFileName.c_str());
+	return (true);
+}
+
+const TBenchConfig& CBenchmark::GetConfig() const
+{
+	return (m_Config);
+}
+
+const std::vector<TBenchResult>& CBenchmark::GetResults() const
+{
+	return (m_vResults);
+}
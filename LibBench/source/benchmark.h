@@ -0,0 +1,73 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+#define BENCH_DEFAULT_ITERATIONS 10
+#define BENCH_DEFAULT_WARMUP 2
+#define BENCH_DEFAULT_SEED 1337
+#define BENCH_DEFAULT_PATCH_SIZE 33
+#define BENCH_DEFAULT_OUTPUT "bench_results.json"
+
+typedef struct SBenchConfig
+{
+	std::vector<GLint> vMapSizes;	// 2^n + 1, diamond-square needs it
+	GLint iPatchSize;
+	uint32_t uiIterations;
+	uint32_t uiWarmup;
+	uint64_t ulSeed;
+	std::string stFilter;			// Substring of "suite/name", empty runs everything
+	std::string stOutput;
+} TBenchConfig;
+
+typedef struct SBenchResult
+{
+	std::string stSuite;
+	std::string stName;
+	GLint iMapSize;					// 0 for the suites that do not depend on the map
+	uint32_t uiIterations;
+	double dMin;					// ms
+	double dMedian;
+	double dMean;
+	double dMax;
+	uint64_t ulItems;				// Work items per iteration (vertices, rays, stamps...)
+	double dChecksum;				// Value from the last iteration, equal across runs with the same seed
+} TBenchResult;
+
+/*
+ * Headless benchmark runner
+ *
+ * Every case runs uiWarmup untimed and uiIterations timed repetitions of its body with
+ * steady_clock. The optional setup runs before each repetition outside the timed part, so
+ * cases that modify the terrain start from the same state every time. The body returns a value
+ * derived from its output, which keeps the work from being optimized away and lets two runs
+ * with the same seed be compared.
+ */
+class CBenchmark
+{
+public:
+	explicit CBenchmark(const TBenchConfig& config);
+
+	bool IsSelected(const std::string& stSuite, const std::string& stName) const;
+
+	void Run(const std::string& stSuite, const std::string& stName, GLint iMapSize, uint64_t ulItems, const std::function<double()>& body, const std::function<void()>& setup = nullptr);
+
+	void PrintTable() const;
+	bool WriteJson(const std::string& stFileName) const;
+
+	const TBenchConfig& GetConfig() const;
+	const std::vector<TBenchResult>& GetResults() const;
+
+private:
+	TBenchConfig m_Config;
+	std::vector<TBenchResult> m_vResults;
+};
+
+// terrain_bench.cpp, once per map size
+void RunTerrainBenchmarks(CBenchmark& bench);
+
+// math_bench.cpp
+void RunMathBenchmarks(CBenchmark& bench);
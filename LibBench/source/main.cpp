@@ -0,0 +1,154 @@
+#include "stdafx.h"
+#include "benchmark.h"
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+/*
+ * Headless benchmark of the CPU side of the terrain pipeline
+ *
+ * No window and no GL context: the terrain is created headless and every case works on the CPU
+ * data only. Map sizes, seed and camera paths are fixed, so two runs on the same machine do the
+ * same work and results can be compared across commits.
+ *
+ * LibBench [--sizes 257,513,1025] [--patch 33] [--iterations 10] [--warmup 2] [--seed 1337]
+ *          [--filter terrain/raycast] [--out bench_results.json]
+ */
+
+namespace
+{
+	void PrintUsage(const char* szExe)
+	{
+		sys_log("Usage: %s [--sizes 257,513,1025] [--patch %d] [--iterations %d] [--warmup %d] [--seed %d] [--filter suite/name] [--out %s]",
+			szExe, BENCH_DEFAULT_PATCH_SIZE, BENCH_DEFAULT_ITERATIONS, BENCH_DEFAULT_WARMUP, BENCH_DEFAULT_SEED, BENCH_DEFAULT_OUTPUT);
+	}
+
+	bool ParseSizes(const char* szList, std::vector<GLint>& vSizes)
+	{
+		vSizes.clear();
+
+		std::stringstream stream(szList);
+		std::string stItem;
+		while (std::getline(stream, stItem, ','))
+		{
+			const GLint iSize = std::atoi(stItem.c_str());
+
+			// Diamond-square needs 2^n + 1
+			if (iSize < 3 || ((iSize - 1) & (iSize - 2)) != 0)
+			{
+				sys_err("LibBench: Map size %s is not 2^n + 1", stItem.c_str());
+				return (false);
+			}
+
+			vSizes.push_back(iSize);
+		}
+
+		return (!vSizes.empty());
+	}
+
+	bool ParseArgs(int argc, char** argv, TBenchConfig& config)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const char* szArg = argv[i];
+			const char* szValue = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+			if (!strcmp(szArg, "--help") || !strcmp(szArg, "-h"))
+			{
+				return (false);
+			}
+
+			if (!szValue)
+			{
+				sys_err("LibBench: Missing value for %s", szArg);
+				return (false);
+			}
+
+			if (!strcmp(szArg, "--sizes"))
+			{
+				if (!ParseSizes(szValue, config.vMapSizes))
+				{
+					return (false);
+				}
+			}
+			else if (!strcmp(szArg, "--patch"))
+			{
+				config.iPatchSize = std::atoi(szValue);
+			}
+			else if (!strcmp(szArg, "--iterations"))
+			{
+				config.uiIterations = static_cast<uint32_t>(std::strtoul(szValue, nullptr, 10));
+			}
+			else if (!strcmp(szArg, "--warmup"))
+			{
+				config.uiWarmup = static_cast<uint32_t>(std::strtoul(szValue, nullptr, 10));
+			}
+			else if (!strcmp(szArg, "--seed"))
+			{
+				config.ulSeed = std::strtoull(szValue, nullptr, 10);
+			}
+			else if (!strcmp(szArg, "--filter"))
+			{
+				config.stFilter = szValue;
+			}
+			else if (!strcmp(szArg, "--out"))
+			{
+				config.stOutput = szValue;
+			}
+			else
+			{
+				sys_err("LibBench: Unknown option %s", szArg);
+				return (false);
+			}
+
+			i++;
+		}
+
+		return (true);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	TBenchConfig config{};
+	config.vMapSizes = { 257, 513, 1025 };
+	config.iPatchSize = BENCH_DEFAULT_PATCH_SIZE;
+	config.uiIterations = BENCH_DEFAULT_ITERATIONS;
+	config.uiWarmup = BENCH_DEFAULT_WARMUP;
+	config.ulSeed = BENCH_DEFAULT_SEED;
+	config.stOutput = BENCH_DEFAULT_OUTPUT;
+
+	if (!ParseArgs(argc, argv, config))
+	{
+		PrintUsage(argv[0]);
+		return (EXIT_FAILURE);
+	}
+
+	if (config.iPatchSize < 3 || (config.iPatchSize % 2) == 0)
+	{
+		sys_err("LibBench: Patch size %d has to be odd and at least 3", config.iPatchSize);
+		return (EXIT_FAILURE);
+	}
+
+	for (GLint iMapSize : config.vMapSizes)
+	{
+		if ((iMapSize - 1) % (config.iPatchSize - 1) != 0)
+		{
+			sys_err("LibBench: Map size %d minus 1 is not a multiple of the patch size %d minus 1", iMapSize, config.iPatchSize);
+			return (EXIT_FAILURE);
+		}
+	}
+
+	CBenchmark bench(config);
+	RunTerrainBenchmarks(bench);
+	RunMathBenchmarks(bench);
+
+	bench.PrintTable();
+
+	if (!config.stOutput.empty() && !bench.WriteJson(config.stOutput))
+	{
+		return (EXIT_FAILURE);
+	}
+
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,415 @@
+#include "stdafx.h"
+#include "benchmark.h"
+#include "../../LibMath/source/batch_transform.h"
+#include "../../LibMath/source/quaternion_simd.h"
+#include "../../LibMath/source/simd.h"
+#include <glm/glm.hpp>
+#include <random>
+
+namespace
+{
+	constexpr size_t MATRIX_COUNT = 1 << 14;
+	constexpr size_t POINT_COUNT = 1 << 18;
+	constexpr size_t QUAT_COUNT = 1 << 16;
+	constexpr size_t RANDOM_COUNT = 1 << 20;
+
+	void RunMatrixBenchmarks(CBenchmark& bench, CRandom& random)
+	{
+		std::vector<CMatrix4Df> vIn(MATRIX_COUNT);
+		std::vector<CMatrix4Df> vOut(MATRIX_COUNT);
+		std::vector<glm::mat4> vGlmIn(MATRIX_COUNT);
+		std::vector<glm::mat4> vGlmOut(MATRIX_COUNT);
+
+		for (size_t i = 0; i < MATRIX_COUNT; i++)
+		{
+			random.Fill(&vIn[i].mat4[0][0], 16, -1.0f, 1.0f);
+			for (GLint iRow = 0; iRow < 4; iRow++)
+			{
+				for (GLint iCol = 0; iCol < 4; iCol++)
+				{
+					vGlmIn[i][iCol][iRow] = vIn[i].mat4[iRow][iCol];
+				}
+			}
+		}
+
+		CMatrix4Df mat;
+		mat.InitRotateTransform(30.0f, 45.0f, 60.0f);
+		glm::mat4 glmMat;
+		for (GLint iRow = 0; iRow < 4; iRow++)
+		{
+			for (GLint iCol = 0; iCol < 4; iCol++)
+			{
+				glmMat[iCol][iRow] = mat.mat4[iRow][iCol];
+			}
+		}
+
+		bench.Run("math", "matrix_mul_scalar", 0, MATRIX_COUNT, [&]()
+		{
+			for (size_t i = 0; i < MATRIX_COUNT; i++)
+			{
+				MathSimd::ScalarMul4x4(&vIn[i].mat4[0][0], &mat.mat4[0][0], &vOut[i].mat4[0][0]);
+			}
+			return (static_cast<double>(vOut[MATRIX_COUNT - 1].mat4[3][3]));
+		});
+
+		bench.Run("math", "matrix_mul", 0, MATRIX_COUNT, [&]()
+		{
+			for (size_t i = 0; i < MATRIX_COUNT; i++)
+			{
+				vOut[i] = vIn[i] * mat;
+			}
+			return (static_cast<double>(vOut[MATRIX_COUNT - 1].mat4[3][3]));
+		});
+
+		bench.Run("math", "matrix_mul_batch", 0, MATRIX_COUNT, [&]()
+		{
+			MathBatch::MultiplyMatrices(vIn.data(), mat, vOut.data(), MATRIX_COUNT);
+			return (static_cast<double>(vOut[MATRIX_COUNT - 1].mat4[3][3]));
+		});
+
+		bench.Run("math", "matrix_mul_glm", 0, MATRIX_COUNT, [&]()
+		{
+			for (size_t i = 0; i < MATRIX_COUNT; i++)
+			{
+				vGlmOut[i] = vGlmIn[i] * glmMat;
+			}
+			return (static_cast<double>(vGlmOut[MATRIX_COUNT - 1][3][3]));
+		});
+
+		// Random entries in [-1, 1], singular inputs are practically impossible
+		bench.Run("math", "matrix_inverse_scalar", 0, MATRIX_COUNT, [&]()
+		{
+			for (size_t i = 0; i < MATRIX_COUNT; i++)
+			{
+				MathSimd::ScalarInverse4x4(&vIn[i].mat4[0][0], &vOut[i].mat4[0][0]);
+			}
+			return (static_cast<double>(vOut[MATRIX_COUNT - 1].mat4[3][3]));
+		});
+
+		bench.Run("math", "matrix_inverse", 0, MATRIX_COUNT, [&]()
+		{
+			for (size_t i = 0; i < MATRIX_COUNT; i++)
+			{
+				vOut[i] = vIn[i].Inverse();
+			}
+			return (static_cast<double>(vOut[MATRIX_COUNT - 1].mat4[3][3]));
+		});
+
+		bench.Run("math", "matrix_inverse_glm", 0, MATRIX_COUNT, [&]()
+		{
+			for (size_t i = 0; i < MATRIX_COUNT; i++)
+			{
+				vGlmOut[i] = glm::inverse(vGlmIn[i]);
+			}
+			return (static_cast<double>(vGlmOut[MATRIX_COUNT - 1][3][3]));
+		});
+
+		bench.Run("math", "matrix_transpose_scalar", 0, MATRIX_COUNT, [&]()
+		{
+			for (size_t i = 0; i < MATRIX_COUNT; i++)
+			{
+				MathSimd::ScalarTranspose4x4(&vIn[i].mat4[0][0], &vOut[i].mat4[0][0]);
+			}
+			return (static_cast<double>(vOut[MATRIX_COUNT - 1].mat4[3][0]));
+		});
+
+		bench.Run("math", "matrix_transpose", 0, MATRIX_COUNT, [&]()
+		{
+			for (size_t i = 0; i < MATRIX_COUNT; i++)
+			{
+				vOut[i] = vIn[i].Transpose();
+			}
+			return (static_cast<double>(vOut[MATRIX_COUNT - 1].mat4[3][0]));
+		});
+
+		bench.Run("math", "matrix_transpose_glm", 0, MATRIX_COUNT, [&]()
+		{
+			for (size_t i = 0; i < MATRIX_COUNT; i++)
+			{
+				vGlmOut[i] = glm::transpose(vGlmIn[i]);
+			}
+			return (static_cast<double>(vGlmOut[MATRIX_COUNT - 1][0][3]));
+		});
+
+		// One AoS vector at a time, the single point path of CMatrix4Df::operator*(SVector4Df)
+		std::vector<SVector4Df> vPoints(MATRIX_COUNT);
+		std::vector<SVector4Df> vPointsOut(MATRIX_COUNT);
+		std::vector<glm::vec4> vGlmPoints(MATRIX_COUNT);
+		std::vector<glm::vec4> vGlmPointsOut(MATRIX_COUNT);
+		for (size_t i = 0; i < MATRIX_COUNT; i++)
+		{
+			random.Fill(&vPoints[i].x, 3, -100.0f, 100.0f);
+			vPoints[i].w = 1.0f;
+			vGlmPoints[i] = glm::vec4(vPoints[i].x, vPoints[i].y, vPoints[i].z, 1.0f);
+		}
+
+		bench.Run("math", "transform_point_scalar", 0, MATRIX_COUNT, [&]()
+		{
+			for (size_t i = 0; i < MATRIX_COUNT; i++)
+			{
+				MathSimd::ScalarTransform4(&mat.mat4[0][0], &vPoints[i].x, &vPointsOut[i].x);
+			}
+			return (static_cast<double>(vPointsOut[MATRIX_COUNT - 1].x));
+		});
+
+		bench.Run("math", "transform_point", 0, MATRIX_COUNT, [&]()
+		{
+			for (size_t i = 0; i < MATRIX_COUNT; i++)
+			{
+				vPointsOut[i] = mat * vPoints[i];
+			}
+			return (static_cast<double>(vPointsOut[MATRIX_COUNT - 1].x));
+		});
+
+		bench.Run("math", "transform_point_glm", 0, MATRIX_COUNT, [&]()
+		{
+			for (size_t i = 0; i < MATRIX_COUNT; i++)
+			{
+				vGlmPointsOut[i] = glmMat * vGlmPoints[i];
+			}
+			return (static_cast<double>(vGlmPointsOut[MATRIX_COUNT - 1].x));
+		});
+	}
+
+	void RunPointBenchmarks(CBenchmark& bench, CRandom& random)
+	{
+		std::vector<float> vX(POINT_COUNT), vY(POINT_COUNT), vZ(POINT_COUNT);
+		std::vector<float> vOutX(POINT_COUNT), vOutY(POINT_COUNT), vOutZ(POINT_COUNT);
+		random.Fill(vX.data(), POINT_COUNT, -100.0f, 100.0f);
+		random.Fill(vY.data(), POINT_COUNT, -100.0f, 100.0f);
+		random.Fill(vZ.data(), POINT_COUNT, -100.0f, 100.0f);
+
+		const TPointStream in = { vX.data(), vY.data(), vZ.data() };
+		const TPointStreamOut out = { vOutX.data(), vOutY.data(), vOutZ.data() };
+
+		CMatrix4Df mat;
+		mat.InitRotateTransform(30.0f, 45.0f, 60.0f);
+
+		bench.Run("math", "transform_points", 0, POINT_COUNT, [&]()
+		{
+			for (size_t i = 0; i < POINT_COUNT; i++)
+			{
+				const SVector4Df v4Point = mat * SVector4Df(vX[i], vY[i], vZ[i], 1.0f);
+				vOutX[i] = v4Point.x;
+				vOutY[i] = v4Point.y;
+				vOutZ[i] = v4Point.z;
+			}
+			return (static_cast<double>(vOutX[POINT_COUNT - 1]));
+		});
+
+		bench.Run("math", "transform_points_batch", 0, POINT_COUNT, [&]()
+		{
+			MathBatch::TransformPoints(mat, in, out, POINT_COUNT);
+			return (static_cast<double>(vOutX[POINT_COUNT - 1]));
+		});
+
+		// Chunks of BATCH_PARALLEL_MIN stay on the calling thread, the SIMD gain without the threads
+		bench.Run("math", "transform_points_batch_1t", 0, POINT_COUNT, [&]()
+		{
+			for (size_t i = 0; i < POINT_COUNT; i += BATCH_PARALLEL_MIN)
+			{
+				const size_t uiChunk = std::min<size_t>(BATCH_PARALLEL_MIN, POINT_COUNT - i);
+				MathBatch::TransformPoints(mat, { in.pX + i, in.pY + i, in.pZ + i }, { out.pX + i, out.pY + i, out.pZ + i }, uiChunk);
+			}
+			return (static_cast<double>(vOutX[POINT_COUNT - 1]));
+		});
+
+		bench.Run("math", "transform_normals", 0, POINT_COUNT, [&]()
+		{
+			for (size_t i = 0; i < POINT_COUNT; i++)
+			{
+				const SVector4Df v4Normal = mat * SVector4Df(vX[i], vY[i], vZ[i], 0.0f);
+				vOutX[i] = v4Normal.x;
+				vOutY[i] = v4Normal.y;
+				vOutZ[i] = v4Normal.z;
+			}
+			return (static_cast<double>(vOutX[POINT_COUNT - 1]));
+		});
+
+		bench.Run("math", "transform_normals_batch", 0, POINT_COUNT, [&]()
+		{
+			MathBatch::TransformNormals(mat, in, out, POINT_COUNT);
+			return (static_cast<double>(vOutX[POINT_COUNT - 1]));
+		});
+
+		// Perspective divide by w = 101 - z, in [1, 201] for z in [-100, 100]
+		CMatrix4Df matProj = mat;
+		matProj.mat4[3][0] = 0.0f;
+		matProj.mat4[3][1] = 0.0f;
+		matProj.mat4[3][2] = -1.0f;
+		matProj.mat4[3][3] = 101.0f;
+
+		bench.Run("math", "project_points", 0, POINT_COUNT, [&]()
+		{
+			for (size_t i = 0; i < POINT_COUNT; i++)
+			{
+				const SVector4Df v4Clip = matProj * SVector4Df(vX[i], vY[i], vZ[i], 1.0f);
+				const float fInvW = 1.0f / v4Clip.w;
+				vOutX[i] = v4Clip.x * fInvW;
+				vOutY[i] = v4Clip.y * fInvW;
+				vOutZ[i] = v4Clip.z * fInvW;
+			}
+			return (static_cast<double>(vOutX[POINT_COUNT - 1]));
+		});
+
+		bench.Run("math", "project_points_batch", 0, POINT_COUNT, [&]()
+		{
+			MathBatch::ProjectPoints(matProj, in, out, POINT_COUNT);
+			return (static_cast<double>(vOutX[POINT_COUNT - 1]));
+		});
+
+		const CQuaternion quat = CQuaternion::FromAxisAngle(SVector3Df(0.0f, 1.0f, 0.0f), 0.75f);
+		TQuaternion legacyQuat = quat.ToQuat();
+
+		bench.Run("math", "quat_rotate_legacy", 0, POINT_COUNT, [&]()
+		{
+			for (size_t i = 0; i < POINT_COUNT; i++)
+			{
+				SVector3Df v3Out;
+				Quaternion_RotateVector(&legacyQuat, SVector3Df(vX[i], vY[i], vZ[i]), v3Out);
+				vOutX[i] = v3Out.x;
+				vOutY[i] = v3Out.y;
+				vOutZ[i] = v3Out.z;
+			}
+			return (static_cast<double>(vOutX[POINT_COUNT - 1]));
+		});
+
+		bench.Run("math", "quat_rotate", 0, POINT_COUNT, [&]()
+		{
+			for (size_t i = 0; i < POINT_COUNT; i++)
+			{
+				const SVector3Df v3Out = quat.Rotate(SVector3Df(vX[i], vY[i], vZ[i]));
+				vOutX[i] = v3Out.x;
+				vOutY[i] = v3Out.y;
+				vOutZ[i] = v3Out.z;
+			}
+			return (static_cast<double>(vOutX[POINT_COUNT - 1]));
+		});
+
+		bench.Run("math", "quat_rotate_batch", 0, POINT_COUNT, [&]()
+		{
+			MathBatch::RotateVectors(quat, in, out, POINT_COUNT);
+			return (static_cast<double>(vOutX[POINT_COUNT - 1]));
+		});
+	}
+
+	void RunQuaternionBenchmarks(CBenchmark& bench, CRandom& random)
+	{
+		std::vector<CQuaternion> vFrom(QUAT_COUNT), vTo(QUAT_COUNT), vOut(QUAT_COUNT);
+		std::vector<float> vT(QUAT_COUNT);
+		for (size_t i = 0; i < QUAT_COUNT; i++)
+		{
+			random.Fill(&vFrom[i].x, 4, -1.0f, 1.0f);
+			random.Fill(&vTo[i].x, 4, -1.0f, 1.0f);
+			vFrom[i].Normalize();
+			vTo[i].Normalize();
+
+			// Quaternion_Slerp does not pick the shorter arc, keep the pairs on it so all paths agree
+			if (vFrom[i].Dot(vTo[i]) < 0.0f)
+			{
+				vTo[i] = CQuaternion(-vTo[i].x, -vTo[i].y, -vTo[i].z, -vTo[i].w);
+			}
+		}
+		random.Fill(vT.data(), QUAT_COUNT);
+
+		std::vector<TQuaternion> vLegacyFrom(QUAT_COUNT), vLegacyTo(QUAT_COUNT), vLegacyOut(QUAT_COUNT);
+		for (size_t i = 0; i < QUAT_COUNT; i++)
+		{
+			vLegacyFrom[i] = vFrom[i].ToQuat();
+			vLegacyTo[i] = vTo[i].ToQuat();
+		}
+
+		bench.Run("math", "quat_slerp_legacy", 0, QUAT_COUNT, [&]()
+		{
+			for (size_t i = 0; i < QUAT_COUNT; i++)
+			{
+				Quaternion_Slerp(&vLegacyFrom[i], &vLegacyTo[i], vT[i], &vLegacyOut[i]);
+			}
+			return (static_cast<double>(vLegacyOut[QUAT_COUNT - 1].w));
+		});
+
+		bench.Run("math", "quat_slerp", 0, QUAT_COUNT, [&]()
+		{
+			for (size_t i = 0; i < QUAT_COUNT; i++)
+			{
+				vOut[i] = CQuaternion::Slerp(vFrom[i], vTo[i], vT[i]);
+			}
+			return (static_cast<double>(vOut[QUAT_COUNT - 1].w));
+		});
+
+		bench.Run("math", "quat_slerp_batch", 0, QUAT_COUNT, [&]()
+		{
+			MathBatch::SlerpQuaternions(vFrom.data(), vTo.data(), vT.data(), vOut.data(), QUAT_COUNT);
+			return (static_cast<double>(vOut[QUAT_COUNT - 1].w));
+		});
+
+		// No nlerp in the Quaternion_* API, the scalar CQuaternion loop is the reference
+		bench.Run("math", "quat_nlerp", 0, QUAT_COUNT, [&]()
+		{
+			for (size_t i = 0; i < QUAT_COUNT; i++)
+			{
+				vOut[i] = CQuaternion::Nlerp(vFrom[i], vTo[i], vT[i]);
+			}
+			return (static_cast<double>(vOut[QUAT_COUNT - 1].w));
+		});
+
+		bench.Run("math", "quat_nlerp_batch", 0, QUAT_COUNT, [&]()
+		{
+			MathBatch::NlerpQuaternions(vFrom.data(), vTo.data(), vT.data(), vOut.data(), QUAT_COUNT);
+			return (static_cast<double>(vOut[QUAT_COUNT - 1].w));
+		});
+	}
+
+	void RunRandomBenchmarks(CBenchmark& bench, uint64_t ulSeed)
+	{
+		std::vector<float> vOut(RANDOM_COUNT);
+
+		bench.Run("math", "random_rand", 0, RANDOM_COUNT, [&]()
+		{
+			srand(static_cast<unsigned int>(ulSeed));
+			for (size_t i = 0; i < RANDOM_COUNT; i++)
+			{
+				vOut[i] = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+			}
+			return (static_cast<double>(vOut[RANDOM_COUNT - 1]));
+		});
+
+		bench.Run("math", "random_mt19937", 0, RANDOM_COUNT, [&]()
+		{
+			std::mt19937 engine(static_cast<uint32_t>(ulSeed));
+			std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+			for (size_t i = 0; i < RANDOM_COUNT; i++)
+			{
+				vOut[i] = dist(engine);
+			}
+			return (static_cast<double>(vOut[RANDOM_COUNT - 1]));
+		});
+
+		bench.Run("math", "random_next_float", 0, RANDOM_COUNT, [&]()
+		{
+			CRandom random(ulSeed);
+			for (size_t i = 0; i < RANDOM_COUNT; i++)
+			{
+				vOut[i] = random.NextFloat();
+			}
+			return (static_cast<double>(vOut[RANDOM_COUNT - 1]));
+		});
+
+		bench.Run("math", "random_fill", 0, RANDOM_COUNT, [&]()
+		{
+			CRandom random(ulSeed);
+			random.Fill(vOut.data(), RANDOM_COUNT);
+			return (static_cast<double>(vOut[RANDOM_COUNT - 1]));
+		});
+	}
+}
+
+void RunMathBenchmarks(CBenchmark& bench)
+{
+	CRandom random(bench.GetConfig().ulSeed, 2);
+
+	RunMatrixBenchmarks(bench, random);
+	RunPointBenchmarks(bench, random);
+	RunQuaternionBenchmarks(bench, random);
+	RunRandomBenchmarks(bench, bench.GetConfig().ulSeed);
+}
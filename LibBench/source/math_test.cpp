@@ -0,0 +1,464 @@
+#include "stdafx.h"
+#include "../../LibMath/source/batch_transform.h"
+#include "../../LibMath/source/simd.h"
+#include <glm/glm.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+/*
+ * Checks the LibMath SIMD and batch kernels against the scalar paths they replace
+ *
+ * Batch results are compared element by element with CMatrix4Df, CQuaternion and the MathSimd::Scalar*
+ * kernels. Counts include tails that are not a multiple of the 4 (SSE) or 8 (AVX) lanes and batches
+ * large enough to be split across threads. CRandom is checked against the Philox4x32-10 known answer
+ * and against its own single draw path. Returns non zero when a check fails, ctest runs it.
+ *
+ * LibMathTest [--seed 1337]
+ */
+
+namespace
+{
+	// Relative to the magnitude of the terms that produced the expected value
+	constexpr float TOLERANCE = 1e-6f;
+
+	// Different algorithms for the same inverse, the error grows with the condition number
+	constexpr float INVERSE_TOLERANCE = 1e-5f;
+
+	constexpr size_t MAX_REPORTED_FAILURES = 16;
+
+	const size_t TEST_COUNTS[] = { 0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 1021, BATCH_PARALLEL_MIN + 13 };
+
+	typedef struct STestState
+	{
+		uint64_t ulChecks;
+		uint64_t ulFailures;
+	} TTestState;
+
+	bool Near(float fValue, float fExpected, float fScale, float fTolerance = TOLERANCE)
+	{
+		return (std::fabs(fValue - fExpected) <= fTolerance * std::max(1.0f, fScale));
+	}
+
+	void Expect(TTestState& state, bool bPassed, const char* szCase, size_t uiCount, size_t uiIndex)
+	{
+		state.ulChecks++;
+		if (bPassed)
+		{
+			return;
+		}
+
+		if (state.ulFailures++ < MAX_REPORTED_FAILURES)
+		{
+			sys_err("LibMathTest: %s failed, count %zu, index %zu", szCase, uiCount, uiIndex);
+		}
+	}
+
+	// Sum of |m[iRow][k] * v[k]|, the magnitude the rounding error of one output scales with
+	float RowScale(const CMatrix4Df& mat, GLint iRow, const SVector4Df& v4Vec)
+	{
+		return (std::fabs(mat.mat4[iRow][0] * v4Vec.x) + std::fabs(mat.mat4[iRow][1] * v4Vec.y) +
+			std::fabs(mat.mat4[iRow][2] * v4Vec.z) + std::fabs(mat.mat4[iRow][3] * v4Vec.w));
+	}
+
+	CMatrix4Df RandomMatrix(CRandom& random)
+	{
+		CMatrix4Df mat;
+		random.Fill(&mat.mat4[0][0], 16, -1.0f, 1.0f);
+		return (mat);
+	}
+
+	void TestStreams(TTestState& state, CRandom& random)
+	{
+		const CMatrix4Df mat = RandomMatrix(random);
+
+		// Projective rows keep w = 1 - z in [2, 11] for z in [-10, -1]
+		CMatrix4Df matProj = RandomMatrix(random);
+		matProj.mat4[3][0] = 0.0f;
+		matProj.mat4[3][1] = 0.0f;
+		matProj.mat4[3][2] = -1.0f;
+		matProj.mat4[3][3] = 1.0f;
+
+		for (size_t uiCount : TEST_COUNTS)
+		{
+			std::vector<float> vX(uiCount), vY(uiCount), vZ(uiCount);
+			std::vector<float> vOutX(uiCount), vOutY(uiCount), vOutZ(uiCount);
+			random.Fill(vX.data(), uiCount, -10.0f, 10.0f);
+			random.Fill(vY.data(), uiCount, -10.0f, 10.0f);
+			random.Fill(vZ.data(), uiCount, -10.0f, -1.0f);
+
+			const TPointStream in = { vX.data(), vY.data(), vZ.data() };
+			const TPointStreamOut out = { vOutX.data(), vOutY.data(), vOutZ.data() };
+
+			MathBatch::TransformPoints(mat, in, out, uiCount);
+			for (size_t i = 0; i < uiCount; i++)
+			{
+				const SVector4Df v4In(vX[i], vY[i], vZ[i], 1.0f);
+				const SVector4Df v4Ref = mat * v4In;
+				Expect(state, Near(vOutX[i], v4Ref.x, RowScale(mat, 0, v4In)) && Near(vOutY[i], v4Ref.y, RowScale(mat, 1, v4In)) &&
+					Near(vOutZ[i], v4Ref.z, RowScale(mat, 2, v4In)), "TransformPoints", uiCount, i);
+			}
+
+			MathBatch::TransformNormals(mat, in, out, uiCount);
+			for (size_t i = 0; i < uiCount; i++)
+			{
+				const SVector4Df v4In(vX[i], vY[i], vZ[i], 0.0f);
+				const SVector4Df v4Ref = mat * v4In;
+				Expect(state, Near(vOutX[i], v4Ref.x, RowScale(mat, 0, v4In)) && Near(vOutY[i], v4Ref.y, RowScale(mat, 1, v4In)) &&
+					Near(vOutZ[i], v4Ref.z, RowScale(mat, 2, v4In)), "TransformNormals", uiCount, i);
+			}
+
+			MathBatch::ProjectPoints(matProj, in, out, uiCount);
+			for (size_t i = 0; i < uiCount; i++)
+			{
+				const SVector4Df v4In(vX[i], vY[i], vZ[i], 1.0f);
+				const SVector4Df v4Ref = matProj * v4In;
+				const float fInvW = 1.0f / v4Ref.w;
+
+				// Error of the numerator plus the error of w carried through the division
+				const float fScaleW = RowScale(matProj, 3, v4In) * fInvW;
+				Expect(state,
+					Near(vOutX[i], v4Ref.x * fInvW, (RowScale(matProj, 0, v4In) + std::fabs(v4Ref.x) * fScaleW) * fInvW) &&
+					Near(vOutY[i], v4Ref.y * fInvW, (RowScale(matProj, 1, v4In) + std::fabs(v4Ref.y) * fScaleW) * fInvW) &&
+					Near(vOutZ[i], v4Ref.z * fInvW, (RowScale(matProj, 2, v4In) + std::fabs(v4Ref.z) * fScaleW) * fInvW),
+					"ProjectPoints", uiCount, i);
+			}
+
+			// In place, the output streams are the input streams
+			std::vector<float> vRefX(vX), vRefY(vY), vRefZ(vZ);
+			MathBatch::TransformPoints(mat, { vRefX.data(), vRefY.data(), vRefZ.data() }, out, uiCount);
+			MathBatch::TransformPoints(mat, in, { vX.data(), vY.data(), vZ.data() }, uiCount);
+			for (size_t i = 0; i < uiCount; i++)
+			{
+				Expect(state, vX[i] == vOutX[i] && vY[i] == vOutY[i] && vZ[i] == vOutZ[i], "TransformPoints in place", uiCount, i);
+			}
+		}
+	}
+
+	void TestRotations(TTestState& state, CRandom& random)
+	{
+		const CQuaternion quat = CQuaternion::FromAxisAngle(SVector3Df(0.267f, 0.535f, 0.802f), 1.1f);
+
+		for (size_t uiCount : TEST_COUNTS)
+		{
+			std::vector<float> vX(uiCount), vY(uiCount), vZ(uiCount);
+			std::vector<float> vOutX(uiCount), vOutY(uiCount), vOutZ(uiCount);
+			random.Fill(vX.data(), uiCount, -10.0f, 10.0f);
+			random.Fill(vY.data(), uiCount, -10.0f, 10.0f);
+			random.Fill(vZ.data(), uiCount, -10.0f, 10.0f);
+
+			MathBatch::RotateVectors(quat, { vX.data(), vY.data(), vZ.data() }, { vOutX.data(), vOutY.data(), vOutZ.data() }, uiCount);
+			for (size_t i = 0; i < uiCount; i++)
+			{
+				const SVector3Df v3Ref = quat.Rotate(SVector3Df(vX[i], vY[i], vZ[i]));
+				const float fScale = 4.0f * (std::fabs(vX[i]) + std::fabs(vY[i]) + std::fabs(vZ[i]));
+				Expect(state, Near(vOutX[i], v3Ref.x, fScale) && Near(vOutY[i], v3Ref.y, fScale) && Near(vOutZ[i], v3Ref.z, fScale),
+					"RotateVectors", uiCount, i);
+			}
+
+			std::vector<CQuaternion> vFrom(uiCount), vTo(uiCount), vOut(uiCount);
+			std::vector<float> vT(uiCount);
+			for (size_t i = 0; i < uiCount; i++)
+			{
+				random.Fill(&vFrom[i].x, 4, -1.0f, 1.0f);
+				random.Fill(&vTo[i].x, 4, -1.0f, 1.0f);
+				vFrom[i].Normalize();
+
+				// Every third pair is nearly equal (or opposite), the Slerp kernels switch to Nlerp there
+				if (i % 3 == 0)
+				{
+					const float fSign = (i % 2) ? -1.0f : 1.0f;
+					vTo[i] = CQuaternion(fSign * vFrom[i].x + vTo[i].x * 0.01f, fSign * vFrom[i].y + vTo[i].y * 0.01f,
+						fSign * vFrom[i].z + vTo[i].z * 0.01f, fSign * vFrom[i].w + vTo[i].w * 0.01f);
+				}
+				vTo[i].Normalize();
+			}
+			random.Fill(vT.data(), uiCount);
+
+			// Some extrapolated factors, outside of the range the batch polynomials cover
+			for (size_t i = 7; i < uiCount; i += 11)
+			{
+				vT[i] = vT[i] * 2.0f - 0.5f;
+			}
+
+			MathBatch::SlerpQuaternions(vFrom.data(), vTo.data(), vT.data(), vOut.data(), uiCount);
+			for (size_t i = 0; i < uiCount; i++)
+			{
+				const CQuaternion qRef = CQuaternion::Slerp(vFrom[i], vTo[i], vT[i]);
+				Expect(state, Near(vOut[i].x, qRef.x, 4.0f) && Near(vOut[i].y, qRef.y, 4.0f) && Near(vOut[i].z, qRef.z, 4.0f) && Near(vOut[i].w, qRef.w, 4.0f),
+					"SlerpQuaternions", uiCount, i);
+			}
+
+			MathBatch::NlerpQuaternions(vFrom.data(), vTo.data(), vT.data(), vOut.data(), uiCount);
+			for (size_t i = 0; i < uiCount; i++)
+			{
+				const CQuaternion qRef = CQuaternion::Nlerp(vFrom[i], vTo[i], vT[i]);
+				Expect(state, Near(vOut[i].x, qRef.x, 4.0f) && Near(vOut[i].y, qRef.y, 4.0f) && Near(vOut[i].z, qRef.z, 4.0f) && Near(vOut[i].w, qRef.w, 4.0f),
+					"NlerpQuaternions", uiCount, i);
+			}
+		}
+	}
+
+	void TestMatrixBatches(TTestState& state, CRandom& random)
+	{
+		const CMatrix4Df mat = RandomMatrix(random);
+
+		// MultiplyMatrices goes wide from BATCH_PARALLEL_MIN / 16 on
+		const size_t aCounts[] = { 0, 1, 3, 5, 7, 9, 17, BATCH_PARALLEL_MIN / 16 * 3 + 5 };
+
+		for (size_t uiCount : aCounts)
+		{
+			std::vector<CMatrix4Df> vIn(uiCount), vOut(uiCount), vPreOut(uiCount);
+			for (auto& matIn : vIn)
+			{
+				matIn = RandomMatrix(random);
+			}
+
+			MathBatch::MultiplyMatrices(vIn.data(), mat, vOut.data(), uiCount);
+			MathBatch::PreMultiplyMatrices(mat, vIn.data(), vPreOut.data(), uiCount);
+
+			for (size_t i = 0; i < uiCount; i++)
+			{
+				CMatrix4Df matRef, matPreRef;
+				MathSimd::ScalarMul4x4(&vIn[i].mat4[0][0], &mat.mat4[0][0], &matRef.mat4[0][0]);
+				MathSimd::ScalarMul4x4(&mat.mat4[0][0], &vIn[i].mat4[0][0], &matPreRef.mat4[0][0]);
+
+				bool bPassed = true;
+				for (GLint iRow = 0; iRow < 4; iRow++)
+				{
+					for (GLint iCol = 0; iCol < 4; iCol++)
+					{
+						// Entries are in [-1, 1], every product term is at most 1
+						bPassed = bPassed && Near(vOut[i].mat4[iRow][iCol], matRef.mat4[iRow][iCol], 4.0f) &&
+							Near(vPreOut[i].mat4[iRow][iCol], matPreRef.mat4[iRow][iCol], 4.0f);
+					}
+				}
+				Expect(state, bPassed, "MultiplyMatrices", uiCount, i);
+			}
+
+			// In place
+			MathBatch::MultiplyMatrices(vIn.data(), mat, vIn.data(), uiCount);
+			for (size_t i = 0; i < uiCount; i++)
+			{
+				Expect(state, !std::memcmp(&vIn[i], &vOut[i], sizeof(CMatrix4Df)), "MultiplyMatrices in place", uiCount, i);
+			}
+		}
+
+		std::vector<SVector4Df> vVectors(7), vVectorsOut(7);
+		for (auto& v4Vec : vVectors)
+		{
+			random.Fill(&v4Vec.x, 4, -10.0f, 10.0f);
+		}
+
+		MathBatch::TransformVectors(mat, vVectors.data(), vVectorsOut.data(), vVectors.size());
+		for (size_t i = 0; i < vVectors.size(); i++)
+		{
+			float afRef[4];
+			MathSimd::ScalarTransform4(&mat.mat4[0][0], &vVectors[i].x, afRef);
+			Expect(state, Near(vVectorsOut[i].x, afRef[0], RowScale(mat, 0, vVectors[i])) && Near(vVectorsOut[i].y, afRef[1], RowScale(mat, 1, vVectors[i])) &&
+				Near(vVectorsOut[i].z, afRef[2], RowScale(mat, 2, vVectors[i])) && Near(vVectorsOut[i].w, afRef[3], RowScale(mat, 3, vVectors[i])),
+				"TransformVectors", vVectors.size(), i);
+		}
+	}
+
+	void TestMatrixKernels(TTestState& state, CRandom& random)
+	{
+		for (size_t i = 0; i < 1024; i++)
+		{
+			// Diagonally dominant, well conditioned for every draw
+			CMatrix4Df mat = RandomMatrix(random);
+			for (GLint d = 0; d < 4; d++)
+			{
+				mat.mat4[d][d] += (mat.mat4[d][d] < 0.0f) ? -4.0f : 4.0f;
+			}
+
+			glm::mat4 glmMat;
+			for (GLint iRow = 0; iRow < 4; iRow++)
+			{
+				for (GLint iCol = 0; iCol < 4; iCol++)
+				{
+					glmMat[iCol][iRow] = mat.mat4[iRow][iCol];
+				}
+			}
+			const glm::mat4 glmInv = glm::inverse(glmMat);
+
+			CMatrix4Df matScalarInv, matTranspose, matScalarTranspose;
+			const bool bScalar = MathSimd::ScalarInverse4x4(&mat.mat4[0][0], &matScalarInv.mat4[0][0]);
+			const CMatrix4Df matInv = mat.Inverse();
+
+			bool bPassed = bScalar;
+			for (GLint iRow = 0; iRow < 4; iRow++)
+			{
+				for (GLint iCol = 0; iCol < 4; iCol++)
+				{
+					bPassed = bPassed && Near(matInv.mat4[iRow][iCol], matScalarInv.mat4[iRow][iCol], 1.0f, INVERSE_TOLERANCE) &&
+						Near(matInv.mat4[iRow][iCol], glmInv[iCol][iRow], 1.0f, INVERSE_TOLERANCE);
+				}
+			}
+			Expect(state, bPassed, "Inverse4x4", 1, i);
+
+			matTranspose = mat.Transpose();
+			MathSimd::ScalarTranspose4x4(&mat.mat4[0][0], &matScalarTranspose.mat4[0][0]);
+			Expect(state, !std::memcmp(&matTranspose, &matScalarTranspose, sizeof(CMatrix4Df)), "Transpose4x4", 1, i);
+
+			CMatrix4Df matProduct, matScalarProduct;
+			MathSimd::Mul4x4(&mat.mat4[0][0], &matInv.mat4[0][0], &matProduct.mat4[0][0]);
+			MathSimd::ScalarMul4x4(&mat.mat4[0][0], &matInv.mat4[0][0], &matScalarProduct.mat4[0][0]);
+
+			bPassed = true;
+			for (GLint iRow = 0; iRow < 4; iRow++)
+			{
+				for (GLint iCol = 0; iCol < 4; iCol++)
+				{
+					bPassed = bPassed && Near(matProduct.mat4[iRow][iCol], matScalarProduct.mat4[iRow][iCol], 8.0f) &&
+						Near(matProduct.mat4[iRow][iCol], (iRow == iCol) ? 1.0f : 0.0f, 1.0f, INVERSE_TOLERANCE);
+				}
+			}
+			Expect(state, bPassed, "Mul4x4", 1, i);
+		}
+
+		// Small integer entries keep every determinant exact, all of these are exactly 0
+		const float aSingular[][16] =
+		{
+			{ 0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0 },
+			{ 1, 2, 3, 4,  0, 0, 0, 0,  5, 6, 7, 8,  2, 1, 0, 3 },		// Zero row
+			{ 1, 2, 3, 4,  5, 6, 7, 8,  1, 2, 3, 4,  2, 1, 0, 3 },		// Repeated row
+			{ 1, 2, 3, 4,  5, 6, 7, 8,  6, 8, 10, 12,  2, 1, 0, 3 },	// Row 2 = row 0 + row 1
+			{ 2, 0, 0, 1,  0, 3, 0, 2,  0, 0, 0, 3,  0, 0, 0, 1 },		// Flattened z, a shadow projection
+			{ 1, 2, 0, 0,  2, 4, 0, 0,  0, 0, 1, 2,  0, 0, 3, 4 },		// Singular upper left 2x2 block
+		};
+
+		for (size_t i = 0; i < std::size(aSingular); i++)
+		{
+			CMatrix4Df mat;
+			std::memcpy(&mat.mat4[0][0], aSingular[i], sizeof(aSingular[i]));
+
+			CMatrix4Df matOut;
+			const bool bScalar = MathSimd::ScalarInverse4x4(&mat.mat4[0][0], &matOut.mat4[0][0]);
+			const bool bSimd = MathSimd::Inverse4x4(&mat.mat4[0][0], &matOut.mat4[0][0]);
+
+			// CMatrix4Df::Inverse hands singular matrices back unchanged
+			const CMatrix4Df matInv = mat.Inverse();
+			Expect(state, !bScalar && !bSimd && !std::memcmp(&matInv, &mat, sizeof(CMatrix4Df)), "Inverse4x4 singular", 1, i);
+		}
+	}
+
+	void TestRandom(TTestState& state, uint64_t ulSeed)
+	{
+		// Random123 known answer for Philox4x32-10, key 0 and counter 0 (seed 0, stream 0, block 0)
+		const uint32_t aKnownAnswer[4] = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+
+		CRandom known(0, 0);
+		for (size_t i = 0; i < 4; i++)
+		{
+			Expect(state, known.NextU32() == aKnownAnswer[i], "CRandom Philox4x32-10 known answer", 4, i);
+		}
+		Expect(state, CRandom::FloatAt(0, 0, 0, 0) == static_cast<float>(aKnownAnswer[0] >> 8) / 16777216.0f, "CRandom::FloatAt known answer", 1, 0);
+
+		// Unaligned starts too, the batched path has to pick up mid block
+		const size_t aOffsets[] = { 0, 1, 2, 3, 4, 5, 7, 8, 13 };
+
+		for (size_t uiOffset : aOffsets)
+		{
+			CRandom batched(ulSeed, uiOffset);
+			CRandom single(ulSeed, uiOffset);
+			batched.Discard(uiOffset);
+			single.Discard(uiOffset);
+
+			for (size_t uiRound = 0; uiRound < 64; uiRound++)
+			{
+				float afBatched[8];
+				batched.NextFloat8(afBatched);
+				for (size_t i = 0; i < 8; i++)
+				{
+					Expect(state, afBatched[i] == single.NextFloat(), "CRandom::NextFloat8", uiOffset, uiRound * 8 + i);
+				}
+			}
+		}
+
+		const uint64_t aDiscards[] = { 0, 1, 3, 4, 5, 7, 8, 9, 1021, 4096 };
+
+		for (uint64_t ulDiscard : aDiscards)
+		{
+			CRandom skipped(ulSeed, 1);
+			CRandom drawn(ulSeed, 1);
+
+			// Also from a position inside a buffered block
+			skipped.NextU32();
+			drawn.NextU32();
+
+			skipped.Discard(ulDiscard);
+			for (uint64_t i = 0; i < ulDiscard; i++)
+			{
+				drawn.NextU32();
+			}
+
+			for (size_t i = 0; i < 16; i++)
+			{
+				Expect(state, skipped.NextU32() == drawn.NextU32(), "CRandom::Discard", static_cast<size_t>(ulDiscard), i);
+			}
+		}
+
+		typedef struct SIntRange
+		{
+			int32_t iMin;
+			int32_t iMax;
+		} TIntRange;
+
+		const TIntRange aRanges[] = { { 0, 0 }, { 0, 1 }, { -5, 5 }, { -1000, -990 }, { 7, 3 }, { 0, INT32_MAX }, { INT32_MIN, INT32_MAX }, { INT32_MIN, INT32_MIN + 2 } };
+
+		CRandom ranged(ulSeed, 2);
+		for (const TIntRange& range : aRanges)
+		{
+			// An empty range returns iMin
+			const int32_t iMax = std::max(range.iMin, range.iMax);
+			bool bHitMin = false;
+			bool bHitMax = false;
+
+			for (size_t i = 0; i < 4096; i++)
+			{
+				const int32_t iValue = ranged.RangeInt(range.iMin, range.iMax);
+				Expect(state, iValue >= range.iMin && iValue <= iMax, "CRandom::RangeInt bounds", static_cast<size_t>(&range - aRanges), i);
+				bHitMin = bHitMin || iValue == range.iMin;
+				bHitMax = bHitMax || iValue == iMax;
+			}
+
+			// Small ranges should reach both ends in 4096 draws
+			if (static_cast<int64_t>(iMax) - range.iMin < 16)
+			{
+				Expect(state, bHitMin && bHitMax, "CRandom::RangeInt reaches both bounds", static_cast<size_t>(&range - aRanges), 0);
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint64_t ulSeed = 1337;
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (!strcmp(argv[i], "--seed"))
+		{
+			ulSeed = std::strtoull(argv[i + 1], nullptr, 10);
+		}
+	}
+
+	CRandom random(ulSeed, 3);
+	TTestState state{};
+
+	TestStreams(state, random);
+	TestRotations(state, random);
+	TestMatrixBatches(state, random);
+	TestMatrixKernels(state, random);
+	TestRandom(state, ulSeed);
+
+	if (state.ulFailures)
+	{
+		sys_err("LibMathTest: %llu of %llu checks failed (seed %llu)", static_cast<unsigned long long>(state.ulFailures),
+			static_cast<unsigned long long>(state.ulChecks), static_cast<unsigned long long>(ulSeed));
+		return (EXIT_FAILURE);
+	}
+
+	sys_log("LibMathTest: %llu checks passed (seed %llu)", static_cast<unsigned long long>(state.ulChecks), static_cast<unsigned long long>(ulSeed));
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,3 @@
+#include "stdafx.h"
+
+// This File Is Needed for successful Compilation.
\ No newline at end of file
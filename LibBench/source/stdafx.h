@@ -0,0 +1,8 @@
+#pragma once
+
+#include "../../LibTerrain/source/stdafx.h"
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
@@ -0,0 +1,354 @@
+#include "stdafx.h"
+#include "benchmark.h"
+#include "../../LibTerrain/source/terrain.h"
+#include "../../LibTerrain/source/lod_manager.h"
+#include "../../LibTerrain/source/midpoint_generator.h"
+#include "../../LibTerrain/source/scatter_grid.h"
+#include "../../LibGL/source/camera.h"
+#include <cmath>
+
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+namespace
+{
+	// Same scale as the editor, the raycasts work in grid units
+	constexpr GLfloat WORLD_SCALE = 1.0f;
+	constexpr GLfloat TEXTURE_SCALE = 1.0f;
+
+	constexpr float ROUGHNESS = 1.0f;
+	constexpr float MIN_HEIGHT = 0.0f;
+	constexpr float MAX_HEIGHT = 300.0f;
+
+	constexpr GLint CAMERA_PATH_POINTS = 64;
+	constexpr GLint BRUSH_STAMPS = 256;
+	constexpr GLint SPLAT_STAMPS = 128;
+	constexpr GLint RAY_COUNT = 4096;
+
+	constexpr float PI = 3.14159265358979f;
+
+	typedef struct SCameraKey
+	{
+		SVector3Df v3Pos;
+		SVector3Df v3Target;
+	} TCameraKey;
+
+	// Circle around the map center at 35% of its size, bobbing a little, looking slightly inwards and down
+	std::vector<TCameraKey> MakeCameraPath(float fWorldSize)
+	{
+		std::vector<TCameraKey> vPath(CAMERA_PATH_POINTS);
+
+		const float fCenter = fWorldSize * 0.5f;
+		const float fRadius = fWorldSize * 0.35f;
+
+		for (GLint i = 0; i < CAMERA_PATH_POINTS; i++)
+		{
+			const float fAngle = 2.0f * PI * static_cast<float>(i) / CAMERA_PATH_POINTS;
+			const float fHeight = MAX_HEIGHT * 1.2f + 40.0f * std::sin(fAngle * 3.0f);
+
+			vPath[i].v3Pos = SVector3Df(fCenter + fRadius * std::cos(fAngle), fHeight, fCenter + fRadius * std::sin(fAngle));
+			vPath[i].v3Target = SVector3Df(fCenter + fRadius * 0.5f * std::cos(fAngle + 0.6f), MAX_HEIGHT * 0.3f, fCenter + fRadius * 0.5f * std::sin(fAngle + 0.6f));
+		}
+
+		return (vPath);
+	}
+
+	// Copies of the vector ops as they were in vectors.cpp, kept out of line to time the normals pass before vectors.inl
+	BENCH_NOINLINE SVector3Df LegacySub(const SVector3Df& a, const SVector3Df& b)
+	{
+		return (SVector3Df(a.x - b.x, a.y - b.y, a.z - b.z));
+	}
+
+	BENCH_NOINLINE SVector3Df LegacyCross(const SVector3Df& a, const SVector3Df& b)
+	{
+		const float _x = a.y * b.z - a.z * b.y;
+		const float _y = a.z * b.x - a.x * b.z;
+		const float _z = a.x * b.y - a.y * b.x;
+		return (SVector3Df(_x, _y, _z));
+	}
+
+	BENCH_NOINLINE float LegacyLength(const SVector3Df& v)
+	{
+		return (std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z));
+	}
+
+	BENCH_NOINLINE SVector3Df& LegacyNormalize(SVector3Df& v)
+	{
+		const float fLen = LegacyLength(v);
+		v.x /= fLen;
+		v.y /= fLen;
+		v.z /= fLen;
+		return (v);
+	}
+
+	// CGeoMipGrid::UpdateNormals over the whole grid, with every vector op going through a call
+	void UpdateNormalsLegacy(CGeoMipGrid* pGrid, GLint iWidth, GLint iDepth, std::vector<SVector3Df>& vNormals)
+	{
+		const auto& vVertices = pGrid->GetVertices();
+
+		for (GLint z = 0; z < iDepth; z++)
+		{
+			for (GLint x = 0; x < iWidth; x++)
+			{
+				const GLint idx = z * iWidth + x;
+				const SVector3Df& pos = vVertices[idx].m_v3Pos;
+
+				const SVector3Df& right = (x + 1 < iWidth) ? vVertices[idx + 1].m_v3Pos : pos;
+				const SVector3Df& left = (x - 1 >= 0) ? vVertices[idx - 1].m_v3Pos : pos;
+				const SVector3Df& up = (z - 1 >= 0) ? vVertices[idx - iWidth].m_v3Pos : pos;
+				const SVector3Df& down = (z + 1 < iDepth) ? vVertices[idx + iWidth].m_v3Pos : pos;
+
+				const SVector3Df dx = LegacySub(right, left);
+				const SVector3Df dz = LegacySub(down, up);
+
+				SVector3Df v3Normal = LegacyCross(dz, dx);
+				vNormals[idx] = LegacyNormalize(v3Normal);
+			}
+		}
+	}
+
+	// Points of an S shaped stroke across the middle of the map
+	SVector2Df GetStrokePoint(float fWorldSize, GLint iStamp, GLint iStampCount)
+	{
+		const float t = static_cast<float>(iStamp) / static_cast<float>(iStampCount - 1);
+		const float fX = fWorldSize * (0.1f + 0.8f * t);
+		const float fZ = fWorldSize * (0.5f + 0.3f * std::sin(t * 2.0f * PI));
+		return (SVector2Df(fX, fZ));
+	}
+
+	void RunMapSize(CBenchmark& bench, GLint iMapSize)
+	{
+		const TBenchConfig& config = bench.GetConfig();
+		const GLint iPatchSize = config.iPatchSize;
+
+		CBaseTerrain terrain(true);
+		terrain.InitializeTerrain(iMapSize, iPatchSize, WORLD_SCALE, TEXTURE_SCALE);
+
+		CGeoMipGrid* pGrid = terrain.GetGeoMipGrid();
+		const float fWorldSize = static_cast<float>(iMapSize - 1) * WORLD_SCALE;
+		const uint64_t ulCells = static_cast<uint64_t>(iMapSize) * iMapSize;
+		const GLint iNumPatches = ((iMapSize - 1) / (iPatchSize - 1)) * ((iMapSize - 1) / (iPatchSize - 1));
+
+		// The default CGrid constructor leaves the storage uninitialized, size it up front
+		CMidPointGenerator generator;
+		CGrid<GLfloat> heights(iMapSize, iMapSize);
+		bench.Run("terrain", "midpoint_generate", iMapSize, ulCells, [&]()
+		{
+			generator.Generate(heights, iMapSize, ROUGHNESS, MIN_HEIGHT, MAX_HEIGHT, config.ulSeed);
+			return (static_cast<double>(heights.Get(iMapSize / 2, iMapSize / 2)));
+		});
+
+		// The later cases all start from the seeded terrain, also when the filter skipped the case above
+		generator.Generate(heights, iMapSize, ROUGHNESS, MIN_HEIGHT, MAX_HEIGHT, config.ulSeed);
+		terrain.SetHeights(heights.GetBaseAddr());
+
+		// Vertices, LOD index lists and normals, the whole CPU side of CreateGeoMipGrid
+		bench.Run("terrain", "geomip_build", iMapSize, ulCells, [&]()
+		{
+			pGrid->Destroy();
+			pGrid->CreateGeoMipGrid(iMapSize, iMapSize, iPatchSize, &terrain);
+			return (static_cast<double>(pGrid->GetIndices().size()));
+		});
+		terrain.SetHeights(heights.GetBaseAddr());
+
+		bench.Run("terrain", "normals", iMapSize, ulCells, [&]()
+		{
+			pGrid->UpdateNormals();
+			return (static_cast<double>(pGrid->GetVertices()[ulCells / 2].m_v3Normals.y));
+		});
+
+		// Same pass with the pre vectors.inl call overhead, the checksum matches the case above
+		std::vector<SVector3Df> vLegacyNormals(ulCells);
+		bench.Run("terrain", "normals_legacy", iMapSize, ulCells, [&]()
+		{
+			UpdateNormalsLegacy(pGrid, iMapSize, iMapSize, vLegacyNormals);
+			return (static_cast<double>(vLegacyNormals[ulCells / 2].y));
+		});
+
+		const std::vector<TCameraKey> vPath = MakeCameraPath(fWorldSize);
+		const uint64_t ulPathPatches = static_cast<uint64_t>(vPath.size()) * iNumPatches;
+
+		bench.Run("terrain", "lod_update", iMapSize, ulPathPatches, [&]()
+		{
+			double dSum = 0.0;
+			for (const TCameraKey& key : vPath)
+			{
+				CLodManager::Instance().Update(key.v3Pos);
+				dSum += CLodManager::Instance().GetPatchLod(0, 0).iCore;
+			}
+			return (dSum);
+		});
+
+		// Matrices are built once with the editor camera projection, only the patch tests are timed
+		const SPersProjInfo persProj = CCameraManager::Instance().GetCurrentCamera()->GetPersProjInfo();
+
+		std::vector<CMatrix4Df> vViewProj;
+		vViewProj.reserve(vPath.size());
+		for (const TCameraKey& key : vPath)
+		{
+			CCamera camera(persProj, key.v3Pos, key.v3Target);
+			vViewProj.push_back(camera.GetViewProjMatrix());
+		}
+
+		bench.Run("terrain", "frustum_cull", iMapSize, ulPathPatches, [&]()
+		{
+			size_t uiVisible = 0;
+			for (const CMatrix4Df& viewProj : vViewProj)
+			{
+				uiVisible += pGrid->CullPatches(viewProj);
+			}
+			return (static_cast<double>(uiVisible));
+		});
+
+		// Every repetition sculpts the same stroke on the same heights
+		const EBrushType aeSculptBrushes[] = { BRUSH_TYPE_UP, BRUSH_TYPE_DOWN, BRUSH_TYPE_SMOOTH, BRUSH_TYPE_NOISE, BRUSH_TYPE_FLATTEN };
+		bench.Run("terrain", "brush_stroke", iMapSize, BRUSH_STAMPS, [&]()
+		{
+			for (GLint i = 0; i < BRUSH_STAMPS; i++)
+			{
+				TBrushStamp stamp{};
+				stamp.eBrushType = aeSculptBrushes[(i / 16) % std::size(aeSculptBrushes)];
+				stamp.v2WorldPos = GetStrokePoint(fWorldSize, i, BRUSH_STAMPS);
+				stamp.fRadius = fWorldSize * 0.03f;
+				stamp.fStrength = 2.0f;
+				stamp.fBaseHeight = MAX_HEIGHT * 0.5f;
+				stamp.iTextureIndex = 0;
+				pGrid->QueueBrushStamp(stamp);
+
+				// The editor flushes once per frame, a frame sees a handful of stamps
+				if ((i % 8) == 7)
+				{
+					pGrid->FlushBrushStamps();
+				}
+			}
+			pGrid->FlushBrushStamps();
+			return (static_cast<double>(pGrid->GetLastModifiedRegion().iMaxX));
+		},
+		[&]()
+		{
+			terrain.SetHeights(heights.GetBaseAddr());
+		});
+		terrain.SetHeights(heights.GetBaseAddr());
+
+		bench.Run("terrain", "splat_paint", iMapSize, SPLAT_STAMPS, [&]()
+		{
+			for (GLint i = 0; i < SPLAT_STAMPS; i++)
+			{
+				TBrushParams brush{};
+				brush.v2WorldPos = GetStrokePoint(fWorldSize, i, SPLAT_STAMPS);
+				brush.fRadius = fWorldSize * 0.02f;
+				brush.fStrength = 0.5f;
+				brush.iSelectedTextureIndex = (i / 32) % 4;
+				brush.fAlpha = 1.0f;
+				pGrid->PaintSplatmap(brush);
+			}
+			return (static_cast<double>(pGrid->GetMaterializedPatchesCount()));
+		},
+		[&]()
+		{
+			pGrid->ResetAllSplatmapsToBaseTexture();
+		});
+
+		// One props layer on the lower, flatter ground, the splat maps are left out
+		CScatterGrid scatter;
+		scatter.Create(&terrain, config.ulSeed);
+
+		TScatterLayer layer{};
+		layer.stName = "Props";
+		layer.fMinDistance = 4.0f;
+		layer.fDensity = 0.8f;
+		layer.fHeightMin = MIN_HEIGHT;
+		layer.fHeightMax = MAX_HEIGHT * 0.6f;
+		layer.fSlopeMin = 0.0f;
+		layer.fSlopeMax = 35.0f;
+		layer.iSplatTexture = -1;
+		layer.fSplatMinWeight = 0.5f;
+		layer.fScaleMin = 0.8f;
+		layer.fScaleMax = 1.2f;
+		layer.fBoundsHeight = 10.0f;
+		layer.fDrawDistance = fWorldSize;
+		scatter.AddLayer(layer);
+
+		bench.Run("terrain", "scatter_generate", iMapSize, iNumPatches, [&]()
+		{
+			scatter.InvalidateAll();
+			scatter.Generate();
+			return (static_cast<double>(scatter.GetInstancesCount()));
+		});
+		scatter.InvalidateAll();
+		scatter.Generate();
+
+		std::vector<std::vector<CMatrix4Df>> vVisible;
+		bench.Run("terrain", "scatter_cull", iMapSize, ulPathPatches, [&]()
+		{
+			size_t uiVisible = 0;
+			for (size_t i = 0; i < vViewProj.size(); i++)
+			{
+				uiVisible += scatter.CollectVisible(vViewProj[i], vPath[i].v3Pos, vVisible);
+			}
+			return (static_cast<double>(uiVisible));
+		});
+
+		// Mostly downward rays from above the terrain, seeded so every run casts the same ones
+		CRandom random(config.ulSeed, 1);
+		std::vector<SVector3Df> vOrigins(RAY_COUNT);
+		std::vector<SVector3Df> vDirections(RAY_COUNT);
+		for (GLint i = 0; i < RAY_COUNT; i++)
+		{
+			// One draw per statement, argument evaluation order differs between compilers
+			const float fX = random.Range(0.0f, fWorldSize);
+			const float fZ = random.Range(0.0f, fWorldSize);
+			const float fDirX = random.Range(-0.5f, 0.5f);
+			const float fDirZ = random.Range(-0.5f, 0.5f);
+
+			vOrigins[i] = SVector3Df(fX, MAX_HEIGHT + 100.0f, fZ);
+			vDirections[i] = SVector3Df(fDirX, -1.0f, fDirZ);
+			vDirections[i].normalize();
+		}
+
+		bench.Run("terrain", "raycast", iMapSize, RAY_COUNT, [&]()
+		{
+			double dSum = 0.0;
+			SVector3Df v3Hit;
+			for (GLint i = 0; i < RAY_COUNT; i++)
+			{
+				if (pGrid->RaycastHeightmap(vOrigins[i], vDirections[i], v3Hit))
+				{
+					dSum += v3Hit.y;
+				}
+			}
+			return (dSum);
+		});
+
+		bench.Run("terrain", "raycast_fast", iMapSize, RAY_COUNT, [&]()
+		{
+			double dSum = 0.0;
+			SVector3Df v3Hit;
+			for (GLint i = 0; i < RAY_COUNT; i++)
+			{
+				if (pGrid->RaycastHeightmapFast(vOrigins[i], vDirections[i], v3Hit))
+				{
+					dSum += v3Hit.y;
+				}
+			}
+			return (dSum);
+		});
+	}
+}
+
+void RunTerrainBenchmarks(CBenchmark& bench)
+{
+	// Owned by CWindow in the editor and reached through their singletons. The default camera
+	// also sets the LOD distances, the same ones the editor starts with
+	CCameraManager cameraManager;
+	CLodManager lodManager;
+
+	// CBaseTerrain is a singleton too, one map size at a time
+	for (GLint iMapSize : bench.GetConfig().vMapSizes)
+	{
+		RunMapSize(bench, iMapSize);
+	}
+}
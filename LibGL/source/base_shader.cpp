@@ -33,6 +33,19 @@ CBaseShader::CBaseShader(const char* stShaderPath)
 	sys_log("CBaseShader::CBaseShader ShaderName: %s, ShaderID: %d, ShaderType: %s", GetName().c_str(), GetShaderID(), GetType().m_stName.c_str());
 }
 
+CBaseShader::CBaseShader(const TShaderSource& source)
+{
+	m_stPath = source.stPath;
+	const char* shaderCodeStr = source.stSource.c_str();
+
+	m_sShaderType = source.sType;
+	m_uiShaderID = glCreateShader(m_sShaderType.m_uiType);
+
+	glShaderSource(m_uiShaderID, 1, &shaderCodeStr, nullptr);
+	glCompileShader(m_uiShaderID);
+	CheckCompileErrors(m_uiShaderID, m_sShaderType.m_stName, GetShaderName(source.stPath));
+}
+
 std::string CBaseShader::LoadShaderFromFile(const std::string& stShaderPath)
 {
 	/* 1. retrieve the shader source code from filePath */
@@ -55,7 +68,7 @@ std::string CBaseShader::LoadShaderFromFile(const std::string& stShaderPath)
 		fShaderFile.close();
 
 		/* convert streams into strings */
-		shaderCode = sShaderStream.str();
+		shaderCode = ExpandShaderIncludes(sShaderStream.str(), stShaderPath);
 
 	}
 	catch (std::ifstream::failure err)
@@ -181,3 +194,95 @@ TShaderType GetShaderType(const std::string& stShaderPath)
 
 	return (shaderType);
 }
+
+TShaderSource ReadShaderSource(const std::string& stShaderPath)
+{
+	TShaderSource source;
+	source.stPath = stShaderPath;
+	source.sType = GetShaderType(stShaderPath);
+
+	std::ifstream fShaderFile(stShaderPath, std::ios::binary);
+	if (!fShaderFile.is_open())
+	{
+		sys_err("ReadShaderSource Failed to Load the Shader File %s", GetShaderName(stShaderPath).c_str());
+		return (source);
+	}
+
+	std::stringstream sShaderStream;
+	sShaderStream << fShaderFile.rdbuf();
+	source.stSource = ExpandShaderIncludes(sShaderStream.str(), stShaderPath);
+
+	return (source);
+}
+
+std::string ExpandShaderIncludes(const std::string& stSource, const std::string& stShaderPath, GLint iDepth)
+{
+	// Shaders without includes keep their source (and program cache key) untouched
+	if (stSource.find("#include") == std::string::npos)
+	{
+		return (stSource);
+	}
+
+	if (iDepth >= SHADER_INCLUDE_MAX_DEPTH)
+	{
+		sys_err("ExpandShaderIncludes Includes Nested Too Deep in %s", GetShaderName(stShaderPath).c_str());
+		return (stSource);
+	}
+
+	const size_t uiSlash = stShaderPath.find_last_of("\\/");
+	const std::string stDir = (uiSlash != std::string::npos) ? stShaderPath.substr(0, uiSlash + 1) : std::string();
+
+	std::string stOut;
+	stOut.reserve(stSource.size());
+
+	std::istringstream sSourceStream(stSource);
+	std::string stLine;
+	GLint iLine = 0;
+
+	while (std::getline(sSourceStream, stLine))
+	{
+		iLine++;
+
+		const size_t uiStart = stLine.find_first_not_of(" \t");
+		if (uiStart == std::string::npos || stLine.compare(uiStart, 8, "#include") != 0)
+		{
+			stOut += stLine;
+			stOut += '\n';
+			continue;
+		}
+
+		const size_t uiOpen = stLine.find('"', uiStart + 8);
+		const size_t uiClose = (uiOpen != std::string::npos) ? stLine.find('"', uiOpen + 1) : std::string::npos;
+		if (uiClose == std::string::npos)
+		{
+			sys_err("ExpandShaderIncludes Malformed #include in %s Line %d", GetShaderName(stShaderPath).c_str(), iLine);
+			stOut += stLine;
+			stOut += '\n';
+			continue;
+		}
+
+		const std::string stIncludePath = stDir + stLine.substr(uiOpen + 1, uiClose - uiOpen - 1);
+		std::ifstream fIncludeFile(stIncludePath, std::ios::binary);
+		if (!fIncludeFile.is_open())
+		{
+			// The directive is left in, so the stage also fails to compile
+			sys_err("ExpandShaderIncludes Failed to Load %s Included From %s", stIncludePath.c_str(), GetShaderName(stShaderPath).c_str());
+			stOut += stLine;
+			stOut += '\n';
+			continue;
+		}
+
+		std::stringstream sIncludeStream;
+		sIncludeStream << fIncludeFile.rdbuf();
+		stOut += ExpandShaderIncludes(sIncludeStream.str(), stIncludePath, iDepth + 1);
+		if (!stOut.empty() && stOut.back() != '\n')
+		{
+			stOut += '\n';
+		}
+
+		// Compile errors after the include still report the line of the including file
+		stOut += "#line " + std::to_string(iLine + 1) + "\n";
+	}
+
+	return (stOut);
+}
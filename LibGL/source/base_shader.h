@@ -3,6 +3,9 @@
 #include <glad/glad.h>
 #include <string>
 
+// Nesting limit of #include "file" in the shader sources
+#define SHADER_INCLUDE_MAX_DEPTH 8
+
 typedef struct SShaderType
 {
 	std::string m_stName;
@@ -21,11 +24,20 @@ typedef struct SShaderType
 	}
 } TShaderType;
 
+// One stage read from disk but not compiled yet
+typedef struct SShaderSource
+{
+	std::string stPath;
+	TShaderType sType;
+	std::string stSource;
+} TShaderSource;
+
 class CBaseShader
 {
 public:
 	CBaseShader(const std::string& stShaderPath);
 	CBaseShader(const char* stShaderPath);
+	explicit CBaseShader(const TShaderSource& source);
 
 	virtual ~CBaseShader() = default;
 
@@ -49,3 +61,7 @@ extern bool CheckCompileErrors(GLuint uiShaderID, const std::string& stShaderTyp
 extern std::string GetShaderName(const std::string& stShaderPath);
 extern std::string GetShaderTypeName(const std::string& stShaderPath);
 extern TShaderType GetShaderType(const std::string& stShaderPath);
+extern TShaderSource ReadShaderSource(const std::string& stShaderPath);
+
+// Replaces #include "file" lines with the file, the path is relative to the including shader
+extern std::string ExpandShaderIncludes(const std::string& stSource, const std::string& stShaderPath, GLint iDepth = 0);
@@ -142,6 +142,11 @@ void CCamera::InitInternal()
 
 	m_v2MousePos = SVector2Df(m_iWindowW / 2.0f, m_iWindowH / 2.0f);
 
+	m_bViewDirty = true;
+	m_bProjDirty = true;
+	m_uiRecomputeCount = 0;
+	m_uiLastFrameRecomputeCount = 0;
+
 	OnUpdate();
 }
 
@@ -150,11 +155,13 @@ void CCamera::SetPosition(const float x, const float y, const float z)
 	m_v3Pos.x = x;
 	m_v3Pos.y = y;
 	m_v3Pos.z = z;
+	InvalidateView();
 }
 
 void CCamera::SetPosition(const SVector3Df& v3Pos)
 {
 	m_v3Pos = v3Pos;
+	InvalidateView();
 }
 
 const SVector3Df& CCamera::GetPosition() const
@@ -167,11 +174,13 @@ void CCamera::SetTarget(const float x, const float y, const float z)
 	m_v3Target.x = x;
 	m_v3Target.y = y;
 	m_v3Target.z = z;
+	InvalidateView();
 }
 
 void CCamera::SetTarget(const SVector3Df& v3Target)
 {
 	m_v3Target = v3Target;
+	InvalidateView();
 }
 
 const SVector3Df& CCamera::GetTarget() const
@@ -184,11 +193,13 @@ void CCamera::SetUp(const float x, const float y, const float z)
 	m_v3Up.x = x;
 	m_v3Up.y = y;
 	m_v3Up.z = z;
+	InvalidateView();
 }
 
 void CCamera::SetUp(const SVector3Df& v3Up)
 {
 	m_v3Up = v3Up;
+	InvalidateView();
 }
 
 const SVector3Df& CCamera::GetUp() const
@@ -201,37 +212,108 @@ const SVector3Df& CCamera::GetDirection() const
 	return (m_v3View);
 }
 
-CMatrix4Df CCamera::GetMatrix() const
+void CCamera::InvalidateView()
 {
-	CMatrix4Df CameraTransformation{};
-	CameraTransformation.InitCameraTransform(m_v3Pos, m_v3Target, m_v3Up);
+	m_bViewDirty = true;
+}
 
-	return (CameraTransformation);
+void CCamera::InvalidateProjection()
+{
+	m_bProjDirty = true;
 }
 
-CMatrix4Df CCamera::GetViewProjMatrix() const
+void CCamera::UpdateMatrixCache() const
 {
-	CMatrix4Df viewMat = GetMatrix();
-	CMatrix4Df projectionMat = GetProjectionMat();
-	CMatrix4Df ViewProjectionMat = projectionMat * viewMat;
-	return (ViewProjectionMat);
+	if (!m_bViewDirty && !m_bProjDirty)
+	{
+		return;
+	}
+
+	if (m_bViewDirty)
+	{
+		m_matView.InitCameraTransform(m_v3Pos, m_v3Target, m_v3Up);
+		m_matViewInverse = m_matView.Inverse();
+
+		// The view rotation is orthonormal, so the billboard rotation is just its transpose
+		CMatrix3Df billboardRotation = CMatrix3Df(m_matView).Transpose();
+		m_matBillBoard = billboardRotation;
+		m_matBillBoard.mat4[3][0] = 0.0f;
+		m_matBillBoard.mat4[3][1] = 0.0f;
+		m_matBillBoard.mat4[3][2] = 0.0f;
+		m_matBillBoard.mat4[3][3] = 1.0f;
+	}
+
+	if (m_bProjDirty)
+	{
+		m_matProjInverse = m_matProj.Inverse();
+	}
+
+	m_matViewProj = m_matProj * m_matView;
+	m_matViewProjInverse = m_matViewInverse * m_matProjInverse;
+	m_FrustumCulling.Update(m_matViewProj);
+
+	m_bViewDirty = false;
+	m_bProjDirty = false;
+	m_uiRecomputeCount++;
+}
+
+const CMatrix4Df& CCamera::GetMatrix() const
+{
+	UpdateMatrixCache();
+	return (m_matView);
 }
 
-CMatrix4Df CCamera::GetViewMatrix() const
+const CMatrix4Df& CCamera::GetViewProjMatrix() const
+{
+	UpdateMatrixCache();
+	return (m_matViewProj);
+}
+
+const CMatrix4Df& CCamera::GetViewMatrix() const
 {
 	return (GetMatrix());
 }
 
-CMatrix4Df CCamera::GetBillBoardMatrix() const
+const CMatrix4Df& CCamera::GetBillBoardMatrix() const
 {
+	UpdateMatrixCache();
 	return (m_matBillBoard);
 }
 
-CMatrix4Df CCamera::GetViewMatrixInverse() const
+const CMatrix4Df& CCamera::GetViewMatrixInverse() const
 {
+	UpdateMatrixCache();
 	return (m_matViewInverse);
 }
 
+const CMatrix4Df& CCamera::GetProjectionMatInverse() const
+{
+	UpdateMatrixCache();
+	return (m_matProjInverse);
+}
+
+const CMatrix4Df& CCamera::GetViewProjMatrixInverse() const
+{
+	UpdateMatrixCache();
+	return (m_matViewProjInverse);
+}
+
+const SFrustumCulling& CCamera::GetFrustumCulling() const
+{
+	UpdateMatrixCache();
+	return (m_FrustumCulling);
+}
+
+GLuint CCamera::GetMatrixRecomputeCount() const
+{
+	return (m_uiRecomputeCount);
+}
+
+GLuint CCamera::GetLastFrameMatrixRecomputeCount() const
+{
+	return (m_uiLastFrameRecomputeCount);
+}
+
 void CCamera::ProcessKeyboardInput(ECameraDirections eDirection, float deltaTime)
 {
 	if (IsLocked())
@@ -252,17 +334,23 @@ void CCamera::ProcessKeyboardInput(ECameraDirections eDirection, float deltaTime
 		break;
 
 	case DIRECTION_RIGHT:
+	{
 		SVector3Df v3Right = m_v3Up.cross(m_v3Target);
 		v3Right.normalize();
 		m_v3Pos += v3Right * fVelocity;
 		break;
+	}
 
 	case DIRECTION_LEFT:
+	{
 		SVector3Df v3Left = m_v3Target.cross(m_v3Up);
 		v3Left.normalize();
 		m_v3Pos += v3Left * fVelocity;
 		break;
 	}
+	}
+
+	InvalidateView();
 }
 
 void CCamera::ProcessMouseMovement(float fOffsetX, float fOffsetY)
@@ -340,12 +428,16 @@ void CCamera::ProcessMouseScroll(float fOffsetY)
 	{
 		m_sPersProjInfo.FOV = m_fZoom;
 		m_matProj.InitPersProjTransform(m_sPersProjInfo);
+		InvalidateProjection();
 	}
 
 }
 
 void CCamera::OnRender()
 {
+	m_uiLastFrameRecomputeCount = m_uiRecomputeCount;
+	m_uiRecomputeCount = 0;
+
 	if (IsLocked())
 	{
 		return;
@@ -448,7 +540,7 @@ void CCamera::OnUpdate()
 	}
 
 	UpdateViewVector();
-	UpdateBillBoardMatrix();
+	InvalidateView();
 }
 
 void CCamera::UpdateViewVector()
@@ -456,24 +548,6 @@ void CCamera::UpdateViewVector()
 	m_v3View = m_v3Target.normalize();
 }
 
-void CCamera::UpdateBillBoardMatrix()
-{
-	// Get the billboard transformation matrix
-	CMatrix4Df view = GetViewMatrix();
-	// Extract the rotation part (upper-left 3x3 matrix) from the view matrix:
-	CMatrix3Df viewRotation = CMatrix3Df(view);
-	// For an orthonormal matrix, the inverse is its transpose:
-	CMatrix3Df billboardRotation = viewRotation.Transpose();
-	// Convert back to a 4x4 matrix with no translation:
-	m_matBillBoard = billboardRotation;
-	m_matBillBoard.mat4[3][0] = 0.0f;
-	m_matBillBoard.mat4[3][1] = 0.0f;
-	m_matBillBoard.mat4[3][2] = 0.0f;
-	m_matBillBoard.mat4[3][3] = 1.0f;
-
-	m_matViewInverse = GetViewMatrix().Inverse();
-}
-
 const float CCamera::GetSpeed() const
 {
 	return (m_fSpeed);
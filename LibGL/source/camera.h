@@ -68,17 +68,24 @@ public:
 	const CMatrix4Df& GetProjectionMat() const;
 	const SPersProjInfo& GetPersProjInfo() const;
 
-	CMatrix4Df GetMatrix() const;
-	CMatrix4Df GetViewProjMatrix() const;
-	CMatrix4Df GetViewMatrix() const;
+	// Cached, only rebuilt after the position, orientation or projection changed
+	const CMatrix4Df& GetMatrix() const;
+	const CMatrix4Df& GetViewProjMatrix() const;
+	const CMatrix4Df& GetViewMatrix() const;
+	const CMatrix4Df& GetBillBoardMatrix() const;
+	const CMatrix4Df& GetViewMatrixInverse() const;
+	const CMatrix4Df& GetProjectionMatInverse() const;
+	const CMatrix4Df& GetViewProjMatrixInverse() const;
+	const SFrustumCulling& GetFrustumCulling() const;
 	CMatrix4Df GetViewPortMatrix() const;
-	CMatrix4Df GetBillBoardMatrix() const;
-	CMatrix4Df GetViewMatrixInverse() const;
+
+	// Cache rebuilds so far in this frame and in the previous one, OnRender starts a new frame
+	GLuint GetMatrixRecomputeCount() const;
+	GLuint GetLastFrameMatrixRecomputeCount() const;
 
 	GLint GetWindowWidth() const;
 	GLint GetWindowHeight() const;
 
-	void UpdateBillBoardMatrix();
 	void UpdateViewVector();
 
 protected:
@@ -89,6 +96,9 @@ protected:
 
 	void OnUpdate();
 
+	void InvalidateView();
+	void InvalidateProjection();
+	void UpdateMatrixCache() const;
 
 private:
 	SVector3Df m_v3Pos; // m_v3Eye
@@ -121,8 +131,19 @@ private:
 
 	SPersProjInfo m_sPersProjInfo;
 	CMatrix4Df m_matProj;
-	CMatrix4Df m_matBillBoard;
-	CMatrix4Df m_matViewInverse;
+
+	// Derived from the members above by UpdateMatrixCache
+	mutable CMatrix4Df m_matView;
+	mutable CMatrix4Df m_matViewProj;
+	mutable CMatrix4Df m_matViewInverse;
+	mutable CMatrix4Df m_matProjInverse;
+	mutable CMatrix4Df m_matViewProjInverse;
+	mutable CMatrix4Df m_matBillBoard;
+	mutable SFrustumCulling m_FrustumCulling;
+	mutable bool m_bViewDirty;
+	mutable bool m_bProjDirty;
+	mutable GLuint m_uiRecomputeCount;
+	GLuint m_uiLastFrameRecomputeCount;
 
 	ECameraStates m_eCamState;
 };
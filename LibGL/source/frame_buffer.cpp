@@ -24,12 +24,12 @@ void CFrameBuffer::Destroy()
 
 	if (m_uiTextureBuffer)
 	{
-		glDeleteTextures(1, &m_uiTextureBuffer);
+		CGLState::DeleteTextures(1, &m_uiTextureBuffer);
 	}
 
 	if (m_uiDepthBuffer)
 	{
-		glDeleteTextures(1, &m_uiDepthBuffer);
+		CGLState::DeleteTextures(1, &m_uiDepthBuffer);
 	}
 }
 
@@ -57,7 +57,7 @@ void CFrameBuffer::InitSkyBox(GLint iWidth, GLint iHeight)
 	glBindFramebuffer(GL_FRAMEBUFFER, m_uiFBO);
 
 	glGenTextures(1, &m_uiTextureBuffer);
-	glBindTexture(GL_TEXTURE_2D, m_uiTextureBuffer);
+	CGLState::BindTexture(GL_TEXTURE_2D, m_uiTextureBuffer);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, iWidth, iHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -68,7 +68,7 @@ void CFrameBuffer::InitSkyBox(GLint iWidth, GLint iHeight)
 	GLExitIfError();
 
 	glGenTextures(1, &m_uiDepthBuffer);
-	glBindTexture(GL_TEXTURE_2D, m_uiDepthBuffer);
+	CGLState::BindTexture(GL_TEXTURE_2D, m_uiDepthBuffer);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, iWidth, iHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -136,7 +136,7 @@ void CFrameBuffer::InitNonDSA(GLint iWidth, GLint iHeight)
 	glGenFramebuffers(1, &m_uiFBO);
 
 	glGenTextures(1, &m_uiTextureBuffer);
-	glBindTexture(GL_TEXTURE_2D, m_uiTextureBuffer);
+	CGLState::BindTexture(GL_TEXTURE_2D, m_uiTextureBuffer);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, iWidth, iHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -146,7 +146,7 @@ void CFrameBuffer::InitNonDSA(GLint iWidth, GLint iHeight)
 	GLExitIfError();
 
 	glGenTextures(1, &m_uiDepthBuffer);
-	glBindTexture(GL_TEXTURE_2D, m_uiDepthBuffer);
+	CGLState::BindTexture(GL_TEXTURE_2D, m_uiDepthBuffer);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, iWidth, iHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -221,12 +221,12 @@ void CFrameBuffer::BindTextureForReading(GLenum eTextureUnit)
 {
 	if (IsGLVersionHigher(4, 5))
 	{
-		glBindTextureUnit(eTextureUnit - GL_TEXTURE0, m_uiTextureBuffer);
+		CGLState::BindTextureUnit(eTextureUnit - GL_TEXTURE0, GL_TEXTURE_2D, m_uiTextureBuffer);
 	}
 	else
 	{
-		glActiveTexture(eTextureUnit);
-		glBindTexture(GL_TEXTURE_2D, m_uiTextureBuffer);
+		CGLState::ActiveTexture(eTextureUnit);
+		CGLState::BindTexture(GL_TEXTURE_2D, m_uiTextureBuffer);
 	}
 }
 
@@ -234,12 +234,12 @@ void CFrameBuffer::BindDepthForReading(GLenum eTextureUnit)
 {
 	if (IsGLVersionHigher(4, 5))
 	{
-		glBindTextureUnit(eTextureUnit - GL_TEXTURE0, m_uiDepthBuffer);
+		CGLState::BindTextureUnit(eTextureUnit - GL_TEXTURE0, GL_TEXTURE_2D, m_uiDepthBuffer);
 	}
 	else
 	{
-		glActiveTexture(eTextureUnit);
-		glBindTexture(GL_TEXTURE_2D, m_uiDepthBuffer);
+		CGLState::ActiveTexture(eTextureUnit);
+		CGLState::BindTexture(GL_TEXTURE_2D, m_uiDepthBuffer);
 	}
 }
 
@@ -337,7 +337,7 @@ bool CShadowFrameBuffer::Initialize(GLint iWidth, GLint iHeight)
 
 		// Create Shadow Texture
 		glGenTextures(1, &m_uiShadowMap);
-		glBindTexture(GL_TEXTURE_2D, m_uiShadowMap);
+		CGLState::BindTexture(GL_TEXTURE_2D, m_uiShadowMap);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, iWidth, iHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
 		glTexParameteri(m_uiShadowMap, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri(m_uiShadowMap, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -385,11 +385,11 @@ void CShadowFrameBuffer::BindTextureForReading(GLenum eTextureUnit)
 {
 	/*if (IsGLVersionHigher(4, 5))
 	{
-		glBindTextureUnit(eTextureUnit - GL_TEXTURE0, m_uiShadowMap);
+		CGLState::BindTextureUnit(eTextureUnit - GL_TEXTURE0, GL_TEXTURE_2D, m_uiShadowMap);
 	}
 	else*/
 	{
-		glActiveTexture(eTextureUnit);
-		glBindTexture(GL_TEXTURE_2D, m_uiShadowMap);
+		CGLState::ActiveTexture(eTextureUnit);
+		CGLState::BindTexture(GL_TEXTURE_2D, m_uiShadowMap);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "stdafx.h"
+#include "gl_state.h"
+
+// Defaults of a fresh context, bindings not listed here start at 0
+GLuint CGLState::ms_uiProgram = 0;
+GLuint CGLState::ms_uiVertexArray = 0;
+GLuint CGLState::ms_auiBuffers[BUFFER_SLOT_COUNT] = {};
+GLuint CGLState::ms_auiIndexedBuffers[INDEXED_SLOT_COUNT][GLSTATE_MAX_INDEXED_BINDINGS] = {};
+GLuint CGLState::ms_uiActiveTexture = GL_TEXTURE0;
+GLuint CGLState::ms_auiTextures[GLSTATE_MAX_TEXTURE_UNITS][TEXTURE_SLOT_COUNT] = {};
+GLuint CGLState::ms_auiCapabilities[CAPABILITY_SLOT_COUNT] = {};
+GLuint CGLState::ms_auiBlendFunc[4] = { GL_ONE, GL_ZERO, GL_ONE, GL_ZERO };
+GLuint CGLState::ms_uiCullFace = GL_BACK;
+GLuint CGLState::ms_uiDepthFunc = GL_LESS;
+GLuint CGLState::ms_uiDepthMask = GL_TRUE;
+
+uint32_t CGLState::ms_uiIssued = 0;
+uint32_t CGLState::ms_uiElided = 0;
+uint32_t CGLState::ms_uiLastFrameIssued = 0;
+uint32_t CGLState::ms_uiLastFrameElided = 0;
+
+void CGLState::DeleteBuffers(GLsizei iCount, const GLuint* puiBuffers)
+{
+	for (GLsizei i = 0; i < iCount; i++)
+	{
+		const GLuint uiBuffer = puiBuffers[i];
+		if (uiBuffer == 0)
+		{
+			continue;
+		}
+
+		for (GLuint& uiBound : ms_auiBuffers)
+		{
+			if (uiBound == uiBuffer)
+			{
+				uiBound = 0;
+			}
+		}
+
+		for (auto& auiIndexed : ms_auiIndexedBuffers)
+		{
+			for (GLuint& uiBound : auiIndexed)
+			{
+				if (uiBound == uiBuffer)
+				{
+					uiBound = 0;
+				}
+			}
+		}
+	}
+
+	glDeleteBuffers(iCount, puiBuffers);
+}
+
+void CGLState::DeleteVertexArrays(GLsizei iCount, const GLuint* puiVertexArrays)
+{
+	for (GLsizei i = 0; i < iCount; i++)
+	{
+		if (puiVertexArrays[i] != 0 && puiVertexArrays[i] == ms_uiVertexArray)
+		{
+			ms_uiVertexArray = 0;
+			ms_auiBuffers[BUFFER_SLOT_ELEMENT_ARRAY] = GLSTATE_UNKNOWN;
+		}
+	}
+
+	glDeleteVertexArrays(iCount, puiVertexArrays);
+}
+
+void CGLState::DeleteTextures(GLsizei iCount, const GLuint* puiTextures)
+{
+	for (GLsizei i = 0; i < iCount; i++)
+	{
+		const GLuint uiTexture = puiTextures[i];
+		if (uiTexture == 0)
+		{
+			continue;
+		}
+
+		for (auto& auiUnit : ms_auiTextures)
+		{
+			for (GLuint& uiBound : auiUnit)
+			{
+				if (uiBound == uiTexture)
+				{
+					uiBound = 0;
+				}
+			}
+		}
+	}
+
+	glDeleteTextures(iCount, puiTextures);
+}
+
+void CGLState::ForgetBuffer(GLenum eTarget)
+{
+	const GLint iSlot = GetBufferSlot(eTarget);
+	if (iSlot >= 0)
+	{
+		ms_auiBuffers[iSlot] = GLSTATE_UNKNOWN;
+	}
+}
+
+void CGLState::ForgetTextureUnit(GLuint uiUnit)
+{
+	// Unknown or untracked active unit, any of them may have changed
+	if (uiUnit >= GLSTATE_MAX_TEXTURE_UNITS)
+	{
+		for (auto& auiUnit : ms_auiTextures)
+		{
+			for (GLuint& uiBound : auiUnit)
+			{
+				uiBound = GLSTATE_UNKNOWN;
+			}
+		}
+		return;
+	}
+
+	for (GLuint& uiBound : ms_auiTextures[uiUnit])
+	{
+		uiBound = GLSTATE_UNKNOWN;
+	}
+}
+
+void CGLState::Invalidate()
+{
+	ms_uiProgram = GLSTATE_UNKNOWN;
+	ms_uiVertexArray = GLSTATE_UNKNOWN;
+	ms_uiActiveTexture = GLSTATE_UNKNOWN;
+	ms_uiCullFace = GLSTATE_UNKNOWN;
+	ms_uiDepthFunc = GLSTATE_UNKNOWN;
+	ms_uiDepthMask = GLSTATE_UNKNOWN;
+
+	for (GLuint& uiBound : ms_auiBuffers)
+	{
+		uiBound = GLSTATE_UNKNOWN;
+	}
+
+	for (auto& auiIndexed : ms_auiIndexedBuffers)
+	{
+		for (GLuint& uiBound : auiIndexed)
+		{
+			uiBound = GLSTATE_UNKNOWN;
+		}
+	}
+
+	ForgetTextureUnit(GLSTATE_UNKNOWN);
+
+	for (GLuint& uiState : ms_auiCapabilities)
+	{
+		uiState = GLSTATE_UNKNOWN;
+	}
+
+	for (GLuint& uiFactor : ms_auiBlendFunc)
+	{
+		uiFactor = GLSTATE_UNKNOWN;
+	}
+}
+
+void CGLState::EndFrame()
+{
+	ms_uiLastFrameIssued = ms_uiIssued;
+	ms_uiLastFrameElided = ms_uiElided;
+	ms_uiIssued = 0;
+	ms_uiElided = 0;
+}
+
+uint32_t CGLState::GetIssuedCount()
+{
+	return (ms_uiIssued);
+}
+
+uint32_t CGLState::GetElidedCount()
+{
+	return (ms_uiElided);
+}
+
+uint32_t CGLState::GetLastFrameIssuedCount()
+{
+	return (ms_uiLastFrameIssued);
+}
+
+uint32_t CGLState::GetLastFrameElidedCount()
+{
+	return (ms_uiLastFrameElided);
+}
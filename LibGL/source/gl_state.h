@@ -0,0 +1,368 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+
+#define GLSTATE_MAX_TEXTURE_UNITS 32
+#define GLSTATE_MAX_INDEXED_BINDINGS 16
+#define GLSTATE_UNKNOWN 0xFFFFFFFFu
+
+/*
+ * Shadow copy of the GL binding state
+ *
+ * Mirrors the bound program, vertex array, buffers per target and per indexed binding point,
+ * textures per unit and target, and the blend, depth and cull state. A call that would set the
+ * value already in effect is dropped. The cache starts out with the defaults of a fresh context,
+ * after Invalidate() every value is unknown until it is set again. Anything the cache does not
+ * track (other buffer or texture targets, units past GLSTATE_MAX_TEXTURE_UNITS) is passed
+ * through unchanged.
+ *
+ * Only valid when all code binds this state through CGLState. ImGui's backend restores what it
+ * changes, so it is safe. Raw GL code has to call Invalidate() afterwards.
+ *
+ * GL thread only.
+ */
+class CGLState
+{
+public:
+	static void UseProgram(GLuint uiProgram)
+	{
+		if (Update(ms_uiProgram, uiProgram))
+		{
+			glUseProgram(uiProgram);
+		}
+	}
+
+	static void BindVertexArray(GLuint uiVertexArray)
+	{
+		if (Update(ms_uiVertexArray, uiVertexArray))
+		{
+			glBindVertexArray(uiVertexArray);
+
+			// The element buffer binding belongs to the vertex array
+			ms_auiBuffers[BUFFER_SLOT_ELEMENT_ARRAY] = GLSTATE_UNKNOWN;
+		}
+	}
+
+	static void BindBuffer(GLenum eTarget, GLuint uiBuffer)
+	{
+		const GLint iSlot = GetBufferSlot(eTarget);
+		if (iSlot < 0)
+		{
+			ms_uiIssued++;
+			glBindBuffer(eTarget, uiBuffer);
+			return;
+		}
+
+		if (Update(ms_auiBuffers[iSlot], uiBuffer))
+		{
+			glBindBuffer(eTarget, uiBuffer);
+		}
+	}
+
+	// Also sets the generic binding of eTarget, like glBindBufferBase does
+	static void BindBufferBase(GLenum eTarget, GLuint uiIndex, GLuint uiBuffer)
+	{
+		const GLint iSlot = GetIndexedSlot(eTarget);
+		if (iSlot < 0 || uiIndex >= GLSTATE_MAX_INDEXED_BINDINGS)
+		{
+			ms_uiIssued++;
+			glBindBufferBase(eTarget, uiIndex, uiBuffer);
+			ForgetBuffer(eTarget);
+			return;
+		}
+
+		if (Update(ms_auiIndexedBuffers[iSlot][uiIndex], uiBuffer))
+		{
+			glBindBufferBase(eTarget, uiIndex, uiBuffer);
+
+			const GLint iBufferSlot = GetBufferSlot(eTarget);
+			if (iBufferSlot >= 0)
+			{
+				ms_auiBuffers[iBufferSlot] = uiBuffer;
+			}
+		}
+	}
+
+	// eTextureUnit is GL_TEXTURE0 + n
+	static void ActiveTexture(GLenum eTextureUnit)
+	{
+		if (Update(ms_uiActiveTexture, eTextureUnit))
+		{
+			glActiveTexture(eTextureUnit);
+		}
+	}
+
+	// Binds to the active unit
+	static void BindTexture(GLenum eTarget, GLuint uiTexture)
+	{
+		const GLuint uiUnit = ms_uiActiveTexture - GL_TEXTURE0;
+		const GLint iSlot = GetTextureSlot(eTarget);
+		if (ms_uiActiveTexture == GLSTATE_UNKNOWN || uiUnit >= GLSTATE_MAX_TEXTURE_UNITS || iSlot < 0)
+		{
+			ms_uiIssued++;
+			glBindTexture(eTarget, uiTexture);
+			ForgetTextureUnit(uiUnit);
+			return;
+		}
+
+		if (Update(ms_auiTextures[uiUnit][iSlot], uiTexture))
+		{
+			glBindTexture(eTarget, uiTexture);
+		}
+	}
+
+	// DSA bind, leaves the active unit alone. eTarget is the target the texture was created with
+	static void BindTextureUnit(GLuint uiUnit, GLenum eTarget, GLuint uiTexture)
+	{
+		const GLint iSlot = GetTextureSlot(eTarget);
+		if (uiUnit >= GLSTATE_MAX_TEXTURE_UNITS || iSlot < 0)
+		{
+			ms_uiIssued++;
+			glBindTextureUnit(uiUnit, uiTexture);
+			ForgetTextureUnit(uiUnit);
+			return;
+		}
+
+		if (Update(ms_auiTextures[uiUnit][iSlot], uiTexture))
+		{
+			glBindTextureUnit(uiUnit, uiTexture);
+
+			// Binding 0 clears every target of the unit
+			if (uiTexture == 0)
+			{
+				for (GLint i = 0; i < TEXTURE_SLOT_COUNT; i++)
+				{
+					ms_auiTextures[uiUnit][i] = 0;
+				}
+			}
+		}
+	}
+
+	static void Enable(GLenum eCapability)
+	{
+		SetCapability(eCapability, true);
+	}
+
+	static void Disable(GLenum eCapability)
+	{
+		SetCapability(eCapability, false);
+	}
+
+	static void BlendFunc(GLenum eSrc, GLenum eDst)
+	{
+		BlendFuncSeparate(eSrc, eDst, eSrc, eDst);
+	}
+
+	static void BlendFuncSeparate(GLenum eSrcRGB, GLenum eDstRGB, GLenum eSrcAlpha, GLenum eDstAlpha)
+	{
+		if (ms_auiBlendFunc[0] == eSrcRGB && ms_auiBlendFunc[1] == eDstRGB && ms_auiBlendFunc[2] == eSrcAlpha && ms_auiBlendFunc[3] == eDstAlpha)
+		{
+			ms_uiElided++;
+			return;
+		}
+
+		ms_auiBlendFunc[0] = eSrcRGB;
+		ms_auiBlendFunc[1] = eDstRGB;
+		ms_auiBlendFunc[2] = eSrcAlpha;
+		ms_auiBlendFunc[3] = eDstAlpha;
+		ms_uiIssued++;
+		glBlendFuncSeparate(eSrcRGB, eDstRGB, eSrcAlpha, eDstAlpha);
+	}
+
+	static void CullFace(GLenum eMode)
+	{
+		if (Update(ms_uiCullFace, eMode))
+		{
+			glCullFace(eMode);
+		}
+	}
+
+	static void DepthFunc(GLenum eFunc)
+	{
+		if (Update(ms_uiDepthFunc, eFunc))
+		{
+			glDepthFunc(eFunc);
+		}
+	}
+
+	static void DepthMask(GLboolean bWrite)
+	{
+		if (Update(ms_uiDepthMask, bWrite))
+		{
+			glDepthMask(bWrite);
+		}
+	}
+
+	// Deleting a bound object resets its bindings to 0, ids may be reused right after
+	static void DeleteBuffers(GLsizei iCount, const GLuint* puiBuffers);
+	static void DeleteVertexArrays(GLsizei iCount, const GLuint* puiVertexArrays);
+	static void DeleteTextures(GLsizei iCount, const GLuint* puiTextures);
+
+	// Forget everything, for code that touched the state behind the cache
+	static void Invalidate();
+
+	// Called once per frame, rolls the counters below
+	static void EndFrame();
+
+	static uint32_t GetIssuedCount();
+	static uint32_t GetElidedCount();
+	static uint32_t GetLastFrameIssuedCount();
+	static uint32_t GetLastFrameElidedCount();
+
+protected:
+	enum EBufferSlot
+	{
+		BUFFER_SLOT_ARRAY,
+		BUFFER_SLOT_ELEMENT_ARRAY,
+		BUFFER_SLOT_UNIFORM,
+		BUFFER_SLOT_SHADER_STORAGE,
+		BUFFER_SLOT_DRAW_INDIRECT,
+		BUFFER_SLOT_DISPATCH_INDIRECT,
+		BUFFER_SLOT_PIXEL_PACK,
+		BUFFER_SLOT_PIXEL_UNPACK,
+		BUFFER_SLOT_COPY_READ,
+		BUFFER_SLOT_COPY_WRITE,
+		BUFFER_SLOT_COUNT,
+	};
+
+	enum EIndexedSlot
+	{
+		INDEXED_SLOT_UNIFORM,
+		INDEXED_SLOT_SHADER_STORAGE,
+		INDEXED_SLOT_COUNT,
+	};
+
+	enum ETextureSlot
+	{
+		TEXTURE_SLOT_1D,
+		TEXTURE_SLOT_2D,
+		TEXTURE_SLOT_3D,
+		TEXTURE_SLOT_2D_ARRAY,
+		TEXTURE_SLOT_CUBE_MAP,
+		TEXTURE_SLOT_2D_MULTISAMPLE,
+		TEXTURE_SLOT_COUNT,
+	};
+
+	enum ECapabilitySlot
+	{
+		CAPABILITY_SLOT_BLEND,
+		CAPABILITY_SLOT_DEPTH_TEST,
+		CAPABILITY_SLOT_CULL_FACE,
+		CAPABILITY_SLOT_SCISSOR_TEST,
+		CAPABILITY_SLOT_STENCIL_TEST,
+		CAPABILITY_SLOT_COUNT,
+	};
+
+	static GLint GetBufferSlot(GLenum eTarget)
+	{
+		switch (eTarget)
+		{
+		case GL_ARRAY_BUFFER: return (BUFFER_SLOT_ARRAY);
+		case GL_ELEMENT_ARRAY_BUFFER: return (BUFFER_SLOT_ELEMENT_ARRAY);
+		case GL_UNIFORM_BUFFER: return (BUFFER_SLOT_UNIFORM);
+		case GL_SHADER_STORAGE_BUFFER: return (BUFFER_SLOT_SHADER_STORAGE);
+		case GL_DRAW_INDIRECT_BUFFER: return (BUFFER_SLOT_DRAW_INDIRECT);
+		case GL_DISPATCH_INDIRECT_BUFFER: return (BUFFER_SLOT_DISPATCH_INDIRECT);
+		case GL_PIXEL_PACK_BUFFER: return (BUFFER_SLOT_PIXEL_PACK);
+		case GL_PIXEL_UNPACK_BUFFER: return (BUFFER_SLOT_PIXEL_UNPACK);
+		case GL_COPY_READ_BUFFER: return (BUFFER_SLOT_COPY_READ);
+		case GL_COPY_WRITE_BUFFER: return (BUFFER_SLOT_COPY_WRITE);
+		default: return (-1);
+		}
+	}
+
+	static GLint GetIndexedSlot(GLenum eTarget)
+	{
+		switch (eTarget)
+		{
+		case GL_UNIFORM_BUFFER: return (INDEXED_SLOT_UNIFORM);
+		case GL_SHADER_STORAGE_BUFFER: return (INDEXED_SLOT_SHADER_STORAGE);
+		default: return (-1);
+		}
+	}
+
+	static GLint GetTextureSlot(GLenum eTarget)
+	{
+		switch (eTarget)
+		{
+		case GL_TEXTURE_1D: return (TEXTURE_SLOT_1D);
+		case GL_TEXTURE_2D: return (TEXTURE_SLOT_2D);
+		case GL_TEXTURE_3D: return (TEXTURE_SLOT_3D);
+		case GL_TEXTURE_2D_ARRAY: return (TEXTURE_SLOT_2D_ARRAY);
+		case GL_TEXTURE_CUBE_MAP: return (TEXTURE_SLOT_CUBE_MAP);
+		case GL_TEXTURE_2D_MULTISAMPLE: return (TEXTURE_SLOT_2D_MULTISAMPLE);
+		default: return (-1);
+		}
+	}
+
+	static GLint GetCapabilitySlot(GLenum eCapability)
+	{
+		switch (eCapability)
+		{
+		case GL_BLEND: return (CAPABILITY_SLOT_BLEND);
+		case GL_DEPTH_TEST: return (CAPABILITY_SLOT_DEPTH_TEST);
+		case GL_CULL_FACE: return (CAPABILITY_SLOT_CULL_FACE);
+		case GL_SCISSOR_TEST: return (CAPABILITY_SLOT_SCISSOR_TEST);
+		case GL_STENCIL_TEST: return (CAPABILITY_SLOT_STENCIL_TEST);
+		default: return (-1);
+		}
+	}
+
+	// True when the cached value changed and the GL call has to be made
+	static bool Update(GLuint& uiCached, GLuint uiValue)
+	{
+		if (uiCached == uiValue)
+		{
+			ms_uiElided++;
+			return (false);
+		}
+
+		uiCached = uiValue;
+		ms_uiIssued++;
+		return (true);
+	}
+
+	static void SetCapability(GLenum eCapability, bool bEnable)
+	{
+		const GLint iSlot = GetCapabilitySlot(eCapability);
+		if (iSlot < 0)
+		{
+			ms_uiIssued++;
+		}
+		else if (!Update(ms_auiCapabilities[iSlot], bEnable ? GL_TRUE : GL_FALSE))
+		{
+			return;
+		}
+
+		if (bEnable)
+		{
+			glEnable(eCapability);
+		}
+		else
+		{
+			glDisable(eCapability);
+		}
+	}
+
+	static void ForgetBuffer(GLenum eTarget);
+	static void ForgetTextureUnit(GLuint uiUnit);
+
+private:
+	static GLuint ms_uiProgram;
+	static GLuint ms_uiVertexArray;
+	static GLuint ms_auiBuffers[BUFFER_SLOT_COUNT];
+	static GLuint ms_auiIndexedBuffers[INDEXED_SLOT_COUNT][GLSTATE_MAX_INDEXED_BINDINGS];
+	static GLuint ms_uiActiveTexture;
+	static GLuint ms_auiTextures[GLSTATE_MAX_TEXTURE_UNITS][TEXTURE_SLOT_COUNT];
+	static GLuint ms_auiCapabilities[CAPABILITY_SLOT_COUNT];
+	static GLuint ms_auiBlendFunc[4];
+	static GLuint ms_uiCullFace;
+	static GLuint ms_uiDepthFunc;
+	static GLuint ms_uiDepthMask;
+
+	static uint32_t ms_uiIssued;
+	static uint32_t ms_uiElided;
+	static uint32_t ms_uiLastFrameIssued;
+	static uint32_t ms_uiLastFrameElided;
+};
@@ -0,0 +1,166 @@
+#include "stdafx.h"
+#include "image_decoder.h"
+
+#if defined(_WIN64)
+#undef max
+#undef min
+#undef minmax
+#endif
+
+namespace
+{
+	constexpr size_t IMAGE_DECODE_MAX_WORKERS = 8;
+}
+
+CImageDecodeQueue::CImageDecodeQueue(size_t iNumWorkers)
+{
+	// Leave a core for the render thread
+	const size_t iHardware = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+	m_iNumWorkers = iNumWorkers ? iNumWorkers : std::min(iHardware, IMAGE_DECODE_MAX_WORKERS);
+
+	m_iInFlight = 0;
+	m_uiNextTicket = 1;
+	m_bStop = false;
+}
+
+CImageDecodeQueue::~CImageDecodeQueue()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_bStop = true;
+
+		// Dropped jobs never reach a worker, a Wait() still blocked on them would never return
+		m_iInFlight -= m_dqJobs.size();
+		m_dqJobs.clear();
+	}
+
+	m_cvJobs.notify_all();
+	m_cvIdle.notify_all();
+
+	for (auto& worker : m_vWorkers)
+	{
+		worker.join();
+	}
+}
+
+void CImageDecodeQueue::StartWorkers()
+{
+	// Threads are only spawned once there is something to decode
+	m_vWorkers.reserve(m_iNumWorkers);
+	for (size_t i = 0; i < m_iNumWorkers; i++)
+	{
+		m_vWorkers.emplace_back(&CImageDecodeQueue::WorkerLoop, this);
+	}
+}
+
+uint64_t CImageDecodeQueue::Submit(const std::string& stFileName)
+{
+	if (m_vWorkers.empty())
+	{
+		// stb keeps the flag globally, every texture in the engine is loaded flipped
+		stbi_set_flip_vertically_on_load(1);
+		StartWorkers();
+	}
+
+	uint64_t uiTicket = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		uiTicket = m_uiNextTicket++;
+		m_dqJobs.push_back({ uiTicket, stFileName });
+		m_iInFlight++;
+	}
+
+	m_cvJobs.notify_one();
+	return (uiTicket);
+}
+
+size_t CImageDecodeQueue::Poll(std::vector<TDecodedImage>& vOut, size_t iMaxResults)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	const size_t iCount = iMaxResults ? std::min(iMaxResults, m_vResults.size()) : m_vResults.size();
+	for (size_t i = 0; i < iCount; i++)
+	{
+		vOut.emplace_back(std::move(m_vResults[i]));
+	}
+
+	m_vResults.erase(m_vResults.begin(), m_vResults.begin() + iCount);
+	return (iCount);
+}
+
+void CImageDecodeQueue::Wait()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_cvIdle.wait(lock, [this]() { return (m_iInFlight == 0); });
+}
+
+size_t CImageDecodeQueue::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return (m_iInFlight + m_vResults.size());
+}
+
+void CImageDecodeQueue::WorkerLoop()
+{
+	for (;;)
+	{
+		TDecodeJob job;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_cvJobs.wait(lock, [this]() { return (m_bStop || !m_dqJobs.empty()); });
+
+			if (m_bStop)
+			{
+				return;
+			}
+
+			job = std::move(m_dqJobs.front());
+			m_dqJobs.pop_front();
+		}
+
+		TDecodedImage image{};
+		image.uiTicket = job.uiTicket;
+		image.stFileName = std::move(job.stFileName);
+
+		const uint64_t uiCacheKey = CTextureCache::IsEnabled() ? CTextureCache::GetKey(image.stFileName) : 0;
+
+		if (uiCacheKey && CTextureCache::Load(uiCacheKey, image.compressed))
+		{
+			image.iWidth = image.compressed.iWidth;
+			image.iHeight = image.compressed.iHeight;
+			image.iChannelsBPP = image.compressed.iChannelsBPP;
+			image.bCompressed = true;
+			image.bSuccess = true;
+		}
+		else if (stbi_uc* pImageData = stbi_load(image.stFileName.c_str(), &image.iWidth, &image.iHeight, &image.iChannelsBPP, 0))
+		{
+			// The pool already runs one image per core, encode on this thread only
+			if (uiCacheKey && CTextureCache::Compress(pImageData, image.iWidth, image.iHeight, image.iChannelsBPP, image.compressed, 1))
+			{
+				CTextureCache::Store(uiCacheKey, image.compressed);
+				image.bCompressed = true;
+			}
+			else
+			{
+				image.vPixels.assign(pImageData, pImageData + static_cast<size_t>(image.iWidth) * image.iHeight * image.iChannelsBPP);
+			}
+
+			image.bSuccess = true;
+			stbi_image_free(pImageData);
+		}
+		else
+		{
+			const char* szReason = stbi_failure_reason();
+			image.stError = szReason ? szReason : "Unknown error";
+			image.bSuccess = false;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_vResults.emplace_back(std::move(image));
+			m_iInFlight--;
+		}
+
+		m_cvIdle.notify_all();
+	}
+}
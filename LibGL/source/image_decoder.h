@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "texture_cache.h"
+
+typedef struct SDecodedImage
+{
+	uint64_t uiTicket;
+	std::string stFileName;
+	GLint iWidth;
+	GLint iHeight;
+	GLint iChannelsBPP;
+	std::vector<GLubyte> vPixels;
+	TCompressedImage compressed;	// Filled instead of vPixels when the texture cache is enabled
+	bool bCompressed;
+	bool bSuccess;
+	std::string stError;
+} TDecodedImage;
+
+// Decodes image files on worker threads, the GL upload stays on the thread that polls the results.
+// Images are flipped vertically like CTexture::Load does, and go through CTextureCache when it's enabled.
+class CImageDecodeQueue
+{
+public:
+	CImageDecodeQueue(size_t iNumWorkers = 0);
+	~CImageDecodeQueue();
+
+	CImageDecodeQueue(const CImageDecodeQueue&) = delete;
+	CImageDecodeQueue& operator=(const CImageDecodeQueue&) = delete;
+
+	// Returns a ticket identifying the result, never 0
+	uint64_t Submit(const std::string& stFileName);
+
+	// Moves finished images into vOut, at most iMaxResults of them (0 takes all), returns how many
+	size_t Poll(std::vector<TDecodedImage>& vOut, size_t iMaxResults = 0);
+
+	// Blocks until every submitted image has been decoded (not polled)
+	void Wait();
+
+	size_t GetPendingCount() const;
+
+protected:
+	void StartWorkers();
+	void WorkerLoop();
+
+private:
+	typedef struct SDecodeJob
+	{
+		uint64_t uiTicket;
+		std::string stFileName;
+	} TDecodeJob;
+
+	size_t m_iNumWorkers;
+	std::vector<std::thread> m_vWorkers;
+	std::deque<TDecodeJob> m_dqJobs;
+	std::vector<TDecodedImage> m_vResults;
+
+	mutable std::mutex m_Mutex;
+	std::condition_variable m_cvJobs;
+	std::condition_variable m_cvIdle;
+
+	size_t m_iInFlight;		// Queued or being decoded
+	uint64_t m_uiNextTicket;
+	bool m_bStop;
+};
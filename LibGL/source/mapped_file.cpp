@@ -0,0 +1,168 @@
+#include "stdafx.h"
+#include "mapped_file.h"
+
+#if defined(_WIN64)
+#include <windows.h>
+#undef min
+#undef max
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+CMappedFile::CMappedFile()
+{
+	m_pData = nullptr;
+	m_iSize = 0;
+#if defined(_WIN64)
+	m_hFile = nullptr;
+	m_hMapping = nullptr;
+#else
+	m_iFd = -1;
+#endif
+}
+
+CMappedFile::~CMappedFile()
+{
+	Close();
+}
+
+bool CMappedFile::Open(const std::string& stFileName)
+{
+	Close();
+
+#if defined(_WIN64)
+	HANDLE hFile = CreateFileA(stFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		sys_err("CMappedFile::Open: Failed to open %s (error %lu)", stFileName.c_str(), GetLastError());
+		return (false);
+	}
+
+	LARGE_INTEGER liSize{};
+	if (!GetFileSizeEx(hFile, &liSize) || liSize.QuadPart == 0)
+	{
+		sys_err("CMappedFile::Open: %s is empty or its size can't be read", stFileName.c_str());
+		CloseHandle(hFile);
+		return (false);
+	}
+
+	HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!hMapping)
+	{
+		sys_err("CMappedFile::Open: Failed to create the mapping of %s (error %lu)", stFileName.c_str(), GetLastError());
+		CloseHandle(hFile);
+		return (false);
+	}
+
+	const void* pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (!pView)
+	{
+		sys_err("CMappedFile::Open: Failed to map the view of %s (error %lu)", stFileName.c_str(), GetLastError());
+		CloseHandle(hMapping);
+		CloseHandle(hFile);
+		return (false);
+	}
+
+	m_hFile = hFile;
+	m_hMapping = hMapping;
+	m_pData = static_cast<const uint8_t*>(pView);
+	m_iSize = static_cast<size_t>(liSize.QuadPart);
+#else
+	int iFd = open(stFileName.c_str(), O_RDONLY);
+	if (iFd < 0)
+	{
+		sys_err("CMappedFile::Open: Failed to open %s", stFileName.c_str());
+		return (false);
+	}
+
+	struct stat st {};
+	if (fstat(iFd, &st) != 0 || st.st_size == 0)
+	{
+		sys_err("CMappedFile::Open: %s is empty or its size can't be read", stFileName.c_str());
+		close(iFd);
+		return (false);
+	}
+
+	void* pView = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, iFd, 0);
+	if (pView == MAP_FAILED)
+	{
+		sys_err("CMappedFile::Open: Failed to map %s", stFileName.c_str());
+		close(iFd);
+		return (false);
+	}
+
+	m_iFd = iFd;
+	m_pData = static_cast<const uint8_t*>(pView);
+	m_iSize = static_cast<size_t>(st.st_size);
+#endif
+
+	m_stFileName = stFileName;
+	return (true);
+}
+
+void CMappedFile::Close()
+{
+#if defined(_WIN64)
+	if (m_pData)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+	if (m_hMapping)
+	{
+		CloseHandle(m_hMapping);
+	}
+	if (m_hFile)
+	{
+		CloseHandle(m_hFile);
+	}
+	m_hMapping = nullptr;
+	m_hFile = nullptr;
+#else
+	if (m_pData)
+	{
+		munmap(const_cast<uint8_t*>(m_pData), m_iSize);
+	}
+	if (m_iFd >= 0)
+	{
+		close(m_iFd);
+	}
+	m_iFd = -1;
+#endif
+
+	m_pData = nullptr;
+	m_iSize = 0;
+	m_stFileName.clear();
+}
+
+bool CMappedFile::IsOpen() const
+{
+	return (m_pData != nullptr);
+}
+
+const uint8_t* CMappedFile::GetData() const
+{
+	return (m_pData);
+}
+
+size_t CMappedFile::GetSize() const
+{
+	return (m_iSize);
+}
+
+const std::string& CMappedFile::GetFileName() const
+{
+	return (m_stFileName);
+}
+
+const uint8_t* CMappedFile::GetRange(size_t offset, size_t size) const
+{
+	if (!m_pData || offset > m_iSize || size > m_iSize - offset)
+	{
+		return (nullptr);
+	}
+
+	return (m_pData + offset);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// Read-only memory mapped file, the view stays valid until Close() or destruction
+class CMappedFile
+{
+public:
+	CMappedFile();
+	~CMappedFile();
+
+	CMappedFile(const CMappedFile&) = delete;
+	CMappedFile& operator=(const CMappedFile&) = delete;
+
+	bool Open(const std::string& stFileName);
+	void Close();
+
+	bool IsOpen() const;
+	const uint8_t* GetData() const;
+	size_t GetSize() const;
+	const std::string& GetFileName() const;
+
+	// Returns nullptr when [offset, offset + size) is outside of the view
+	const uint8_t* GetRange(size_t offset, size_t size) const;
+
+private:
+	std::string m_stFileName;
+	const uint8_t* m_pData;
+	size_t m_iSize;
+
+#if defined(_WIN64)
+	void* m_hFile;
+	void* m_hMapping;
+#else
+	int m_iFd;
+#endif
+};
@@ -1,6 +1,110 @@
 #include "stdafx.h"
 #include "mesh.h"
 #include <meshoptimizer/meshoptimizer.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+#if defined(_WIN64)
+#undef max
+#undef min
+#undef minmax
+#endif
+
+namespace
+{
+	// Share of the LOD 0 triangles each level targets
+	constexpr float MESH_LOD_RATIOS[MESH_MAX_LODS] = { 1.0f, 0.5f, 0.25f, 0.1f };
+
+	// Relative error the simplifier may introduce per level
+	constexpr float MESH_LOD_ERRORS[MESH_MAX_LODS] = { 0.0f, 0.01f, 0.03f, 0.08f };
+
+	// Smallest projected height (fraction of the viewport) a level is used for
+	constexpr float MESH_LOD_SCREEN_SIZES[MESH_MAX_LODS] = { 0.25f, 0.12f, 0.05f, 0.0f };
+
+	// Shared by every mesh, the workers are only started on the first texture request
+	CImageDecodeQueue& GetTextureDecodeQueue()
+	{
+		static CImageDecodeQueue s_Queue;
+		return (s_Queue);
+	}
+
+	// Runs Job(0..iCount-1) on the hardware threads, the calling thread included
+	void ParallelFor(size_t iCount, const std::function<void(size_t)>& Job)
+	{
+		const size_t iNumThreads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), iCount);
+
+		if (iNumThreads <= 1)
+		{
+			for (size_t i = 0; i < iCount; i++)
+			{
+				Job(i);
+			}
+			return;
+		}
+
+		std::atomic<size_t> iNextJob(0);
+		auto Worker = [&]()
+			{
+				for (size_t i = iNextJob++; i < iCount; i = iNextJob++)
+				{
+					Job(i);
+				}
+			};
+
+		std::vector<std::thread> vWorkers;
+		vWorkers.reserve(iNumThreads - 1);
+
+		for (size_t t = 1; t < iNumThreads; t++)
+		{
+			vWorkers.emplace_back(Worker);
+		}
+
+		Worker();
+
+		for (auto& worker : vWorkers)
+		{
+			worker.join();
+		}
+	}
+
+	inline float SignNotZero(float fValue)
+	{
+		return ((fValue >= 0.0f) ? 1.0f : -1.0f);
+	}
+
+	// Octahedral normal encoding, folds the lower hemisphere over the diagonals
+	void OctEncode(const SVector3Df& v3Normal, int16_t iOut[2])
+	{
+		const float fL1 = std::fabs(v3Normal.x) + std::fabs(v3Normal.y) + std::fabs(v3Normal.z);
+		float u = (fL1 > 0.0f) ? v3Normal.x / fL1 : 0.0f;
+		float v = (fL1 > 0.0f) ? v3Normal.y / fL1 : 0.0f;
+
+		if (v3Normal.z < 0.0f)
+		{
+			const float fPrevU = u;
+			u = (1.0f - std::fabs(v)) * SignNotZero(fPrevU);
+			v = (1.0f - std::fabs(fPrevU)) * SignNotZero(v);
+		}
+
+		iOut[0] = static_cast<int16_t>(meshopt_quantizeSnorm(u, 16));
+		iOut[1] = static_cast<int16_t>(meshopt_quantizeSnorm(v, 16));
+	}
+
+	SVector3Df OctDecode(const int16_t iIn[2])
+	{
+		const float u = std::max(iIn[0] / 32767.0f, -1.0f);
+		const float v = std::max(iIn[1] / 32767.0f, -1.0f);
+
+		SVector3Df v3Normal(u, v, 1.0f - std::fabs(u) - std::fabs(v));
+		const float t = std::max(-v3Normal.z, 0.0f);
+		v3Normal.x += (v3Normal.x >= 0.0f) ? -t : t;
+		v3Normal.y += (v3Normal.y >= 0.0f) ? -t : t;
+
+		const float fLength = std::sqrt(v3Normal.x * v3Normal.x + v3Normal.y * v3Normal.y + v3Normal.z * v3Normal.z);
+		return (SVector3Df(v3Normal.x / fLength, v3Normal.y / fLength, v3Normal.z / fLength));
+	}
+}
 
 CMesh::~CMesh()
 {
@@ -21,74 +125,76 @@ bool CMesh::LoadMesh(const std::string& stFileName, bool bIsUVFlipped)
 	else
 	{
 		glGenVertexArrays(1, &m_uiVAO);
-		glBindVertexArray(m_uiVAO);
+		CGLState::BindVertexArray(m_uiVAO);
 		glGenBuffers(arr_size(m_uiBuffers), m_uiBuffers);
 	}
 
 	bool bRet = false;
+	m_pScene = nullptr;
 
-	if (bIsUVFlipped)
+	uint32_t uiCacheFlags = bIsUVFlipped ? MESH_FILE_FLAG_UV_FLIPPED : 0;
+	if (m_bQuantized)
 	{
-		m_pScene = m_Importer.ReadFile(stFileName.c_str(), ASSIMP_LOAD_FLAGS_UV_FLIP);
-	}
-	else
-	{
-		m_pScene = m_Importer.ReadFile(stFileName.c_str(), ASSIMP_LOAD_FLAGS);
+		uiCacheFlags |= MESH_FILE_FLAG_QUANTIZED;
 	}
 
-	if (m_pScene)
+#if defined(USE_MESH_OPRIMIZER)
+	uiCacheFlags |= MESH_FILE_FLAG_OPTIMIZED;
+#endif
+
+	if (LoadFromCache(stFileName, uiCacheFlags))
 	{
-		m_matGlobalInverseTransform = m_pScene->mRootNode->mTransformation;
-		m_matGlobalInverseTransform = m_matGlobalInverseTransform.Inverse();
-		bRet = InitFromScene(m_pScene, stFileName);
+		bRet = true;
 	}
 	else
 	{
-		sys_err("CMesh::LoadMesh Error parsing '%s': '%s'", stFileName.c_str(), m_Importer.GetErrorString());
+		if (bIsUVFlipped)
+		{
+			m_pScene = m_Importer.ReadFile(stFileName.c_str(), ASSIMP_LOAD_FLAGS_UV_FLIP);
+		}
+		else
+		{
+			m_pScene = m_Importer.ReadFile(stFileName.c_str(), ASSIMP_LOAD_FLAGS);
+		}
+
+		if (m_pScene)
+		{
+			m_matGlobalInverseTransform = m_pScene->mRootNode->mTransformation;
+			m_matGlobalInverseTransform = m_matGlobalInverseTransform.Inverse();
+			bRet = InitFromScene(m_pScene, stFileName);
+
+			if (bRet)
+			{
+				SaveToCache(stFileName, uiCacheFlags);
+			}
+		}
+		else
+		{
+			sys_err("CMesh::LoadMesh Error parsing '%s': '%s'", stFileName.c_str(), m_Importer.GetErrorString());
+		}
 	}
 
 	// Make sure the VAO is not changed from the outside
 	if (!IsGLVersionHigher(4, 5))
 	{
-		glBindVertexArray(0);
+		CGLState::BindVertexArray(0);
 	}
 	return (bRet);
 }
 
 void CMesh::Render()
 {
-	if (IsPBR())
-	{
-		SetupRenderMaterialsPBR();
-	}
-
-	glBindVertexArray(m_uiVAO);
-
-	for (GLuint uiMeshIndex = 0; uiMeshIndex < m_vMeshes.size(); ++uiMeshIndex)
-	{
-		const GLuint uiMaterialIndex = m_vMeshes[uiMeshIndex].uiMaterialIndex;
-		ASSERT(uiMaterialIndex < m_vMaterials.size(),  "Check Mesh Materials");
-
-		if (!IsPBR())
-		{
-			SetupRenderMaterialsPhong(uiMeshIndex, uiMaterialIndex);
-		}
-
-		glDrawElementsBaseVertex(GL_TRIANGLES,
-			m_vMeshes[uiMeshIndex].uiNumIndices,
-			GL_UNSIGNED_INT,
-			(void*)(sizeof(unsigned int) * m_vMeshes[uiMeshIndex].uiBaseIndex),
-			m_vMeshes[uiMeshIndex].uiBaseVertex);
-
-	}
+	DrawMeshes(0);
+}
 
-	// Make sure the VAO is not changed from the outside
-	glBindVertexArray(0);
+void CMesh::Render(const CMatrix4Df& matWVP)
+{
+	DrawMeshes(SelectLod(matWVP));
 }
 
 void CMesh::Render(GLuint uiDrawIndex, GLuint uiPrimID)
 {
-	glBindVertexArray(m_uiVAO);
+	CGLState::BindVertexArray(m_uiVAO);
 	const GLuint uiMaterialIndex = m_vMeshes[uiDrawIndex].uiMaterialIndex;
 	ASSERT(uiMaterialIndex < m_vMaterials.size(), "Check Mesh Materials");
 
@@ -104,19 +210,54 @@ void CMesh::Render(GLuint uiDrawIndex, GLuint uiPrimID)
 
 	glDrawElementsBaseVertex(GL_TRIANGLES, 3, GL_UNSIGNED_INT, (void*)(sizeof(GLuint) *(m_vMeshes[uiDrawIndex].uiBaseIndex + uiPrimID * 3)), m_vMeshes[uiDrawIndex].uiBaseVertex);
 	// Make sure the VAO is not changed from the outside
-	glBindVertexArray(0);
+	CGLState::BindVertexArray(0);
 
 }
 
 void CMesh::Render(GLuint uiNumInstances, const CMatrix4Df* matWVP, const CMatrix4Df* matWorld)
 {
-	glBindBuffer(GL_ARRAY_BUFFER, m_uiBuffers[WVP_MAT_BUFFER]);
-	glBufferData(GL_ARRAY_BUFFER, uiNumInstances * sizeof(CMatrix4Df), matWVP, GL_DYNAMIC_DRAW);
+	// Group the instances by LOD so every level draws one contiguous range of the instance buffers
+	GLuint uiLodFirst[MESH_MAX_LODS] = {};
+	GLuint uiLodCount[MESH_MAX_LODS] = {};
+
+	std::vector<GLuint> vInstanceLods(uiNumInstances);
+	for (GLuint i = 0; i < uiNumInstances; i++)
+	{
+		vInstanceLods[i] = SelectLod(matWVP[i]);
+		uiLodCount[vInstanceLods[i]]++;
+	}
+
+	for (GLuint uiLod = 1; uiLod < MESH_MAX_LODS; uiLod++)
+	{
+		uiLodFirst[uiLod] = uiLodFirst[uiLod - 1] + uiLodCount[uiLod - 1];
+	}
+
+	m_vInstanceWVP.resize(uiNumInstances);
+	m_vInstanceWorld.resize(uiNumInstances);
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_uiBuffers[WORLD_MAT_BUFFER]);
-	glBufferData(GL_ARRAY_BUFFER, uiNumInstances * sizeof(CMatrix4Df), matWorld, GL_DYNAMIC_DRAW);
+	GLuint uiCursor[MESH_MAX_LODS];
+	std::copy(std::begin(uiLodFirst), std::end(uiLodFirst), uiCursor);
 
-	glBindVertexArray(m_uiVAO);
+	for (GLuint i = 0; i < uiNumInstances; i++)
+	{
+		const GLuint uiSlot = uiCursor[vInstanceLods[i]]++;
+		m_vInstanceWVP[uiSlot] = matWVP[i];
+		m_vInstanceWorld[uiSlot] = matWorld[i];
+	}
+
+	// The quantized positions are brought back to model space here, the world matrices are left alone
+	if (m_bQuantized)
+	{
+		MathBatch::MultiplyMatrices(m_vInstanceWVP.data(), GetDequantizeMatrix(), m_vInstanceWVP.data(), uiNumInstances);
+	}
+
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_uiBuffers[WVP_MAT_BUFFER]);
+	glBufferData(GL_ARRAY_BUFFER, uiNumInstances * sizeof(CMatrix4Df), m_vInstanceWVP.data(), GL_DYNAMIC_DRAW);
+
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_uiBuffers[WORLD_MAT_BUFFER]);
+	glBufferData(GL_ARRAY_BUFFER, uiNumInstances * sizeof(CMatrix4Df), m_vInstanceWorld.data(), GL_DYNAMIC_DRAW);
+
+	CGLState::BindVertexArray(m_uiVAO);
 
 	for (size_t i = 0; i < m_vMeshes.size(); i++)
 	{
@@ -133,12 +274,21 @@ void CMesh::Render(GLuint uiNumInstances, const CMatrix4Df* matWVP, const CMatri
 			m_vMaterials[uiMaterialIndex].m_pSpecularMap->Bind(SPECULAR_EXPONENT_UNIT);
 		}
 
-		glDrawElementsInstancedBaseVertex(GL_TRIANGLES, m_vMeshes[i].uiNumIndices, GL_UNSIGNED_INT,
-			(void*)(sizeof(GLuint)* m_vMeshes[i].uiBaseIndex), uiNumInstances, m_vMeshes[i].uiBaseVertex);
+		for (GLuint uiLod = 0; uiLod < MESH_MAX_LODS; uiLod++)
+		{
+			if (uiLodCount[uiLod] == 0)
+			{
+				continue;
+			}
+
+			const TMeshLod& rLod = GetLod(m_vMeshes[i], uiLod);
+			glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, rLod.uiNumIndices, GL_UNSIGNED_INT,
+				(void*)(sizeof(GLuint) * rLod.uiBaseIndex), uiLodCount[uiLod], m_vMeshes[i].uiBaseVertex, uiLodFirst[uiLod]);
+		}
 	}
 
 	// Make sure the VAO is not changed from the outside
-	glBindVertexArray(0);
+	CGLState::BindVertexArray(0);
 }
 
 const TMaterial& CMesh::GetMaterial()
@@ -174,6 +324,19 @@ void CMesh::GetLeadingVertex(GLuint uiDrawIndex, GLuint uiPrimID, SVector3Df& Ve
 {
 	GLuint uiMeshIndex = uiDrawIndex; // Each mesh is rendered in its own draw call
 
+	if (!m_pScene)
+	{
+		// Loaded from the cache, read the decoded buffers
+		ASSERT(uiMeshIndex < m_vMeshes.size(), "Check Model Meshes Number");
+		const TMeshEntry& rMesh = m_vMeshes[uiMeshIndex];
+
+		ASSERT(uiPrimID * 3 < rMesh.uiNumIndices, "Check Mesh Faces Number");
+		const GLuint uiVertex = rMesh.uiBaseVertex + m_vIndices[rMesh.uiBaseIndex + uiPrimID * 3];
+
+		Vertex = m_bQuantized ? DequantizePosition(m_vQuantizedVertices[uiVertex]) : m_vVertices[uiVertex].v3Pos;
+		return;
+	}
+
 	ASSERT(uiMeshIndex < m_pScene->mNumMeshes, "Check Model Meshes Number");
 	const aiMesh* pMesh = m_pScene->mMeshes[uiMeshIndex];
 
@@ -199,32 +362,106 @@ bool CMesh::IsPBR() const
 	return (m_bIsPBR);
 }
 
+GLuint CMesh::SelectLod(const CMatrix4Df& matWVP) const
+{
+	const SVector4Df v4Clip = matWVP * SVector4Df(m_v3BoundsCenter.x, m_v3BoundsCenter.y, m_v3BoundsCenter.z, 1.0f);
+
+	// Camera inside or behind the sphere
+	if (v4Clip.w <= m_fBoundsRadius)
+	{
+		return (0);
+	}
+
+	// The second row maps model space onto clip y, its length scales the radius like the projection does
+	const float fScaleY = std::sqrt(matWVP.mat4[1][0] * matWVP.mat4[1][0] + matWVP.mat4[1][1] * matWVP.mat4[1][1] + matWVP.mat4[1][2] * matWVP.mat4[1][2]);
+	const float fScreenSize = m_fBoundsRadius * fScaleY / v4Clip.w * m_fLodBias;
+
+	GLuint uiLod = 0;
+	while (uiLod + 1 < MESH_MAX_LODS && fScreenSize < MESH_LOD_SCREEN_SIZES[uiLod])
+	{
+		uiLod++;
+	}
+
+	return (uiLod);
+}
+
+void CMesh::SetLodBias(float fBias)
+{
+	m_fLodBias = fBias;
+}
+
+float CMesh::GetLodBias() const
+{
+	return (m_fLodBias);
+}
+
+void CMesh::SetQuantized(bool bQuantized)
+{
+	m_bQuantized = bQuantized;
+}
+
+bool CMesh::IsQuantized() const
+{
+	return (m_bQuantized);
+}
+
+CMatrix4Df CMesh::GetDequantizeMatrix() const
+{
+	CMatrix4Df matDequantize;
+	matDequantize.InitIdentity();
+
+	if (m_bQuantized)
+	{
+		matDequantize.mat4[0][0] = m_v3QuantScale.x;
+		matDequantize.mat4[1][1] = m_v3QuantScale.y;
+		matDequantize.mat4[2][2] = m_v3QuantScale.z;
+		matDequantize.mat4[0][3] = m_v3QuantOffset.x;
+		matDequantize.mat4[1][3] = m_v3QuantOffset.y;
+		matDequantize.mat4[2][3] = m_v3QuantOffset.z;
+	}
+
+	return (matDequantize);
+}
+
 // Protected Members
 
 void CMesh::Clear()
 {
+	// Releases the material textures
+	m_vMaterials.clear();
+
 	if (m_uiBuffers[0] != 0)
 	{
-		glDeleteBuffers(arr_size(m_uiBuffers), m_uiBuffers);
+		CGLState::DeleteBuffers(arr_size(m_uiBuffers), m_uiBuffers);
 	}
 
 	if (m_uiVAO != 0)
 	{
-		glDeleteVertexArrays(1, &m_uiVAO);
+		CGLState::DeleteVertexArrays(1, &m_uiVAO);
 		m_uiVAO = 0;
 	}
 }
 
+const CMesh::TMeshLod& CMesh::GetLod(const TMeshEntry& rMesh, GLuint uiLod) const
+{
+	// Submeshes that could not be simplified further reuse their last level
+	return (rMesh.lods[std::min(uiLod, rMesh.uiNumLods - 1)]);
+}
+
 void CMesh::ReserveSpace(GLuint uiNumVertices, GLuint uiNumIndices)
 {
 	m_vVertices.reserve(uiNumVertices);
 	m_vIndices.reserve(uiNumIndices);
 }
 
-void CMesh::InitSingleMesh(const aiMesh* pMesh)
+void CMesh::InitSingleMesh(GLuint uiMeshIndex, const aiMesh* pMesh)
 {
 	const aiVector3D ZeroVec(0.0f, 0.0f, 0.0f);
 
+	// ConvertVerticesAndIndices laid the submeshes out already, write straight into our range
+	TVertex* pVertices = m_vVertices.data() + m_vMeshes[uiMeshIndex].uiBaseVertex;
+	GLuint* pIndices = m_vIndices.data() + m_vMeshes[uiMeshIndex].uiBaseIndex;
+
 	// Populate the vertex attribute vectors
 	TVertex vertex{};
 
@@ -247,20 +484,20 @@ void CMesh::InitSingleMesh(const aiMesh* pMesh)
 		const aiVector3D& vTexCoords = pMesh->HasTextureCoords(0) ? pMesh->mTextureCoords[0][i] : ZeroVec;
 		vertex.v2Texture = SVector2Df(vTexCoords.x, vTexCoords.y);
 
-		m_vVertices.emplace_back(vertex);
+		pVertices[i] = vertex;
 	}
 
 	// Populate the index buffer
 	for (GLuint i = 0; i < pMesh->mNumFaces; i++)
 	{
 		const aiFace& rFace = pMesh->mFaces[i];
-		m_vIndices.emplace_back(rFace.mIndices[0]);
-		m_vIndices.emplace_back(rFace.mIndices[1]);
-		m_vIndices.emplace_back(rFace.mIndices[2]);
+		pIndices[i * 3 + 0] = rFace.mIndices[0];
+		pIndices[i * 3 + 1] = rFace.mIndices[1];
+		pIndices[i * 3 + 2] = rFace.mIndices[2];
 	}
 }
 
-void CMesh::InitSingleMeshOptimized(GLuint uiMeshIndex, const aiMesh* pMesh)
+void CMesh::InitSingleMeshOptimized(GLuint uiMeshIndex, const aiMesh* pMesh, std::vector<TVertex>& vVertices, std::vector<GLuint>& vIndices)
 {
 	const aiVector3D ZeroVec(0.0f, 0.0f, 0.0f);
 
@@ -290,9 +527,6 @@ void CMesh::InitSingleMeshOptimized(GLuint uiMeshIndex, const aiMesh* pMesh)
 		vecVertices[i] = vertex;
 	}
 
-	m_vMeshes[uiMeshIndex].uiBaseVertex = static_cast<GLuint>(m_vVertices.size());
-	m_vMeshes[uiMeshIndex].uiBaseIndex = static_cast<GLuint>(m_vIndices.size());
-
 	GLint iNumIndices = pMesh->mNumFaces * 3;
 	
 	std::vector<GLuint> vecIndicies;
@@ -307,30 +541,61 @@ void CMesh::InitSingleMeshOptimized(GLuint uiMeshIndex, const aiMesh* pMesh)
 		vecIndicies[i * 3 + 2] = rFace.mIndices[2];
 	}
 
-	OptimizeMesh(uiMeshIndex, vecVertices, vecIndicies);
+	OptimizeMesh(uiMeshIndex, vecVertices, vecIndicies, vVertices, vIndices);
 }
 
 void CMesh::PopulateBuffers()
+{
+	if (m_bQuantized)
+	{
+		PopulateBuffers(m_vQuantizedVertices.data(), m_vQuantizedVertices.size(), m_vIndices.data(), m_vIndices.size());
+	}
+	else
+	{
+		PopulateBuffers(m_vVertices.data(), m_vVertices.size(), m_vIndices.data(), m_vIndices.size());
+	}
+}
+
+void CMesh::PopulateBuffers(const void* pVertices, size_t iNumVertices, const GLuint* pIndices, size_t iNumIndices)
 {
 	if (IsGLVersionHigher(4, 5))
 	{
-		PopulateBuffersDSA();
+		PopulateBuffersDSA(pVertices, iNumVertices, pIndices, iNumIndices);
 	}
 	else
 	{
-		PopulateBuffersNonDSA();
+		PopulateBuffersNonDSA(pVertices, iNumVertices, pIndices, iNumIndices);
 
 	}
 }
 
-void CMesh::PopulateBuffersDSA()
+void CMesh::PopulateBuffersDSA(const void* pVertices, size_t iNumVertices, const GLuint* pIndices, size_t iNumIndices)
 {
-	glNamedBufferStorage(m_uiBuffers[VERTEX_BUFFER], sizeof(m_vVertices[0]) * m_vVertices.size(), m_vVertices.data(), 0);
-	glNamedBufferStorage(m_uiBuffers[INDEX_BUFFER], sizeof(m_vIndices[0]) * m_vIndices.size(), m_vIndices.data(), 0);
+	glNamedBufferStorage(m_uiBuffers[VERTEX_BUFFER], GetVertexStride() * iNumVertices, pVertices, 0);
+	glNamedBufferStorage(m_uiBuffers[INDEX_BUFFER], sizeof(GLuint) * iNumIndices, pIndices, 0);
 
-	glVertexArrayVertexBuffer(m_uiVAO, 0, m_uiBuffers[VERTEX_BUFFER], 0, sizeof(TVertex));
+	glVertexArrayVertexBuffer(m_uiVAO, 0, m_uiBuffers[VERTEX_BUFFER], 0, static_cast<GLsizei>(GetVertexStride()));
 	glVertexArrayElementBuffer(m_uiVAO, m_uiBuffers[INDEX_BUFFER]);
 
+	InitInstanceAttributesDSA();
+
+	if (m_bQuantized)
+	{
+		// unorm16 positions, snorm16 octahedral normals, half float UVs, the shader sees them as floats
+		glEnableVertexArrayAttrib(m_uiVAO, POSITION_LOCATION);
+		glVertexArrayAttribFormat(m_uiVAO, POSITION_LOCATION, 3, GL_UNSIGNED_SHORT, GL_TRUE, (GLuint)offsetof(TQuantizedVertex, uiPos));
+		glVertexArrayAttribBinding(m_uiVAO, POSITION_LOCATION, 0);
+
+		glEnableVertexArrayAttrib(m_uiVAO, NORMALS_LOCATION);
+		glVertexArrayAttribFormat(m_uiVAO, NORMALS_LOCATION, 2, GL_SHORT, GL_TRUE, (GLuint)offsetof(TQuantizedVertex, iNormal));
+		glVertexArrayAttribBinding(m_uiVAO, NORMALS_LOCATION, 0);
+
+		glEnableVertexArrayAttrib(m_uiVAO, TEX_COORDS_LOCATION);
+		glVertexArrayAttribFormat(m_uiVAO, TEX_COORDS_LOCATION, 2, GL_HALF_FLOAT, GL_FALSE, (GLuint)offsetof(TQuantizedVertex, uiTexture));
+		glVertexArrayAttribBinding(m_uiVAO, TEX_COORDS_LOCATION, 0);
+		return;
+	}
+
 	size_t sNumFloats = 0;
 
 	glEnableVertexArrayAttrib(m_uiVAO, POSITION_LOCATION);
@@ -350,13 +615,29 @@ void CMesh::PopulateBuffersDSA()
 	glVertexArrayAttribBinding(m_uiVAO, TEX_COORDS_LOCATION, 0);
 }
 
-void CMesh::PopulateBuffersNonDSA()
+void CMesh::PopulateBuffersNonDSA(const void* pVertices, size_t iNumVertices, const GLuint* pIndices, size_t iNumIndices)
 {
-	glBindBuffer(GL_ARRAY_BUFFER, m_uiBuffers[VERTEX_BUFFER]);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_uiBuffers[INDEX_BUFFER]);
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_uiBuffers[VERTEX_BUFFER]);
+	CGLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_uiBuffers[INDEX_BUFFER]);
+
+	glBufferData(GL_ARRAY_BUFFER, GetVertexStride() * iNumVertices, pVertices, GL_STATIC_DRAW);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * iNumIndices, pIndices, GL_STATIC_DRAW);
 
-	glBufferData(GL_ARRAY_BUFFER, sizeof(m_vVertices[0]) * m_vVertices.size(), &m_vVertices[0], GL_STATIC_DRAW);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(m_vIndices[0]) * m_vIndices.size(), &m_vIndices[0], GL_STATIC_DRAW);
+	InitInstanceAttributesNonDSA();
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_uiBuffers[VERTEX_BUFFER]);
+
+	if (m_bQuantized)
+	{
+		glEnableVertexAttribArray(POSITION_LOCATION);
+		glVertexAttribPointer(POSITION_LOCATION, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(TQuantizedVertex), (const void*)offsetof(TQuantizedVertex, uiPos));
+
+		glEnableVertexAttribArray(NORMALS_LOCATION);
+		glVertexAttribPointer(NORMALS_LOCATION, 2, GL_SHORT, GL_TRUE, sizeof(TQuantizedVertex), (const void*)offsetof(TQuantizedVertex, iNormal));
+
+		glEnableVertexAttribArray(TEX_COORDS_LOCATION);
+		glVertexAttribPointer(TEX_COORDS_LOCATION, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(TQuantizedVertex), (const void*)offsetof(TQuantizedVertex, uiTexture));
+		return;
+	}
 
 	size_t sNumFloats = 0;
 
@@ -372,6 +653,61 @@ void CMesh::PopulateBuffersNonDSA()
 	glVertexAttribPointer(TEX_COORDS_LOCATION, 2, GL_FLOAT, GL_FALSE, sizeof(TVertex), (const void*)(sNumFloats * sizeof(float)));
 }
 
+size_t CMesh::GetVertexStride() const
+{
+	return (m_bQuantized ? sizeof(TQuantizedVertex) : sizeof(TVertex));
+}
+
+void CMesh::InitInstanceAttributesDSA()
+{
+	// One identity per buffer, so the non instanced draws never fetch from an empty store
+	CMatrix4Df matIdentity;
+	matIdentity.InitIdentity();
+	glNamedBufferData(m_uiBuffers[WVP_MAT_BUFFER], sizeof(CMatrix4Df), &matIdentity, GL_DYNAMIC_DRAW);
+	glNamedBufferData(m_uiBuffers[WORLD_MAT_BUFFER], sizeof(CMatrix4Df), &matIdentity, GL_DYNAMIC_DRAW);
+
+	glVertexArrayVertexBuffer(m_uiVAO, 1, m_uiBuffers[WVP_MAT_BUFFER], 0, sizeof(CMatrix4Df));
+	glVertexArrayVertexBuffer(m_uiVAO, 2, m_uiBuffers[WORLD_MAT_BUFFER], 0, sizeof(CMatrix4Df));
+	glVertexArrayBindingDivisor(m_uiVAO, 1, 1);
+	glVertexArrayBindingDivisor(m_uiVAO, 2, 1);
+
+	// A mat4 attribute is 4 vec4 locations, each one gets a row of the row major CMatrix4Df
+	for (GLuint i = 0; i < 4; i++)
+	{
+		glEnableVertexArrayAttrib(m_uiVAO, INSTANCE_WVP_LOCATION + i);
+		glVertexArrayAttribFormat(m_uiVAO, INSTANCE_WVP_LOCATION + i, 4, GL_FLOAT, GL_FALSE, i * sizeof(SVector4Df));
+		glVertexArrayAttribBinding(m_uiVAO, INSTANCE_WVP_LOCATION + i, 1);
+
+		glEnableVertexArrayAttrib(m_uiVAO, INSTANCE_WORLD_LOCATION + i);
+		glVertexArrayAttribFormat(m_uiVAO, INSTANCE_WORLD_LOCATION + i, 4, GL_FLOAT, GL_FALSE, i * sizeof(SVector4Df));
+		glVertexArrayAttribBinding(m_uiVAO, INSTANCE_WORLD_LOCATION + i, 2);
+	}
+}
+
+void CMesh::InitInstanceAttributesNonDSA()
+{
+	CMatrix4Df matIdentity;
+	matIdentity.InitIdentity();
+
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_uiBuffers[WVP_MAT_BUFFER]);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(CMatrix4Df), &matIdentity, GL_DYNAMIC_DRAW);
+	for (GLuint i = 0; i < 4; i++)
+	{
+		glEnableVertexAttribArray(INSTANCE_WVP_LOCATION + i);
+		glVertexAttribPointer(INSTANCE_WVP_LOCATION + i, 4, GL_FLOAT, GL_FALSE, sizeof(CMatrix4Df), (const void*)(i * sizeof(SVector4Df)));
+		glVertexAttribDivisor(INSTANCE_WVP_LOCATION + i, 1);
+	}
+
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_uiBuffers[WORLD_MAT_BUFFER]);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(CMatrix4Df), &matIdentity, GL_DYNAMIC_DRAW);
+	for (GLuint i = 0; i < 4; i++)
+	{
+		glEnableVertexAttribArray(INSTANCE_WORLD_LOCATION + i);
+		glVertexAttribPointer(INSTANCE_WORLD_LOCATION + i, 4, GL_FLOAT, GL_FALSE, sizeof(CMatrix4Df), (const void*)(i * sizeof(SVector4Df)));
+		glVertexAttribDivisor(INSTANCE_WORLD_LOCATION + i, 1);
+	}
+}
+
 // Priave Members
 
 bool CMesh::InitFromScene(const aiScene* pScene, const std::string& stFileName)
@@ -385,6 +721,13 @@ bool CMesh::InitFromScene(const aiScene* pScene, const std::string& stFileName)
 	ConvertVerticesAndIndices(pScene, uiNumVertices, uiNumIndices);
 	ReserveSpace(uiNumVertices, uiNumIndices);
 	InitAllMeshes(pScene);
+	CalculateBounds();
+	GenerateLods();
+
+	if (m_bQuantized)
+	{
+		QuantizeVertices();
+	}
 
 	if (!InitMaterials(pScene, stFileName))
 	{
@@ -418,18 +761,47 @@ void CMesh::ConvertVerticesAndIndices(const aiScene* pScene, GLuint& uiNumVertic
 
 void CMesh::InitAllMeshes(const aiScene* pScene)
 {
-	for (GLuint i = 0; i < m_vMeshes.size(); i++)
+	m_vVertices.clear();
+	m_vIndices.clear();
+
+	if (m_vMeshes.empty())
 	{
-		const aiMesh* pMesh = pScene->mMeshes[i];
+		return;
+	}
+
 #if defined(USE_MESH_OPRIMIZER)
-		InitSingleMeshOptimized(i, pMesh);
+	// The optimized sizes are only known afterwards, every submesh fills its own arrays and they are appended in order
+	std::vector<std::vector<TVertex>> vMeshVertices(m_vMeshes.size());
+	std::vector<std::vector<GLuint>> vMeshIndices(m_vMeshes.size());
+
+	ParallelFor(m_vMeshes.size(), [&](size_t i)
+		{
+			InitSingleMeshOptimized(static_cast<GLuint>(i), pScene->mMeshes[i], vMeshVertices[i], vMeshIndices[i]);
+		});
+
+	for (size_t i = 0; i < m_vMeshes.size(); i++)
+	{
+		m_vMeshes[i].uiBaseVertex = static_cast<GLuint>(m_vVertices.size());
+		m_vMeshes[i].uiBaseIndex = static_cast<GLuint>(m_vIndices.size());
+		m_vMeshes[i].uiNumIndices = static_cast<GLuint>(vMeshIndices[i].size());
+
+		m_vVertices.insert(m_vVertices.end(), vMeshVertices[i].begin(), vMeshVertices[i].end());
+		m_vIndices.insert(m_vIndices.end(), vMeshIndices[i].begin(), vMeshIndices[i].end());
+	}
 #else
-		InitSingleMesh(pMesh);
+	const TMeshEntry& rLast = m_vMeshes.back();
+	m_vVertices.resize(rLast.uiBaseVertex + pScene->mMeshes[m_vMeshes.size() - 1]->mNumVertices);
+	m_vIndices.resize(rLast.uiBaseIndex + rLast.uiNumIndices);
+
+	ParallelFor(m_vMeshes.size(), [&](size_t i)
+		{
+			InitSingleMesh(static_cast<GLuint>(i), pScene->mMeshes[i]);
+		});
 #endif
-	}
 }
 
-void CMesh::OptimizeMesh(GLint iMeshIndex, std::vector<TVertex>& vVertices, std::vector<GLuint>& vIndices)
+void CMesh::OptimizeMesh(GLint iMeshIndex, const std::vector<TVertex>& vVertices, const std::vector<GLuint>& vIndices,
+	std::vector<TVertex>& vOutVertices, std::vector<GLuint>& vOutIndices)
 {
 	size_t NumVertices = vVertices.size();
 	size_t NumIndices = vIndices.size();
@@ -467,35 +839,227 @@ void CMesh::OptimizeMesh(GLint iMeshIndex, std::vector<TVertex>& vVertices, std:
 	// Optimization #4: optimize access to the vertex buffer
 	meshopt_optimizeVertexFetch(optimizedVerticesVec.data(), optimizedIndicesVec.data(), NumIndices, optimizedVerticesVec.data(), OptimizedVertexCount, sizeof(TVertex));
 
-	// Optimization #5: create a simplified version of the model
-	float fThreshHold = 1.0f;
-	size_t TargetIndexCount = static_cast<size_t>(NumIndices * fThreshHold);
+#if defined(ENABLE_PRINT_MESH_DATA)
+	sys_log("CMesh::OptimizeMesh Mesh %d vertices %zu -> %zu", iMeshIndex, NumVertices, OptimizedVertexCount);
+#endif
+
+	// Simplification is left to GenerateLods, LOD 0 keeps every triangle
+	vOutIndices = std::move(optimizedIndicesVec);
+	vOutVertices = std::move(optimizedVerticesVec);
+}
+
+void CMesh::GenerateLods()
+{
+	// The simplified levels are appended after every full mesh, so the LOD 0 ranges stay where they are
+	for (GLuint i = 0; i < m_vMeshes.size(); i++)
+	{
+		TMeshEntry& rMesh = m_vMeshes[i];
+		rMesh.lods[0] = { rMesh.uiBaseIndex, rMesh.uiNumIndices };
+		rMesh.uiNumLods = 1;
 
-	float fTargetError = 0.0f;
+		const size_t iFirstVertex = rMesh.uiBaseVertex;
+		const size_t iLastVertex = (i + 1 < m_vMeshes.size()) ? m_vMeshes[i + 1].uiBaseVertex : m_vVertices.size();
+		const size_t iNumVertices = iLastVertex - iFirstVertex;
+
+		if (rMesh.uiNumIndices == 0 || iNumVertices == 0)
+		{
+			continue;
+		}
 
-	std::vector<GLuint> SimplifiedIndiciesVec(optimizedIndicesVec.size());
+		// Copy the source range, m_vIndices grows while we append to it
+		const std::vector<GLuint> vSource(m_vIndices.begin() + rMesh.uiBaseIndex, m_vIndices.begin() + rMesh.uiBaseIndex + rMesh.uiNumIndices);
+		const float* pPositions = &m_vVertices[iFirstVertex].v3Pos.x;
+
+		std::vector<GLuint> vLod(vSource.size());
+
+		for (GLuint uiLod = 1; uiLod < MESH_MAX_LODS; uiLod++)
+		{
+			const size_t iTargetIndices = static_cast<size_t>(vSource.size() * MESH_LOD_RATIOS[uiLod]) / 3 * 3;
+
+			float fResultError = 0.0f;
+			const size_t iLodIndices = meshopt_simplify(vLod.data(), vSource.data(), vSource.size(), pPositions, iNumVertices, sizeof(TVertex),
+				iTargetIndices, MESH_LOD_ERRORS[uiLod], 0, &fResultError);
+
+			// Stop once the error bound keeps the simplifier from making real progress
+			const TMeshLod& rPrevious = rMesh.lods[uiLod - 1];
+			if (iLodIndices == 0 || iLodIndices > rPrevious.uiNumIndices * 9 / 10)
+			{
+				break;
+			}
 
-	size_t OptimizedIndicesCount = meshopt_simplify(SimplifiedIndiciesVec.data(), optimizedIndicesVec.data(), NumIndices,
-		&(optimizedVerticesVec[0].v3Pos.x), OptimizedVertexCount, sizeof(TVertex), TargetIndexCount, fTargetError);
+			meshopt_optimizeVertexCache(vLod.data(), vLod.data(), iLodIndices, iNumVertices);
 
-	static GLint iNumIndices = 0;
-	iNumIndices += static_cast<GLint>(NumIndices);
+			rMesh.lods[uiLod] = { static_cast<GLuint>(m_vIndices.size()), static_cast<GLuint>(iLodIndices) };
+			rMesh.uiNumLods++;
 
-	static GLint iOptimizedIndices = 0;
-	iOptimizedIndices += static_cast<GLint>(OptimizedIndicesCount);
+			m_vIndices.insert(m_vIndices.end(), vLod.begin(), vLod.begin() + iLodIndices);
 
 #if defined(ENABLE_PRINT_MESH_DATA)
-	sys_log("CMesh::OptimizeMesh Num indices %d\n", iNumIndices);
-	sys_log("CMesh::OptimizeMesh Optimized number of indices %d\n", iOptimizedIndices);
+			sys_log("CMesh::GenerateLods Mesh %u LOD %u: %zu -> %zu indices (error %.4f)", i, uiLod, vSource.size(), iLodIndices, fResultError);
+#endif
+		}
+	}
+}
+
+void CMesh::CalculateBounds()
+{
+	if (m_vVertices.empty())
+	{
+		m_v3BoundsCenter = SVector3Df(0.0f, 0.0f, 0.0f);
+		m_fBoundsRadius = 0.0f;
+		return;
+	}
+
+	SVector3Df v3Min = m_vVertices[0].v3Pos;
+	SVector3Df v3Max = m_vVertices[0].v3Pos;
+
+	for (const TVertex& rVertex : m_vVertices)
+	{
+		v3Min.x = std::min(v3Min.x, rVertex.v3Pos.x);
+		v3Min.y = std::min(v3Min.y, rVertex.v3Pos.y);
+		v3Min.z = std::min(v3Min.z, rVertex.v3Pos.z);
+		v3Max.x = std::max(v3Max.x, rVertex.v3Pos.x);
+		v3Max.y = std::max(v3Max.y, rVertex.v3Pos.y);
+		v3Max.z = std::max(v3Max.z, rVertex.v3Pos.z);
+	}
+
+	m_v3BoundsCenter = SVector3Df((v3Min.x + v3Max.x) * 0.5f, (v3Min.y + v3Max.y) * 0.5f, (v3Min.z + v3Max.z) * 0.5f);
+
+	float fRadiusSq = 0.0f;
+	for (const TVertex& rVertex : m_vVertices)
+	{
+		const float dx = rVertex.v3Pos.x - m_v3BoundsCenter.x;
+		const float dy = rVertex.v3Pos.y - m_v3BoundsCenter.y;
+		const float dz = rVertex.v3Pos.z - m_v3BoundsCenter.z;
+		fRadiusSq = std::max(fRadiusSq, dx * dx + dy * dy + dz * dz);
+	}
+
+	m_fBoundsRadius = std::sqrt(fRadiusSq);
+}
+
+void CMesh::QuantizeVertices()
+{
+	// Model wide bounds so a single matrix dequantizes every submesh
+	SVector3Df v3Min = m_v3BoundsCenter;
+	SVector3Df v3Max = m_v3BoundsCenter;
+
+	for (const TVertex& rVertex : m_vVertices)
+	{
+		v3Min.x = std::min(v3Min.x, rVertex.v3Pos.x);
+		v3Min.y = std::min(v3Min.y, rVertex.v3Pos.y);
+		v3Min.z = std::min(v3Min.z, rVertex.v3Pos.z);
+		v3Max.x = std::max(v3Max.x, rVertex.v3Pos.x);
+		v3Max.y = std::max(v3Max.y, rVertex.v3Pos.y);
+		v3Max.z = std::max(v3Max.z, rVertex.v3Pos.z);
+	}
+
+	m_v3QuantOffset = v3Min;
+	m_v3QuantScale = SVector3Df(v3Max.x - v3Min.x, v3Max.y - v3Min.y, v3Max.z - v3Min.z);
+
+	const SVector3Df v3InvScale(
+		(m_v3QuantScale.x > 0.0f) ? 1.0f / m_v3QuantScale.x : 0.0f,
+		(m_v3QuantScale.y > 0.0f) ? 1.0f / m_v3QuantScale.y : 0.0f,
+		(m_v3QuantScale.z > 0.0f) ? 1.0f / m_v3QuantScale.z : 0.0f);
+
+	m_vQuantizedVertices.resize(m_vVertices.size());
+
+	for (size_t i = 0; i < m_vVertices.size(); i++)
+	{
+		const TVertex& rSrc = m_vVertices[i];
+		TQuantizedVertex& rDst = m_vQuantizedVertices[i];
+
+		rDst.uiPos[0] = static_cast<uint16_t>(meshopt_quantizeUnorm((rSrc.v3Pos.x - v3Min.x) * v3InvScale.x, 16));
+		rDst.uiPos[1] = static_cast<uint16_t>(meshopt_quantizeUnorm((rSrc.v3Pos.y - v3Min.y) * v3InvScale.y, 16));
+		rDst.uiPos[2] = static_cast<uint16_t>(meshopt_quantizeUnorm((rSrc.v3Pos.z - v3Min.z) * v3InvScale.z, 16));
+		rDst.uiPadding = 0;
+
+		OctEncode(rSrc.v3Normals, rDst.iNormal);
+
+		rDst.uiTexture[0] = meshopt_quantizeHalf(rSrc.v2Texture.x);
+		rDst.uiTexture[1] = meshopt_quantizeHalf(rSrc.v2Texture.y);
+	}
+
+#if defined(ENABLE_PRINT_QUANTIZATION_ERRORS)
+	// Error report, measured against the float layout we are about to drop
+	for (GLuint uiMeshIndex = 0; uiMeshIndex < m_vMeshes.size(); uiMeshIndex++)
+	{
+		const size_t iFirst = m_vMeshes[uiMeshIndex].uiBaseVertex;
+		const size_t iLast = (uiMeshIndex + 1 < m_vMeshes.size()) ? m_vMeshes[uiMeshIndex + 1].uiBaseVertex : m_vVertices.size();
+
+		float fMaxPosError = 0.0f;
+		float fMaxNormalError = 0.0f;
+		float fMaxUVError = 0.0f;
+
+		for (size_t i = iFirst; i < iLast; i++)
+		{
+			const TVertex& rSrc = m_vVertices[i];
+			const TQuantizedVertex& rQuantized = m_vQuantizedVertices[i];
+
+			const SVector3Df v3Pos = DequantizePosition(rQuantized);
+			fMaxPosError = std::max({ fMaxPosError, std::fabs(v3Pos.x - rSrc.v3Pos.x), std::fabs(v3Pos.y - rSrc.v3Pos.y), std::fabs(v3Pos.z - rSrc.v3Pos.z) });
+
+			const SVector3Df v3Normal = OctDecode(rQuantized.iNormal);
+			const float fSrcLength = std::sqrt(rSrc.v3Normals.x * rSrc.v3Normals.x + rSrc.v3Normals.y * rSrc.v3Normals.y + rSrc.v3Normals.z * rSrc.v3Normals.z);
+			if (fSrcLength > 0.0f)
+			{
+				const float fDot = (v3Normal.x * rSrc.v3Normals.x + v3Normal.y * rSrc.v3Normals.y + v3Normal.z * rSrc.v3Normals.z) / fSrcLength;
+				fMaxNormalError = std::max(fMaxNormalError, ToDegree(std::acos(std::clamp(fDot, -1.0f, 1.0f))));
+			}
+
+			fMaxUVError = std::max({ fMaxUVError,
+				std::fabs(meshopt_dequantizeHalf(rQuantized.uiTexture[0]) - rSrc.v2Texture.x),
+				std::fabs(meshopt_dequantizeHalf(rQuantized.uiTexture[1]) - rSrc.v2Texture.y) });
+		}
+
+		sys_log("CMesh::QuantizeVertices Mesh %u: %zu vertices, position error %.6f, normal error %.3f deg, uv error %.6f",
+			uiMeshIndex, iLast - iFirst, fMaxPosError, fMaxNormalError, fMaxUVError);
+	}
+
+	sys_log("CMesh::QuantizeVertices Vertex data %zu -> %zu bytes", m_vVertices.size() * sizeof(TVertex), m_vQuantizedVertices.size() * sizeof(TQuantizedVertex));
 #endif
 
-	SimplifiedIndiciesVec.resize(OptimizedIndicesCount);
+	// Only the quantized copy goes to the GPU and the cache
+	std::vector<TVertex>().swap(m_vVertices);
+}
+
+SVector3Df CMesh::DequantizePosition(const TQuantizedVertex& rVertex) const
+{
+	return (SVector3Df(
+		m_v3QuantOffset.x + rVertex.uiPos[0] / 65535.0f * m_v3QuantScale.x,
+		m_v3QuantOffset.y + rVertex.uiPos[1] / 65535.0f * m_v3QuantScale.y,
+		m_v3QuantOffset.z + rVertex.uiPos[2] / 65535.0f * m_v3QuantScale.z));
+}
+
+void CMesh::DrawMeshes(GLuint uiLod)
+{
+	if (IsPBR())
+	{
+		SetupRenderMaterialsPBR();
+	}
+
+	CGLState::BindVertexArray(m_uiVAO);
+
+	for (GLuint uiMeshIndex = 0; uiMeshIndex < m_vMeshes.size(); ++uiMeshIndex)
+	{
+		const GLuint uiMaterialIndex = m_vMeshes[uiMeshIndex].uiMaterialIndex;
+		ASSERT(uiMaterialIndex < m_vMaterials.size(),  "Check Mesh Materials");
+
+		if (!IsPBR())
+		{
+			SetupRenderMaterialsPhong(uiMeshIndex, uiMaterialIndex);
+		}
 
-	// Concatenate the local arrays into the class attributes arrays
-	m_vIndices.insert(m_vIndices.end(), SimplifiedIndiciesVec.begin(), SimplifiedIndiciesVec.end());
-	m_vVertices.insert(m_vVertices.end(), optimizedVerticesVec.begin(), optimizedVerticesVec.end());
+		const TMeshLod& rLod = GetLod(m_vMeshes[uiMeshIndex], uiLod);
+		glDrawElementsBaseVertex(GL_TRIANGLES,
+			rLod.uiNumIndices,
+			GL_UNSIGNED_INT,
+			(void*)(sizeof(unsigned int) * rLod.uiBaseIndex),
+			m_vMeshes[uiMeshIndex].uiBaseVertex);
 
-	m_vMeshes[iMeshIndex].uiNumIndices = static_cast<GLuint>(OptimizedIndicesCount);
+	}
+
+	// Make sure the VAO is not changed from the outside
+	CGLState::BindVertexArray(0);
 }
 
 bool CMesh::InitMaterials(const aiScene* pScene, const std::string& stFileName)
@@ -514,9 +1078,254 @@ bool CMesh::InitMaterials(const aiScene* pScene, const std::string& stFileName)
 		LoadColors(pMat, i);
 	}
 
+	FinishTextureUploads();
 	return true;
 }
 
+bool CMesh::LoadFromCache(const std::string& stFileName, uint32_t uiFlags)
+{
+	const std::string stCacheFile = stFileName + MESH_FILE_EXTENSION;
+
+	CMeshFile cacheFile;
+	if (!cacheFile.Open(stCacheFile, stFileName, uiFlags))
+	{
+		return false;
+	}
+
+	const TMeshFileHeader& header = cacheFile.GetHeader();
+
+	// Decode the streams first, a corrupt cache falls back to the importer untouched
+	m_vIndices.resize(header.uiNumIndices);
+	bool bDecoded = cacheFile.DecodeIndices(m_vIndices.data());
+
+	if (m_bQuantized)
+	{
+		m_vQuantizedVertices.resize(header.uiNumVertices);
+		bDecoded = bDecoded && cacheFile.DecodeVertices(m_vQuantizedVertices.data());
+	}
+	else
+	{
+		m_vVertices.resize(header.uiNumVertices);
+		bDecoded = bDecoded && cacheFile.DecodeVertices(m_vVertices.data());
+	}
+
+	if (!bDecoded)
+	{
+		sys_err("CMesh::LoadFromCache Failed to decode %s, re-importing", stCacheFile.c_str());
+		m_vIndices.clear();
+		m_vVertices.clear();
+		m_vQuantizedVertices.clear();
+		return false;
+	}
+
+	m_vMeshes.resize(header.uiNumMeshes);
+	const TMeshFileEntry* pMeshes = cacheFile.GetMeshes();
+	for (GLuint i = 0; i < header.uiNumMeshes; i++)
+	{
+		m_vMeshes[i].uiBaseVertex = pMeshes[i].uiBaseVertex;
+		m_vMeshes[i].uiBaseIndex = pMeshes[i].uiBaseIndex;
+		m_vMeshes[i].uiNumIndices = pMeshes[i].uiNumIndices;
+		m_vMeshes[i].uiMaterialIndex = pMeshes[i].uiMaterialIndex;
+		m_vMeshes[i].uiNumLods = std::clamp<GLuint>(pMeshes[i].uiNumLods, 1, MESH_MAX_LODS);
+
+		for (GLuint uiLod = 0; uiLod < m_vMeshes[i].uiNumLods; uiLod++)
+		{
+			m_vMeshes[i].lods[uiLod] = { pMeshes[i].uiLodBaseIndex[uiLod], pMeshes[i].uiLodNumIndices[uiLod] };
+		}
+	}
+
+	m_v3BoundsCenter = SVector3Df(header.fBoundsCenter[0], header.fBoundsCenter[1], header.fBoundsCenter[2]);
+	m_fBoundsRadius = header.fBoundsRadius;
+	m_v3QuantOffset = SVector3Df(header.fQuantOffset[0], header.fQuantOffset[1], header.fQuantOffset[2]);
+	m_v3QuantScale = SVector3Df(header.fQuantScale[0], header.fQuantScale[1], header.fQuantScale[2]);
+
+	m_vMaterials.resize(header.uiNumMaterials);
+	const TMeshFileMaterial* pMaterials = cacheFile.GetMaterials();
+	for (GLuint i = 0; i < header.uiNumMaterials; i++)
+	{
+		const TMeshFileMaterial& rSrc = pMaterials[i];
+		TMaterial& rMaterial = m_vMaterials[i];
+
+		rMaterial.m_stName.assign(rSrc.szName, strnlen(rSrc.szName, sizeof(rSrc.szName)));
+		rMaterial.m_v4AmbientColor = SVector4Df(rSrc.fAmbient[0], rSrc.fAmbient[1], rSrc.fAmbient[2], rSrc.fAmbient[3]);
+		rMaterial.m_v4DiffuseColor = SVector4Df(rSrc.fDiffuse[0], rSrc.fDiffuse[1], rSrc.fDiffuse[2], rSrc.fDiffuse[3]);
+		rMaterial.m_v4SpecularColor = SVector4Df(rSrc.fSpecular[0], rSrc.fSpecular[1], rSrc.fSpecular[2], rSrc.fSpecular[3]);
+
+		rMaterial.m_pDiffuseMap = LoadCachedTexture(rSrc.szTextures[MESH_FILE_TEXTURE_DIFFUSE]);
+		rMaterial.m_pSpecularMap = LoadCachedTexture(rSrc.szTextures[MESH_FILE_TEXTURE_SPECULAR]);
+		rMaterial.m_sPBRMaterial.m_pAlbedo = LoadCachedTexture(rSrc.szTextures[MESH_FILE_TEXTURE_ALBEDO]);
+		rMaterial.m_sPBRMaterial.m_pMetallic = LoadCachedTexture(rSrc.szTextures[MESH_FILE_TEXTURE_METALLIC]);
+		rMaterial.m_sPBRMaterial.m_pRoughness = LoadCachedTexture(rSrc.szTextures[MESH_FILE_TEXTURE_ROUGHNESS]);
+	}
+
+	FinishTextureUploads();
+
+	PopulateBuffers();
+
+#if defined(ENABLE_PRINT_MESH_DATA)
+	sys_log("CMesh::LoadFromCache Loaded %s (%u vertices, %u indices, %u meshes)", stCacheFile.c_str(), header.uiNumVertices, header.uiNumIndices, header.uiNumMeshes);
+#endif
+
+	return GLCheckError();
+}
+
+bool CMesh::SaveToCache(const std::string& stFileName, uint32_t uiFlags) const
+{
+	const aiTextureType eTextureTypes[MESH_FILE_TEXTURE_COUNT] =
+	{
+		aiTextureType_DIFFUSE,
+		aiTextureType_SHININESS,
+		aiTextureType_BASE_COLOR,
+		aiTextureType_METALNESS,
+		aiTextureType_DIFFUSE_ROUGHNESS,
+	};
+
+	const std::string stDir = GetDirFromFilename(stFileName);
+
+	std::vector<TMeshFileMaterial> vMaterials(m_vMaterials.size());
+	for (GLuint i = 0; i < m_vMaterials.size(); i++)
+	{
+		const TMaterial& rMaterial = m_vMaterials[i];
+		TMeshFileMaterial& rDst = vMaterials[i];
+		rDst = {};
+
+		std::memcpy(rDst.szName, rMaterial.m_stName.c_str(), std::min(rMaterial.m_stName.size(), sizeof(rDst.szName) - 1));
+		std::memcpy(rDst.fAmbient, &rMaterial.m_v4AmbientColor, sizeof(rDst.fAmbient));
+		std::memcpy(rDst.fDiffuse, &rMaterial.m_v4DiffuseColor, sizeof(rDst.fDiffuse));
+		std::memcpy(rDst.fSpecular, &rMaterial.m_v4SpecularColor, sizeof(rDst.fSpecular));
+
+		const aiMaterial* pMaterial = m_pScene->mMaterials[i];
+		for (GLuint t = 0; t < MESH_FILE_TEXTURE_COUNT; t++)
+		{
+			aiString stPath;
+			if (pMaterial->GetTextureCount(eTextureTypes[t]) == 0 ||
+				pMaterial->GetTexture(eTextureTypes[t], 0, &stPath, nullptr, nullptr, nullptr, nullptr, nullptr) != AI_SUCCESS)
+			{
+				continue;
+			}
+
+			// Embedded textures only live inside the source file
+			if (m_pScene->GetEmbeddedTexture(stPath.C_Str()))
+			{
+				sys_log("CMesh::SaveToCache %s has embedded textures, not cached", stFileName.c_str());
+				return false;
+			}
+
+			const std::string stFullPath = GetFullPath(stDir, stPath);
+			if (stFullPath.size() >= sizeof(rDst.szTextures[t]))
+			{
+				sys_err("CMesh::SaveToCache Texture path too long %s", stFullPath.c_str());
+				return false;
+			}
+
+			std::memcpy(rDst.szTextures[t], stFullPath.c_str(), stFullPath.size());
+		}
+	}
+
+	std::vector<TMeshFileEntry> vMeshes(m_vMeshes.size());
+	for (size_t i = 0; i < m_vMeshes.size(); i++)
+	{
+		const TMeshEntry& rMesh = m_vMeshes[i];
+		TMeshFileEntry& rDst = vMeshes[i];
+		rDst = { rMesh.uiBaseVertex, rMesh.uiBaseIndex, rMesh.uiNumIndices, rMesh.uiMaterialIndex, rMesh.uiNumLods };
+
+		for (GLuint uiLod = 0; uiLod < rMesh.uiNumLods; uiLod++)
+		{
+			rDst.uiLodBaseIndex[uiLod] = rMesh.lods[uiLod].uiBaseIndex;
+			rDst.uiLodNumIndices[uiLod] = rMesh.lods[uiLod].uiNumIndices;
+		}
+	}
+
+	TMeshFileData data{};
+	data.uiFlags = uiFlags;
+	data.v3BoundsCenter = m_v3BoundsCenter;
+	data.fBoundsRadius = m_fBoundsRadius;
+	data.v3QuantOffset = m_v3QuantOffset;
+	data.v3QuantScale = m_v3QuantScale;
+	data.pVertices = m_bQuantized ? static_cast<const void*>(m_vQuantizedVertices.data()) : static_cast<const void*>(m_vVertices.data());
+	data.uiNumVertices = static_cast<uint32_t>(m_bQuantized ? m_vQuantizedVertices.size() : m_vVertices.size());
+	data.uiVertexStride = static_cast<uint32_t>(GetVertexStride());
+	data.pIndices = m_vIndices.data();
+	data.uiNumIndices = static_cast<uint32_t>(m_vIndices.size());
+	data.vMeshes = std::move(vMeshes);
+	data.vMaterials = std::move(vMaterials);
+
+	return CMeshFile::Save(stFileName + MESH_FILE_EXTENSION, stFileName, data);
+}
+
+CTexture* CMesh::LoadCachedTexture(const char* szFullPath)
+{
+	if (!szFullPath[0])
+	{
+		return nullptr;
+	}
+
+	return (RequestTexture(szFullPath));
+}
+
+CTexture* CMesh::RequestTexture(const std::string& stFullPath)
+{
+	bool bCreated = false;
+	CTexture* pTexture = CTextureRegistry::Acquire(stFullPath, GL_TEXTURE_2D, bCreated);
+
+	// Materials sharing the file get the texture that is already loaded or queued
+	if (bCreated)
+	{
+		m_mPendingTextures[GetTextureDecodeQueue().Submit(stFullPath)] = pTexture;
+	}
+
+	return (pTexture);
+}
+
+void CMesh::FinishTextureUploads()
+{
+	if (m_mPendingTextures.empty())
+	{
+		return;
+	}
+
+	CImageDecodeQueue& rQueue = GetTextureDecodeQueue();
+	rQueue.Wait();
+
+	std::vector<TDecodedImage> vImages;
+	rQueue.Poll(vImages);
+
+	// Only the GL object creation is serialized
+	for (TDecodedImage& rImage : vImages)
+	{
+		auto it = m_mPendingTextures.find(rImage.uiTicket);
+		if (it == m_mPendingTextures.end())
+		{
+			continue;
+		}
+
+		CTexture* pTexture = it->second;
+		m_mPendingTextures.erase(it);
+
+		if (!rImage.bSuccess)
+		{
+			sys_err("CMesh::FinishTextureUploads Failed to Load a Texture %s - %s", rImage.stFileName.c_str(), rImage.stError.c_str());
+			CTextureRegistry::Forget(pTexture);
+			continue;
+		}
+
+		if (rImage.bCompressed)
+		{
+			if (!pTexture->LoadCompressed(rImage.compressed))
+			{
+				sys_err("CMesh::FinishTextureUploads Failed to upload the compressed texture %s", rImage.stFileName.c_str());
+				CTextureRegistry::Forget(pTexture);
+			}
+		}
+		else
+		{
+			pTexture->LoadRaw(rImage.iWidth, rImage.iHeight, rImage.iChannelsBPP, rImage.vPixels.data());
+		}
+	}
+
+	m_mPendingTextures.clear();
+}
+
 void CMesh::LoadTextures(const std::string& stDirectory, const aiMaterial* pMaterial, GLint iMaterialIndex)
 {
 	LoadDiffuseTexture(stDirectory, pMaterial, iMaterialIndex);
@@ -554,7 +1363,7 @@ void CMesh::LoadDiffuseTexture(const std::string& stDirectory, const aiMaterial*
 
 void CMesh::LoadDiffuseTextureEmbeded(const aiTexture* pTexture, GLint iMaterialIndex)
 {
-	m_vMaterials[iMaterialIndex].m_pDiffuseMap = new CTexture(GL_TEXTURE_2D);
+	m_vMaterials[iMaterialIndex].m_pDiffuseMap = CTextureRegistry::Adopt(new CTexture(GL_TEXTURE_2D));
 	GLint iBufferSize = pTexture->mWidth;
 	m_vMaterials[iMaterialIndex].m_pDiffuseMap->Load(iBufferSize, pTexture->pcData);
 
@@ -566,15 +1375,10 @@ void CMesh::LoadDiffuseTextureEmbeded(const aiTexture* pTexture, GLint iMaterial
 void CMesh::LoadDiffuseTextureFromFile(const std::string& stDirectory, const aiString& stPath, GLint iMaterialIndex)
 {
 	std::string stFullPath = GetFullPath(stDirectory, stPath);
-	m_vMaterials[iMaterialIndex].m_pDiffuseMap = new CTexture(stFullPath.c_str(), GL_TEXTURE_2D);
-	if (!m_vMaterials[iMaterialIndex].m_pDiffuseMap->Load())
-	{
-		sys_err("CMesh::LoadDiffuseTextureFromFile Failed to Load a Diffuse Texture %s", stFullPath.c_str());
-		return;
-	}
+	m_vMaterials[iMaterialIndex].m_pDiffuseMap = RequestTexture(stFullPath);
 
 #if defined(ENABLE_PRINT_MESH_DATA)
-	sys_log("CMesh::LoadDiffuseTextureEmbeded Loaded a Diffuse Texture %s at Index %d", stFullPath.c_str(), iMaterialIndex);
+	sys_log("CMesh::LoadDiffuseTextureFromFile Queued a Diffuse Texture %s at Index %d", stFullPath.c_str(), iMaterialIndex);
 #endif
 }
 
@@ -604,7 +1408,7 @@ void CMesh::LoadSpecularTexture(const std::string& stDirectory, const aiMaterial
 
 void CMesh::LoadSpecularTextureEmbeded(const aiTexture* pTexture, GLint iMaterialIndex)
 {
-	m_vMaterials[iMaterialIndex].m_pSpecularMap = new CTexture(GL_TEXTURE_2D);
+	m_vMaterials[iMaterialIndex].m_pSpecularMap = CTextureRegistry::Adopt(new CTexture(GL_TEXTURE_2D));
 	GLint iBufferSize = pTexture->mWidth;
 	m_vMaterials[iMaterialIndex].m_pSpecularMap->Load(iBufferSize, pTexture->pcData);
 
@@ -616,15 +1420,10 @@ void CMesh::LoadSpecularTextureEmbeded(const aiTexture* pTexture, GLint iMateria
 void CMesh::LoadSpecularTextureFromFile(const std::string& stDirectory, const aiString& stPath, GLint iMaterialIndex)
 {
 	std::string stFullPath = GetFullPath(stDirectory, stPath);
-	m_vMaterials[iMaterialIndex].m_pSpecularMap = new CTexture(stFullPath.c_str(), GL_TEXTURE_2D);
-	if (!m_vMaterials[iMaterialIndex].m_pSpecularMap->Load())
-	{
-		sys_err("CMesh::LoadSpecularTextureFromFile Failed to Load a Specular Texture %s", stFullPath.c_str());
-		return;
-	}
+	m_vMaterials[iMaterialIndex].m_pSpecularMap = RequestTexture(stFullPath);
 
 #if defined(ENABLE_PRINT_MESH_DATA)
-	sys_log("CMesh::LoadSpecularTextureFromFile Loaded a Specular Texture %s at Index %d", stFullPath.c_str(), iMaterialIndex);
+	sys_log("CMesh::LoadSpecularTextureFromFile Queued a Specular Texture %s at Index %d", stFullPath.c_str(), iMaterialIndex);
 #endif
 }
 
@@ -654,7 +1453,7 @@ void CMesh::LoadAlbedoTexture(const std::string& stDirectory, const aiMaterial*
 
 void CMesh::LoadAlbedoTextureEmbeded(const aiTexture* pTexture, GLint iMaterialIndex)
 {
-	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pAlbedo = new CTexture(GL_TEXTURE_2D);
+	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pAlbedo = CTextureRegistry::Adopt(new CTexture(GL_TEXTURE_2D));
 	GLint iBufferSize = pTexture->mWidth;
 	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pAlbedo->Load(iBufferSize, pTexture->pcData);
 
@@ -666,15 +1465,10 @@ void CMesh::LoadAlbedoTextureEmbeded(const aiTexture* pTexture, GLint iMaterialI
 void CMesh::LoadAlbedoTextureFromFile(const std::string& stDirectory, const aiString& stPath, GLint iMaterialIndex)
 {
 	std::string stFullPath = GetFullPath(stDirectory, stPath);
-	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pAlbedo = new CTexture(stFullPath.c_str(), GL_TEXTURE_2D);
-	if (!m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pAlbedo->Load())
-	{
-		sys_err("CMesh::LoadAlbedoTextureFromFile Failed to Load an Albedo Texture %s", stFullPath.c_str());
-		return;
-	}
+	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pAlbedo = RequestTexture(stFullPath);
 
 #if defined(ENABLE_PRINT_MESH_DATA)
-	sys_log("CMesh::LoadAlbedoTextureFromFile Loaded an Albedo Texture %s at Index %d", stFullPath.c_str(), iMaterialIndex);
+	sys_log("CMesh::LoadAlbedoTextureFromFile Queued an Albedo Texture %s at Index %d", stFullPath.c_str(), iMaterialIndex);
 #endif
 }
 
@@ -704,7 +1498,7 @@ void CMesh::LoadMetalnessTexture(const std::string& stDirectory, const aiMateria
 
 void CMesh::LoadMetalnessTextureEmbeded(const aiTexture* pTexture, GLint iMaterialIndex)
 {
-	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pMetallic = new CTexture(GL_TEXTURE_2D);
+	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pMetallic = CTextureRegistry::Adopt(new CTexture(GL_TEXTURE_2D));
 	GLint iBufferSize = pTexture->mWidth;
 	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pMetallic->Load(iBufferSize, pTexture->pcData);
 
@@ -716,15 +1510,10 @@ void CMesh::LoadMetalnessTextureEmbeded(const aiTexture* pTexture, GLint iMateri
 void CMesh::LoadMetalnessTextureFromFile(const std::string& stDirectory, const aiString& stPath, GLint iMaterialIndex)
 {
 	std::string stFullPath = GetFullPath(stDirectory, stPath);
-	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pMetallic = new CTexture(stFullPath.c_str(), GL_TEXTURE_2D);
-	if (!m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pMetallic->Load())
-	{
-		sys_err("CMesh::LoadMetalnessTextureFromFile Failed to Load a Metallic Texture %s", stFullPath.c_str());
-		return;
-	}
+	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pMetallic = RequestTexture(stFullPath);
 
 #if defined(ENABLE_PRINT_MESH_DATA)
-	sys_log("CMesh::LoadMetalnessTextureFromFile Loaded a Metallic Texture %s at Index %d", stFullPath.c_str(), iMaterialIndex);
+	sys_log("CMesh::LoadMetalnessTextureFromFile Queued a Metallic Texture %s at Index %d", stFullPath.c_str(), iMaterialIndex);
 #endif
 }
 
@@ -754,7 +1543,7 @@ void CMesh::LoadRoughnessTexture(const std::string& stDirectory, const aiMateria
 
 void CMesh::LoadRoughnessTextureEmbeded(const aiTexture* pTexture, GLint iMaterialIndex)
 {
-	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pRoughness = new CTexture(GL_TEXTURE_2D);
+	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pRoughness = CTextureRegistry::Adopt(new CTexture(GL_TEXTURE_2D));
 	GLint iBufferSize = pTexture->mWidth;
 	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pRoughness->Load(iBufferSize, pTexture->pcData);
 
@@ -766,15 +1555,10 @@ void CMesh::LoadRoughnessTextureEmbeded(const aiTexture* pTexture, GLint iMateri
 void CMesh::LoadRoughnessTextureFromFile(const std::string& stDirectory, const aiString& stPath, GLint iMaterialIndex)
 {
 	std::string stFullPath = GetFullPath(stDirectory, stPath);
-	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pRoughness = new CTexture(stFullPath.c_str(), GL_TEXTURE_2D);
-	if (!m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pRoughness->Load())
-	{
-		sys_err("CMesh::LoadRoughnessTextureFromFile Failed to Load a Diffuse Roughness Texture %s", stFullPath.c_str());
-		return;
-	}
+	m_vMaterials[iMaterialIndex].m_sPBRMaterial.m_pRoughness = RequestTexture(stFullPath);
 
 #if defined(ENABLE_PRINT_MESH_DATA)
-	sys_log("CMesh::LoadRoughnessTextureFromFile Loaded a Diffuse Roughness Texture %s at Index %d", stFullPath.c_str(), iMaterialIndex);
+	sys_log("CMesh::LoadRoughnessTextureFromFile Queued a Diffuse Roughness Texture %s at Index %d", stFullPath.c_str(), iMaterialIndex);
 #endif
 }
 
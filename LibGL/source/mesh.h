@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
 
 #include <assimp/Importer.hpp>      // C++ importer interface
 #include <assimp/scene.h>			// Output data structure
@@ -12,6 +13,8 @@
 #include "../../LibMath/source/vectors.h"
 #include "../../LibMath/source/world_translation.h"
 #include "model.h"
+#include "mesh_file.h"
+#include "image_decoder.h"
 
 #define INVALID_MATERIAL 0xFFFFFFFF
 #define ASSIMP_LOAD_FLAGS_UV_FLIP (aiProcess_JoinIdenticalVertices |    \
@@ -42,10 +45,13 @@
 #define POSITION_LOCATION  0
 #define NORMALS_LOCATION    1
 #define TEX_COORDS_LOCATION 2
+#define INSTANCE_WVP_LOCATION 3		// mat4, locations 3 to 6, read by the instanced Render only
+#define INSTANCE_WORLD_LOCATION 7	// mat4, locations 7 to 10
 
 #define GLCheckError() (glGetError() == GL_NO_ERROR)
 //#define USE_MESH_OPRIMIZER
 #define ENABLE_PRINT_MESH_DATA
+//#define ENABLE_PRINT_QUANTIZATION_ERRORS	// Per submesh error report of QuantizeVertices, costs a pass over every vertex
 
 class CMesh : public CModel
 {
@@ -55,6 +61,7 @@ public:
 
 	bool LoadMesh(const std::string& stFileName, bool bIsUVFlipped = false);
 	void Render();
+	void Render(const CMatrix4Df& matWVP);
 	void Render(GLuint uiDrawIndex, GLuint uiPrimID);
 	void Render(GLuint uiNumInstances, const CMatrix4Df* matWVP, const CMatrix4Df* matWorld);
 	const TMaterial& GetMaterial();
@@ -63,14 +70,39 @@ public:
 	void SetPBR(bool bIsPBR);
 	bool IsPBR() const;
 
+	// Picks the detail level from the projected height of the bounding sphere,
+	// a bias above 1 keeps the detailed levels longer
+	GLuint SelectLod(const CMatrix4Df& matWVP) const;
+	void SetLodBias(float fBias);
+	float GetLodBias() const;
+
+	// Switches to the TQuantizedVertex layout, call it before LoadMesh.
+	// Quantized positions are in [0, 1] of the mesh bounds: multiply the WVP given to the
+	// shader by GetDequantizeMatrix() (identity for the float layout). Normals arrive
+	// as a vec2 octahedral encoding.
+	void SetQuantized(bool bQuantized);
+	bool IsQuantized() const;
+	CMatrix4Df GetDequantizeMatrix() const;
+
 protected:
 	void Clear();
 	virtual void ReserveSpace(GLuint uiNumVertices, GLuint uiNumIndices);
-	virtual void InitSingleMesh(const aiMesh* pMesh);
-	virtual void InitSingleMeshOptimized(GLuint uiMeshIndex, const aiMesh* pMesh);
+	// Both run on worker threads, one call per submesh, and must only touch their own submesh
+	virtual void InitSingleMesh(GLuint uiMeshIndex, const aiMesh* pMesh);
+	virtual void InitSingleMeshOptimized(GLuint uiMeshIndex, const aiMesh* pMesh, std::vector<TVertex>& vVertices, std::vector<GLuint>& vIndices);
 	virtual void PopulateBuffers();
-	virtual void PopulateBuffersDSA();
-	virtual void PopulateBuffersNonDSA();
+	virtual void PopulateBuffers(const void* pVertices, size_t iNumVertices, const GLuint* pIndices, size_t iNumIndices);
+	virtual void PopulateBuffersDSA(const void* pVertices, size_t iNumVertices, const GLuint* pIndices, size_t iNumIndices);
+	virtual void PopulateBuffersNonDSA(const void* pVertices, size_t iNumVertices, const GLuint* pIndices, size_t iNumIndices);
+	size_t GetVertexStride() const;
+	void InitInstanceAttributesDSA();
+	void InitInstanceAttributesNonDSA();
+
+	typedef struct SMeshLod
+	{
+		GLuint uiBaseIndex;
+		GLuint uiNumIndices;
+	} TMeshLod;
 
 	typedef struct SMeshEntry
 	{
@@ -80,14 +112,21 @@ protected:
 			uiBaseIndex = 0;
 			uiNumIndices = 0;
 			uiMaterialIndex = INVALID_MATERIAL;
+			uiNumLods = 0;
 		}
 
 		GLuint uiBaseVertex;
 		GLuint uiBaseIndex;
 		GLuint uiNumIndices;
 		GLuint uiMaterialIndex;
+
+		// lods[0] is the range above, the simplified ranges follow the full meshes in the index buffer
+		TMeshLod lods[MESH_MAX_LODS];
+		GLuint uiNumLods;
 	} TMeshEntry;
 
+	const TMeshLod& GetLod(const TMeshEntry& rMesh, GLuint uiLod) const;
+
 	enum EBufferType
 	{
 		INDEX_BUFFER,
@@ -106,12 +145,37 @@ protected:
 	GLuint m_uiVAO;
 	GLuint m_uiBuffers[NUM_BUFFERS];
 
+	// Bounding sphere of all the submeshes in model space
+	SVector3Df m_v3BoundsCenter;
+	float m_fBoundsRadius = 0.0f;
+	float m_fLodBias = 1.0f;
+
+	bool m_bQuantized = false;
+	SVector3Df m_v3QuantOffset;
+	SVector3Df m_v3QuantScale;
+
 private:
 	bool InitFromScene(const aiScene* pScene, const std::string& stFileName);
 	void ConvertVerticesAndIndices(const aiScene* pScene, GLuint& uiNumVertices, GLuint& uiNumIndices);
 	void InitAllMeshes(const aiScene* pScene);
-	void OptimizeMesh(GLint iMeshIndex, std::vector<TVertex>& vVertices, std::vector<GLuint>& vIndices);
+	void OptimizeMesh(GLint iMeshIndex, const std::vector<TVertex>& vVertices, const std::vector<GLuint>& vIndices,
+		std::vector<TVertex>& vOutVertices, std::vector<GLuint>& vOutIndices);
+	void GenerateLods();
+	void CalculateBounds();
+	void DrawMeshes(GLuint uiLod);
+	void QuantizeVertices();
+	SVector3Df DequantizePosition(const TQuantizedVertex& rVertex) const;
 	bool InitMaterials(const aiScene* pScene, const std::string& stFileName);
+
+	// .meshbin cache next to the source (see mesh_file.h)
+	bool LoadFromCache(const std::string& stFileName, uint32_t uiFlags);
+	bool SaveToCache(const std::string& stFileName, uint32_t uiFlags) const;
+	CTexture* LoadCachedTexture(const char* szFullPath);
+
+	// Texture files are decoded on a worker pool, FinishTextureUploads creates the GL objects
+	CTexture* RequestTexture(const std::string& stFullPath);
+	void FinishTextureUploads();
+
 	void LoadTextures(const std::string& stDirectory, const aiMaterial* pMaterial, GLint iMaterialIndex);
 
 	void LoadDiffuseTexture(const std::string& stDirectory, const aiMaterial* pMaterial, GLint iMaterialIndex);
@@ -142,7 +206,14 @@ private:
 
 	// Temporary space for vertex stuff before we load them into the GPU
 	std::vector<TVertex> m_vVertices;
+	std::vector<TQuantizedVertex> m_vQuantizedVertices;
 
 	Assimp::Importer m_Importer;
 	bool m_bIsPBR;
+
+	std::unordered_map<uint64_t, CTexture*> m_mPendingTextures;
+
+	// Instance matrices grouped by LOD, reused between frames
+	std::vector<CMatrix4Df> m_vInstanceWVP;
+	std::vector<CMatrix4Df> m_vInstanceWorld;
 };
\ No newline at end of file
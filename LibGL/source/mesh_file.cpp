@@ -0,0 +1,212 @@
+#include "stdafx.h"
+#include "mesh_file.h"
+#include <fstream>
+#include <filesystem>
+#include <meshoptimizer/meshoptimizer.h>
+
+namespace
+{
+	inline size_t AlignUp(size_t iValue)
+	{
+		return ((iValue + MESH_FILE_ALIGNMENT - 1) & ~(MESH_FILE_ALIGNMENT - 1));
+	}
+}
+
+CMeshFile::CMeshFile()
+{
+	m_pHeader = nullptr;
+}
+
+bool CMeshFile::GetSourceStamp(const std::string& stSourceFile, uint64_t& uiSize, int64_t& iTime)
+{
+	std::error_code ec;
+
+	uiSize = static_cast<uint64_t>(std::filesystem::file_size(stSourceFile, ec));
+	if (ec)
+	{
+		return (false);
+	}
+
+	iTime = static_cast<int64_t>(std::filesystem::last_write_time(stSourceFile, ec).time_since_epoch().count());
+	return (!ec);
+}
+
+bool CMeshFile::Save(const std::string& stFileName, const std::string& stSourceFile, const TMeshFileData& data)
+{
+	TMeshFileHeader header{};
+	header.uiMagic = MESH_FILE_MAGIC;
+	header.uiVersion = MESH_FILE_VERSION;
+	header.uiFlags = data.uiFlags;
+	header.uiVertexStride = data.uiVertexStride;
+
+	if (!GetSourceStamp(stSourceFile, header.uiSourceSize, header.iSourceTime))
+	{
+		sys_err("CMeshFile::Save: Failed to stat the source %s", stSourceFile.c_str());
+		return (false);
+	}
+
+	// Compress the streams first, their encoded size decides the layout
+	std::vector<uint8_t> vEncodedVertices(meshopt_encodeVertexBufferBound(data.uiNumVertices, data.uiVertexStride));
+	vEncodedVertices.resize(meshopt_encodeVertexBuffer(vEncodedVertices.data(), vEncodedVertices.size(), data.pVertices, data.uiNumVertices, data.uiVertexStride));
+
+	std::vector<uint8_t> vEncodedIndices(meshopt_encodeIndexBufferBound(data.uiNumIndices, data.uiNumVertices));
+	vEncodedIndices.resize(meshopt_encodeIndexBuffer(vEncodedIndices.data(), vEncodedIndices.size(), data.pIndices, data.uiNumIndices));
+
+	if ((data.uiNumVertices && vEncodedVertices.empty()) || (data.uiNumIndices && vEncodedIndices.empty()))
+	{
+		sys_err("CMeshFile::Save: Failed to encode the buffers of %s", stSourceFile.c_str());
+		return (false);
+	}
+
+	header.uiNumVertices = data.uiNumVertices;
+	header.uiNumIndices = data.uiNumIndices;
+	header.uiNumMeshes = static_cast<uint32_t>(data.vMeshes.size());
+	header.uiNumMaterials = static_cast<uint32_t>(data.vMaterials.size());
+
+	header.fBoundsCenter[0] = data.v3BoundsCenter.x;
+	header.fBoundsCenter[1] = data.v3BoundsCenter.y;
+	header.fBoundsCenter[2] = data.v3BoundsCenter.z;
+	header.fBoundsRadius = data.fBoundsRadius;
+
+	header.fQuantOffset[0] = data.v3QuantOffset.x;
+	header.fQuantOffset[1] = data.v3QuantOffset.y;
+	header.fQuantOffset[2] = data.v3QuantOffset.z;
+	header.fQuantScale[0] = data.v3QuantScale.x;
+	header.fQuantScale[1] = data.v3QuantScale.y;
+	header.fQuantScale[2] = data.v3QuantScale.z;
+
+	header.uiVerticesOffset = AlignUp(sizeof(TMeshFileHeader));
+	header.uiVerticesSize = vEncodedVertices.size();
+	header.uiIndicesOffset = AlignUp(header.uiVerticesOffset + header.uiVerticesSize);
+	header.uiIndicesSize = vEncodedIndices.size();
+	header.uiMeshesOffset = AlignUp(header.uiIndicesOffset + header.uiIndicesSize);
+	header.uiMaterialsOffset = AlignUp(header.uiMeshesOffset + data.vMeshes.size() * sizeof(TMeshFileEntry));
+
+	std::ofstream file(stFileName, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		sys_err("CMeshFile::Save: Failed to open %s for writing", stFileName.c_str());
+		return (false);
+	}
+
+	static const char s_Padding[MESH_FILE_ALIGNMENT] = {};
+	size_t iWritten = 0;
+
+	auto Write = [&](const void* pData, size_t iBytes)
+		{
+			file.write(static_cast<const char*>(pData), static_cast<std::streamsize>(iBytes));
+			iWritten += iBytes;
+		};
+
+	auto Pad = [&](uint64_t uiOffset)
+		{
+			Write(s_Padding, static_cast<size_t>(uiOffset) - iWritten);
+		};
+
+	Write(&header, sizeof(header));
+	Pad(header.uiVerticesOffset);
+	Write(vEncodedVertices.data(), vEncodedVertices.size());
+	Pad(header.uiIndicesOffset);
+	Write(vEncodedIndices.data(), vEncodedIndices.size());
+	Pad(header.uiMeshesOffset);
+	Write(data.vMeshes.data(), data.vMeshes.size() * sizeof(TMeshFileEntry));
+	Pad(header.uiMaterialsOffset);
+	Write(data.vMaterials.data(), data.vMaterials.size() * sizeof(TMeshFileMaterial));
+
+	if (!file.good())
+	{
+		sys_err("CMeshFile::Save: Failed to write %s", stFileName.c_str());
+		return (false);
+	}
+
+	sys_log("CMeshFile::Save: Saved %s (%zu bytes, vertices %zu -> %zu, indices %zu -> %zu)", stFileName.c_str(), iWritten,
+		static_cast<size_t>(data.uiNumVertices) * data.uiVertexStride, vEncodedVertices.size(),
+		static_cast<size_t>(data.uiNumIndices) * sizeof(GLuint), vEncodedIndices.size());
+	return (true);
+}
+
+bool CMeshFile::Open(const std::string& stFileName, const std::string& stSourceFile, uint32_t uiFlags)
+{
+	Close();
+
+	uint64_t uiSourceSize = 0;
+	int64_t iSourceTime = 0;
+
+	std::error_code ec;
+	if (!std::filesystem::exists(stFileName, ec) || !GetSourceStamp(stSourceFile, uiSourceSize, iSourceTime))
+	{
+		return (false);
+	}
+
+	if (!m_File.Open(stFileName))
+	{
+		return (false);
+	}
+
+	const TMeshFileHeader* pHeader = reinterpret_cast<const TMeshFileHeader*>(m_File.GetRange(0, sizeof(TMeshFileHeader)));
+	const uint32_t uiStride = (uiFlags & MESH_FILE_FLAG_QUANTIZED) ? sizeof(TQuantizedVertex) : sizeof(TVertex);
+	if (!pHeader || pHeader->uiMagic != MESH_FILE_MAGIC || pHeader->uiVersion != MESH_FILE_VERSION || pHeader->uiVertexStride != uiStride)
+	{
+		sys_log("CMeshFile::Open: %s has an old layout, re-importing", stFileName.c_str());
+		Close();
+		return (false);
+	}
+
+	if (pHeader->uiFlags != uiFlags || pHeader->uiSourceSize != uiSourceSize || pHeader->iSourceTime != iSourceTime)
+	{
+		sys_log("CMeshFile::Open: %s is out of date, re-importing", stFileName.c_str());
+		Close();
+		return (false);
+	}
+
+	if (!m_File.GetRange(pHeader->uiVerticesOffset, pHeader->uiVerticesSize) ||
+		!m_File.GetRange(pHeader->uiIndicesOffset, pHeader->uiIndicesSize) ||
+		!m_File.GetRange(pHeader->uiMeshesOffset, pHeader->uiNumMeshes * sizeof(TMeshFileEntry)) ||
+		!m_File.GetRange(pHeader->uiMaterialsOffset, pHeader->uiNumMaterials * sizeof(TMeshFileMaterial)))
+	{
+		sys_err("CMeshFile::Open: %s is truncated", stFileName.c_str());
+		Close();
+		return (false);
+	}
+
+	m_pHeader = pHeader;
+	return (true);
+}
+
+void CMeshFile::Close()
+{
+	m_File.Close();
+	m_pHeader = nullptr;
+}
+
+bool CMeshFile::IsOpen() const
+{
+	return (m_pHeader != nullptr);
+}
+
+const TMeshFileHeader& CMeshFile::GetHeader() const
+{
+	return (*m_pHeader);
+}
+
+bool CMeshFile::DecodeVertices(void* pDst) const
+{
+	const unsigned char* pSrc = m_File.GetData() + m_pHeader->uiVerticesOffset;
+	return (meshopt_decodeVertexBuffer(pDst, m_pHeader->uiNumVertices, m_pHeader->uiVertexStride, pSrc, static_cast<size_t>(m_pHeader->uiVerticesSize)) == 0);
+}
+
+bool CMeshFile::DecodeIndices(GLuint* pDst) const
+{
+	const unsigned char* pSrc = m_File.GetData() + m_pHeader->uiIndicesOffset;
+	return (meshopt_decodeIndexBuffer(pDst, m_pHeader->uiNumIndices, sizeof(GLuint), pSrc, static_cast<size_t>(m_pHeader->uiIndicesSize)) == 0);
+}
+
+const TMeshFileEntry* CMeshFile::GetMeshes() const
+{
+	return (reinterpret_cast<const TMeshFileEntry*>(m_File.GetData() + m_pHeader->uiMeshesOffset));
+}
+
+const TMeshFileMaterial* CMeshFile::GetMaterials() const
+{
+	return (reinterpret_cast<const TMeshFileMaterial*>(m_File.GetData() + m_pHeader->uiMaterialsOffset));
+}
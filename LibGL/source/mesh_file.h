@@ -0,0 +1,134 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "mapped_file.h"
+#include "model.h"
+
+/*
+ * .meshbin, the post-processed CMesh data
+ *
+ * [TMeshFileHeader][vertices][indices][TMeshFileEntry x meshes][TMeshFileMaterial x materials]
+ *
+ * Every block is aligned to MESH_FILE_ALIGNMENT. The vertex and index blocks are compressed with
+ * the meshoptimizer codecs, the vertex stride is either TVertex or TQuantizedVertex.
+ * The header records the source size and write time, a cache older than its source
+ * (or imported with other flags) is ignored.
+ * The LOD index ranges of every submesh live in the same index block, after the full meshes.
+ */
+constexpr uint32_t MESH_FILE_MAGIC = 0x4E49424D; // "MBIN"
+constexpr uint32_t MESH_FILE_VERSION = 3;
+constexpr size_t MESH_FILE_ALIGNMENT = 16;
+constexpr const char* MESH_FILE_EXTENSION = ".meshbin";
+
+enum EMeshFileFlags : uint32_t
+{
+	MESH_FILE_FLAG_UV_FLIPPED = 1 << 0,
+	MESH_FILE_FLAG_OPTIMIZED = 1 << 1,
+	MESH_FILE_FLAG_QUANTIZED = 1 << 2,
+};
+
+enum EMeshFileTexture : uint32_t
+{
+	MESH_FILE_TEXTURE_DIFFUSE,
+	MESH_FILE_TEXTURE_SPECULAR,
+	MESH_FILE_TEXTURE_ALBEDO,
+	MESH_FILE_TEXTURE_METALLIC,
+	MESH_FILE_TEXTURE_ROUGHNESS,
+	MESH_FILE_TEXTURE_COUNT,
+};
+
+#pragma pack(push, 1)
+typedef struct SMeshFileHeader
+{
+	uint32_t uiMagic;
+	uint32_t uiVersion;
+	uint32_t uiFlags;
+	uint32_t uiVertexStride;
+	uint64_t uiSourceSize;
+	int64_t iSourceTime;
+	uint32_t uiNumVertices;
+	uint32_t uiNumIndices;
+	uint32_t uiNumMeshes;
+	uint32_t uiNumMaterials;
+	float fBoundsCenter[3];
+	float fBoundsRadius;
+	float fQuantOffset[3];	// Dequantized position = offset + unorm * scale
+	float fQuantScale[3];
+	uint64_t uiVerticesOffset;
+	uint64_t uiVerticesSize;	// Encoded bytes
+	uint64_t uiIndicesOffset;
+	uint64_t uiIndicesSize;
+	uint64_t uiMeshesOffset;
+	uint64_t uiMaterialsOffset;
+} TMeshFileHeader;
+
+typedef struct SMeshFileEntry
+{
+	uint32_t uiBaseVertex;
+	uint32_t uiBaseIndex;
+	uint32_t uiNumIndices;
+	uint32_t uiMaterialIndex;
+	uint32_t uiNumLods;
+	uint32_t uiLodBaseIndex[MESH_MAX_LODS];
+	uint32_t uiLodNumIndices[MESH_MAX_LODS];
+} TMeshFileEntry;
+
+typedef struct SMeshFileMaterial
+{
+	char szName[64];
+	float fAmbient[4];
+	float fDiffuse[4];
+	float fSpecular[4];
+	char szTextures[MESH_FILE_TEXTURE_COUNT][260];	// Full paths, empty when the slot is unused
+} TMeshFileMaterial;
+#pragma pack(pop)
+
+// Everything CMeshFile::Save writes, the vertex stream is raw (TVertex or TQuantizedVertex)
+typedef struct SMeshFileData
+{
+	uint32_t uiFlags;
+	SVector3Df v3BoundsCenter;
+	float fBoundsRadius;
+	SVector3Df v3QuantOffset;
+	SVector3Df v3QuantScale;
+
+	const void* pVertices;
+	uint32_t uiNumVertices;
+	uint32_t uiVertexStride;
+	const GLuint* pIndices;
+	uint32_t uiNumIndices;
+
+	std::vector<TMeshFileEntry> vMeshes;
+	std::vector<TMeshFileMaterial> vMaterials;
+} TMeshFileData;
+
+class CMeshFile
+{
+public:
+	CMeshFile();
+
+	static bool Save(const std::string& stFileName, const std::string& stSourceFile, const TMeshFileData& data);
+
+	// Fails when the file is missing, stale or was imported with different flags
+	bool Open(const std::string& stFileName, const std::string& stSourceFile, uint32_t uiFlags);
+	void Close();
+	bool IsOpen() const;
+
+	const TMeshFileHeader& GetHeader() const;
+
+	// pDst must hold uiNumVertices * uiVertexStride bytes / uiNumIndices indices
+	bool DecodeVertices(void* pDst) const;
+	bool DecodeIndices(GLuint* pDst) const;
+	const TMeshFileEntry* GetMeshes() const;
+	const TMeshFileMaterial* GetMaterials() const;
+
+protected:
+	static bool GetSourceStamp(const std::string& stSourceFile, uint64_t& uiSize, int64_t& iTime);
+
+private:
+	CMappedFile m_File;
+	const TMeshFileHeader* m_pHeader;
+};
@@ -3,6 +3,10 @@
 #include "../../LibMath/source/vectors.h"
 #include "../../LibMath/source/world_translation.h"
 #include "texture.h"
+#include "texture_registry.h"
+
+// Detail levels kept per submesh, LOD 0 is the full mesh
+#define MESH_MAX_LODS 4
 
 typedef struct SVertex
 {
@@ -20,6 +24,15 @@ typedef struct SVertex
 	}
 } TVertex;
 
+// Compact layout used by CMesh::SetQuantized, 16 bytes against the 32 of TVertex
+typedef struct SQuantizedVertex
+{
+	uint16_t uiPos[3];		// unorm16 inside the mesh bounds, see CMesh::GetDequantizeMatrix
+	uint16_t uiPadding;
+	int16_t iNormal[2];		// snorm16 octahedral encoding
+	uint16_t uiTexture[2];	// half floats
+} TQuantizedVertex;
+
 typedef struct SPBRMaterial
 {
 	float m_fRoughness;
@@ -75,15 +88,13 @@ typedef struct SMaterial
 
 	~SMaterial()
 	{
-		if (m_pDiffuseMap)
-		{
-			delete m_pDiffuseMap;
-		}
-
-		if (m_pSpecularMap)
-		{
-			delete m_pSpecularMap;
-		}
+		// Shared through CTextureRegistry, deleted with their last user
+		CTextureRegistry::Release(m_pDiffuseMap);
+		CTextureRegistry::Release(m_pSpecularMap);
+		CTextureRegistry::Release(m_sPBRMaterial.m_pAlbedo);
+		CTextureRegistry::Release(m_sPBRMaterial.m_pRoughness);
+		CTextureRegistry::Release(m_sPBRMaterial.m_pMetallic);
+		CTextureRegistry::Release(m_sPBRMaterial.m_pNormalMap);
 	}
 
 } TMaterial;
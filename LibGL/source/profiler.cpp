@@ -0,0 +1,331 @@
+#include "stdafx.h"
+#include "profiler.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <fstream>
+
+using json = nlohmann::json;
+
+bool CProfiler::ms_bCreated = false;
+bool CProfiler::ms_bEnabled = true;
+bool CProfiler::ms_bPaused = false;
+bool CProfiler::ms_bInFrame = false;
+uint64_t CProfiler::ms_ulFrame = 0;
+uint64_t CProfiler::ms_ulLatestResolved = 0;
+std::vector<uint32_t> CProfiler::ms_vStack;
+std::vector<TProfileFrame> CProfiler::ms_vHistory;
+GLuint CProfiler::ms_auiQueries[PROFILER_GPU_LATENCY][2 + PROFILER_MAX_SCOPES * 2] = {};
+uint64_t CProfiler::ms_aulSlotFrame[PROFILER_GPU_LATENCY] = {};
+
+namespace
+{
+	constexpr uint64_t NO_FRAME = UINT64_MAX;
+	constexpr double NANO_TO_MILLI = 1e-6;
+
+	std::chrono::steady_clock::time_point s_tStart = std::chrono::steady_clock::now();
+
+	GLuint BeginQuery(uint32_t uiScope)
+	{
+		return (2 + uiScope * 2);
+	}
+
+	GLuint EndQuery(uint32_t uiScope)
+	{
+		return (2 + uiScope * 2 + 1);
+	}
+}
+
+void CProfiler::Create()
+{
+	if (ms_bCreated)
+	{
+		return;
+	}
+
+	for (auto& auiSlot : ms_auiQueries)
+	{
+		glGenQueries(static_cast<GLsizei>(std::size(auiSlot)), auiSlot);
+	}
+
+	for (uint64_t& ulFrame : ms_aulSlotFrame)
+	{
+		ulFrame = NO_FRAME;
+	}
+
+	ms_vHistory.assign(PROFILER_HISTORY, TProfileFrame{});
+	ms_vStack.reserve(PROFILER_MAX_SCOPES);
+	s_tStart = std::chrono::steady_clock::now();
+	ms_bCreated = true;
+}
+
+void CProfiler::Destroy()
+{
+	if (!ms_bCreated)
+	{
+		return;
+	}
+
+	for (auto& auiSlot : ms_auiQueries)
+	{
+		glDeleteQueries(static_cast<GLsizei>(std::size(auiSlot)), auiSlot);
+	}
+
+	ms_vHistory.clear();
+	ms_vStack.clear();
+	ms_bInFrame = false;
+	ms_bCreated = false;
+}
+
+double CProfiler::GetTime()
+{
+	return (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_tStart).count());
+}
+
+TProfileFrame& CProfiler::GetHistoryFrame(uint64_t ulFrame)
+{
+	return (ms_vHistory[ulFrame % PROFILER_HISTORY]);
+}
+
+void CProfiler::BeginFrame()
+{
+	ms_bInFrame = false;
+	if (!ms_bCreated || !ms_bEnabled || ms_bPaused)
+	{
+		return;
+	}
+
+	ms_ulFrame++;
+
+	// The slot is about to be reused, whatever it still holds is read now or dropped
+	const uint32_t uiSlot = static_cast<uint32_t>(ms_ulFrame % PROFILER_GPU_LATENCY);
+	if (ms_aulSlotFrame[uiSlot] != NO_FRAME)
+	{
+		ResolveQueries(ms_aulSlotFrame[uiSlot]);
+	}
+
+	TProfileFrame& frame = GetHistoryFrame(ms_ulFrame);
+	frame.ulFrame = ms_ulFrame;
+	frame.dCpuStart = GetTime();
+	frame.dCpuTime = 0.0;
+	frame.dGpuTime = -1.0;
+	frame.bGpuReady = false;
+	frame.vScopes.clear();
+
+	glQueryCounter(ms_auiQueries[uiSlot][0], GL_TIMESTAMP);
+	ms_aulSlotFrame[uiSlot] = ms_ulFrame;
+
+	ms_vStack.clear();
+	ms_bInFrame = true;
+}
+
+void CProfiler::EndFrame()
+{
+	if (!ms_bInFrame)
+	{
+		return;
+	}
+
+	// Close whatever is still open so every begin query has its end
+	while (!ms_vStack.empty())
+	{
+		EndScope(ms_vStack.back());
+	}
+
+	const uint32_t uiSlot = static_cast<uint32_t>(ms_ulFrame % PROFILER_GPU_LATENCY);
+	glQueryCounter(ms_auiQueries[uiSlot][1], GL_TIMESTAMP);
+
+	TProfileFrame& frame = GetHistoryFrame(ms_ulFrame);
+	frame.dCpuTime = GetTime() - frame.dCpuStart;
+
+	ms_bInFrame = false;
+}
+
+uint32_t CProfiler::BeginScope(const char* szName)
+{
+	if (!ms_bInFrame)
+	{
+		return (PROFILER_INVALID_SCOPE);
+	}
+
+	TProfileFrame& frame = GetHistoryFrame(ms_ulFrame);
+	if (frame.vScopes.size() >= PROFILER_MAX_SCOPES)
+	{
+		return (PROFILER_INVALID_SCOPE);
+	}
+
+	const uint32_t uiScope = static_cast<uint32_t>(frame.vScopes.size());
+
+	TProfileScope scope{};
+	scope.szName = szName;
+	scope.uiDepth = static_cast<uint32_t>(ms_vStack.size());
+	scope.uiParent = ms_vStack.empty() ? PROFILER_INVALID_SCOPE : ms_vStack.back();
+	scope.dCpuStart = GetTime() - frame.dCpuStart;
+	scope.dGpuTime = -1.0;
+	frame.vScopes.push_back(scope);
+
+	const uint32_t uiSlot = static_cast<uint32_t>(ms_ulFrame % PROFILER_GPU_LATENCY);
+	glQueryCounter(ms_auiQueries[uiSlot][BeginQuery(uiScope)], GL_TIMESTAMP);
+
+	ms_vStack.push_back(uiScope);
+	return (uiScope);
+}
+
+void CProfiler::EndScope(uint32_t uiScope)
+{
+	if (!ms_bInFrame || uiScope == PROFILER_INVALID_SCOPE || ms_vStack.empty())
+	{
+		return;
+	}
+
+	const uint32_t uiSlot = static_cast<uint32_t>(ms_ulFrame % PROFILER_GPU_LATENCY);
+	glQueryCounter(ms_auiQueries[uiSlot][EndQuery(uiScope)], GL_TIMESTAMP);
+
+	TProfileFrame& frame = GetHistoryFrame(ms_ulFrame);
+	TProfileScope& scope = frame.vScopes[uiScope];
+	scope.dCpuTime = GetTime() - frame.dCpuStart - scope.dCpuStart;
+
+	ms_vStack.pop_back();
+}
+
+void CProfiler::ResolveQueries(uint64_t ulFrame)
+{
+	const uint32_t uiSlot = static_cast<uint32_t>(ulFrame % PROFILER_GPU_LATENCY);
+	ms_aulSlotFrame[uiSlot] = NO_FRAME;
+
+	TProfileFrame& frame = GetHistoryFrame(ulFrame);
+	if (frame.ulFrame != ulFrame)
+	{
+		return;
+	}
+
+	// Queries complete in order, the frame end being available means every scope is
+	GLint iAvailable = GL_FALSE;
+	glGetQueryObjectiv(ms_auiQueries[uiSlot][1], GL_QUERY_RESULT_AVAILABLE, &iAvailable);
+	if (iAvailable != GL_TRUE)
+	{
+		return;
+	}
+
+	GLuint64 ulFrameBegin = 0, ulFrameEnd = 0;
+	glGetQueryObjectui64v(ms_auiQueries[uiSlot][0], GL_QUERY_RESULT, &ulFrameBegin);
+	glGetQueryObjectui64v(ms_auiQueries[uiSlot][1], GL_QUERY_RESULT, &ulFrameEnd);
+	frame.dGpuTime = static_cast<double>(ulFrameEnd - ulFrameBegin) * NANO_TO_MILLI;
+
+	for (uint32_t i = 0; i < frame.vScopes.size(); i++)
+	{
+		GLuint64 ulBegin = 0, ulEnd = 0;
+		glGetQueryObjectui64v(ms_auiQueries[uiSlot][BeginQuery(i)], GL_QUERY_RESULT, &ulBegin);
+		glGetQueryObjectui64v(ms_auiQueries[uiSlot][EndQuery(i)], GL_QUERY_RESULT, &ulEnd);
+
+		frame.vScopes[i].dGpuStart = static_cast<double>(ulBegin - ulFrameBegin) * NANO_TO_MILLI;
+		frame.vScopes[i].dGpuTime = static_cast<double>(ulEnd - ulBegin) * NANO_TO_MILLI;
+	}
+
+	frame.bGpuReady = true;
+	ms_ulLatestResolved = ulFrame;
+}
+
+void CProfiler::SetEnabled(bool bEnabled)
+{
+	ms_bEnabled = bEnabled;
+}
+
+bool CProfiler::IsEnabled()
+{
+	return (ms_bEnabled);
+}
+
+void CProfiler::SetPaused(bool bPaused)
+{
+	ms_bPaused = bPaused;
+}
+
+bool CProfiler::IsPaused()
+{
+	return (ms_bPaused);
+}
+
+const TProfileFrame* CProfiler::GetLatestFrame()
+{
+	if (!ms_bCreated || ms_ulLatestResolved == 0)
+	{
+		return (nullptr);
+	}
+
+	const TProfileFrame& frame = GetHistoryFrame(ms_ulLatestResolved);
+	if (frame.ulFrame != ms_ulLatestResolved)
+	{
+		return (nullptr);
+	}
+
+	return (&frame);
+}
+
+bool CProfiler::ExportChromeTrace(const std::string& stFileName)
+{
+	if (!ms_bCreated)
+	{
+		return (false);
+	}
+
+	json events = json::array();
+	events.push_back({ { "name", "thread_name" }, { "ph", "M" }, { "pid", 1 }, { "tid", 1 }, { "args", { { "name", "CPU" } } } });
+	events.push_back({ { "name", "thread_name" }, { "ph", "M" }, { "pid", 1 }, { "tid", 2 }, { "args", { { "name", "GPU" } } } });
+
+	const uint64_t ulFirst = ms_ulFrame >= PROFILER_HISTORY ? ms_ulFrame - PROFILER_HISTORY + 1 : 1;
+	for (uint64_t ulFrame = ulFirst; ulFrame <= ms_ulFrame; ulFrame++)
+	{
+		const TProfileFrame& frame = GetHistoryFrame(ulFrame);
+		if (frame.ulFrame != ulFrame || (ms_bInFrame && ulFrame == ms_ulFrame))
+		{
+			continue;
+		}
+
+		// Trace timestamps are in microseconds. The GPU track is drawn from the CPU start of its
+		// frame, the two clocks have no common origin
+		const double dFrameStart = frame.dCpuStart * 1000.0;
+		const std::string stFrameName = "Frame " + std::to_string(ulFrame);
+
+		events.push_back({ { "name", stFrameName }, { "cat", "cpu" }, { "ph", "X" }, { "pid", 1 }, { "tid", 1 },
+			{ "ts", dFrameStart }, { "dur", frame.dCpuTime * 1000.0 } });
+
+		if (frame.bGpuReady)
+		{
+			events.push_back({ { "name", stFrameName }, { "cat", "gpu" }, { "ph", "X" }, { "pid", 1 }, { "tid", 2 },
+				{ "ts", dFrameStart }, { "dur", frame.dGpuTime * 1000.0 } });
+		}
+
+		for (const TProfileScope& scope : frame.vScopes)
+		{
+			events.push_back({ { "name", scope.szName }, { "cat", "cpu" }, { "ph", "X" }, { "pid", 1 }, { "tid", 1 },
+				{ "ts", dFrameStart + scope.dCpuStart * 1000.0 }, { "dur", scope.dCpuTime * 1000.0 } });
+
+			if (frame.bGpuReady)
+			{
+				events.push_back({ { "name", scope.szName }, { "cat", "gpu" }, { "ph", "X" }, { "pid", 1 }, { "tid", 2 },
+					{ "ts", dFrameStart + scope.dGpuStart * 1000.0 }, { "dur", scope.dGpuTime * 1000.0 } });
+			}
+		}
+	}
+
+	std::ofstream file(stFileName);
+	if (!file.is_open())
+	{
+		sys_err("CProfiler::ExportChromeTrace: Failed to open %s for writing", stFileName.c_str());
+		return (false);
+	}
+
+	json trace;
+	trace["traceEvents"] = std::move(events);
+	trace["displayTimeUnit"] = "ms";
+	file << trace.dump() << std::endl;
+
+	if (!file.good())
+	{
+		sys_err("CProfiler::ExportChromeTrace: Failed to write %s", stFileName.c_str());
+		return (false);
+	}
+
+	sys_log("CProfiler::ExportChromeTrace: Wrote %s", stFileName.c_str());
+	return (true);
+}
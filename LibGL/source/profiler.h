@@ -0,0 +1,107 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#define PROFILER_MAX_SCOPES 64		// per frame, deeper or later scopes are dropped
+#define PROFILER_GPU_LATENCY 3		// frames the timer queries stay in flight before they are read
+#define PROFILER_HISTORY 240		// frames kept for the panel and the trace export
+#define PROFILER_INVALID_SCOPE 0xFFFFFFFFu
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+// Times the rest of the enclosing block on the CPU and the GPU, szName has to be a string literal
+#define PROFILE_SCOPE(szName) CProfileScope PROFILE_CONCAT(profileScope, __LINE__)(szName)
+
+typedef struct SProfileScope
+{
+	const char* szName;
+	uint32_t uiDepth;
+	uint32_t uiParent;		// PROFILER_INVALID_SCOPE for the top level scopes
+	double dCpuStart;		// ms since the frame began
+	double dCpuTime;		// ms
+	double dGpuStart;		// ms since the frame began on the GPU
+	double dGpuTime;		// ms, negative until the queries are read
+} TProfileScope;
+
+typedef struct SProfileFrame
+{
+	uint64_t ulFrame;
+	double dCpuStart;		// ms since Create, places the frame on the trace timeline
+	double dCpuTime;
+	double dGpuTime;		// negative until the queries are read
+	bool bGpuReady;
+	std::vector<TProfileScope> vScopes;
+} TProfileFrame;
+
+/*
+ * Hierarchical CPU/GPU frame profiler
+ *
+ * PROFILE_SCOPE records a CPU interval with steady_clock and brackets the same commands with
+ * two GL_TIMESTAMP queries. Timestamps are used instead of GL_TIME_ELAPSED because elapsed
+ * queries cannot nest. The queries of a frame are read PROFILER_GPU_LATENCY frames later and
+ * only once the driver reports them available, so the profiler never waits on the GPU; a frame
+ * whose results are still pending then is shown without GPU times.
+ *
+ * GL thread only.
+ */
+class CProfiler
+{
+public:
+	static void Create();
+	static void Destroy();
+
+	static void BeginFrame();
+	static void EndFrame();
+
+	static uint32_t BeginScope(const char* szName);
+	static void EndScope(uint32_t uiScope);
+
+	static void SetEnabled(bool bEnabled);
+	static bool IsEnabled();
+
+	// Paused keeps the history as it is, so a spike can be inspected
+	static void SetPaused(bool bPaused);
+	static bool IsPaused();
+
+	// Latest frame with GPU results, nullptr before the first one is read
+	static const TProfileFrame* GetLatestFrame();
+
+	// Every recorded frame, oldest first, in the Chrome trace event format (chrome://tracing, Perfetto)
+	static bool ExportChromeTrace(const std::string& stFileName);
+
+protected:
+	static TProfileFrame& GetHistoryFrame(uint64_t ulFrame);
+	static void ResolveQueries(uint64_t ulFrame);
+	static double GetTime();
+
+private:
+	static bool ms_bCreated;
+	static bool ms_bEnabled;
+	static bool ms_bPaused;
+	static bool ms_bInFrame;
+	static uint64_t ms_ulFrame;
+	static uint64_t ms_ulLatestResolved;
+	static std::vector<uint32_t> ms_vStack;
+	static std::vector<TProfileFrame> ms_vHistory;
+
+	// Per latency slot: frame begin/end, then a begin/end pair per scope
+	static GLuint ms_auiQueries[PROFILER_GPU_LATENCY][2 + PROFILER_MAX_SCOPES * 2];
+	static uint64_t ms_aulSlotFrame[PROFILER_GPU_LATENCY];
+};
+
+class CProfileScope
+{
+public:
+	explicit CProfileScope(const char* szName) : m_uiScope(CProfiler::BeginScope(szName)) {}
+	~CProfileScope() { CProfiler::EndScope(m_uiScope); }
+
+	CProfileScope(const CProfileScope&) = delete;
+	CProfileScope& operator=(const CProfileScope&) = delete;
+
+private:
+	uint32_t m_uiScope;
+};
@@ -0,0 +1,207 @@
+#include "stdafx.h"
+#include "program_cache.h"
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include <cstring>
+
+bool CProgramCache::ms_bEnabled = true;
+uint32_t CProgramCache::ms_uiCachedPrograms = 0;
+uint32_t CProgramCache::ms_uiCompiledPrograms = 0;
+double CProgramCache::ms_dCachedTime = 0.0;
+double CProgramCache::ms_dCompiledTime = 0.0;
+
+namespace
+{
+	// FNV-1a, 64 bit
+	constexpr uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ull;
+	constexpr uint64_t FNV_PRIME = 0x100000001B3ull;
+
+	uint64_t HashBytes(uint64_t ulHash, const void* pData, size_t uiSize)
+	{
+		const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+		for (size_t i = 0; i < uiSize; i++)
+		{
+			ulHash ^= pBytes[i];
+			ulHash *= FNV_PRIME;
+		}
+
+		return (ulHash);
+	}
+
+	uint64_t HashString(uint64_t ulHash, const char* szText)
+	{
+		if (!szText)
+		{
+			szText = "";
+		}
+
+		// The terminator keeps "ab" + "c" apart from "a" + "bc"
+		return (HashBytes(ulHash, szText, strlen(szText) + 1));
+	}
+}
+
+uint64_t CProgramCache::MakeKey(const std::vector<TShaderSource>& vStages)
+{
+	uint64_t ulHash = FNV_OFFSET_BASIS;
+	ulHash = HashString(ulHash, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+	ulHash = HashString(ulHash, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+	ulHash = HashString(ulHash, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+	for (const TShaderSource& stage : vStages)
+	{
+		ulHash = HashBytes(ulHash, &stage.sType.m_uiType, sizeof(stage.sType.m_uiType));
+		ulHash = HashString(ulHash, stage.stSource.c_str());
+	}
+
+	return (ulHash);
+}
+
+std::string CProgramCache::GetFileName(uint64_t ulKey)
+{
+	char szName[32];
+	snprintf(szName, sizeof(szName), "%016llx", static_cast<unsigned long long>(ulKey));
+	return (std::string(PROGRAM_CACHE_DIR) + "/" + szName + PROGRAM_FILE_EXTENSION);
+}
+
+bool CProgramCache::IsSupported()
+{
+	GLint iNumFormats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &iNumFormats);
+	return (iNumFormats > 0);
+}
+
+bool CProgramCache::Load(GLuint uiProgram, uint64_t ulKey)
+{
+	if (!ms_bEnabled || !IsSupported())
+	{
+		return (false);
+	}
+
+	const std::string stFileName = GetFileName(ulKey);
+	std::ifstream file(stFileName, std::ios::binary);
+	if (!file.is_open())
+	{
+		return (false);
+	}
+
+	TProgramFileHeader header{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file.good() || header.uiMagic != PROGRAM_FILE_MAGIC || header.uiVersion != PROGRAM_FILE_VERSION || header.ulKey != ulKey)
+	{
+		sys_log("CProgramCache::Load: %s has an old layout, recompiling", stFileName.c_str());
+		file.close();
+		std::error_code ec;
+		std::filesystem::remove(stFileName, ec);
+		return (false);
+	}
+
+	std::vector<char> vBinary(header.uiBinarySize);
+	file.read(vBinary.data(), static_cast<std::streamsize>(vBinary.size()));
+	if (!file.good())
+	{
+		sys_err("CProgramCache::Load: %s is truncated", stFileName.c_str());
+		return (false);
+	}
+	file.close();
+
+	glProgramBinary(uiProgram, header.uiFormat, vBinary.data(), static_cast<GLsizei>(vBinary.size()));
+
+	GLint iLinked = GL_FALSE;
+	glGetProgramiv(uiProgram, GL_LINK_STATUS, &iLinked);
+	if (iLinked != GL_TRUE)
+	{
+		// Same key but the driver changed its mind (format no longer accepted), drop the file
+		sys_log("CProgramCache::Load: Driver rejected %s, recompiling", stFileName.c_str());
+		std::error_code ec;
+		std::filesystem::remove(stFileName, ec);
+		return (false);
+	}
+
+	return (true);
+}
+
+bool CProgramCache::Save(GLuint uiProgram, uint64_t ulKey)
+{
+	if (!ms_bEnabled || !IsSupported())
+	{
+		return (false);
+	}
+
+	GLint iLength = 0;
+	glGetProgramiv(uiProgram, GL_PROGRAM_BINARY_LENGTH, &iLength);
+	if (iLength <= 0)
+	{
+		return (false);
+	}
+
+	std::vector<char> vBinary(static_cast<size_t>(iLength));
+	GLenum eFormat = 0;
+	GLsizei iWritten = 0;
+	glGetProgramBinary(uiProgram, iLength, &iWritten, &eFormat, vBinary.data());
+	if (iWritten <= 0)
+	{
+		return (false);
+	}
+
+	std::error_code ec;
+	std::filesystem::create_directories(PROGRAM_CACHE_DIR, ec);
+
+	const std::string stFileName = GetFileName(ulKey);
+	std::ofstream file(stFileName, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		sys_err("CProgramCache::Save: Failed to open %s for writing", stFileName.c_str());
+		return (false);
+	}
+
+	TProgramFileHeader header{};
+	header.uiMagic = PROGRAM_FILE_MAGIC;
+	header.uiVersion = PROGRAM_FILE_VERSION;
+	header.ulKey = ulKey;
+	header.uiFormat = eFormat;
+	header.uiBinarySize = static_cast<uint32_t>(iWritten);
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(vBinary.data(), iWritten);
+
+	if (!file.good())
+	{
+		sys_err("CProgramCache::Save: Failed to write %s", stFileName.c_str());
+		return (false);
+	}
+
+	return (true);
+}
+
+void CProgramCache::SetEnabled(bool bEnabled)
+{
+	ms_bEnabled = bEnabled;
+}
+
+bool CProgramCache::IsEnabled()
+{
+	return (ms_bEnabled);
+}
+
+void CProgramCache::AddBuildTime(double dMilliseconds, bool bFromCache)
+{
+	if (bFromCache)
+	{
+		ms_uiCachedPrograms++;
+		ms_dCachedTime += dMilliseconds;
+	}
+	else
+	{
+		ms_uiCompiledPrograms++;
+		ms_dCompiledTime += dMilliseconds;
+	}
+}
+
+void CProgramCache::LogStats()
+{
+	sys_log("CProgramCache::LogStats: %s, %u programs from the cache in %.2f ms (%.2f ms avg), %u compiled in %.2f ms (%.2f ms avg)",
+		ms_bEnabled ? "enabled" : "disabled",
+		ms_uiCachedPrograms, ms_dCachedTime, ms_uiCachedPrograms ? ms_dCachedTime / ms_uiCachedPrograms : 0.0,
+		ms_uiCompiledPrograms, ms_dCompiledTime, ms_uiCompiledPrograms ? ms_dCompiledTime / ms_uiCompiledPrograms : 0.0);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "base_shader.h"
+
+/*
+ * .progbin, linked programs saved with glGetProgramBinary
+ *
+ * [TProgramFileHeader][binary]
+ *
+ * One file per program in PROGRAM_CACHE_DIR, named after a hash of every stage (type and source)
+ * and of the GL vendor, renderer and version strings, so an edited shader or a driver update
+ * just misses. A binary the driver refuses is deleted and the program is compiled again.
+ *
+ * GL thread only.
+ */
+constexpr uint32_t PROGRAM_FILE_MAGIC = 0x4E494250; // "PBIN"
+constexpr uint32_t PROGRAM_FILE_VERSION = 1;
+constexpr const char* PROGRAM_FILE_EXTENSION = ".progbin";
+constexpr const char* PROGRAM_CACHE_DIR = "cache/shaders";
+
+#pragma pack(push, 1)
+typedef struct SProgramFileHeader
+{
+	uint32_t uiMagic;
+	uint32_t uiVersion;
+	uint64_t ulKey;
+	uint32_t uiFormat;		// GL binary format from glGetProgramBinary
+	uint32_t uiBinarySize;
+} TProgramFileHeader;
+#pragma pack(pop)
+
+class CProgramCache
+{
+public:
+	static uint64_t MakeKey(const std::vector<TShaderSource>& vStages);
+
+	// Loads the cached binary into uiProgram, false on a miss or when the driver rejects it
+	static bool Load(GLuint uiProgram, uint64_t ulKey);
+
+	// uiProgram has to be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+	static bool Save(GLuint uiProgram, uint64_t ulKey);
+
+	// Disabled: every program is compiled from source and nothing is written
+	static void SetEnabled(bool bEnabled);
+	static bool IsEnabled();
+
+	// Startup report, build times of the programs loaded from the cache and compiled from source
+	static void AddBuildTime(double dMilliseconds, bool bFromCache);
+	static void LogStats();
+
+protected:
+	static std::string GetFileName(uint64_t ulKey);
+	static bool IsSupported();
+
+private:
+	static bool ms_bEnabled;
+	static uint32_t ms_uiCachedPrograms;
+	static uint32_t ms_uiCompiledPrograms;
+	static double ms_dCachedTime;
+	static double ms_dCompiledTime;
+};
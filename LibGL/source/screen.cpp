@@ -10,47 +10,19 @@ CRay CScreen::ms_Ray;
  */
 CScreen::CScreen(GLint iVerticesNum)
 {
-	m_bIsInitialized = true;
+	m_bIsInitialized = false;
+	m_iVAO = 0;
+	m_iVBO = 0;
 	m_iVertexCapacity = iVerticesNum;
 
-	m_pLineShader = std::make_unique<CShader>("LineShader");
-
-	glGenVertexArrays(1, &m_iVAO);
-	glBindVertexArray(m_iVAO);
-
-	glGenBuffers(1, &m_iVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
-
-	glGenBuffers(1, &m_iIdxBuf);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIdxBuf);
-
-	glBindVertexArray(m_iVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(TScreenVertex) * m_iVertexCapacity, nullptr, GL_STATIC_DRAW);
+	Init();
 
-	const GLint POS_LOC = 0;
-	const GLint	COL_LOC = 1;
-	size_t NumFloats = 0;
-
-	glEnableVertexAttribArray(POS_LOC);
-	glVertexAttribPointer(POS_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(TScreenVertex), (const void*)(NumFloats * sizeof(float)));
-	NumFloats += 3;
-	glEnableVertexAttribArray(COL_LOC);
-	glVertexAttribPointer(COL_LOC, 4, GL_FLOAT, GL_FALSE, sizeof(TScreenVertex), (const void*)(NumFloats * sizeof(float)));
-	NumFloats += 4;
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-
-	// TODO: Initialize shaderProgram with a basic line shader
-	m_pLineShader->AttachShader("shaders/line_shader.vert");
-	m_pLineShader->AttachShader("shaders/line_shader.frag");
-	m_pLineShader->LinkPrograms();
 	m_v4DiffColor = SVector4Df(0.0f, 1.0f, 0.0f, 1.0f);
-	m_iVertexCapacity = 1;
 	m_matView = CCameraManager::Instance().GetCurrentCamera()->GetViewMatrix();
 	m_matInverseView = CCameraManager::Instance().GetCurrentCamera()->GetViewMatrixInverse();
 
+	m_vDebugLines.reserve(m_iVertexCapacity);
+
 	ms_v3PickRayOrigin = SVector3Df(0.0f);
 	ms_v3PickRayDir = SVector3Df(0.0f);
 
@@ -65,64 +37,76 @@ CScreen::CScreen(GLint iVerticesNum)
 	m_fBrushStrength = 5.0f;
 	m_iTerrainTexNum = 0;
 	m_bTerrainRayIntersection = false;
+
+	m_bBrushStroke = false;
+	m_v2LastStampPos = SVector2Df(0.0f);
+	m_fBrushSpacing = 0.25f;
+	m_fStrokeDwellTimer = 0.0f;
+	m_fStrokeBaseHeight = 0.0f;
 }
 
 void CScreen::Init()
 {
-	if (!m_bIsInitialized)
+	if (m_bIsInitialized)
 	{
-		m_pLineShader = std::make_unique<CShader>("LineShader");
+		return;
+	}
 
-		glGenVertexArrays(1, &m_iVAO);
-		glBindVertexArray(m_iVAO);
+	m_pLineShader = std::make_unique<CShader>("LineShader");
 
-		glGenBuffers(1, &m_iVBO);
-		glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
+	glGenVertexArrays(1, &m_iVAO);
+	CGLState::BindVertexArray(m_iVAO);
 
-		glGenBuffers(1, &m_iIdxBuf);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIdxBuf);
+	glGenBuffers(1, &m_iVBO);
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_iVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(TScreenVertex) * m_iVertexCapacity, nullptr, GL_DYNAMIC_DRAW);
 
-		glBindVertexArray(m_iVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(TScreenVertex) * m_iVertexCapacity, nullptr, GL_STATIC_DRAW);
+	const GLint POS_LOC = 0;
+	const GLint	COL_LOC = 1;
+	size_t NumFloats = 0;
 
-		const GLint POS_LOC = 0;
-		const GLint	COL_LOC = 1;
-		size_t NumFloats = 0;
+	glEnableVertexAttribArray(POS_LOC);
+	glVertexAttribPointer(POS_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(TScreenVertex), (const void*)(NumFloats * sizeof(float)));
+	NumFloats += 3;
+	glEnableVertexAttribArray(COL_LOC);
+	glVertexAttribPointer(COL_LOC, 4, GL_FLOAT, GL_FALSE, sizeof(TScreenVertex), (const void*)(NumFloats * sizeof(float)));
+	NumFloats += 4;
 
-		glEnableVertexAttribArray(POS_LOC);
-		glVertexAttribPointer(POS_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(TScreenVertex), (const void*)(NumFloats * sizeof(float)));
-		NumFloats += 3;
-		glEnableVertexAttribArray(COL_LOC);
-		glVertexAttribPointer(COL_LOC, 4, GL_FLOAT, GL_FALSE, sizeof(TScreenVertex), (const void*)(NumFloats * sizeof(float)));
-		NumFloats += 4;
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+	CGLState::BindVertexArray(0);
 
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindVertexArray(0);
+	m_pLineShader->AttachShader("shaders/line_shader.vert");
+	m_pLineShader->AttachShader("shaders/line_shader.frag");
+	m_pLineShader->LinkPrograms();
 
-		// TODO: Initialize shaderProgram with a basic line shader
-		m_pLineShader->AttachShader("shaders/line_shader.vert");
-		m_pLineShader->AttachShader("shaders/line_shader.frag");
-		m_pLineShader->LinkPrograms();
-	}
+	m_bIsInitialized = true;
 }
 
 CScreen::~CScreen()
 {
 	if (m_iVAO)
 	{
-		glDeleteVertexArrays(1, &m_iVAO);
+		CGLState::DeleteVertexArrays(1, &m_iVAO);
 	}
 	if (m_iVBO)
 	{
-		glDeleteBuffers(1, &m_iVBO);
-	}
-	if (m_iIdxBuf)
-	{
-		glDeleteBuffers(1, &m_iIdxBuf);
+		CGLState::DeleteBuffers(1, &m_iVBO);
 	}
 }
 
+void CScreen::PushLine(const SVector3Df& v3Start, const SVector3Df& v3End)
+{
+	m_vDebugLines.push_back({ v3Start, m_v4DiffColor });
+	m_vDebugLines.push_back({ v3End, m_v4DiffColor });
+}
+
+void CScreen::PushTriangle(const SVector3Df& v0, const SVector3Df& v1, const SVector3Df& v2)
+{
+	m_vDebugTriangles.push_back({ v0, m_v4DiffColor });
+	m_vDebugTriangles.push_back({ v1, m_v4DiffColor });
+	m_vDebugTriangles.push_back({ v2, m_v4DiffColor });
+}
+
 void CScreen::RenderLine2d(float sx, float sz, float ex, float ez, float y)
 {
 	RenderLine3d(sx, sz, y, ex, ez, y);
@@ -130,160 +114,102 @@ void CScreen::RenderLine2d(float sx, float sz, float ex, float ez, float y)
 
 void CScreen::RenderLine2d(const SVector2Df& v2StartPoint, const SVector2Df& v2EndPoint, float z)
 {
-	RenderLine3d(v2StartPoint.x, v2StartPoint.y, z, v2StartPoint.x, v2StartPoint.y, z);
+	RenderLine3d(v2StartPoint.x, v2StartPoint.y, z, v2EndPoint.x, v2EndPoint.y, z);
 }
 
 void CScreen::RenderLine3d(float sx, float sy, float sz, float ex, float ey, float ez)
 {
-	if (m_iVAO == 0)
-	{
-		Init();
-	}
-
-	m_pLineShader->Use();
-	m_pLineShader->setMat4("ViewMatrix", CCameraManager::Instance().GetCurrentCamera()->GetViewProjMatrix());
-
-	SVector3Df v3StartPoint(sx, sy, sz);
-	SVector3Df v3EndPoint(ex, ey, ez);
-
-	TScreenVertex vertices[2] = {
-		{{ v3StartPoint }, { m_v4DiffColor }},
-		{{ v3EndPoint }, { m_v4DiffColor }}
-	};
-
-	glBindVertexArray(m_iVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-	glDrawArrays(GL_LINES, 0, 2);
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	PushLine(SVector3Df(sx, sy, sz), SVector3Df(ex, ey, ez));
 }
 
 void CScreen::RenderLine3d(const SVector3Df& v3StartPoint, const SVector3Df& v3EndPoint)
 {
-	if (m_iVAO == 0)
-	{
-		Init();
-	}
-
-	m_pLineShader->Use();
-	m_pLineShader->setMat4("ViewMatrix", CCameraManager::Instance().GetCurrentCamera()->GetViewProjMatrix());
-
-	TScreenVertex vertices[2] = {
-		{{ v3StartPoint }, { m_v4DiffColor }},
-		{{ v3EndPoint }, { m_v4DiffColor }}
-	};
-
-	glBindVertexArray(m_iVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-	glDrawArrays(GL_LINES, 0, 2);
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	PushLine(v3StartPoint, v3EndPoint);
 }
 
 void CScreen::RenderCircle2d(float fx, float fy, float fz, float fRadius, int iStep, bool bHorizontal)
 {
-	float theta = 0.0f;
-	float delta = 2.0f * static_cast<float>(M_PI) / static_cast<float>(iStep);
-	float x, y, z;
-	std::vector<SVector3Df> points;
-	points.clear();
-	points.resize(iStep);
+	if (iStep < 2)
+	{
+		return;
+	}
 
+	const float delta = 2.0f * static_cast<float>(M_PI) / static_cast<float>(iStep);
+	m_vDebugLines.reserve(m_vDebugLines.size() + static_cast<size_t>(iStep) * 2);
+
+	SVector3Df v3First, v3Prev;
 	for (GLint count = 0; count < iStep; count++)
 	{
+		const float theta = delta * static_cast<float>(count);
+		SVector3Df v3Point;
+
 		if (bHorizontal)
 		{
-			x = fx + fRadius * std::cosf(theta);
-			y = fy;
-			z = fz + fRadius * std::sinf(theta);
+			v3Point = SVector3Df(fx + fRadius * std::cos(theta), fy, fz + fRadius * std::sin(theta));
 		}
 		else
 		{
-			x = fx + fRadius * std::cosf(theta);
-			y = fy + fRadius * std::sinf(theta);
-			z = fz;
+			v3Point = SVector3Df(fx + fRadius * std::cos(theta), fy + fRadius * std::sin(theta), fz);
 		}
 
-		points[count] = SVector3Df(x, y, z);
-		theta += delta;
+		if (count == 0)
+		{
+			v3First = v3Point;
+		}
+		else
+		{
+			PushLine(v3Prev, v3Point);
+		}
+		v3Prev = v3Point;
 	}
 
-	for (GLint count = 0; count < iStep - 1; count++)
-	{
-		RenderLine3d(points[count].x, points[count].y, points[count].z, points[count + 1].x, points[count + 1].y, points[count + 1].z);
-	}
-	RenderLine3d(points[iStep - 1].x, points[iStep - 1].y, points[iStep - 1].z, points[0].x, points[0].y, points[0].z);
+	PushLine(v3Prev, v3First);
 }
 
 void CScreen::RenderCircle3d(float fx, float fy, float fz, float fRadius, int iStep)
 {
-	std::vector<SVector3Df> points;
-	points.clear();
-	points.resize(iStep);
-
-	float theta = 0.0f;
-	float delta = 2.0f * static_cast<float>(M_PI) / static_cast<float>(iStep);
+	if (iStep < 2)
+	{
+		return;
+	}
 
-	CMatrix4Df billBoardMat = CCameraManager::Instance().GetCurrentCamera()->GetBillBoardMatrix();
+	const float delta = 2.0f * static_cast<float>(M_PI) / static_cast<float>(iStep);
+	const CMatrix4Df& billBoardMat = CCameraManager::Instance().GetCurrentCamera()->GetBillBoardMatrix();
 
-	// Generate the circle points
+	// Circle in the XY plane, the scratch streams keep their capacity between calls
+	m_vCircleX.resize(iStep);
+	m_vCircleY.resize(iStep);
+	m_vCircleZ.assign(iStep, 0.0f);
 	for (GLint count = 0; count < iStep; count++)
 	{
-		SVector3Df point(fRadius * std::cosf(theta), fRadius * std::sinf(theta), 0.0f);
-		points[count] = SVector3Df(billBoardMat * SVector4Df(point, 1.0f)); // Transform to camera-aligned space
-		theta += delta;
+		const float theta = delta * static_cast<float>(count);
+		m_vCircleX[count] = fRadius * std::cos(theta);
+		m_vCircleY[count] = fRadius * std::sin(theta);
 	}
 
-	// Render the circle using connected line segments
-	for (GLint count = 0; count < iStep - 1; count++)
+	// Transform to camera-aligned space
+	MathBatch::TransformPoints(billBoardMat, { m_vCircleX.data(), m_vCircleY.data(), m_vCircleZ.data() }, { m_vCircleX.data(), m_vCircleY.data(), m_vCircleZ.data() }, iStep);
+
+	// Connected line segments, the last one closes the circle
+	m_vDebugLines.reserve(m_vDebugLines.size() + static_cast<size_t>(iStep) * 2);
+	for (GLint count = 0; count < iStep; count++)
 	{
-		RenderLine3d(fx + points[count].x, fy + points[count].y, fz + points[count].z,
-			fx + points[count + 1].x, fy + points[count + 1].y, fz + points[count + 1].z);
+		const GLint next = (count + 1) % iStep;
+		PushLine(SVector3Df(fx + m_vCircleX[count], fy + m_vCircleY[count], fz + m_vCircleZ[count]),
+			SVector3Df(fx + m_vCircleX[next], fy + m_vCircleY[next], fz + m_vCircleZ[next]));
 	}
-
-	// Connect the last point to the first to close the circle
-	RenderLine3d(fx + points[iStep - 1].x, fy + points[iStep - 1].y, fz + points[iStep - 1].z,
-		fx + points[0].x, fy + points[0].y, fz + points[0].z);
 }
 
 void CScreen::RenderLinedBox3d(float sx, float sy, float sz, float ex, float ey, float ez)
 {
-	if (m_iVAO == 0)
-	{
-		Init();
-	}
-
-	m_pLineShader->Use();
-	m_pLineShader->setMat4("ViewMatrix", CCameraManager::Instance().GetCurrentCamera()->GetViewProjMatrix());
-
 	// Define 8 corners of the box
-	SVector3Df v0(sx, sy, sz);
-	SVector3Df v1(ex, sy, sz);
-	SVector3Df v2(sx, ey, sz);
-	SVector3Df v3(ex, ey, sz);
-	SVector3Df v4(sx, sy, ez);
-	SVector3Df v5(ex, sy, ez);
-	SVector3Df v6(sx, ey, ez);
-	SVector3Df v7(ex, ey, ez);
-
-	// Use m_v4DiffColor for all vertices (assumed to be set to a visible color)
-	TScreenVertex vertices[8] = {
-		{ v0, m_v4DiffColor },
-		{ v1, m_v4DiffColor },
-		{ v2, m_v4DiffColor },
-		{ v3, m_v4DiffColor },
-		{ v4, m_v4DiffColor },
-		{ v5, m_v4DiffColor },
-		{ v6, m_v4DiffColor },
-		{ v7, m_v4DiffColor }
+	const SVector3Df v[8] = {
+		SVector3Df(sx, sy, sz), SVector3Df(ex, sy, sz), SVector3Df(sx, ey, sz), SVector3Df(ex, ey, sz),
+		SVector3Df(sx, sy, ez), SVector3Df(ex, sy, ez), SVector3Df(sx, ey, ez), SVector3Df(ex, ey, ez)
 	};
 
-	// Define indices for the 12 edges (24 indices total)
-	GLuint indices[24] = {
+	// 12 edges
+	static const GLuint indices[24] = {
 		// Bottom face edges
 		0, 1,  1, 3,  3, 2,  2, 0,
 		// Top face edges
@@ -292,115 +218,37 @@ void CScreen::RenderLinedBox3d(float sx, float sy, float sz, float ex, float ey,
 		0, 4,  1, 5,  2, 6,  3, 7
 	};
 
-	UpdateVertexBuffer(vertices, 8);
-
-	// Bind the VAO and update the vertex buffer with new vertex data
-	glBindVertexArray(m_iVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-
-	// Draw using indices; 8 indices means 4 line segments (GL_LINES uses 2 indices per line)
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIdxBuf);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	glDrawElements(GL_LINES, 24, GL_UNSIGNED_INT, 0);
-	//glDrawArrays(GL_LINES, 0, 8);
-
-	// Unbind buffers and VAO
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	for (GLint i = 0; i < 24; i += 2)
+	{
+		PushLine(v[indices[i]], v[indices[i + 1]]);
+	}
 }
 
 void CScreen::RenderLinedSquare3d(float sx, float sy, float sz, float ex, float ey, float ez)
 {
-	if (m_iVAO == 0)
-	{
-		Init();
-	}
-
-	m_pLineShader->Use();
-	m_pLineShader->setMat4("ViewMatrix", CCameraManager::Instance().GetCurrentCamera()->GetViewProjMatrix());
-
 	// Define 4 corners of the square plane.
 	// Here, we assume the plane is axis-aligned in XY and uses the z value of the first corner (sz).
-	SVector3Df v0(sx, sy, sz); // bottom-left
-	SVector3Df v1(ex, sy, sz); // bottom-right
-	SVector3Df v2(sx, ey, sz); // top-left
-	SVector3Df v3(ex, ey, sz); // top-right
-
-	// Create a vertex array for 4 vertices using a common color (m_v4DiffColor)
-	TScreenVertex vertices[4] = {
-		{ v0, m_v4DiffColor },
-		{ v1, m_v4DiffColor },
-		{ v2, m_v4DiffColor },
-		{ v3, m_v4DiffColor }
-	};
-
-	// Define indices for the square edges (4 edges, 8 indices total)
-	GLuint indices[8] = {
-		0, 1, // bottom edge
-		1, 3, // right edge
-		3, 2, // top edge
-		2, 0  // left edge
-	};
-
-	UpdateVertexBuffer(vertices, 4);
+	const SVector3Df v0(sx, sy, sz); // bottom-left
+	const SVector3Df v1(ex, sy, sz); // bottom-right
+	const SVector3Df v2(sx, ey, sz); // top-left
+	const SVector3Df v3(ex, ey, sz); // top-right
 
-	// Bind the VAO and update the vertex buffer with new vertex data
-	glBindVertexArray(m_iVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-
-	// Draw using indices; 8 indices means 4 line segments (GL_LINES uses 2 indices per line)
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIdxBuf);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	// Draw the square edges using the index buffer (8 indices = 4 line segments)
-	glDrawElements(GL_LINES, 8, GL_UNSIGNED_INT, 0);
-
-	// Unbind buffers and VAO
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	PushLine(v0, v1); // bottom edge
+	PushLine(v1, v3); // right edge
+	PushLine(v3, v2); // top edge
+	PushLine(v2, v0); // left edge
 }
 
 void CScreen::RenderBox3d(float sx, float sy, float sz, float ex, float ey, float ez)
 {
-	// Ensure the VAO is initialized
-	if (m_iVAO == 0)
-	{
-		Init();
-	}
-
-	// Use your line (or general) shader and set the view-projection matrix
-	m_pLineShader->Use();
-	m_pLineShader->setMat4("ViewMatrix", CCameraManager::Instance().GetCurrentCamera()->GetViewProjMatrix());
-
 	// Define the 8 corners of the cube
-	SVector3Df v0(sx, sy, sz);
-	SVector3Df v1(ex, sy, sz);
-	SVector3Df v2(sx, ey, sz);
-	SVector3Df v3(ex, ey, sz);
-	SVector3Df v4(sx, sy, ez);
-	SVector3Df v5(ex, sy, ez);
-	SVector3Df v6(sx, ey, ez);
-	SVector3Df v7(ex, ey, ez);
-
-	// Create an array of vertices using a common color (m_v4DiffColor)
-	TScreenVertex vertices[8] = {
-		{ v0, m_v4DiffColor },
-		{ v1, m_v4DiffColor },
-		{ v2, m_v4DiffColor },
-		{ v3, m_v4DiffColor },
-		{ v4, m_v4DiffColor },
-		{ v5, m_v4DiffColor },
-		{ v6, m_v4DiffColor },
-		{ v7, m_v4DiffColor }
+	const SVector3Df v[8] = {
+		SVector3Df(sx, sy, sz), SVector3Df(ex, sy, sz), SVector3Df(sx, ey, sz), SVector3Df(ex, ey, sz),
+		SVector3Df(sx, sy, ez), SVector3Df(ex, sy, ez), SVector3Df(sx, ey, ez), SVector3Df(ex, ey, ez)
 	};
 
-	// Define indices for 12 triangles (36 indices total)
-	// Each face of the cube is made up of two triangles.
-	GLuint indices[36] = {
+	// Each face of the cube is made up of two triangles
+	static const GLuint indices[36] = {
 		// Front face (v0,v1,v3,v2)
 		0, 1, 3,
 		3, 2, 0,
@@ -421,95 +269,93 @@ void CScreen::RenderBox3d(float sx, float sy, float sz, float ex, float ey, floa
 		5, 1, 0
 	};
 
-	UpdateVertexBuffer(vertices, 8);
-
-	// Update the vertex buffer with the vertex data
-	glBindVertexArray(m_iVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-
-	// Update the index buffer with our indices
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIdxBuf);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+	for (GLint i = 0; i < 36; i += 3)
+	{
+		PushTriangle(v[indices[i]], v[indices[i + 1]], v[indices[i + 2]]);
+	}
+}
 
-	// Draw the cube using triangles (36 indices = 12 triangles)
-	glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+void CScreen::RenderSquare3d(float sx, float sy, float sz, float ex, float ey, float ez)
+{
+	// Define 4 corners of the square plane.
+	// Here, we assume the plane is axis-aligned in XY and uses the z value of the first corner (sz).
+	const SVector3Df v0(sx, sy, sz); // bottom-left
+	const SVector3Df v1(ex, sy, sz); // bottom-right
+	const SVector3Df v2(sx, ey, sz); // top-left
+	const SVector3Df v3(ex, ey, sz); // top-right
 
-	// Unbind buffers and VAO
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	PushTriangle(v0, v1, v3);
+	PushTriangle(v3, v2, v0);
 }
 
-void CScreen::RenderSquare3d(float sx, float sy, float sz, float ex, float ey, float ez)
+void CScreen::FlushDebugDraw()
 {
-	if (m_iVAO == 0)
+	const size_t uiLineVertices = m_vDebugLines.size();
+	const size_t uiTriangleVertices = m_vDebugTriangles.size();
+
+	if (uiLineVertices == 0 && uiTriangleVertices == 0)
 	{
-		Init();
+		return;
 	}
 
-	m_pLineShader->Use();
-	m_pLineShader->setMat4("ViewMatrix", CCameraManager::Instance().GetCurrentCamera()->GetViewProjMatrix());
+	PROFILE_SCOPE("Debug Draw");
 
-	// Define 4 corners of the square plane.
-	// Here, we assume the plane is axis-aligned in XY and uses the z value of the first corner (sz).
-	SVector3Df v0(sx, sy, sz); // bottom-left
-	SVector3Df v1(ex, sy, sz); // bottom-right
-	SVector3Df v2(sx, ey, sz); // top-left
-	SVector3Df v3(ex, ey, sz); // top-right
-
-	// Create a vertex array for 4 vertices using a common color (m_v4DiffColor)
-	TScreenVertex vertices[4] = {
-		{ v0, m_v4DiffColor },
-		{ v1, m_v4DiffColor },
-		{ v2, m_v4DiffColor },
-		{ v3, m_v4DiffColor }
-	};
+	Init();
 
-	// Define indices for the square edges (4 edges, 8 indices total)
-	GLuint indices[6] = {
-		// Front face (v0,v1,v3,v2)
-		0, 1, 3,
-		3, 2, 0,
-	};
+	// Triangles follow the lines in the same buffer, one upload for the whole frame
+	UpdateVertexBuffer(uiLineVertices + uiTriangleVertices);
 
-	UpdateVertexBuffer(vertices, 4);
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_iVBO);
+	if (uiLineVertices)
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(TScreenVertex) * uiLineVertices, m_vDebugLines.data());
+	}
+	if (uiTriangleVertices)
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, sizeof(TScreenVertex) * uiLineVertices, sizeof(TScreenVertex) * uiTriangleVertices, m_vDebugTriangles.data());
+	}
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, 0);
 
-	glDisable(GL_CULL_FACE);
+	// The view-projection matrix comes from SceneConstants
+	m_pLineShader->Use();
+	CGLState::BindVertexArray(m_iVAO);
 
-	// Bind the VAO and update the vertex buffer with new vertex data
-	glBindVertexArray(m_iVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+	if (uiLineVertices)
+	{
+		glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(uiLineVertices));
+	}
 
-	// Draw using indices; 8 indices means 4 line segments (GL_LINES uses 2 indices per line)
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIdxBuf);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+	// Squares are single sided, boxes are closed, neither needs culling
+	if (uiTriangleVertices)
+	{
+		CGLState::Disable(GL_CULL_FACE);
+		glDrawArrays(GL_TRIANGLES, static_cast<GLint>(uiLineVertices), static_cast<GLsizei>(uiTriangleVertices));
+		CGLState::Enable(GL_CULL_FACE);
+	}
+
+	CGLState::BindVertexArray(0);
 
-	// Draw the cube using triangles (36 indices = 12 triangles)
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+	// Keep the capacity, next frame appends into the same storage
+	m_vDebugLines.clear();
+	m_vDebugTriangles.clear();
+}
 
-	// Unbind buffers and VAO
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-	glEnable(GL_CULL_FACE);
+size_t CScreen::GetDebugVertexCount() const
+{
+	return (m_vDebugLines.size() + m_vDebugTriangles.size());
 }
 
-void CScreen::UpdateVertexBuffer(const TScreenVertex* vertices, size_t vertexCount)
+void CScreen::UpdateVertexBuffer(size_t vertexCount)
 {
-	if (vertexCount > m_iVertexCapacity)
+	// Grow geometrically, otherwise orphan the old storage so the driver never waits on last frame's draw
+	if (vertexCount > static_cast<size_t>(m_iVertexCapacity))
 	{
-		// Increase capacity (e.g. double it or set to vertexCount)
-		m_iVertexCapacity = static_cast<GLint>(vertexCount);
-		glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(TScreenVertex) * m_iVertexCapacity, nullptr, GL_DYNAMIC_DRAW);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		m_iVertexCapacity = std::max(static_cast<GLint>(vertexCount), m_iVertexCapacity * 2);
 	}
-	// Now update the buffer data
-	glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(TScreenVertex) * vertexCount, vertices);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_iVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(TScreenVertex) * m_iVertexCapacity, nullptr, GL_DYNAMIC_DRAW);
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 const SVector4Df& CScreen::GetDiffuseColor()
@@ -570,12 +416,12 @@ SVector3Df CScreen::GetRayFromScreenCenter()
 	SVector4Df rayClip(ndcX, ndcY, -1.0f, 1.0f);
 
 	// Inverse projection to eye (view) space
-	CMatrix4Df invProj = scene->pCamera->GetProjectionMat().Inverse();
+	const CMatrix4Df& invProj = scene->pCamera->GetProjectionMatInverse();
 	SVector4Df rayEye = invProj * rayClip;
 	rayEye = SVector4Df(rayEye.x, rayEye.y, -1.0f, 0.0f);
 
 	// Inverse view to world space
-	CMatrix4Df invView = scene->pCamera->GetViewMatrix().Inverse();
+	const CMatrix4Df& invView = scene->pCamera->GetViewMatrixInverse();
 	SVector4Df rayWorld = invView * rayEye;
 
 	SVector3Df rayDir = SVector3Df(rayWorld.x, rayWorld.y, rayWorld.z).normalize();
@@ -630,133 +476,20 @@ SVector3Df CScreen::GetRayFromScreenCenter()
 
 bool CScreen::RaycastHeightmap(const SVector3Df& rayOrigin, const SVector3Df& rayDir, SVector3Df& intersectionPoint)
 {
-	if (rayDir.y >= 0.0f)
-		return false; // Only works for rays pointing downward
-
-	// Find where the ray crosses the ground plane
-	float t = -rayOrigin.y / rayDir.y;
-	SVector3Df groundPoint = rayOrigin + rayDir * t;
-
-	GLint width = CBaseTerrain::Instance().GetWidth();
-	GLint depth = CBaseTerrain::Instance().GetDepth();
-
-	float fx = groundPoint.x;
-	float fz = groundPoint.z;
-
-	if (fx < 0.0f || fx >= width - 1 || fz < 0.0f || fz >= depth - 1)
-		return false; // Out of terrain bounds
-
-	GLint ix = static_cast<GLint>(fx);
-	GLint iz = static_cast<GLint>(fz);
-
-	float localX = fx - ix;
-	float localZ = fz - iz;
-
-	// Get 4 corner heights
-	float h00 = CBaseTerrain::Instance().GetVertices()[iz * width + ix].m_v3Pos.y;
-	float h10 = CBaseTerrain::Instance().GetVertices()[iz * width + (ix + 1)].m_v3Pos.y;
-	float h01 = CBaseTerrain::Instance().GetVertices()[(iz + 1) * width + ix].m_v3Pos.y;
-	float h11 = CBaseTerrain::Instance().GetVertices()[(iz + 1) * width + (ix + 1)].m_v3Pos.y;
-
-	// Bilinear interpolation
-	float h0 = h00 + (h10 - h00) * localX;
-	float h1 = h01 + (h11 - h01) * localX;
-	float height = h0 + (h1 - h0) * localZ;
-
-	if (groundPoint.y <= height)
-	{
-		intersectionPoint = SVector3Df(groundPoint.x, height, groundPoint.z);
-		return true;
-	}
-
-	return false;
+	return (CBaseTerrain::Instance().GetGeoMipGrid()->RaycastHeightmap(rayOrigin, rayDir, intersectionPoint));
 }
 
 bool CScreen::RaycastHeightmapFast(const SVector3Df& rayOrigin, const SVector3Df& rayDir, SVector3Df& intersectionPoint)
 {
-	if (rayDir.y >= 0.0f)
-		return false; // Only works for downward rays
-
-	const float stepSize = 1.0f;
-	const int maxSteps = 102400;    // Max distance = 1024 units
-
-	const GLint width = m_iTerrainWidth;
-	const GLint depth = m_iTerrainDepth;
-	const float maxX = static_cast<float>(width - 2);
-	const float maxZ = static_cast<float>(depth - 2);
-
-	SVector3Df currentPos = rayOrigin;
-
-	for (int step = 0; step < maxSteps; ++step)
-	{
-		float fx = std::clamp(currentPos.x, 0.0f, maxX);
-		float fz = std::clamp(currentPos.z, 0.0f, maxZ);
-
-		GLint ix = static_cast<GLint>(fx);
-		GLint iz = static_cast<GLint>(fz);
-
-		float localX = fx - ix;
-		float localZ = fz - iz;
-
-		const auto& v00 = CBaseTerrain::Instance().GetVertices()[iz * width + ix].m_v3Pos.y;
-		const auto& v10 = CBaseTerrain::Instance().GetVertices()[iz * width + (ix + 1)].m_v3Pos.y;
-		const auto& v01 = CBaseTerrain::Instance().GetVertices()[(iz + 1) * width + ix].m_v3Pos.y;
-		const auto& v11 = CBaseTerrain::Instance().GetVertices()[(iz + 1) * width + (ix + 1)].m_v3Pos.y;
-
-		float h0 = v00 + (v10 - v00) * localX;
-		float h1 = v01 + (v11 - v01) * localX;
-		float height = h0 + (h1 - h0) * localZ;
-
-		if (currentPos.y <= height)
-		{
-			// Optional: binary refinement for smoother brush edge
-			SVector3Df backtrack = currentPos - rayDir * stepSize;
-			for (int j = 0; j < 4; ++j)
-			{
-				SVector3Df mid = (currentPos + backtrack) * 0.5f;
-				float mx = std::clamp(mid.x, 0.0f, maxX);
-				float mz = std::clamp(mid.z, 0.0f, maxZ);
-				GLint mix = static_cast<GLint>(mx);
-				GLint miz = static_cast<GLint>(mz);
-				float lx = mx - mix;
-				float lz = mz - miz;
-
-				float mh0 = CBaseTerrain::Instance().GetVertices()[miz * width + mix].m_v3Pos.y +
-					(CBaseTerrain::Instance().GetVertices()[miz * width + (mix + 1)].m_v3Pos.y -
-						CBaseTerrain::Instance().GetVertices()[miz * width + mix].m_v3Pos.y) * lx;
-
-				float mh1 = CBaseTerrain::Instance().GetVertices()[(miz + 1) * width + mix].m_v3Pos.y +
-					(CBaseTerrain::Instance().GetVertices()[(miz + 1) * width + (mix + 1)].m_v3Pos.y -
-						CBaseTerrain::Instance().GetVertices()[(miz + 1) * width + mix].m_v3Pos.y) * lx;
-
-				float midHeight = mh0 + (mh1 - mh0) * lz;
-
-				if (mid.y <= midHeight)
-					currentPos = mid;
-				else
-					backtrack = mid;
-			}
-
-			intersectionPoint = currentPos;
-			intersectionPoint.y = height;
-			return true;
-		}
-
-		currentPos += rayDir * stepSize;
-
-		// early out if ray is too far
-		if (currentPos.x < 0.0f || currentPos.x >= width || currentPos.z < 0.0f || currentPos.z >= depth)
-			return false;
-	}
-
-	return false;
+	return (CBaseTerrain::Instance().GetGeoMipGrid()->RaycastHeightmapFast(rayOrigin, rayDir, intersectionPoint));
 }
 
 void CScreen::SetCursorPosition(GLint iX, GLint iY, GLint hRes, GLint vRes)
 {
 	// Retrieve inverse view and inverse projection matrices
-	auto inverseView = CCameraManager::Instance().GetCurrentCamera()->GetViewMatrixInverse();
-	auto inverseProj = CCameraManager::Instance().GetCurrentCamera()->GetProjectionMat().Inverse();
+	const CCamera* pCamera = CCameraManager::Instance().GetCurrentCamera();
+	const CMatrix4Df& inverseView = pCamera->GetViewMatrixInverse();
+	const CMatrix4Df& inverseProj = pCamera->GetProjectionMatInverse();
 
 	// Convert screen coordinates to normalized device coordinates (NDC) [-1,1]
 	SVector3Df v3NDC;
@@ -915,24 +648,159 @@ void CScreen::GetPickingPosition(float t, float* x, float* y, float* z)
 
 void CScreen::ApplyTerrainBrush(EBrushType eBrushType)
 {
-	if (GetEditingMode() && m_bTerrainRayIntersection)
+	if (!m_bTerrainRayIntersection)
 	{
-		// Just pass the exact world coordinates  no grid conversion here
-		if (eBrushType >= BRUSH_TYPE_UP && eBrushType <= BRUSH_TYPE_NOISE)
+		return;
+	}
+
+	m_fStrokeBaseHeight = m_v3InterSectionPoint.y;
+
+	TBrushStamp stamp{};
+	if (BuildBrushStamp(eBrushType, SVector2Df(m_v3InterSectionPoint.x, m_v3InterSectionPoint.z), stamp))
+	{
+		CBaseTerrain::Instance().GetGeoMipGrid()->QueueBrushStamp(stamp);
+		CBaseTerrain::Instance().GetGeoMipGrid()->FlushBrushStamps();
+	}
+}
+
+bool CScreen::BuildBrushStamp(EBrushType eBrushType, const SVector2Df& v2WorldPos, TBrushStamp& stamp) const
+{
+	stamp.v2WorldPos = v2WorldPos;
+	stamp.fRadius = m_fBrushRadius;
+	stamp.fBaseHeight = m_fStrokeBaseHeight;
+	stamp.iTextureIndex = CBaseTerrain::Instance().GetGeoMipGrid()->GetCurrentTextureIndex();
+
+	if (GetEditingMode())
+	{
+		if (eBrushType < BRUSH_TYPE_UP || eBrushType > BRUSH_TYPE_NOISE)
 		{
-			CBaseTerrain::Instance().GetGeoMipGrid()->ApplyTerrainBrush_World(eBrushType, m_v3InterSectionPoint.x, m_v3InterSectionPoint.z, m_fBrushRadius, m_fBrushStrength);
+			return (false);
 		}
+
+		// Each stamp carries a share of the brush strength, so a stroke deposits the same amount per distance travelled
+		stamp.eBrushType = eBrushType;
+		stamp.fStrength = m_fBrushStrength * m_fBrushSpacing;
+		return (true);
+	}
+
+	if (GetTextureEditMode())
+	{
+		stamp.eBrushType = BRUSH_TYPE_TEXTURE;
+		stamp.fStrength = 1.0f;
+		return (true);
+	}
+
+	return (false);
+}
+
+void CScreen::BeginBrushStroke(EBrushType eBrushType)
+{
+	m_bBrushStroke = false;
+
+	if (!m_bTerrainRayIntersection || (!GetEditingMode() && !GetTextureEditMode()))
+	{
+		return;
 	}
-	else if (GetTextureEditMode() && m_bTerrainRayIntersection)
+
+	m_bBrushStroke = true;
+	m_fStrokeDwellTimer = 0.0f;
+	m_fStrokeBaseHeight = m_v3InterSectionPoint.y;
+	m_v2LastStampPos = SVector2Df(m_v3InterSectionPoint.x, m_v3InterSectionPoint.z);
+
+	TBrushStamp stamp{};
+	if (BuildBrushStamp(eBrushType, m_v2LastStampPos, stamp))
 	{
-		TBrushParams brush{};
-		brush.v2WorldPos = SVector2Df(m_v3InterSectionPoint.x, m_v3InterSectionPoint.z);
-		brush.fRadius = m_fBrushRadius;
-		brush.fStrength = 1.0f;
-		brush.fAlpha = 1.0f;
-		brush.iSelectedTextureIndex = CBaseTerrain::Instance().GetGeoMipGrid()->GetCurrentTextureIndex(); // G channel (for grass, e.g.)
-		CBaseTerrain::Instance().GetGeoMipGrid()->PaintSplatmap(brush);
+		CBaseTerrain::Instance().GetGeoMipGrid()->QueueBrushStamp(stamp);
 	}
+
+	CBaseTerrain::Instance().GetGeoMipGrid()->FlushBrushStamps();
+}
+
+void CScreen::UpdateBrushStroke(EBrushType eBrushType, GLfloat fDeltaTime)
+{
+	if (!m_bBrushStroke)
+	{
+		BeginBrushStroke(eBrushType);
+		return;
+	}
+
+	if (!m_bTerrainRayIntersection)
+	{
+		return;
+	}
+
+	CGeoMipGrid* pGrid = CBaseTerrain::Instance().GetGeoMipGrid();
+
+	SVector2Df v2Cursor(m_v3InterSectionPoint.x, m_v3InterSectionPoint.z);
+	const GLfloat fSpacing = std::max(m_fBrushRadius * m_fBrushSpacing, 0.1f);
+
+	SVector2Df v2Delta = v2Cursor - m_v2LastStampPos;
+	const GLfloat fDistance = v2Delta.length();
+
+	TBrushStamp stamp{};
+
+	if (fDistance >= fSpacing)
+	{
+		// Walk the cursor path and drop a stamp every fSpacing units
+		const SVector2Df v2Dir = v2Delta / fDistance;
+		const GLint iNumStamps = static_cast<GLint>(fDistance / fSpacing);
+
+		for (GLint i = 1; i <= iNumStamps; i++)
+		{
+			const SVector2Df v2StampPos = m_v2LastStampPos + v2Dir * (fSpacing * static_cast<GLfloat>(i));
+			if (BuildBrushStamp(eBrushType, v2StampPos, stamp))
+			{
+				pGrid->QueueBrushStamp(stamp);
+			}
+		}
+
+		m_v2LastStampPos = m_v2LastStampPos + v2Dir * (fSpacing * static_cast<GLfloat>(iNumStamps));
+		m_fStrokeDwellTimer = 0.0f;
+	}
+	else
+	{
+		// Resting cursor keeps depositing at the old brush rate (0.5 s per full strength, 0.1 s for textures)
+		const GLfloat fDwellInterval = GetTextureEditMode() ? 0.1f : 0.5f * m_fBrushSpacing;
+
+		m_fStrokeDwellTimer += fDeltaTime;
+		while (m_fStrokeDwellTimer >= fDwellInterval)
+		{
+			if (BuildBrushStamp(eBrushType, m_v2LastStampPos, stamp))
+			{
+				pGrid->QueueBrushStamp(stamp);
+			}
+			m_fStrokeDwellTimer -= fDwellInterval;
+		}
+	}
+
+	// All stamps of this frame are merged into one region update
+	pGrid->FlushBrushStamps();
+}
+
+void CScreen::EndBrushStroke()
+{
+	if (m_bBrushStroke)
+	{
+		CBaseTerrain::Instance().GetGeoMipGrid()->FlushBrushStamps();
+	}
+
+	m_bBrushStroke = false;
+	m_fStrokeDwellTimer = 0.0f;
+}
+
+bool CScreen::IsBrushStrokeActive() const
+{
+	return (m_bBrushStroke);
+}
+
+void CScreen::SetBrushSpacing(float fVal)
+{
+	m_fBrushSpacing = std::clamp(fVal, 0.05f, 2.0f);
+}
+
+float CScreen::GetBrushSpacing() const
+{
+	return (m_fBrushSpacing);
 }
 
 void CScreen::SetEditingMode(bool bActive)
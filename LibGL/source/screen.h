@@ -28,6 +28,11 @@ public:
 	void RenderBox3d(float sx, float sy, float sz, float ex, float ey, float ez);
 	void RenderSquare3d(float sx, float sy, float sz, float ex, float ey, float ez);
 
+	// Debug draw: the Render* calls above only append to a frame list. FlushDebugDraw uploads
+	// it once and issues one draw per primitive type, call it once per frame after the scene
+	void FlushDebugDraw();
+	size_t GetDebugVertexCount() const;
+
 	void Init();
 
 	const SVector4Df& GetDiffuseColor();
@@ -62,7 +67,11 @@ protected:
 		SVector4Df v4Color;
 	} TScreenVertex;
 
-	void UpdateVertexBuffer(const TScreenVertex* vertices, size_t vertexCount);
+	void PushLine(const SVector3Df& v3Start, const SVector3Df& v3End);
+	void PushTriangle(const SVector3Df& v0, const SVector3Df& v1, const SVector3Df& v2);
+
+	// Makes room for vertexCount vertices and orphans the previous contents
+	void UpdateVertexBuffer(size_t vertexCount);
 
 public: // terrrain
 	bool RaycastHeightmap(const SVector3Df& rayOrigin, const SVector3Df& rayDir, SVector3Df& intersectionPoint);
@@ -70,6 +79,15 @@ public: // terrrain
 
 	void ApplyTerrainBrush(EBrushType eBrushType);
 
+	// Stroke editing: cursor motion is turned into evenly spaced stamps, flushed once per frame
+	void BeginBrushStroke(EBrushType eBrushType);
+	void UpdateBrushStroke(EBrushType eBrushType, GLfloat fDeltaTime);
+	void EndBrushStroke();
+	bool IsBrushStrokeActive() const;
+
+	void SetBrushSpacing(float fVal);
+	float GetBrushSpacing() const;
+
 	void SetEditingMode(bool bActive);
 	bool GetEditingMode() const;
 
@@ -86,12 +104,20 @@ public: // terrrain
 
 	SVector3Df GetIntersectionPoint() const;
 
+protected:
+	bool BuildBrushStamp(EBrushType eBrushType, const SVector2Df& v2WorldPos, TBrushStamp& stamp) const;
+
 private:
 	GLuint m_iVAO; // Vertex Array Object
 	GLuint m_iVBO; // Vertex Buffer Object
-	GLuint m_iIdxBuf; // Index Buffer
 	GLint m_iVertexCapacity;
 
+	std::vector<TScreenVertex> m_vDebugLines;		// GL_LINES, two vertices per segment
+	std::vector<TScreenVertex> m_vDebugTriangles;	// GL_TRIANGLES, unindexed
+	std::vector<float> m_vCircleX;					// RenderCircle3d scratch streams
+	std::vector<float> m_vCircleY;
+	std::vector<float> m_vCircleZ;
+
 	std::unique_ptr<CShader> m_pLineShader;
 	GLboolean m_bIsInitialized;
 	SVector4Df m_v4DiffColor;
@@ -115,4 +141,11 @@ private:
 	GLint m_iTerrainTexNum;
 
 	GLboolean m_bTerrainRayIntersection;
+
+	// Brush Stroke
+	bool m_bBrushStroke;
+	SVector2Df m_v2LastStampPos;
+	GLfloat m_fBrushSpacing;		// Distance between stamps, in fractions of the brush radius
+	GLfloat m_fStrokeDwellTimer;	// Time the cursor rested since the last stamp
+	GLfloat m_fStrokeBaseHeight;	// Flatten reference height, sampled when the stroke begins
 };
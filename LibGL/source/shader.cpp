@@ -1,7 +1,10 @@
 #include "stdafx.h"
 #include "shader.h"
+#include "program_cache.h"
+#include "shader_blocks.h"
 #include <fstream>
 #include <sstream>
+#include <chrono>
 
 /**
  * Constructor with shader paths.
@@ -28,7 +31,7 @@ CShader::CShader(const std::string& stName, const std::string& stComputeShader)
 	m_bIsCompute = false;
 	m_uiID = glCreateProgram();
 
-	AttachShader(CBaseShader(stComputeShader));
+	AttachShader(stComputeShader);
 	LinkPrograms();
 }
 
@@ -64,20 +67,88 @@ CShader* CShader::AttachShader(const CBaseShader& shader)
 	return this;
 }
 
+CShader* CShader::AttachShader(const std::string& stShaderPath)
+{
+	if (!IsCompute())
+	{
+		if (GetShaderTypeName(stShaderPath) == "comp")
+		{
+			m_bIsCompute = true;
+		}
+		m_vSources.emplace_back(ReadShaderSource(stShaderPath));
+	}
+	else
+	{
+		sys_err("CShader::AttachShader Trying to Attach a nonCompute Shader to A Compute Program");
+	}
+
+	return this;
+}
+
+CShader* CShader::AttachShader(const char* szShaderPath)
+{
+	return (AttachShader(std::string(szShaderPath)));
+}
+
 void CShader::LinkPrograms()
 {
+	const auto tStart = std::chrono::steady_clock::now();
+	auto GetElapsedMs = [&tStart]()
+		{
+			return (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tStart).count());
+		};
+
+	// Only programs built purely from file stages can be cached, an already compiled CBaseShader has no source here
+	const bool bCacheable = !m_vSources.empty() && m_lShaders.empty();
+	const uint64_t ulKey = bCacheable ? CProgramCache::MakeKey(m_vSources) : 0;
+
+	if (bCacheable && CProgramCache::Load(GetID(), ulKey))
+	{
+		m_bIsLinked = true;
+		m_vSources.clear();
+		CheckUniformBlocks();
+
+		const double dElapsed = GetElapsedMs();
+		CProgramCache::AddBuildTime(dElapsed, true);
+		sys_log("CShader::LinkPrograms Program %s Loaded From Cache in %.2f ms", GetName().c_str(), dElapsed);
+		return;
+	}
+
+	for (const TShaderSource& source : m_vSources)
+	{
+		CBaseShader shader(source);
+		glAttachShader(GetID(), shader.GetShaderID());
+		m_lShaders.emplace_back(shader.GetShaderID());
+	}
+	m_vSources.clear();
+
+	if (bCacheable && CProgramCache::IsEnabled())
+	{
+		glProgramParameteri(GetID(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
 	glLinkProgram(GetID());
 
 	if (CheckCompileErrors(GetID(), "program", ""))
 	{
 		m_bIsLinked = true;
-		sys_log("CShader::LinkPrograms Program %s Linked Correctly", GetName().c_str());
+		CheckUniformBlocks();
 
 		while (!m_lShaders.empty())
 		{
+			glDetachShader(GetID(), m_lShaders.back());
 			glDeleteShader(m_lShaders.back());
 			m_lShaders.pop_back();
 		}
+
+		if (bCacheable)
+		{
+			CProgramCache::Save(GetID(), ulKey);
+		}
+
+		const double dElapsed = GetElapsedMs();
+		CProgramCache::AddBuildTime(dElapsed, false);
+		sys_log("CShader::LinkPrograms Program %s Linked Correctly in %.2f ms", GetName().c_str(), dElapsed);
 	}
 	else
 	{
@@ -85,6 +156,31 @@ void CShader::LinkPrograms()
 	}
 }
 
+// The shared blocks are sized on the C++ side, a stale copy of the GLSL layout shows up here
+void CShader::CheckUniformBlocks() const
+{
+	const GLuint uiBlock = glGetUniformBlockIndex(GetID(), SCENE_CONSTANTS_BLOCK);
+	if (uiBlock == GL_INVALID_INDEX)
+	{
+		return;
+	}
+
+	GLint iSize = 0;
+	GLint iBinding = -1;
+	glGetActiveUniformBlockiv(GetID(), uiBlock, GL_UNIFORM_BLOCK_DATA_SIZE, &iSize);
+	glGetActiveUniformBlockiv(GetID(), uiBlock, GL_UNIFORM_BLOCK_BINDING, &iBinding);
+
+	if (iSize != static_cast<GLint>(sizeof(TSceneConstants)))
+	{
+		sys_err("CShader::CheckUniformBlocks Program %s Block %s Is %d Bytes, TSceneConstants Is %d", GetName().c_str(), SCENE_CONSTANTS_BLOCK, iSize, static_cast<GLint>(sizeof(TSceneConstants)));
+	}
+
+	if (iBinding != SCENE_CONSTANTS_BINDING)
+	{
+		sys_err("CShader::CheckUniformBlocks Program %s Block %s Uses Binding %d Instead of %d", GetName().c_str(), SCENE_CONSTANTS_BLOCK, iBinding, SCENE_CONSTANTS_BINDING);
+	}
+}
+
 /**
  * Activates the shader program.
  *
@@ -95,7 +191,7 @@ void CShader::Use() const
 {
 	if (IsLinked())
 	{
-		glUseProgram(GetID());
+		CGLState::UseProgram(GetID());
 	}
 }
 
@@ -400,12 +496,12 @@ void CShader::setSampler2D(const std::string& name, GLuint iTextureID, GLint iTe
 	if (IsGLVersionHigher(4, 5))
 	{
 		// Use glBindTextureUnit for OpenGL 4.5 and higher
-		glBindTextureUnit(iTexValue, iTextureID);
+		CGLState::BindTextureUnit(iTexValue, GL_TEXTURE_2D, iTextureID);
 	}
 	else
 	{
-		glActiveTexture(GL_TEXTURE0 + iTexValue);
-		glBindTexture(GL_TEXTURE_2D, iTextureID);
+		CGLState::ActiveTexture(GL_TEXTURE0 + iTexValue);
+		CGLState::BindTexture(GL_TEXTURE_2D, iTextureID);
 	}
 	setInt(name, iTexValue);
 }
@@ -415,12 +511,12 @@ void CShader::setSampler3D(const std::string& name, GLuint iTexValue, GLint iTex
 	if (IsGLVersionHigher(4, 5))
 	{
 		// Use glBindTextureUnit for OpenGL 4.5 and higher
-		glBindTextureUnit(iTexValue, iTextureID);
+		CGLState::BindTextureUnit(iTexValue, GL_TEXTURE_3D, iTextureID);
 	}
 	else
 	{
-		glActiveTexture(GL_TEXTURE0 + iTexValue);
-		glBindTexture(GL_TEXTURE_3D, iTextureID);
+		CGLState::ActiveTexture(GL_TEXTURE0 + iTexValue);
+		CGLState::BindTexture(GL_TEXTURE_3D, iTextureID);
 	}
 	setInt(name, iTexValue);
 }
\ No newline at end of file
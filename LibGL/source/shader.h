@@ -2,6 +2,8 @@
 
 #include "stdafx.h"
 #include <string>
+#include <vector>
+#include <list>
 #include "base_shader.h"
 
 class CShader
@@ -15,6 +17,10 @@ public:
 
 	CShader* AttachShader(const CBaseShader& shader);
 
+	// Only reads the file, the stage is compiled by LinkPrograms when the program cache misses
+	CShader* AttachShader(const std::string& stShaderPath);
+	CShader* AttachShader(const char* szShaderPath);
+
 	void LinkPrograms();
 
 	/* the program ID */
@@ -53,10 +59,14 @@ public:
 	void setSampler3D(const std::string& name, GLuint iTextureID, GLint iTexValue) const;
 
 protected:
+	// Compares the linked SceneConstants block with TSceneConstants
+	void CheckUniformBlocks() const;
+
 	/* the program ID */
 	GLuint m_uiID{0}; // Recommended: ensures m_uiID is always valid.;
 
 	std::list<GLuint> m_lShaders;
+	std::vector<TShaderSource> m_vSources;
 	std::string m_stName;
 
 	bool m_bIsLinked;
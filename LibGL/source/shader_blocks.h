@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include "../../LibMath/source/stdafx.h"
+
+// Uniform buffer binding point of the SceneConstants block (UBO bindings do not share indices with the SSBOs)
+#define SCENE_CONSTANTS_BINDING 0
+#define SCENE_CONSTANTS_BLOCK "SceneConstants"
+
+/*
+ * Per frame values every shader reads from the SceneConstants block
+ *
+ * std140 with row_major matrices, so the CMatrix4Df rows are copied as they are and every
+ * member sits on a 16 byte boundary. The GLSL side is shaders/scene_constants.glsl, pulled
+ * into the stages with #include, and CShader checks the linked block size against this struct.
+ */
+typedef struct SSceneConstants
+{
+	CMatrix4Df m4View;
+	CMatrix4Df m4Proj;
+	CMatrix4Df m4ViewProj;
+	CMatrix4Df m4InvView;
+	CMatrix4Df m4InvProj;
+	CMatrix4Df m4InvViewProj;
+	SVector4Df v4CameraPos;
+	SVector4Df v4LightDir;
+	SVector4Df v4LightColor;
+	SVector4Df v4FogColor;
+	SVector4Df v4Screen;
+} TSceneConstants;
+
+// std140 offsets of the block members, in declaration order
+static_assert(offsetof(TSceneConstants, m4View) == 0, "m4SceneView offset");
+static_assert(offsetof(TSceneConstants, m4Proj) == 64, "m4SceneProj offset");
+static_assert(offsetof(TSceneConstants, m4ViewProj) == 128, "m4SceneViewProj offset");
+static_assert(offsetof(TSceneConstants, m4InvView) == 192, "m4SceneInvView offset");
+static_assert(offsetof(TSceneConstants, m4InvProj) == 256, "m4SceneInvProj offset");
+static_assert(offsetof(TSceneConstants, m4InvViewProj) == 320, "m4SceneInvViewProj offset");
+static_assert(offsetof(TSceneConstants, v4CameraPos) == 384, "v4SceneCameraPos offset");
+static_assert(offsetof(TSceneConstants, v4LightDir) == 400, "v4SceneLightDir offset");
+static_assert(offsetof(TSceneConstants, v4LightColor) == 416, "v4SceneLightColor offset");
+static_assert(offsetof(TSceneConstants, v4FogColor) == 432, "v4SceneFogColor offset");
+static_assert(offsetof(TSceneConstants, v4Screen) == 448, "v4SceneScreen offset");
+static_assert(sizeof(TSceneConstants) == 6 * 64 + 5 * 16, "TSceneConstants must match the std140 SceneConstants block");
@@ -14,6 +14,8 @@
 #include "../../LibMath/source/stdafx.h"
 
 #include "utils.h"
+#include "gl_state.h"
+#include "profiler.h"
 
 #include "camera.h"
 #include "texture.h"
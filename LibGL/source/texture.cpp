@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "texture.h"
+#include "texture_cache.h"
 
 #define ENABLE_PRINT_TEXTURE_DATA
 
@@ -43,7 +44,7 @@ CTexture::~CTexture()
 
 void CTexture::Destroy()
 {
-	glDeleteTextures(1, &m_uiTextureID);
+	CGLState::DeleteTextures(1, &m_uiTextureID);
 	m_uiTextureID = 0;
 
 	// Securely clear if sensitive data
@@ -62,6 +63,18 @@ bool CTexture::Load(bool bBindless)
 		sys_err("CTexture::Load Failed to Load Texture, Not Loaded File.");
 		return false;
 	}
+
+	// GPU ready copy from a previous run, skips the decode entirely
+	const uint64_t uiCacheKey = CTextureCache::IsEnabled() ? CTextureCache::GetKey(m_strFullTexturePath) : 0;
+	if (uiCacheKey)
+	{
+		TCompressedImage compressed;
+		if (CTextureCache::Load(uiCacheKey, compressed) && LoadCompressed(compressed))
+		{
+			return true;
+		}
+	}
+
 	stbi_set_flip_vertically_on_load(1);
 
 	auto* pImageData = stbi_load(m_strFullTexturePath.c_str(), &m_iWidth, &m_iHeight, &m_iChannelsBPP, 0);
@@ -75,6 +88,17 @@ bool CTexture::Load(bool bBindless)
 	sys_err("Texture: %s, Loaded with width: %d, height: %d, Channels: %d", m_stTextureName.c_str(), m_iWidth, m_iHeight, m_iChannelsBPP);
 #endif
 
+	if (uiCacheKey)
+	{
+		TCompressedImage compressed;
+		if (CTextureCache::Compress(pImageData, m_iWidth, m_iHeight, m_iChannelsBPP, compressed) && LoadCompressed(compressed))
+		{
+			CTextureCache::Store(uiCacheKey, compressed);
+			stbi_image_free(pImageData);
+			return true;
+		}
+	}
+
 	m_vbTextureData.assign(pImageData, pImageData + m_iWidth * m_iHeight * m_iChannelsBPP);
 
 	if (bBindless)
@@ -85,6 +109,8 @@ bool CTexture::Load(bool bBindless)
 	{
 		LoadInternal(pImageData);
 	}
+
+	stbi_image_free(pImageData);
 	return true;
 }
 
@@ -145,6 +171,49 @@ void CTexture::LoadF32(GLint iWidth, GLint iHeight, float* pImageData)
 	glGenerateTextureMipmap(m_uiTextureID);
 }
 
+bool CTexture::LoadCompressed(const SCompressedImage& image)
+{
+	if (!IsGLVersionHigher(4, 5) || image.vLevels.empty())
+	{
+		return false;
+	}
+
+	m_iWidth = image.iWidth;
+	m_iHeight = image.iHeight;
+	m_iChannelsBPP = image.iChannelsBPP;
+
+	const GLint iLevels = static_cast<GLint>(image.vLevels.size());
+
+	glCreateTextures(m_eTextureTarget, 1, &m_uiTextureID);
+	glTextureStorage2D(m_uiTextureID, iLevels, image.eFormat, m_iWidth, m_iHeight);
+
+	for (GLint i = 0; i < iLevels; i++)
+	{
+		const TTextureCacheLevel& level = image.vLevels[i];
+		glCompressedTextureSubImage2D(m_uiTextureID, i, 0, 0, level.uiWidth, level.uiHeight, image.eFormat,
+			static_cast<GLsizei>(level.uiSize), image.vData.data() + level.uiOffset);
+	}
+
+	if (m_iChannelsBPP == 1)
+	{
+		GLint SwizzleMask[] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+		glTextureParameteriv(m_uiTextureID, GL_TEXTURE_SWIZZLE_RGBA, SwizzleMask);
+	}
+
+	glTextureParameteri(m_uiTextureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTextureParameteri(m_uiTextureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(m_uiTextureID, GL_TEXTURE_BASE_LEVEL, 0);
+	glTextureParameteri(m_uiTextureID, GL_TEXTURE_MAX_LEVEL, iLevels - 1);
+	glTextureParameteri(m_uiTextureID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTextureParameteri(m_uiTextureID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	GLfloat maxAniso = 0.0f;
+	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAniso);
+	glTextureParameterf(m_uiTextureID, GL_TEXTURE_MAX_ANISOTROPY, maxAniso);
+
+	return true;
+}
+
 void CTexture::Bind(GLenum eTextureUnit)
 {
 	if (IsGLVersionHigher(4, 5))
@@ -198,7 +267,7 @@ void CTexture::LoadInternalDSA(void* pImageData)
 
 	glCreateTextures(m_eTextureTarget, 1, &m_uiTextureID);
 
-	GLint iLevels = std::min(5, (GLint)std::log2f((GLfloat)std::max(m_iWidth, m_iHeight)));
+	GLint iLevels = std::min(5, (GLint)std::log2((GLfloat)std::max(m_iWidth, m_iHeight)));
 	GLint SwizzleMask[] = { GL_RED, GL_RED, GL_RED, GL_RED };
 
 	if (m_eTextureTarget == GL_TEXTURE_2D)
@@ -248,7 +317,7 @@ void CTexture::LoadInternalNonDSA(void* pImageData)
 	memcpy(m_vbTextureData.data(), pImageData, dataSize);
 
 	glGenTextures(1, &m_uiTextureID);
-	glBindTexture(m_eTextureTarget, m_uiTextureID);
+	CGLState::BindTexture(m_eTextureTarget, m_uiTextureID);
 
 	if (m_eTextureTarget == GL_TEXTURE_2D)
 	{
@@ -287,18 +356,18 @@ void CTexture::LoadInternalNonDSA(void* pImageData)
 	glTexParameteri(m_eTextureTarget, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
 	glGenerateMipmap(m_eTextureTarget);
-	glBindTexture(m_eTextureTarget, 0);
+	CGLState::BindTexture(m_eTextureTarget, 0);
 }
 
 void CTexture::BindInternalDSA(GLenum eTextureUnit)
 {
-	glBindTextureUnit(eTextureUnit - GL_TEXTURE0, m_uiTextureID);
+	CGLState::BindTextureUnit(eTextureUnit - GL_TEXTURE0, m_eTextureTarget, m_uiTextureID);
 }
 
 void CTexture::BindInternalNonDSA(GLenum eTextureUnit)
 {
-	glActiveTexture(eTextureUnit);
-	glBindTexture(m_eTextureTarget, m_uiTextureID);
+	CGLState::ActiveTexture(eTextureUnit);
+	CGLState::BindTexture(m_eTextureTarget, m_uiTextureID);
 }
 
 GLuint CTexture::GenerateTexture2D(GLint iWidth, GLint iHeight)
@@ -310,8 +379,8 @@ GLuint CTexture::GenerateTexture2D(GLint iWidth, GLint iHeight)
 	else
 	{
 		glGenTextures(1, &m_uiTextureID);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, m_uiTextureID);
+		CGLState::ActiveTexture(GL_TEXTURE0);
+		CGLState::BindTexture(GL_TEXTURE_2D, m_uiTextureID);
 	}
 
 	glTextureParameteri(m_uiTextureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -332,7 +401,7 @@ GLuint CTexture::GenerateTexture2D(GLint iWidth, GLint iHeight)
 GLuint CTexture::GenerateEmptyTexture2D(GLint iWidth, GLint iHeight, GLint iTextureType)
 {
 	glGenTextures(1, &m_uiTextureID);
-	glBindTexture(m_eTextureTarget, m_uiTextureID);
+	CGLState::BindTexture(m_eTextureTarget, m_uiTextureID);
 
 	if (iTextureType == GL_RGBA32UI)
 	{
@@ -347,7 +416,7 @@ GLuint CTexture::GenerateEmptyTexture2D(GLint iWidth, GLint iHeight, GLint iText
 	glTexParameteri(m_eTextureTarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(m_eTextureTarget, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(m_eTextureTarget, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glBindTexture(m_eTextureTarget, 0);
+	CGLState::BindTexture(m_eTextureTarget, 0);
 
 	return (m_uiTextureID);
 }
@@ -356,7 +425,7 @@ GLuint CTexture::GenerateColoredTexture2D(GLint iWidth, GLint iHeight, const SVe
 {
 	// Step 1: Generate and bind the texture
 	glGenTextures(1, &m_uiTextureID);
-	glBindTexture(m_eTextureTarget, m_uiTextureID);
+	CGLState::BindTexture(m_eTextureTarget, m_uiTextureID);
 
 	glTexImage2D(m_eTextureTarget, 0, GL_RGBA8, iWidth, iHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
 
@@ -380,7 +449,7 @@ GLuint CTexture::GenerateColoredTexture2D(GLint iWidth, GLint iHeight, const SVe
 	// Allocate and fill texture
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, iWidth, iHeight, 0, GL_RGBA, GL_FLOAT, colorData.data());
 
-	glBindTexture(m_eTextureTarget, 0);
+	CGLState::BindTexture(m_eTextureTarget, 0);
 	return (m_uiTextureID);
 }
 
@@ -393,8 +462,8 @@ GLuint CTexture::GenerateTexture3D(GLint iWidth, GLint iHeight, GLint iDepth)
 	else
 	{
 		glGenTextures(1, &m_uiTextureID);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_3D, m_uiTextureID);
+		CGLState::ActiveTexture(GL_TEXTURE0);
+		CGLState::BindTexture(GL_TEXTURE_3D, m_uiTextureID);
 	}
 
 	glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -516,7 +585,7 @@ void CTexture::UploadFloatRGBA(const SVector4Df* data)
 {
 	if (m_uiTextureID)
 	{
-		glBindTexture(GL_TEXTURE_2D, m_uiTextureID);
+		CGLState::BindTexture(GL_TEXTURE_2D, m_uiTextureID);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, m_iWidth, m_iHeight, 0, GL_RGBA, GL_FLOAT, data);
 	}
 }
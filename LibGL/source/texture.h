@@ -7,6 +7,8 @@
 #include <string>
 #include <filesystem> // C++17
 
+struct SCompressedImage;
+
 class CTexture
 {
 public:
@@ -67,6 +69,9 @@ public:
 
 	void LoadF32(GLint iWidth, GLint iHeight, float* pImageData);
 
+	// Uploads a block compressed mip chain (see texture_cache.h)
+	bool LoadCompressed(const SCompressedImage& image);
+
 	// Should be called once to bind the texture
 	void Bind(GLenum eTextureUnit);
 	void GetImageSize(GLint& iImageWidth, GLint& iImageHeight);
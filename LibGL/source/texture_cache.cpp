@@ -0,0 +1,487 @@
+#include "stdafx.h"
+#include "texture_cache.h"
+#include "mapped_file.h"
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+
+#if defined(_WIN64)
+#undef max
+#undef min
+#undef minmax
+#endif
+
+bool CTextureCache::ms_bEnabled = false;
+std::string CTextureCache::ms_stDirectory = "cache/textures";
+
+namespace
+{
+	constexpr uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ull;
+	constexpr uint64_t FNV_PRIME = 0x100000001B3ull;
+
+	// Bumped whenever the encoder or the mip filter changes, invalidates every entry
+	constexpr uint64_t TEXTURE_CACHE_IMPORT_OPTIONS = (static_cast<uint64_t>(TEXTURE_CACHE_VERSION) << 32) | 1 /* flipped on load */;
+
+	inline uint64_t HashBytes(uint64_t uiHash, const uint8_t* pData, size_t iSize)
+	{
+		for (size_t i = 0; i < iSize; i++)
+		{
+			uiHash ^= pData[i];
+			uiHash *= FNV_PRIME;
+		}
+
+		return (uiHash);
+	}
+
+	GLenum GetCompressedFormat(GLint iChannelsBPP)
+	{
+		switch (iChannelsBPP)
+		{
+		case 1: return (GL_COMPRESSED_RED_RGTC1);
+		case 2: return (GL_COMPRESSED_RG_RGTC2);
+		case 3: return (GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+		case 4: return (GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+		default: return (0);
+		}
+	}
+
+	size_t GetBlockSize(GLint iChannelsBPP)
+	{
+		return ((iChannelsBPP == 2 || iChannelsBPP == 4) ? 16 : 8);
+	}
+
+	inline uint16_t Pack565(const uint8_t* pColor)
+	{
+		return (static_cast<uint16_t>(((pColor[0] >> 3) << 11) | ((pColor[1] >> 2) << 5) | (pColor[2] >> 3)));
+	}
+
+	inline void Unpack565(uint16_t uiColor, GLint* pColor)
+	{
+		const GLint r = (uiColor >> 11) & 31;
+		const GLint g = (uiColor >> 5) & 63;
+		const GLint b = uiColor & 31;
+		pColor[0] = (r << 3) | (r >> 2);
+		pColor[1] = (g << 2) | (g >> 4);
+		pColor[2] = (b << 3) | (b >> 2);
+	}
+
+	// Bounding box endpoints inset by 1/16, good enough for terrain and model albedo
+	void EncodeBC1(const uint8_t Block[16][4], uint8_t* pOut)
+	{
+		uint8_t Min[3] = { 255, 255, 255 };
+		uint8_t Max[3] = { 0, 0, 0 };
+
+		for (GLint i = 0; i < 16; i++)
+		{
+			for (GLint c = 0; c < 3; c++)
+			{
+				Min[c] = std::min(Min[c], Block[i][c]);
+				Max[c] = std::max(Max[c], Block[i][c]);
+			}
+		}
+
+		for (GLint c = 0; c < 3; c++)
+		{
+			const uint8_t uiInset = static_cast<uint8_t>((Max[c] - Min[c]) >> 4);
+			Min[c] = static_cast<uint8_t>(Min[c] + uiInset);
+			Max[c] = static_cast<uint8_t>(Max[c] - uiInset);
+		}
+
+		const uint16_t c0 = Pack565(Max);
+		const uint16_t c1 = Pack565(Min);
+
+		uint32_t uiIndices = 0;
+
+		if (c0 != c1)
+		{
+			GLint Palette[4][3];
+			Unpack565(c0, Palette[0]);
+			Unpack565(c1, Palette[1]);
+			for (GLint c = 0; c < 3; c++)
+			{
+				Palette[2][c] = (2 * Palette[0][c] + Palette[1][c]) / 3;
+				Palette[3][c] = (Palette[0][c] + 2 * Palette[1][c]) / 3;
+			}
+
+			for (GLint i = 0; i < 16; i++)
+			{
+				GLint iBest = 0;
+				GLint iBestDist = INT32_MAX;
+
+				for (GLint p = 0; p < 4; p++)
+				{
+					const GLint dr = Block[i][0] - Palette[p][0];
+					const GLint dg = Block[i][1] - Palette[p][1];
+					const GLint db = Block[i][2] - Palette[p][2];
+					const GLint iDist = dr * dr + dg * dg + db * db;
+					if (iDist < iBestDist)
+					{
+						iBestDist = iDist;
+						iBest = p;
+					}
+				}
+
+				uiIndices |= static_cast<uint32_t>(iBest) << (i * 2);
+			}
+		}
+
+		std::memcpy(pOut + 0, &c0, sizeof(c0));
+		std::memcpy(pOut + 2, &c1, sizeof(c1));
+		std::memcpy(pOut + 4, &uiIndices, sizeof(uiIndices));
+	}
+
+	// 8 value mode, a0 > a1
+	void EncodeBC4(const uint8_t Values[16], uint8_t* pOut)
+	{
+		uint8_t uiMin = 255;
+		uint8_t uiMax = 0;
+
+		for (GLint i = 0; i < 16; i++)
+		{
+			uiMin = std::min(uiMin, Values[i]);
+			uiMax = std::max(uiMax, Values[i]);
+		}
+
+		pOut[0] = uiMax;
+		pOut[1] = uiMin;
+
+		uint64_t uiIndices = 0;
+
+		if (uiMax != uiMin)
+		{
+			const GLint iRange = uiMax - uiMin;
+
+			for (GLint i = 0; i < 16; i++)
+			{
+				// Position along a0 -> a1 in sevenths, then remapped to the BC4 index order
+				const GLint iStep = ((uiMax - Values[i]) * 7 + iRange / 2) / iRange;
+				const GLint iIndex = (iStep == 0) ? 0 : (iStep == 7) ? 1 : iStep + 1;
+				uiIndices |= static_cast<uint64_t>(iIndex) << (i * 3);
+			}
+		}
+
+		for (GLint i = 0; i < 6; i++)
+		{
+			pOut[2 + i] = static_cast<uint8_t>(uiIndices >> (i * 8));
+		}
+	}
+
+	void EncodeBlock(const uint8_t Block[16][4], GLint iChannelsBPP, uint8_t* pOut)
+	{
+		uint8_t Channel[16];
+
+		switch (iChannelsBPP)
+		{
+		case 1:
+			for (GLint i = 0; i < 16; i++) Channel[i] = Block[i][0];
+			EncodeBC4(Channel, pOut);
+			break;
+
+		case 2:
+			for (GLint i = 0; i < 16; i++) Channel[i] = Block[i][0];
+			EncodeBC4(Channel, pOut);
+			for (GLint i = 0; i < 16; i++) Channel[i] = Block[i][1];
+			EncodeBC4(Channel, pOut + 8);
+			break;
+
+		case 3:
+			EncodeBC1(Block, pOut);
+			break;
+
+		case 4:
+			for (GLint i = 0; i < 16; i++) Channel[i] = Block[i][3];
+			EncodeBC4(Channel, pOut);
+			EncodeBC1(Block, pOut + 8);
+			break;
+		}
+	}
+
+	// 2x2 box filter, odd edges are clamped
+	void Downsample(const std::vector<GLubyte>& vSrc, GLint iWidth, GLint iHeight, GLint iChannelsBPP, std::vector<GLubyte>& vDst, GLint& iOutWidth, GLint& iOutHeight)
+	{
+		iOutWidth = std::max(iWidth / 2, 1);
+		iOutHeight = std::max(iHeight / 2, 1);
+		vDst.resize(static_cast<size_t>(iOutWidth) * iOutHeight * iChannelsBPP);
+
+		for (GLint y = 0; y < iOutHeight; y++)
+		{
+			const GLint y0 = std::min(y * 2, iHeight - 1);
+			const GLint y1 = std::min(y * 2 + 1, iHeight - 1);
+
+			for (GLint x = 0; x < iOutWidth; x++)
+			{
+				const GLint x0 = std::min(x * 2, iWidth - 1);
+				const GLint x1 = std::min(x * 2 + 1, iWidth - 1);
+
+				for (GLint c = 0; c < iChannelsBPP; c++)
+				{
+					const GLint iSum = vSrc[(static_cast<size_t>(y0) * iWidth + x0) * iChannelsBPP + c] +
+						vSrc[(static_cast<size_t>(y0) * iWidth + x1) * iChannelsBPP + c] +
+						vSrc[(static_cast<size_t>(y1) * iWidth + x0) * iChannelsBPP + c] +
+						vSrc[(static_cast<size_t>(y1) * iWidth + x1) * iChannelsBPP + c];
+
+					vDst[(static_cast<size_t>(y) * iOutWidth + x) * iChannelsBPP + c] = static_cast<GLubyte>((iSum + 2) / 4);
+				}
+			}
+		}
+	}
+}
+
+void CTextureCache::SetEnabled(bool bEnabled)
+{
+	ms_bEnabled = bEnabled;
+}
+
+bool CTextureCache::IsEnabled()
+{
+	return (ms_bEnabled);
+}
+
+void CTextureCache::SetDirectory(const std::string& stDirectory)
+{
+	ms_stDirectory = stDirectory;
+}
+
+const std::string& CTextureCache::GetDirectory()
+{
+	return (ms_stDirectory);
+}
+
+std::string CTextureCache::GetCachePath(uint64_t uiKey)
+{
+	char szName[32];
+	snprintf(szName, sizeof(szName), "%016llx.btex", static_cast<unsigned long long>(uiKey));
+	return ((std::filesystem::path(ms_stDirectory) / szName).string());
+}
+
+uint64_t CTextureCache::GetKey(const std::string& stSourceFile)
+{
+	CMappedFile file;
+	if (!file.Open(stSourceFile))
+	{
+		return (0);
+	}
+
+	uint64_t uiHash = HashBytes(FNV_OFFSET_BASIS, file.GetData(), file.GetSize());
+	uiHash = HashBytes(uiHash, reinterpret_cast<const uint8_t*>(&TEXTURE_CACHE_IMPORT_OPTIONS), sizeof(TEXTURE_CACHE_IMPORT_OPTIONS));
+
+	return (uiHash ? uiHash : 1);
+}
+
+bool CTextureCache::Load(uint64_t uiKey, TCompressedImage& image)
+{
+	const std::string stPath = GetCachePath(uiKey);
+
+	std::ifstream file(stPath, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+	{
+		return (false); // Plain miss
+	}
+
+	const size_t iFileSize = static_cast<size_t>(file.tellg());
+	file.seekg(0);
+
+	TTextureCacheHeader header{};
+	if (iFileSize < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+	{
+		return (false);
+	}
+
+	if (header.uiMagic != TEXTURE_CACHE_MAGIC || header.uiVersion != TEXTURE_CACHE_VERSION || header.uiKey != uiKey || header.uiLevels == 0)
+	{
+		sys_err("CTextureCache::Load: %s is stale or corrupted, it will be rebuilt", stPath.c_str());
+		return (false);
+	}
+
+	image.vLevels.resize(header.uiLevels);
+	if (!file.read(reinterpret_cast<char*>(image.vLevels.data()), header.uiLevels * sizeof(TTextureCacheLevel)))
+	{
+		return (false);
+	}
+
+	const size_t iDataOffset = sizeof(header) + header.uiLevels * sizeof(TTextureCacheLevel);
+	const size_t iDataSize = iFileSize - iDataOffset;
+
+	for (const auto& level : image.vLevels)
+	{
+		if (level.uiOffset > iDataSize || level.uiSize > iDataSize - level.uiOffset)
+		{
+			sys_err("CTextureCache::Load: %s has a level out of range", stPath.c_str());
+			return (false);
+		}
+	}
+
+	image.vData.resize(iDataSize);
+	if (!file.read(reinterpret_cast<char*>(image.vData.data()), static_cast<std::streamsize>(iDataSize)))
+	{
+		return (false);
+	}
+
+	image.eFormat = header.uiFormat;
+	image.iWidth = static_cast<GLint>(header.uiWidth);
+	image.iHeight = static_cast<GLint>(header.uiHeight);
+	image.iChannelsBPP = static_cast<GLint>(header.uiChannels);
+	return (true);
+}
+
+bool CTextureCache::Store(uint64_t uiKey, const TCompressedImage& image)
+{
+	std::error_code ec;
+	std::filesystem::create_directories(ms_stDirectory, ec);
+
+	const std::string stPath = GetCachePath(uiKey);
+	const std::string stTempPath = stPath + ".tmp";
+
+	TTextureCacheHeader header{};
+	header.uiMagic = TEXTURE_CACHE_MAGIC;
+	header.uiVersion = TEXTURE_CACHE_VERSION;
+	header.uiKey = uiKey;
+	header.uiFormat = image.eFormat;
+	header.uiWidth = static_cast<uint32_t>(image.iWidth);
+	header.uiHeight = static_cast<uint32_t>(image.iHeight);
+	header.uiChannels = static_cast<uint32_t>(image.iChannelsBPP);
+	header.uiLevels = static_cast<uint32_t>(image.vLevels.size());
+
+	{
+		std::ofstream file(stTempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			sys_err("CTextureCache::Store: Failed to open %s for writing", stTempPath.c_str());
+			return (false);
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(image.vLevels.data()), image.vLevels.size() * sizeof(TTextureCacheLevel));
+		file.write(reinterpret_cast<const char*>(image.vData.data()), static_cast<std::streamsize>(image.vData.size()));
+
+		if (!file.good())
+		{
+			sys_err("CTextureCache::Store: Failed to write %s", stTempPath.c_str());
+			return (false);
+		}
+	}
+
+	// Written aside first so a concurrent reader never sees a partial entry
+	std::filesystem::rename(stTempPath, stPath, ec);
+	if (ec)
+	{
+		std::filesystem::remove(stTempPath, ec);
+		return (false);
+	}
+
+	return (true);
+}
+
+void CTextureCache::EncodeLevel(const GLubyte* pPixels, GLint iWidth, GLint iHeight, GLint iChannelsBPP, uint8_t* pOut, size_t iNumThreads)
+{
+	const GLint iBlocksX = (iWidth + 3) / 4;
+	const GLint iBlocksY = (iHeight + 3) / 4;
+	const size_t iBlockSize = GetBlockSize(iChannelsBPP);
+
+	std::atomic<GLint> iNextRow{ 0 };
+
+	auto EncodeRows = [&]()
+		{
+			uint8_t Block[16][4];
+
+			for (GLint by = iNextRow++; by < iBlocksY; by = iNextRow++)
+			{
+				for (GLint bx = 0; bx < iBlocksX; bx++)
+				{
+					// Blocks hanging over the edge repeat the last row/column
+					for (GLint i = 0; i < 16; i++)
+					{
+						const GLint x = std::min(bx * 4 + (i & 3), iWidth - 1);
+						const GLint y = std::min(by * 4 + (i >> 2), iHeight - 1);
+						const GLubyte* pSrc = pPixels + (static_cast<size_t>(y) * iWidth + x) * iChannelsBPP;
+
+						Block[i][0] = pSrc[0];
+						Block[i][1] = iChannelsBPP > 1 ? pSrc[1] : 0;
+						Block[i][2] = iChannelsBPP > 2 ? pSrc[2] : 0;
+						Block[i][3] = iChannelsBPP > 3 ? pSrc[3] : 255;
+					}
+
+					EncodeBlock(Block, iChannelsBPP, pOut + (static_cast<size_t>(by) * iBlocksX + bx) * iBlockSize);
+				}
+			}
+		};
+
+	const size_t iThreads = std::min(iNumThreads, static_cast<size_t>(iBlocksY));
+	if (iThreads <= 1)
+	{
+		EncodeRows();
+		return;
+	}
+
+	std::vector<std::thread> vWorkers;
+	vWorkers.reserve(iThreads - 1);
+	for (size_t i = 1; i < iThreads; i++)
+	{
+		vWorkers.emplace_back(EncodeRows);
+	}
+
+	EncodeRows();
+
+	for (auto& worker : vWorkers)
+	{
+		worker.join();
+	}
+}
+
+bool CTextureCache::Compress(const GLubyte* pPixels, GLint iWidth, GLint iHeight, GLint iChannelsBPP, TCompressedImage& image, size_t iNumThreads)
+{
+	const GLenum eFormat = GetCompressedFormat(iChannelsBPP);
+	if (!eFormat || !pPixels || iWidth <= 0 || iHeight <= 0)
+	{
+		return (false);
+	}
+
+	if (iNumThreads == 0)
+	{
+		iNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	const size_t iBlockSize = GetBlockSize(iChannelsBPP);
+	const GLint iLevels = static_cast<GLint>(std::floor(std::log2(std::max(iWidth, iHeight)))) + 1;
+
+	image.eFormat = eFormat;
+	image.iWidth = iWidth;
+	image.iHeight = iHeight;
+	image.iChannelsBPP = iChannelsBPP;
+	image.vLevels.resize(iLevels);
+
+	// Lay out every level first so the data is allocated once
+	size_t iTotalSize = 0;
+	for (GLint i = 0; i < iLevels; i++)
+	{
+		TTextureCacheLevel& level = image.vLevels[i];
+		level.uiWidth = static_cast<uint32_t>(std::max(iWidth >> i, 1));
+		level.uiHeight = static_cast<uint32_t>(std::max(iHeight >> i, 1));
+		level.uiOffset = iTotalSize;
+		level.uiSize = static_cast<uint64_t>((level.uiWidth + 3) / 4) * ((level.uiHeight + 3) / 4) * iBlockSize;
+		iTotalSize += static_cast<size_t>(level.uiSize);
+	}
+	image.vData.resize(iTotalSize);
+
+	std::vector<GLubyte> vLevel(pPixels, pPixels + static_cast<size_t>(iWidth) * iHeight * iChannelsBPP);
+	std::vector<GLubyte> vNext;
+	GLint iLevelWidth = iWidth;
+	GLint iLevelHeight = iHeight;
+
+	for (GLint i = 0; i < iLevels; i++)
+	{
+		EncodeLevel(vLevel.data(), iLevelWidth, iLevelHeight, iChannelsBPP, image.vData.data() + image.vLevels[i].uiOffset, iNumThreads);
+
+		if (i + 1 < iLevels)
+		{
+			Downsample(vLevel, iLevelWidth, iLevelHeight, iChannelsBPP, vNext, iLevelWidth, iLevelHeight);
+			vLevel.swap(vNext);
+		}
+	}
+
+	return (true);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*
+ * On-disk cache of GPU ready textures
+ *
+ * [TTextureCacheHeader][TTextureCacheLevel x levels][block data]
+ *
+ * Entries are keyed by a hash of the source file bytes and the import options, so an edited
+ * source or a new encoder version simply misses and is rebuilt. The whole mip chain is stored
+ * block compressed and uploaded as is with glCompressedTextureSubImage2D.
+ *
+ *  - 1 channel:  BC4 (RGTC1)
+ *  - 2 channels: BC5 (RGTC2)
+ *  - 3 channels: BC1 (DXT1)
+ *  - 4 channels: BC3 (DXT5)
+ *
+ * Off until SetEnabled(true). The format only follows the channel count, so a 3 channel normal
+ * or data map would end up as BC1; enable it only for sets where every texture is colour data.
+ */
+constexpr uint32_t TEXTURE_CACHE_MAGIC = 0x58455442; // "BTEX"
+constexpr uint32_t TEXTURE_CACHE_VERSION = 1;
+
+#pragma pack(push, 1)
+typedef struct STextureCacheHeader
+{
+	uint32_t uiMagic;
+	uint32_t uiVersion;
+	uint64_t uiKey;
+	uint32_t uiFormat;		// GL compressed internal format
+	uint32_t uiWidth;
+	uint32_t uiHeight;
+	uint32_t uiChannels;	// Of the source image
+	uint32_t uiLevels;
+	uint32_t uiReserved[3];
+} TTextureCacheHeader;
+
+typedef struct STextureCacheLevel
+{
+	uint32_t uiWidth;
+	uint32_t uiHeight;
+	uint64_t uiOffset;		// From the start of the block data
+	uint64_t uiSize;
+} TTextureCacheLevel;
+#pragma pack(pop)
+
+typedef struct SCompressedImage
+{
+	GLenum eFormat;
+	GLint iWidth;
+	GLint iHeight;
+	GLint iChannelsBPP;
+	std::vector<TTextureCacheLevel> vLevels;
+	std::vector<uint8_t> vData;
+
+	SCompressedImage()
+	{
+		eFormat = 0;
+		iWidth = 0;
+		iHeight = 0;
+		iChannelsBPP = 0;
+	}
+} TCompressedImage;
+
+class CTextureCache
+{
+public:
+	static void SetEnabled(bool bEnabled);
+	static bool IsEnabled();
+	static void SetDirectory(const std::string& stDirectory);
+	static const std::string& GetDirectory();
+
+	// Hash of the source bytes and import options, 0 if the source can't be read
+	static uint64_t GetKey(const std::string& stSourceFile);
+
+	static bool Load(uint64_t uiKey, TCompressedImage& image);
+	static bool Store(uint64_t uiKey, const TCompressedImage& image);
+
+	// Builds the mip chain and block compresses every level, iNumThreads 0 uses every core
+	static bool Compress(const GLubyte* pPixels, GLint iWidth, GLint iHeight, GLint iChannelsBPP, TCompressedImage& image, size_t iNumThreads = 0);
+
+protected:
+	static std::string GetCachePath(uint64_t uiKey);
+	static void EncodeLevel(const GLubyte* pPixels, GLint iWidth, GLint iHeight, GLint iChannelsBPP, uint8_t* pOut, size_t iNumThreads);
+
+private:
+	static bool ms_bEnabled;
+	static std::string ms_stDirectory;
+};
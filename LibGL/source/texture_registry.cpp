@@ -0,0 +1,115 @@
+#include "stdafx.h"
+#include "texture_registry.h"
+#include <filesystem>
+#include <algorithm>
+
+std::unordered_map<std::string, CTexture*> CTextureRegistry::ms_mByKey;
+std::unordered_map<CTexture*, CTextureRegistry::TTextureEntry> CTextureRegistry::ms_mEntries;
+
+std::string CTextureRegistry::GetKey(const std::string& stFileName, GLenum eTarget)
+{
+	// Different spellings of the same file ("a/../b.png", "B.PNG" on Windows) share one entry
+	std::error_code ec;
+	std::filesystem::path fsPath = std::filesystem::weakly_canonical(stFileName, ec);
+	std::string stPath = ec ? std::filesystem::path(stFileName).lexically_normal().generic_string() : fsPath.generic_string();
+
+#if defined(_WIN64)
+	std::transform(stPath.begin(), stPath.end(), stPath.begin(), [](unsigned char c) { return (static_cast<char>(std::tolower(c))); });
+#endif
+
+	return (stPath + "#" + std::to_string(eTarget));
+}
+
+CTexture* CTextureRegistry::Acquire(const std::string& stFileName, GLenum eTarget, bool& bCreated)
+{
+	const std::string stKey = GetKey(stFileName, eTarget);
+
+	auto it = ms_mByKey.find(stKey);
+	if (it != ms_mByKey.end())
+	{
+		ms_mEntries[it->second].uiRefs++;
+		bCreated = false;
+		return (it->second);
+	}
+
+	CTexture* pTexture = new CTexture(stFileName, eTarget);
+	ms_mByKey[stKey] = pTexture;
+	ms_mEntries[pTexture] = { stKey, 1 };
+
+	bCreated = true;
+	return (pTexture);
+}
+
+CTexture* CTextureRegistry::AcquireExisting(const std::string& stFileName, GLenum eTarget)
+{
+	auto it = ms_mByKey.find(GetKey(stFileName, eTarget));
+	if (it == ms_mByKey.end())
+	{
+		return (nullptr);
+	}
+
+	ms_mEntries[it->second].uiRefs++;
+	return (it->second);
+}
+
+CTexture* CTextureRegistry::Adopt(CTexture* pTexture)
+{
+	if (pTexture)
+	{
+		ms_mEntries[pTexture] = { std::string(), 1 };
+	}
+
+	return (pTexture);
+}
+
+void CTextureRegistry::Release(CTexture*& pTexture)
+{
+	if (!pTexture)
+	{
+		return;
+	}
+
+	auto it = ms_mEntries.find(pTexture);
+	if (it == ms_mEntries.end())
+	{
+		sys_err("CTextureRegistry::Release: Texture %p was not acquired from the registry", static_cast<void*>(pTexture));
+		pTexture = nullptr;
+		return;
+	}
+
+	if (--it->second.uiRefs == 0)
+	{
+		if (!it->second.stKey.empty())
+		{
+			ms_mByKey.erase(it->second.stKey);
+		}
+
+		ms_mEntries.erase(it);
+		delete pTexture;
+	}
+
+	pTexture = nullptr;
+}
+
+void CTextureRegistry::Forget(CTexture* pTexture)
+{
+	auto it = ms_mEntries.find(pTexture);
+	if (it == ms_mEntries.end() || it->second.stKey.empty())
+	{
+		return;
+	}
+
+	auto itKey = ms_mByKey.find(it->second.stKey);
+	if (itKey != ms_mByKey.end() && itKey->second == pTexture)
+	{
+		ms_mByKey.erase(itKey);
+	}
+
+	// From now on it's released like an adopted texture
+	it->second.stKey.clear();
+}
+
+size_t CTextureRegistry::GetCount()
+{
+	return (ms_mEntries.size());
+}
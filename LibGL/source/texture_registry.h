@@ -0,0 +1,54 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+class CTexture;
+
+/*
+ * Process wide owner of the file backed textures
+ *
+ * Textures are keyed by the canonical path of their file and the import options (target),
+ * so every image is decoded and uploaded once no matter how many materials or terrain
+ * layers use it. Users Acquire a reference and Release it instead of deleting the texture.
+ * Textures without a file (generated, embedded) can be handed over with Adopt so the same
+ * Release works on every pointer.
+ *
+ * GL thread only.
+ */
+class CTextureRegistry
+{
+public:
+	// Shared texture for the file, bCreated is set when it was just registered and still has to be loaded
+	static CTexture* Acquire(const std::string& stFileName, GLenum eTarget, bool& bCreated);
+
+	// Same as Acquire but never creates, nullptr when the file is not registered yet
+	static CTexture* AcquireExisting(const std::string& stFileName, GLenum eTarget);
+
+	// Takes ownership of a texture that has no file, Release deletes it
+	static CTexture* Adopt(CTexture* pTexture);
+
+	// Drops one reference and nulls the pointer, the last reference deletes the texture
+	static void Release(CTexture*& pTexture);
+
+	// Unregisters the file of a texture that failed to load so the next Acquire decodes it again.
+	// References already handed out stay valid until they are released
+	static void Forget(CTexture* pTexture);
+
+	static size_t GetCount();
+
+protected:
+	static std::string GetKey(const std::string& stFileName, GLenum eTarget);
+
+private:
+	typedef struct STextureEntry
+	{
+		std::string stKey;		// Empty for adopted textures
+		uint32_t uiRefs;
+	} TTextureEntry;
+
+	static std::unordered_map<std::string, CTexture*> ms_mByKey;
+	static std::unordered_map<CTexture*, TTextureEntry> ms_mEntries;
+};
@@ -1,5 +1,8 @@
 #include "stdafx.h"
 #include "utils.h"
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
 
 bool IsGLVersionHigher(int MajorVer, int MinorVer)
 {
@@ -47,16 +50,38 @@ std::string GetDirFromFilename(const std::string& Filename)
 
 }
 
-char* ReadBinaryFile(const char* pFilename, int& size)
+// fopen_s and strerror_s only exist on the MSVC runtime
+static FILE* OpenFile(const char* pFilename, const char* pMode, int& err)
 {
+#if defined(_WIN64) || defined(_WIN32)
     FILE* f = NULL;
+    err = fopen_s(&f, pFilename, pMode);
+    return f;
+#else
+    FILE* f = fopen(pFilename, pMode);
+    err = f ? 0 : errno;
+    return f;
+#endif
+}
 
-    errno_t err = fopen_s(&f, pFilename, "rb");
+static void GetErrorString(int err, char* buf, size_t size)
+{
+#if defined(_WIN64) || defined(_WIN32)
+    strerror_s(buf, size, err);
+#else
+    snprintf(buf, size, "%s", strerror(err));
+#endif
+}
+
+char* ReadBinaryFile(const char* pFilename, int& size)
+{
+    int err = 0;
+    FILE* f = OpenFile(pFilename, "rb", err);
 
     if (!f)
     {
         char buf[256] = { 0 };
-        strerror_s(buf, sizeof(buf), err);
+        GetErrorString(err, buf, sizeof(buf));
         sys_err("Error opening '%s': %s\n", pFilename, buf);
         exit(0);
     }
@@ -67,8 +92,9 @@ char* ReadBinaryFile(const char* pFilename, int& size)
     if (error)
     {
         char buf[256] = { 0 };
-        strerror_s(buf, sizeof(buf), err);
+        GetErrorString(errno, buf, sizeof(buf));
         sys_err("Error getting file stats: %s\n", buf);
+        fclose(f);
         return NULL;
     }
 
@@ -82,7 +108,7 @@ char* ReadBinaryFile(const char* pFilename, int& size)
     if (bytes_read != size)
     {
         char buf[256] = { 0 };
-        strerror_s(buf, sizeof(buf), err);
+        GetErrorString(errno, buf, sizeof(buf));
         sys_err("Read file error file: %s\n", buf);
         exit(0);
     }
@@ -95,9 +121,8 @@ char* ReadBinaryFile(const char* pFilename, int& size)
 
 void WriteBinaryFile(const char* pFilename, const void* pData, int size)
 {
-    FILE* f = NULL;
-
-    errno_t err = fopen_s(&f, pFilename, "wb");
+    int err = 0;
+    FILE* f = OpenFile(pFilename, "wb", err);
 
     if (!f)
     {
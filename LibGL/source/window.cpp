@@ -31,8 +31,7 @@ CWindow::CWindow()
 	m_bMouseState.at(1) = GLFW_RELEASE;
 	m_bIsMouseFocusedIn = true;
 	m_eBrushType = BRUSH_TYPE_NONE;
-	m_fBrushInterval = 0.5f;
-	m_fBrushTimer = 0.0f;
+	m_bBrushStroke = false;
 #if defined(_WIN64)
 	m_uiRandSeed = 0;
 #else
@@ -155,6 +154,8 @@ void CWindow::WindowSwapAndBufferEvents()
 {
 	glfwSwapBuffers(m_pWindow);
 	glfwPollEvents();
+
+	CGLState::EndFrame();
 }
 
 GLFWwindow* CWindow::GetWindow()
@@ -188,13 +189,6 @@ void CWindow::mouse_button_callback(GLFWwindow* window, int button, int action,
 			appWnd->GetCamera()->SetLock(false);
 		}
 	}
-	if (button == GLFW_MOUSE_BUTTON_LEFT)
-	{
-		if (action == GLFW_PRESS || action == GLFW_REPEAT)
-		{
-			CScreen::Instance().ApplyTerrainBrush(appWnd->GetBrushType());
-		}
-	}
 }
 
 void CWindow::mouse_callback(GLFWwindow* window, double xpos, double ypos)
@@ -215,8 +209,6 @@ void CWindow::scroll_callback(GLFWwindow* window, double xoffset, double yoffset
 
 void CWindow::ProcessInput(float deltaTime)
 {
-	m_fBrushTimer += deltaTime;
-
 	if (glfwGetKey(m_pWindow, GLFW_KEY_W))
 	{
 		GetCamera()->ProcessKeyboardInput(DIRECTION_FORWARD, deltaTime);
@@ -236,20 +228,14 @@ void CWindow::ProcessInput(float deltaTime)
 
 	if (glfwGetMouseButton(GetWindow(), GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS)
 	{
-		if (m_eBrushType == BRUSH_TYPE_TEXTURE)
-		{
-			m_fBrushInterval = 0.1f;
-		}
-		else
-		{
-			m_fBrushInterval = 0.5f;
-		}
-
-		if (m_fBrushTimer >= m_fBrushInterval)
-		{
-			CScreen::Instance().ApplyTerrainBrush(GetBrushType());
-			m_fBrushTimer = 0.0f;  // Reset the timer after applying the brush
-		}
+		// Stamps are spaced along the cursor path and flushed once per frame
+		CScreen::Instance().UpdateBrushStroke(GetBrushType(), deltaTime);
+		m_bBrushStroke = true;
+	}
+	else if (m_bBrushStroke)
+	{
+		CScreen::Instance().EndBrushStroke();
+		m_bBrushStroke = false;
 	}
 }
 
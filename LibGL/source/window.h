@@ -68,8 +68,7 @@ private:
 	std::array<bool, 1024> m_bKeyBools;
 	CCamera* m_pCamera;
 	CFrameBuffer* m_pFrameBufObj;
-	GLfloat m_fBrushInterval;	// Time interval in seconds for brush application
-	GLfloat m_fBrushTimer;		// Timer to track elapsed time
+	bool m_bBrushStroke;		// Left button held down over the terrain
 
 	EBrushType m_eBrushType;
 };
\ No newline at end of file
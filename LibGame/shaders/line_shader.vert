@@ -3,11 +3,13 @@
 layout (location = 0) in vec3 aPos;     // Vertex position
 layout (location = 1) in vec4 aColors;     // Vertex position
 
-uniform mat4 ViewMatrix;                // Line color
+// Shared per frame values, filled by CSceneConstants (scene_constants.h)
+#include "scene_constants.glsl"
+
 out vec4 v4Color;
 
 void main()
 {
-    gl_Position = ViewMatrix * vec4(aPos, 1.0);
+    gl_Position = m4SceneViewProj * vec4(aPos, 1.0);
     v4Color = aColors;
 }
@@ -0,0 +1,18 @@
+#version 460 core
+
+layout (location = 0) in vec3 Position;
+layout (location = 1) in vec3 aNormals;
+layout (location = 2) in vec2 TexCoord;
+
+// Per instance, filled by CMesh::Render(uiNumInstances, ...)
+layout (location = 3) in mat4 InstanceWVP;
+layout (location = 7) in mat4 InstanceWorld;
+
+out vec2 TexCoord0;
+
+void main()
+{
+    // CMatrix4Df is row major, each attribute location holds a row, so the vector goes on the left
+    gl_Position = vec4(Position, 1.0) * InstanceWVP;
+    TexCoord0 = TexCoord;
+}
@@ -4,12 +4,15 @@ layout (location = 0) in vec3 Position;
 layout (location = 1) in vec3 aNormals;
 layout (location = 2) in vec2 TexCoord;
 
-uniform mat4 gWVP;
+// Shared per frame values, filled by CSceneConstants (scene_constants.h)
+#include "scene_constants.glsl"
+
+uniform mat4 gWorld;
 
 out vec2 TexCoord0;
 
 void main()
 {
-    gl_Position = gWVP * vec4(Position, 1.0);
+    gl_Position = m4SceneViewProj * gWorld * vec4(Position, 1.0);
     TexCoord0 = TexCoord;
 }
@@ -0,0 +1,16 @@
+// SceneConstants uniform block, expanded into the stages by ReadShaderSource (#include "scene_constants.glsl")
+// Layout is TSceneConstants in LibGL/source/shader_blocks.h, CShader checks the block size after linking
+layout(std140, row_major, binding = 0) uniform SceneConstants
+{
+	mat4 m4SceneView;
+	mat4 m4SceneProj;
+	mat4 m4SceneViewProj;
+	mat4 m4SceneInvView;
+	mat4 m4SceneInvProj;
+	mat4 m4SceneInvViewProj;
+	vec4 v4SceneCameraPos;     // xyz position, w unused
+	vec4 v4SceneLightDir;      // xyz normalized direction, w unused
+	vec4 v4SceneLightColor;    // rgb, a unused
+	vec4 v4SceneFogColor;      // rgb, a unused
+	vec4 v4SceneScreen;        // xy resolution, z time in seconds, w frame time
+};
@@ -4,16 +4,13 @@ out vec4 FragColor;
 
 in vec2 TexCoords;
 
-uniform vec2 v2Resolution;
-uniform mat4 m4Inv_proj;
-uniform mat4 m4Inv_view;
+// Shared per frame values, filled by CSceneConstants (scene_constants.h)
+#include "scene_constants.glsl"
 
-uniform vec3 v3LightDir;
 uniform vec3 v3SkyColorTop;
 uniform vec3 v3SkyColorBottom;
 
 uniform bool bIsNight = true;
-uniform float fTime;
 
 uniform float fStarDensity = 1.5;    // [0.5 - 3.0]
 uniform float fStarBrightness = 1.0; // [0.1 - 2.0]
@@ -24,7 +21,7 @@ uniform float fSunCoreIntensity = 2.0;
 
 const float fSunEdgeSoftness = 0.01; // Reduced softness for sharper edges
 
-#define SUN_DIR v3LightDir
+#define SUN_DIR v4SceneLightDir.xyz
 
 #define STAR_SIZE 0.25
 
@@ -230,7 +227,7 @@ vec3 ComputeClipSpaceCoord(ivec2 v2FragCoord)
 {
     // Flip the Y-axis (since OpenGL's NDC has [0, 1] at the bottom, not the top)
     // Normalize to [-1,1] range in X/Y
-	vec2 ray_nds = 2.0f * vec2(v2FragCoord.xy) / v2Resolution.xy - 1.0f;
+	vec2 ray_nds = 2.0f * vec2(v2FragCoord.xy) / v4SceneScreen.xy - 1.0f;
 
     // 2) Flip Y because OpenGLs window coords origin is bottom-left
     //    but gl_FragCoord.y is bottom-left = 0, top = height.
@@ -303,7 +300,7 @@ vec4 ColorCubeMap(vec3 v3EndPos, const vec3 v3Dir)
     // --- 3) Add stars if its night ---
     if (bIsNight)
     {
-        float stars = generateStars(normalize(v3Dir), fStarDensity, fTime);
+        float stars = generateStars(normalize(v3Dir), fStarDensity, v4SceneScreen.z);
         float horizonFade = smoothstep(0.1, 0.4, abs(v3Dir.y));
         float sunFade = 1.0 - smoothstep(0.995, 1.0, dot(normalize(v3Dir), SUN_DIR));
         
@@ -331,11 +328,11 @@ void main()
 	vec4 v4RayClip = vec4(ComputeClipSpaceCoord(v2FragCoord), 1.0f);
 
     // 2) Unproject to view space
-	vec4 v4RayView = m4Inv_proj * v4RayClip;
+	vec4 v4RayView = m4SceneInvProj * v4RayClip;
 	v4RayView = vec4(v4RayView.xy, -1.0f, 0.0f);
 
     // 3) Unproject to world space and normalize
-	vec3 v3WorldDir = normalize((m4Inv_view * v4RayView).xyz);
+	vec3 v3WorldDir = normalize((m4SceneInvView * v4RayView).xyz);
 
     // 4) Flip X/Y if needed (undo the NDC flip)
     vec3 shadeDir = vec3(-v3WorldDir.x, -v3WorldDir.y, v3WorldDir.z);
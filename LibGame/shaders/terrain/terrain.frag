@@ -26,12 +26,12 @@ in vec3 v3WorldPos;
 in vec2 v2TexCoord;
 in vec3 v3Normal;
 
+// Shared per frame values, filled by CSceneConstants (scene_constants.h)
+#include "../scene_constants.glsl"
+
 uniform int iPatchIndex;
 
-uniform vec3 v3LightDirection;   // Direction of the light
-uniform vec3 v3LightColor;       // Color of the light
 uniform vec3 v3AmbientColor;     // Ambient light color
-uniform vec3 v3CameraPosition;   // Camera position (for specular lighting)
 uniform float fShininess;        // Shininess factor for specular highlights
 
 uniform vec3 u_HitPosition;
@@ -71,16 +71,16 @@ void main()
 
     // 5) simple phong lighting
     vec3 N = normalize(v3Normal);
-    vec3 L = normalize(v3LightDirection);
+    vec3 L = v4SceneLightDir.xyz;
     float diff = max(dot(N, L), 0.0);
-    vec3 diffuse = diff * v3LightColor * albedo;
+    vec3 diffuse = diff * v4SceneLightColor.rgb * albedo;
     vec3 ambient = v3AmbientColor * albedo;
 
     // specular
-    vec3 V = normalize(v3CameraPosition - v3WorldPos);
+    vec3 V = normalize(v4SceneCameraPos.xyz - v3WorldPos);
     vec3 R = reflect(-L, N);
     float spec = pow(max(dot(R, V), 0.0), fShininess);
-    vec3 specular = spec * v3LightColor;
+    vec3 specular = spec * v4SceneLightColor.rgb;
 
     float totalWeight = weights[0] + weights[1] + weights[2] + weights[3];
 
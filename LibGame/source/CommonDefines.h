@@ -1,3 +1,6 @@
 #pragma once
 
-#define ENABLE_USE_PYTHON
\ No newline at end of file
+#define ENABLE_USE_PYTHON
+
+// Linked shader programs are cached in cache/shaders, comment out to time a cold start
+#define ENABLE_PROGRAM_CACHE
\ No newline at end of file
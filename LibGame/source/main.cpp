@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "../../LibGL/source/shader.h"
+#include "../../LibGL/source/program_cache.h"
 
 #include "../../LibGL/source/screen.h"
 #include "../../LibGL/source/mesh.h"
@@ -7,6 +8,8 @@
 #include "../../LibTerrain/source/object.h"
 #include "../../LibTerrain/source/skybox.h"
 #include "../../LibTerrain/source/clouds_object.h"
+#include "../../LibTerrain/source/scene_constants.h"
+#include "../../LibTerrain/source/scatter.h"
 
 #include "userinterface.h"
 
@@ -40,6 +43,7 @@ CBaseTerrain* m_pTerrain;
 CWindow* app;
 std::unique_ptr<CMesh> pMesh;
 std::unique_ptr<CShader> pMeshShader;
+std::unique_ptr<CTerrainScatter> pScatter;
 std::vector<CTexture*> vTerrainTextures;
 GLuint terrainHandlesSSBO;
 std::vector<GLuint64> textureHandles;
@@ -97,9 +101,9 @@ static void FinalizeBindlessSetup()
 
 	// Create and fill SSBO
 	glGenBuffers(1, &terrainHandlesSSBO);
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, terrainHandlesSSBO);
+	CGLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, terrainHandlesSSBO);
 	glBufferData(GL_SHADER_STORAGE_BUFFER, textureHandles.size() * sizeof(GLuint64), textureHandles.data(), GL_STATIC_READ);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, terrainHandlesSSBO);
+	CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, terrainHandlesSSBO);
 
 	// After creating SSBO
 	GLuint64* handles = static_cast<GLuint64*>(
@@ -156,6 +160,26 @@ static void InitTerrain()
 	pMeshShader->AttachShader("shaders/model_shader.frag");
 	pMeshShader->LinkPrograms();
 
+	// Fixed seed, the props land on the same spots every run
+	pScatter = std::make_unique<CTerrainScatter>();
+	pScatter->Create(&CBaseTerrain::Instance(), 1);
+
+	TScatterLayer props{};
+	props.stName = "Props";
+	props.fMinDistance = 12.0f;
+	props.fDensity = 0.6f;
+	props.fHeightMin = -1000.0f;
+	props.fHeightMax = 1000.0f;
+	props.fSlopeMin = 0.0f;
+	props.fSlopeMax = 25.0f;
+	props.iSplatTexture = -1;
+	props.fSplatMinWeight = 0.5f;
+	props.fScaleMin = 0.8f;
+	props.fScaleMax = 1.2f;
+	props.fBoundsHeight = 10.0f;
+	props.fDrawDistance = 600.0f;
+	pScatter->AddLayer(props, pMesh.get());
+	pScatter->bRender = true;
 
 	//m_pTerrain->SaveToFile("resources/terrain/heightmap.png");
 }
@@ -164,8 +188,6 @@ bool bStuckCam = false;
 
 static void RenderSceneNew(const float deltaTime)
 {
-	CCameraManager::Instance().GetCurrentCamera()->OnRender();
-
 	if (bStuckCam)
 	{
 		SVector3Df vNewPos = m_pTerrain->ConstrainCameraToTerrain();
@@ -176,24 +198,25 @@ static void RenderSceneNew(const float deltaTime)
 	worldTransform->SetPosition(CScreen::Instance().GetIntersectionPoint());
 	CMatrix4Df World = worldTransform->GetMatrix();
 
-	CMatrix4Df View = CCameraManager::Instance().GetCurrentCamera()->GetMatrix();
-
-	CMatrix4Df Projection{};
-	Projection.InitPersProjTransform(CCameraManager::Instance().GetCurrentCamera()->GetPersProjInfo());
-
 	// Bind SSBO once per frame
-	//glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, terrainHandlesSSBO);
+	//CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, terrainHandlesSSBO);
 	CBaseTerrain::Instance().Render();
-	//glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+	//CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
 
-	CMatrix4Df WVP = Projection * View * World;
+	pScatter->Render();
+
+	// The view-projection half comes from SceneConstants
+	CMatrix4Df WVP = CCameraManager::Instance().GetCurrentCamera()->GetViewProjMatrix() * World;
 	pMeshShader->Use();
-	pMeshShader->setMat4("gWVP", WVP);
+	pMeshShader->setMat4("gWorld", World * pMesh->GetDequantizeMatrix());
 
 
 	auto scene = CObject::pScene;
 	if (scene->bRenderChar)
-		pMesh->Render();
+	{
+		PROFILE_SCOPE("Mesh Draw");
+		pMesh->Render(WVP);
+	}
 
 	double mouseX, mouseY;
 	GLint winW, winH;
@@ -211,6 +234,10 @@ int main()
 
 	SRANDOM();
 
+#if !defined(ENABLE_PROGRAM_CACHE)
+	CProgramCache::SetEnabled(false);
+#endif
+
 	app = new CWindow();
 	
 	if (!app->InitializeWindow("Terrain Engine", DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT))
@@ -224,14 +251,16 @@ int main()
 	InitTerrain();
 
     glFrontFace(GL_CCW);
-    glCullFace(GL_BACK);
-    glEnable(GL_CULL_FACE);
-    glEnable(GL_DEPTH_TEST);
-	glEnable(GL_MULTISAMPLE);
-	glEnable(GL_DEBUG_OUTPUT);
+    CGLState::CullFace(GL_BACK);
+    CGLState::Enable(GL_CULL_FACE);
+    CGLState::Enable(GL_DEPTH_TEST);
+	CGLState::Enable(GL_MULTISAMPLE);
+	CGLState::Enable(GL_DEBUG_OUTPUT);
 
 	CScreen* screen = new CScreen;
 
+	CProfiler::Create();
+
 	CUserInterface UI(app);
 
 	//Every scene object need these informations to be rendered
@@ -257,6 +286,11 @@ int main()
 
 	CObject::pScene = &scene;
 
+	if (!CSceneConstants::Create())
+	{
+		return (EXIT_FAILURE);
+	}
+
 	CSkyBox skyBox(app);
 	//CCloudsObject cloudsModel(&scene, &skyBox);
 
@@ -264,17 +298,27 @@ int main()
 	UI.AddObject(&skyBox);
 	//UI.AddObject(&cloudsModel);
 	UI.AddObject(m_pTerrain);
+	UI.AddObject(pScatter.get());
+
+	CProgramCache::LogStats();
 
 	app->SetFrameBuffer(SceneFBO);
 
 	while (app->WindowLoop())
 	{
+		CProfiler::BeginFrame();
+
 		scene.v3LightDir.normalize();
 		scene.v3LightPos = scene.v3LightDir * 1e6f + app->GetCamera()->GetPosition();
 
 		float frametime = 1 / ImGui::GetIO().Framerate;
 		app->ProcessInput(frametime);
 
+		// Settle the camera for the frame, then publish it with the light to every shader at once
+		CCamera* pCamera = CCameraManager::Instance().GetCurrentCamera();
+		pCamera->OnRender();
+		CSceneConstants::Update(scene, *pCamera, app->GetWidth(), app->GetHeight(), static_cast<float>(glfwGetTime()), frametime);
+
 		app->GetFrameBuffer()->BindForWriting();
 
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -299,11 +343,16 @@ int main()
 
 		app->GetFrameBuffer()->BindForWriting();
 		RenderSceneNew(frametime);
+		CScreen::Instance().FlushDebugDraw();
 		app->GetFrameBuffer()->UnBindWriting();
 
 		// Render UI on top
-		UI.Render();
+		{
+			PROFILE_SCOPE("ImGui");
+			UI.Render();
+		}
 
+		CProfiler::EndFrame();
 		app->WindowSwapAndBufferEvents();
 	}
 
@@ -313,9 +362,13 @@ int main()
 		tex->Destroy();
 	}
 
+	CSceneConstants::Destroy();
+	CProfiler::Destroy();
+
 	safe_delete(textureset);
 	safe_delete(SceneFBO);
 	safe_delete(screen);
+	pScatter.reset();
 	safe_delete(m_pTerrain);
 	safe_delete(app);
 
@@ -8,6 +8,7 @@
 #include "../../LibImageUI/ImGuiFileDialog.h"
 #include "../../LibImageUI/ImGuiFileDialogConfig.h"
 #include "../../LibImageUI/imgui_internal.h"
+#include <string_view>
 
 
 #if defined(_WIN64)
@@ -47,6 +48,7 @@ CUserInterface::CUserInterface(CWindow* pWindow)
 	m_bShowDemonWindow = false;
 	m_bShowSceneWindow = true;
 	m_bShowSkyboxWindow = true;
+	m_bShowProfilerWindow = true;
 	m_bInitialized = false;
 }
 
@@ -263,6 +265,19 @@ void CUserInterface::RenderTerrainUI()
 		CWindow::Instance().SetBrushType(BRUSH_TYPE_ERASER);
 	}
 
+	ImGui::Spacing();
+	if (ImGui::Button("Auto Texture", buttonSize))
+	{
+		CBaseTerrain::Instance().GetGeoMipGrid()->AutoSplat();
+	}
+
+	ImGui::SameLine();
+	bool bAutoSplatOnSculpt = CBaseTerrain::Instance().GetGeoMipGrid()->IsAutoSplatOnSculpt();
+	if (ImGui::Checkbox("Auto Texture on Sculpt", &bAutoSplatOnSculpt))
+	{
+		CBaseTerrain::Instance().GetGeoMipGrid()->SetAutoSplatOnSculpt(bAutoSplatOnSculpt);
+	}
+
 	ImGui::Spacing();
 
 	static char filenameBuffer[128] = "resources/terrain/textureset.json";
@@ -299,6 +314,38 @@ void CUserInterface::RenderTerrainUI()
 		// close
 		ImGuiFileDialog::Instance()->Close();
 	}
+
+	ImGui::Spacing();
+
+	static char splatFilenameBuffer[128] = "resources/terrain/splatmap.bin";
+	ImGui::InputText("##Save Splatmap As", splatFilenameBuffer, IM_ARRAYSIZE(splatFilenameBuffer));
+
+	if (ImGui::Button("Save Splatmap", buttonSize))
+	{
+		CBaseTerrain::Instance().GetGeoMipGrid()->SaveSplatmaps(std::string(splatFilenameBuffer));
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Load Splatmap", buttonSize))
+	{
+		CBaseTerrain::Instance().GetGeoMipGrid()->LoadSplatmaps(std::string(splatFilenameBuffer));
+	}
+
+	ImGui::Spacing();
+
+	static char worldFilenameBuffer[128] = "resources/terrain/world.terrain";
+	ImGui::InputText("##Save World As", worldFilenameBuffer, IM_ARRAYSIZE(worldFilenameBuffer));
+
+	if (ImGui::Button("Save World", buttonSize))
+	{
+		CBaseTerrain::Instance().SaveWorld(std::string(worldFilenameBuffer));
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Load World", buttonSize))
+	{
+		CBaseTerrain::Instance().LoadWorld(std::string(worldFilenameBuffer));
+	}
 }
 
 void CUserInterface::RenderSceneUI()
@@ -341,6 +388,106 @@ void CUserInterface::RenderSkyBoxUI()
 	CSkyBox::Instance().SetGUI();
 }
 
+// One row per scope depth, scaled so dFrameTime fills the available width
+static void RenderProfilerTimeline(const char* szLabel, const TProfileFrame& frame, bool bGpu, double dFrameTime)
+{
+	uint32_t uiMaxDepth = 0;
+	for (const TProfileScope& scope : frame.vScopes)
+	{
+		uiMaxDepth = std::max(uiMaxDepth, scope.uiDepth);
+	}
+
+	ImGui::TextUnformatted(szLabel);
+
+	const float fRowHeight = ImGui::GetTextLineHeight() + 4.0f;
+	const float fWidth = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+	const ImVec2 v2Origin = ImGui::GetCursorScreenPos();
+	ImGui::InvisibleButton(szLabel, ImVec2(fWidth, fRowHeight * static_cast<float>(uiMaxDepth + 1)));
+
+	if (dFrameTime <= 0.0)
+	{
+		return;
+	}
+
+	ImDrawList* pDrawList = ImGui::GetWindowDrawList();
+	for (const TProfileScope& scope : frame.vScopes)
+	{
+		const double dStart = bGpu ? scope.dGpuStart : scope.dCpuStart;
+		const double dTime = bGpu ? scope.dGpuTime : scope.dCpuTime;
+
+		const float fX0 = v2Origin.x + static_cast<float>(dStart / dFrameTime) * fWidth;
+		const float fX1 = std::max(fX0 + 1.0f, v2Origin.x + static_cast<float>((dStart + dTime) / dFrameTime) * fWidth);
+		const float fY0 = v2Origin.y + static_cast<float>(scope.uiDepth) * fRowHeight;
+		const ImVec2 v2Min(fX0, fY0);
+		const ImVec2 v2Max(fX1, fY0 + fRowHeight - 1.0f);
+
+		// Same hue for the same scope on both rows and every frame
+		const float fHue = static_cast<float>(std::hash<std::string_view>{}(scope.szName) % 360) / 360.0f;
+		pDrawList->AddRectFilled(v2Min, v2Max, ImColor::HSV(fHue, 0.55f, 0.75f));
+
+		pDrawList->PushClipRect(v2Min, v2Max, true);
+		pDrawList->AddText(ImVec2(fX0 + 2.0f, fY0 + 2.0f), IM_COL32_WHITE, scope.szName);
+		pDrawList->PopClipRect();
+
+		if (ImGui::IsMouseHoveringRect(v2Min, v2Max))
+		{
+			ImGui::SetTooltip("%s: %.3f ms", scope.szName, dTime);
+		}
+	}
+}
+
+void CUserInterface::RenderProfilerUI()
+{
+	bool bPaused = CProfiler::IsPaused();
+	if (ImGui::Checkbox("Pause", &bPaused))
+	{
+		CProfiler::SetPaused(bPaused);
+	}
+
+	static char traceFilenameBuffer[128] = "profiler_trace.json";
+	ImGui::InputText("Trace File", traceFilenameBuffer, IM_ARRAYSIZE(traceFilenameBuffer));
+	if (ImGui::Button("Export Chrome Trace"))
+	{
+		CProfiler::ExportChromeTrace(std::string(traceFilenameBuffer));
+	}
+
+	const TProfileFrame* pFrame = CProfiler::GetLatestFrame();
+	if (!pFrame)
+	{
+		ImGui::Text("Waiting for GPU timings...");
+		return;
+	}
+
+	ImGui::Text("Frame %llu: CPU %.3f ms, GPU %.3f ms", static_cast<unsigned long long>(pFrame->ulFrame), pFrame->dCpuTime, pFrame->dGpuTime);
+
+	// Both timelines on one scale so the CPU and GPU bars can be compared directly
+	const double dFrameTime = std::max(pFrame->dCpuTime, pFrame->dGpuTime);
+	RenderProfilerTimeline("CPU", *pFrame, false, dFrameTime);
+	RenderProfilerTimeline("GPU", *pFrame, true, dFrameTime);
+
+	if (ImGui::BeginTable("##ProfilerScopes", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+	{
+		ImGui::TableSetupColumn("Scope");
+		ImGui::TableSetupColumn("CPU ms");
+		ImGui::TableSetupColumn("GPU ms");
+		ImGui::TableHeadersRow();
+
+		for (const TProfileScope& scope : pFrame->vScopes)
+		{
+			ImGui::TableNextRow();
+			ImGui::TableSetColumnIndex(0);
+			ImGui::SetCursorPosX(ImGui::GetCursorPosX() + static_cast<float>(scope.uiDepth) * ImGui::GetStyle().IndentSpacing);
+			ImGui::TextUnformatted(scope.szName);
+			ImGui::TableSetColumnIndex(1);
+			ImGui::Text("%.3f", scope.dCpuTime);
+			ImGui::TableSetColumnIndex(2);
+			ImGui::Text("%.3f", scope.dGpuTime);
+		}
+
+		ImGui::EndTable();
+	}
+}
+
 void CUserInterface::Render()
 {
 	for (auto obj : m_lObjectsUI)
@@ -396,10 +543,21 @@ void CUserInterface::Render()
 			}
 		}
 
+		if (m_bShowProfilerWindow)
+		{
+			if (ImGui::BeginTabItem("Profiler"))
+			{
+				RenderProfilerUI();
+				ImGui::EndTabItem();
+			}
+		}
+
 		ImGui::EndTabBar();
 	}
 
 	ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	ImGui::Text("Camera matrix rebuilds last frame: %u", CCameraManager::Instance().GetCurrentCamera()->GetLastFrameMatrixRecomputeCount());
+	ImGui::Text("GL state calls last frame: %u issued, %u elided", CGLState::GetLastFrameIssuedCount(), CGLState::GetLastFrameElidedCount());
 	ImGui::End();
 
 	//actual drawing
@@ -522,6 +680,11 @@ void CUserInterface::Update()
 				CSkyBox::Instance().bRender = !CSkyBox::Instance().bRender;
 			}
 
+			if (ImGui::MenuItem("Profiler"))
+			{
+				m_bShowProfilerWindow = !m_bShowProfilerWindow;
+			}
+
 			if (ImGui::MenuItem("Demo"))
 			{
 				m_bShowDemonWindow = !m_bShowDemonWindow;
@@ -20,6 +20,7 @@ public:
 	void RenderTerrainUI();
 	void RenderSceneUI();
 	void RenderSkyBoxUI();
+	void RenderProfilerUI();
 
 private:
 	CWindow* m_pWindow;
@@ -29,6 +30,7 @@ private:
 	bool m_bShowAboutInfo;
 	bool m_bShowSceneWindow;
 	bool m_bShowSkyboxWindow;
+	bool m_bShowProfilerWindow;
 
 	bool m_bInitialized = false;
 
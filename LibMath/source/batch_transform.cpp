@@ -0,0 +1,412 @@
+#include "stdafx.h"
+#include "batch_transform.h"
+#include <thread>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+#if defined(_WIN64)
+#undef max
+#undef min
+#undef minmax
+#endif
+
+namespace
+{
+#if defined(MATH_SIMD_AVX)
+	typedef __m256 TLane;
+	constexpr size_t LANE_WIDTH = 8;
+
+	inline TLane LaneLoad(const float* p) { return (_mm256_loadu_ps(p)); }
+	inline void LaneStore(float* p, TLane v) { _mm256_storeu_ps(p, v); }
+	inline TLane LaneSet(float f) { return (_mm256_set1_ps(f)); }
+	inline TLane LaneMulAdd(TLane a, TLane b, TLane c) { return (_mm256_add_ps(_mm256_mul_ps(a, b), c)); }
+	inline TLane LaneMul(TLane a, TLane b) { return (_mm256_mul_ps(a, b)); }
+	inline TLane LaneDiv(TLane a, TLane b) { return (_mm256_div_ps(a, b)); }
+	inline TLane LaneSub(TLane a, TLane b) { return (_mm256_sub_ps(a, b)); }
+#elif defined(MATH_SIMD_SSE)
+	typedef __m128 TLane;
+	constexpr size_t LANE_WIDTH = 4;
+
+	inline TLane LaneLoad(const float* p) { return (_mm_loadu_ps(p)); }
+	inline void LaneStore(float* p, TLane v) { _mm_storeu_ps(p, v); }
+	inline TLane LaneSet(float f) { return (_mm_set1_ps(f)); }
+	inline TLane LaneMulAdd(TLane a, TLane b, TLane c) { return (_mm_add_ps(_mm_mul_ps(a, b), c)); }
+	inline TLane LaneMul(TLane a, TLane b) { return (_mm_mul_ps(a, b)); }
+	inline TLane LaneDiv(TLane a, TLane b) { return (_mm_div_ps(a, b)); }
+	inline TLane LaneSub(TLane a, TLane b) { return (_mm_sub_ps(a, b)); }
+#endif
+
+	enum EStreamMode
+	{
+		STREAM_POINTS,
+		STREAM_NORMALS,
+		STREAM_PROJECT
+	};
+
+	// Splits [0, iCount) in one contiguous range per thread, small batches stay on the caller
+	void ParallelRanges(size_t iCount, size_t iMinPerThread, const std::function<void(size_t, size_t)>& Job)
+	{
+		const size_t iMaxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		const size_t iNumThreads = std::min(iMaxThreads, std::max<size_t>(iCount / iMinPerThread, 1));
+
+		if (iNumThreads <= 1)
+		{
+			Job(0, iCount);
+			return;
+		}
+
+		const size_t iPerThread = (iCount + iNumThreads - 1) / iNumThreads;
+
+		std::vector<std::thread> vWorkers;
+		vWorkers.reserve(iNumThreads - 1);
+
+		for (size_t t = 1; t < iNumThreads; t++)
+		{
+			const size_t iBegin = std::min(t * iPerThread, iCount);
+			const size_t iEnd = std::min(iBegin + iPerThread, iCount);
+			vWorkers.emplace_back(Job, iBegin, iEnd);
+		}
+
+		Job(0, std::min(iPerThread, iCount));
+
+		for (auto& worker : vWorkers)
+		{
+			worker.join();
+		}
+	}
+
+	template <EStreamMode eMode>
+	void TransformStreamRange(const CMatrix4Df& mat, const TPointStream& in, const TPointStreamOut& out, size_t iBegin, size_t iEnd)
+	{
+		const float(&m)[4][4] = mat.mat4;
+		const float fW = (eMode == STREAM_NORMALS) ? 0.0f : 1.0f;
+		size_t i = iBegin;
+
+#if defined(MATH_SIMD_SSE)
+		const TLane m00 = LaneSet(m[0][0]), m01 = LaneSet(m[0][1]), m02 = LaneSet(m[0][2]), m03 = LaneSet(m[0][3] * fW);
+		const TLane m10 = LaneSet(m[1][0]), m11 = LaneSet(m[1][1]), m12 = LaneSet(m[1][2]), m13 = LaneSet(m[1][3] * fW);
+		const TLane m20 = LaneSet(m[2][0]), m21 = LaneSet(m[2][1]), m22 = LaneSet(m[2][2]), m23 = LaneSet(m[2][3] * fW);
+		const TLane m30 = LaneSet(m[3][0]), m31 = LaneSet(m[3][1]), m32 = LaneSet(m[3][2]), m33 = LaneSet(m[3][3]);
+
+		for (; i + LANE_WIDTH <= iEnd; i += LANE_WIDTH)
+		{
+			const TLane x = LaneLoad(in.pX + i);
+			const TLane y = LaneLoad(in.pY + i);
+			const TLane z = LaneLoad(in.pZ + i);
+
+			TLane ox = LaneMulAdd(m02, z, LaneMulAdd(m01, y, LaneMulAdd(m00, x, m03)));
+			TLane oy = LaneMulAdd(m12, z, LaneMulAdd(m11, y, LaneMulAdd(m10, x, m13)));
+			TLane oz = LaneMulAdd(m22, z, LaneMulAdd(m21, y, LaneMulAdd(m20, x, m23)));
+
+			if constexpr (eMode == STREAM_PROJECT)
+			{
+				const TLane ow = LaneMulAdd(m32, z, LaneMulAdd(m31, y, LaneMulAdd(m30, x, m33)));
+				const TLane rcp = LaneDiv(LaneSet(1.0f), ow);
+				ox = LaneMul(ox, rcp);
+				oy = LaneMul(oy, rcp);
+				oz = LaneMul(oz, rcp);
+			}
+
+			LaneStore(out.pX + i, ox);
+			LaneStore(out.pY + i, oy);
+			LaneStore(out.pZ + i, oz);
+		}
+#endif
+
+		for (; i < iEnd; i++)
+		{
+			const float x = in.pX[i];
+			const float y = in.pY[i];
+			const float z = in.pZ[i];
+
+			float ox = m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3] * fW;
+			float oy = m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3] * fW;
+			float oz = m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3] * fW;
+
+			if constexpr (eMode == STREAM_PROJECT)
+			{
+				const float fRcp = 1.0f / (m[3][0] * x + m[3][1] * y + m[3][2] * z + m[3][3]);
+				ox *= fRcp;
+				oy *= fRcp;
+				oz *= fRcp;
+			}
+
+			out.pX[i] = ox;
+			out.pY[i] = oy;
+			out.pZ[i] = oz;
+		}
+	}
+
+	void RotateStreamRange(const CQuaternion& quat, const TPointStream& in, const TPointStreamOut& out, size_t iBegin, size_t iEnd)
+	{
+		size_t i = iBegin;
+
+#if defined(MATH_SIMD_SSE)
+		const TLane qx = LaneSet(quat.x), qy = LaneSet(quat.y), qz = LaneSet(quat.z), qw = LaneSet(quat.w);
+		const TLane two = LaneSet(2.0f);
+
+		for (; i + LANE_WIDTH <= iEnd; i += LANE_WIDTH)
+		{
+			const TLane x = LaneLoad(in.pX + i);
+			const TLane y = LaneLoad(in.pY + i);
+			const TLane z = LaneLoad(in.pZ + i);
+
+			// t = 2 (u x v), v' = v + w t + u x t
+			const TLane tx = LaneMul(two, LaneSub(LaneMul(qy, z), LaneMul(qz, y)));
+			const TLane ty = LaneMul(two, LaneSub(LaneMul(qz, x), LaneMul(qx, z)));
+			const TLane tz = LaneMul(two, LaneSub(LaneMul(qx, y), LaneMul(qy, x)));
+
+			LaneStore(out.pX + i, LaneMulAdd(qw, tx, LaneMulAdd(qy, tz, LaneSub(x, LaneMul(qz, ty)))));
+			LaneStore(out.pY + i, LaneMulAdd(qw, ty, LaneMulAdd(qz, tx, LaneSub(y, LaneMul(qx, tz)))));
+			LaneStore(out.pZ + i, LaneMulAdd(qw, tz, LaneMulAdd(qx, ty, LaneSub(z, LaneMul(qy, tx)))));
+		}
+#endif
+
+		for (; i < iEnd; i++)
+		{
+			const SVector3Df v3Rotated = quat.Rotate(SVector3Df(in.pX[i], in.pY[i], in.pZ[i]));
+			out.pX[i] = v3Rotated.x;
+			out.pY[i] = v3Rotated.y;
+			out.pZ[i] = v3Rotated.z;
+		}
+	}
+
+#if defined(MATH_SIMD_SSE)
+	// Four quaternions into x, y, z, w registers, one pair per lane
+	inline void LoadQuaternions4(const CQuaternion* p, __m128& x, __m128& y, __m128& z, __m128& w)
+	{
+		x = _mm_load_ps(&p[0].x);
+		y = _mm_load_ps(&p[1].x);
+		z = _mm_load_ps(&p[2].x);
+		w = _mm_load_ps(&p[3].x);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+	}
+
+	inline void StoreQuaternions4(CQuaternion* p, __m128 x, __m128 y, __m128 z, __m128 w)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_store_ps(&p[0].x, x);
+		_mm_store_ps(&p[1].x, y);
+		_mm_store_ps(&p[2].x, z);
+		_mm_store_ps(&p[3].x, w);
+	}
+
+	inline __m128 Dot4Lanes(__m128 ax, __m128 ay, __m128 az, __m128 aw, __m128 bx, __m128 by, __m128 bz, __m128 bw)
+	{
+		return (_mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw))));
+	}
+
+	inline __m128 Select4(__m128 mask, __m128 a, __m128 b)
+	{
+		return (_mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)));
+	}
+
+	// acos(c) for c in [0, 1], Abramowitz & Stegun 4.4.45, error below 2e-8
+	inline __m128 Acos01(__m128 c)
+	{
+		__m128 p = _mm_set1_ps(-0.0012624911f);
+		p = _mm_add_ps(_mm_mul_ps(p, c), _mm_set1_ps(0.0066700901f));
+		p = _mm_add_ps(_mm_mul_ps(p, c), _mm_set1_ps(-0.0170881256f));
+		p = _mm_add_ps(_mm_mul_ps(p, c), _mm_set1_ps(0.0308918810f));
+		p = _mm_add_ps(_mm_mul_ps(p, c), _mm_set1_ps(-0.0501743046f));
+		p = _mm_add_ps(_mm_mul_ps(p, c), _mm_set1_ps(0.0889789874f));
+		p = _mm_add_ps(_mm_mul_ps(p, c), _mm_set1_ps(-0.2145988016f));
+		p = _mm_add_ps(_mm_mul_ps(p, c), _mm_set1_ps(1.5707963050f));
+		return (_mm_mul_ps(p, _mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), c))));
+	}
+
+	// sin(x) for x in [0, pi / 2], Taylor series up to x^11, error below 6e-8
+	inline __m128 SinQuarter(__m128 x)
+	{
+		const __m128 x2 = _mm_mul_ps(x, x);
+		__m128 p = _mm_set1_ps(-2.5052108e-8f);
+		p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(2.7557319e-6f));
+		p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.9841270e-4f));
+		p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(8.3333333e-3f));
+		p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.6666667e-1f));
+		return (_mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(x, x2), p)));
+	}
+#endif
+
+	// Same result as CQuaternion::Slerp per pair, four pairs per iteration with polynomial acos/sin
+	void SlerpRange(const CQuaternion* pFrom, const CQuaternion* pTo, const float* pT, CQuaternion* pOut, size_t iBegin, size_t iEnd)
+	{
+		size_t i = iBegin;
+
+#if defined(MATH_SIMD_SSE)
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128 nlerpCos = _mm_set1_ps(0.9995f);
+
+		for (; i + 4 <= iEnd; i += 4)
+		{
+			const __m128 t = _mm_loadu_ps(pT + i);
+
+			// The polynomials only cover angles in [0, pi / 2], extrapolation takes the scalar path
+			if (_mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(t, zero), _mm_cmpgt_ps(t, one))))
+			{
+				for (size_t j = i; j < i + 4; j++)
+				{
+					pOut[j] = CQuaternion::Slerp(pFrom[j], pTo[j], pT[j]);
+				}
+				continue;
+			}
+
+			__m128 ax, ay, az, aw, bx, by, bz, bw;
+			LoadQuaternions4(pFrom + i, ax, ay, az, aw);
+			LoadQuaternions4(pTo + i, bx, by, bz, bw);
+
+			// Shorter arc, flip the target where the dot is negative
+			__m128 c = Dot4Lanes(ax, ay, az, aw, bx, by, bz, bw);
+			const __m128 flip = _mm_and_ps(c, signMask);
+			bx = _mm_xor_ps(bx, flip);
+			by = _mm_xor_ps(by, flip);
+			bz = _mm_xor_ps(bz, flip);
+			bw = _mm_xor_ps(bw, flip);
+			c = _mm_min_ps(_mm_xor_ps(c, flip), one);
+
+			const __m128 theta = Acos01(c);
+			const __m128 invSin = _mm_div_ps(one, _mm_sqrt_ps(_mm_sub_ps(one, _mm_mul_ps(c, c))));
+			const __m128 oneMinusT = _mm_sub_ps(one, t);
+
+			// Nearly equal rotations blend linearly and are renormalized below, like CQuaternion::Nlerp
+			const __m128 nlerpMask = _mm_cmpgt_ps(c, nlerpCos);
+			const __m128 wFrom = Select4(nlerpMask, oneMinusT, _mm_mul_ps(SinQuarter(_mm_mul_ps(oneMinusT, theta)), invSin));
+			const __m128 wTo = Select4(nlerpMask, t, _mm_mul_ps(SinQuarter(_mm_mul_ps(t, theta)), invSin));
+
+			__m128 ox = _mm_add_ps(_mm_mul_ps(ax, wFrom), _mm_mul_ps(bx, wTo));
+			__m128 oy = _mm_add_ps(_mm_mul_ps(ay, wFrom), _mm_mul_ps(by, wTo));
+			__m128 oz = _mm_add_ps(_mm_mul_ps(az, wFrom), _mm_mul_ps(bz, wTo));
+			__m128 ow = _mm_add_ps(_mm_mul_ps(aw, wFrom), _mm_mul_ps(bw, wTo));
+
+			const __m128 invLen = _mm_div_ps(one, _mm_sqrt_ps(Dot4Lanes(ox, oy, oz, ow, ox, oy, oz, ow)));
+			const __m128 scale = Select4(nlerpMask, invLen, one);
+			StoreQuaternions4(pOut + i, _mm_mul_ps(ox, scale), _mm_mul_ps(oy, scale), _mm_mul_ps(oz, scale), _mm_mul_ps(ow, scale));
+		}
+#endif
+
+		for (; i < iEnd; i++)
+		{
+			pOut[i] = CQuaternion::Slerp(pFrom[i], pTo[i], pT[i]);
+		}
+	}
+
+	void NlerpRange(const CQuaternion* pFrom, const CQuaternion* pTo, const float* pT, CQuaternion* pOut, size_t iBegin, size_t iEnd)
+	{
+		size_t i = iBegin;
+
+#if defined(MATH_SIMD_SSE)
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+
+		for (; i + 4 <= iEnd; i += 4)
+		{
+			const __m128 t = _mm_loadu_ps(pT + i);
+
+			__m128 ax, ay, az, aw, bx, by, bz, bw;
+			LoadQuaternions4(pFrom + i, ax, ay, az, aw);
+			LoadQuaternions4(pTo + i, bx, by, bz, bw);
+
+			const __m128 flip = _mm_and_ps(Dot4Lanes(ax, ay, az, aw, bx, by, bz, bw), signMask);
+
+			// a + (b - a) t, renormalized
+			const __m128 ox = _mm_add_ps(ax, _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(bx, flip), ax), t));
+			const __m128 oy = _mm_add_ps(ay, _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(by, flip), ay), t));
+			const __m128 oz = _mm_add_ps(az, _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(bz, flip), az), t));
+			const __m128 ow = _mm_add_ps(aw, _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(bw, flip), aw), t));
+
+			const __m128 invLen = _mm_div_ps(one, _mm_sqrt_ps(Dot4Lanes(ox, oy, oz, ow, ox, oy, oz, ow)));
+			StoreQuaternions4(pOut + i, _mm_mul_ps(ox, invLen), _mm_mul_ps(oy, invLen), _mm_mul_ps(oz, invLen), _mm_mul_ps(ow, invLen));
+		}
+#endif
+
+		for (; i < iEnd; i++)
+		{
+			pOut[i] = CQuaternion::Nlerp(pFrom[i], pTo[i], pT[i]);
+		}
+	}
+
+	template <EStreamMode eMode>
+	void TransformStream(const CMatrix4Df& mat, const TPointStream& in, const TPointStreamOut& out, size_t uiCount)
+	{
+		ParallelRanges(uiCount, BATCH_PARALLEL_MIN, [&](size_t iBegin, size_t iEnd)
+			{
+				TransformStreamRange<eMode>(mat, in, out, iBegin, iEnd);
+			});
+	}
+}
+
+void MathBatch::TransformPoints(const CMatrix4Df& mat, const TPointStream& in, const TPointStreamOut& out, size_t uiCount)
+{
+	TransformStream<STREAM_POINTS>(mat, in, out, uiCount);
+}
+
+void MathBatch::TransformNormals(const CMatrix4Df& mat, const TPointStream& in, const TPointStreamOut& out, size_t uiCount)
+{
+	TransformStream<STREAM_NORMALS>(mat, in, out, uiCount);
+}
+
+void MathBatch::ProjectPoints(const CMatrix4Df& mat, const TPointStream& in, const TPointStreamOut& out, size_t uiCount)
+{
+	TransformStream<STREAM_PROJECT>(mat, in, out, uiCount);
+}
+
+void MathBatch::MultiplyMatrices(const CMatrix4Df* pIn, const CMatrix4Df& mat, CMatrix4Df* pOut, size_t uiCount)
+{
+	// A matrix product is ~16 times the work of a point, so threads pay off much earlier
+	const CMatrix4Df matRight = mat;
+	ParallelRanges(uiCount, BATCH_PARALLEL_MIN / 16, [&](size_t iBegin, size_t iEnd)
+		{
+			for (size_t i = iBegin; i < iEnd; i++)
+			{
+				MathSimd::Mul4x4(&pIn[i].mat4[0][0], &matRight.mat4[0][0], &pOut[i].mat4[0][0]);
+			}
+		});
+}
+
+void MathBatch::PreMultiplyMatrices(const CMatrix4Df& mat, const CMatrix4Df* pIn, CMatrix4Df* pOut, size_t uiCount)
+{
+	const CMatrix4Df matLeft = mat;
+	ParallelRanges(uiCount, BATCH_PARALLEL_MIN / 16, [&](size_t iBegin, size_t iEnd)
+		{
+			for (size_t i = iBegin; i < iEnd; i++)
+			{
+				MathSimd::Mul4x4(&matLeft.mat4[0][0], &pIn[i].mat4[0][0], &pOut[i].mat4[0][0]);
+			}
+		});
+}
+
+void MathBatch::TransformVectors(const CMatrix4Df& mat, const SVector4Df* pIn, SVector4Df* pOut, size_t uiCount)
+{
+	for (size_t i = 0; i < uiCount; i++)
+	{
+		MathSimd::Transform4(&mat.mat4[0][0], &pIn[i].x, &pOut[i].x);
+	}
+}
+
+void MathBatch::RotateVectors(const CQuaternion& quat, const TPointStream& in, const TPointStreamOut& out, size_t uiCount)
+{
+	ParallelRanges(uiCount, BATCH_PARALLEL_MIN, [&](size_t iBegin, size_t iEnd)
+		{
+			RotateStreamRange(quat, in, out, iBegin, iEnd);
+		});
+}
+
+void MathBatch::SlerpQuaternions(const CQuaternion* pFrom, const CQuaternion* pTo, const float* pT, CQuaternion* pOut, size_t uiCount)
+{
+	// Polynomials per pair, worth threading much earlier than the point streams
+	ParallelRanges(uiCount, BATCH_PARALLEL_MIN / 8, [&](size_t iBegin, size_t iEnd)
+		{
+			SlerpRange(pFrom, pTo, pT, pOut, iBegin, iEnd);
+		});
+}
+
+void MathBatch::NlerpQuaternions(const CQuaternion* pFrom, const CQuaternion* pTo, const float* pT, CQuaternion* pOut, size_t uiCount)
+{
+	ParallelRanges(uiCount, BATCH_PARALLEL_MIN / 4, [&](size_t iBegin, size_t iEnd)
+		{
+			NlerpRange(pFrom, pTo, pT, pOut, iBegin, iEnd);
+		});
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "matrix.h"
+#include "quaternion_simd.h"
+
+/*
+ * Batch transforms for code that pushes many points through one matrix or quaternion
+ *
+ * Points and normals are passed as SoA streams (separate x, y and z arrays) so the SIMD
+ * backend from simd.h can work on 4 (SSE) or 8 (AVX) elements per step. Batches of at
+ * least BATCH_PARALLEL_MIN elements are also split across threads. Output streams may be
+ * the input streams for in place transforms.
+ */
+
+#define BATCH_PARALLEL_MIN (1 << 16)
+
+typedef struct SPointStream
+{
+	const float* pX;
+	const float* pY;
+	const float* pZ;
+} TPointStream;
+
+typedef struct SPointStreamOut
+{
+	float* pX;
+	float* pY;
+	float* pZ;
+} TPointStreamOut;
+
+namespace MathBatch
+{
+	// out = mat * (x, y, z, 1), the resulting w is dropped
+	void TransformPoints(const CMatrix4Df& mat, const TPointStream& in, const TPointStreamOut& out, size_t uiCount);
+
+	// out = mat * (x, y, z, 0), pass the inverse transpose of the model matrix for normals under non uniform scale.
+	// The results are not renormalized
+	void TransformNormals(const CMatrix4Df& mat, const TPointStream& in, const TPointStreamOut& out, size_t uiCount);
+
+	// out = (mat * (x, y, z, 1)).xyz / w, NDC when mat is a view projection
+	void ProjectPoints(const CMatrix4Df& mat, const TPointStream& in, const TPointStreamOut& out, size_t uiCount);
+
+	// pOut[i] = pIn[i] * mat, pOut may be pIn
+	void MultiplyMatrices(const CMatrix4Df* pIn, const CMatrix4Df& mat, CMatrix4Df* pOut, size_t uiCount);
+
+	// pOut[i] = mat * pIn[i], pOut may be pIn
+	void PreMultiplyMatrices(const CMatrix4Df& mat, const CMatrix4Df* pIn, CMatrix4Df* pOut, size_t uiCount);
+
+	// AoS helper for short fixed lists (frustum corners, debug shapes), pOut may be pIn
+	void TransformVectors(const CMatrix4Df& mat, const SVector4Df* pIn, SVector4Df* pOut, size_t uiCount);
+
+	// out = quat.Rotate(v) for every point of the stream, quat has to be normalized
+	void RotateVectors(const CQuaternion& quat, const TPointStream& in, const TPointStreamOut& out, size_t uiCount);
+
+	// pOut[i] = CQuaternion::Slerp/Nlerp(pFrom[i], pTo[i], pT[i]), pOut may be pFrom or pTo.
+	// Four pairs per SSE step, Slerp uses polynomial acos/sin (within 1e-6) for t in [0, 1]
+	void SlerpQuaternions(const CQuaternion* pFrom, const CQuaternion* pTo, const float* pT, CQuaternion* pOut, size_t uiCount);
+	void NlerpQuaternions(const CQuaternion* pFrom, const CQuaternion* pTo, const float* pT, CQuaternion* pOut, size_t uiCount);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "matrix.h"
+#include "batch_transform.h"
 
 struct SFrustum
 {
@@ -18,15 +19,8 @@ struct SFrustum
 
 	void transform(const CMatrix4Df& mat)
 	{
-		v4NearTopLeft = mat * v4NearTopLeft;
-		v4NearBottomLeft = mat * v4NearBottomLeft;
-		v4NearTopRight = mat * v4NearTopRight;
-		v4NearBottomRight = mat * v4NearBottomRight;
-
-		v4FarTopLeft = mat * v4FarTopLeft;
-		v4FarBottomLeft = mat * v4FarBottomLeft;
-		v4FarTopRight = mat * v4FarTopRight;
-		v4FarBottomRight = mat * v4FarBottomRight;
+		// The eight corners are laid out back to back
+		MathBatch::TransformVectors(mat, &v4NearTopLeft, &v4NearTopLeft, 8);
 	}
 
 	void print() const
@@ -44,8 +38,12 @@ struct SFrustum
 	}
 };
 
+static_assert(sizeof(SFrustum) == 8 * sizeof(SVector4Df), "SFrustum::transform expects the corners to be packed");
+
 struct SFrustumCulling
 {
+	SFrustumCulling() = default;
+
 	SFrustumCulling(const CMatrix4Df& matViewProj)
 	{
 		Update(matViewProj);
@@ -71,6 +69,31 @@ struct SFrustumCulling
 		return (bIsInside);
 	}
 
+	// Conservative box test against the same planes: true only when the whole box is behind one of them
+	bool IsBoxOutsideViewFrustum(const SVector3Df& v3Min, const SVector3Df& v3Max) const
+	{
+		// Box corner farthest along the plane normal, and the one farthest against it
+		auto MaxDot = [&](const SVector4Df& v4Plane)
+			{
+				return (v4Plane.x * (v4Plane.x >= 0.0f ? v3Max.x : v3Min.x) +
+					v4Plane.y * (v4Plane.y >= 0.0f ? v3Max.y : v3Min.y) +
+					v4Plane.z * (v4Plane.z >= 0.0f ? v3Max.z : v3Min.z) + v4Plane.w);
+			};
+
+		auto MinDot = [&](const SVector4Df& v4Plane)
+			{
+				return (v4Plane.x * (v4Plane.x >= 0.0f ? v3Min.x : v3Max.x) +
+					v4Plane.y * (v4Plane.y >= 0.0f ? v3Min.y : v3Max.y) +
+					v4Plane.z * (v4Plane.z >= 0.0f ? v3Min.z : v3Max.z) + v4Plane.w);
+			};
+
+		return (
+			(MaxDot(m_v4LeftClipPlane) < 0) ||
+			(MinDot(m_v4RightClipPlane) > 0) ||
+			(MaxDot(m_v4NearClipPlane) < 0) ||
+			(MinDot(m_v4FarClipPlane) > 0));
+	}
+
 private:
 	SVector4Df m_v4LeftClipPlane;
 	SVector4Df m_v4RightClipPlane;
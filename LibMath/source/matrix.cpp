@@ -6,9 +6,9 @@
 
 CMatrix4Df::CMatrix4Df(const CMatrix3Df& AssimpMatrix)
 {
-	mat4[0][0] = AssimpMatrix.mat3[0][0]; mat4[0][1] = AssimpMatrix.mat3[0][1]; mat4[0][2] = AssimpMatrix.mat3[0][3]; mat4[0][3] = 0.0f;
-	mat4[1][0] = AssimpMatrix.mat3[1][0]; mat4[1][1] = AssimpMatrix.mat3[1][1]; mat4[1][2] = AssimpMatrix.mat3[1][3]; mat4[1][3] = 0.0f;
-	mat4[2][0] = AssimpMatrix.mat3[2][0]; mat4[2][1] = AssimpMatrix.mat3[2][1]; mat4[2][2] = AssimpMatrix.mat3[2][3]; mat4[2][3] = 0.0f;
+	mat4[0][0] = AssimpMatrix.mat3[0][0]; mat4[0][1] = AssimpMatrix.mat3[0][1]; mat4[0][2] = AssimpMatrix.mat3[0][2]; mat4[0][3] = 0.0f;
+	mat4[1][0] = AssimpMatrix.mat3[1][0]; mat4[1][1] = AssimpMatrix.mat3[1][1]; mat4[1][2] = AssimpMatrix.mat3[1][2]; mat4[1][3] = 0.0f;
+	mat4[2][0] = AssimpMatrix.mat3[2][0]; mat4[2][1] = AssimpMatrix.mat3[2][1]; mat4[2][2] = AssimpMatrix.mat3[2][2]; mat4[2][3] = 0.0f;
 	mat4[3][0] = 0.0f; mat4[3][1] = 0.0f; mat4[3][2] = 0.0f; mat4[3][3] = 1.0f;
 }
 
@@ -28,15 +28,15 @@ void CMatrix4Df::InitRotationX(const float fRotX, const bool bLeftHanded)
 	if (bLeftHanded)
 	{
 		mat4[0][0] = 1.0f; mat4[0][1] = 0.0f; mat4[0][2] = 0.0f; mat4[0][3] = 0.0f;
-		mat4[1][0] = 0.0f; mat4[1][1] = std::cosf(fRotX); mat4[1][2] = std::sinf(fRotX); mat4[1][3] = 0.0f;
-		mat4[2][0] = 0.0f; mat4[2][1] = -std::sinf(fRotX); mat4[2][2] = std::cosf(fRotX); mat4[2][3] = 0.0f;
+		mat4[1][0] = 0.0f; mat4[1][1] = std::cos(fRotX); mat4[1][2] = std::sin(fRotX); mat4[1][3] = 0.0f;
+		mat4[2][0] = 0.0f; mat4[2][1] = -std::sin(fRotX); mat4[2][2] = std::cos(fRotX); mat4[2][3] = 0.0f;
 		mat4[3][0] = 0.0f; mat4[3][1] = 0.0f; mat4[3][2] = 0.0f; mat4[3][3] = 1.0f;
 		return;
 	}
 
 	mat4[0][0] = 1.0f; mat4[0][1] = 0.0f; mat4[0][2] = 0.0f; mat4[0][3] = 0.0f;
-	mat4[1][0] = 0.0f; mat4[1][1] = std::cosf(fRotX); mat4[1][2] = -std::sinf(fRotX); mat4[1][3] = 0.0f;
-	mat4[2][0] = 0.0f; mat4[2][1] = std::sinf(fRotX); mat4[2][2] = std::cosf(fRotX); mat4[2][3] = 0.0f;
+	mat4[1][0] = 0.0f; mat4[1][1] = std::cos(fRotX); mat4[1][2] = -std::sin(fRotX); mat4[1][3] = 0.0f;
+	mat4[2][0] = 0.0f; mat4[2][1] = std::sin(fRotX); mat4[2][2] = std::cos(fRotX); mat4[2][3] = 0.0f;
 	mat4[3][0] = 0.0f; mat4[3][1] = 0.0f; mat4[3][2] = 0.0f; mat4[3][3] = 1.0f;
 }
 
@@ -55,16 +55,16 @@ void CMatrix4Df::InitRotationY(const float fRotY, const bool bLeftHanded)
 	/* Rotate The Matrix in Left Handed Coordinate System Around Y Axis */
 	if (bLeftHanded)
 	{
-		mat4[0][0] = std::cosf(fRotY); mat4[0][1] = 0.0f; mat4[0][2] = -std::sinf(fRotY); mat4[0][3] = 0.0f;
+		mat4[0][0] = std::cos(fRotY); mat4[0][1] = 0.0f; mat4[0][2] = -std::sin(fRotY); mat4[0][3] = 0.0f;
 		mat4[1][0] = 0.0f; mat4[1][1] = 1.0f; mat4[1][2] = 0.0f; mat4[1][3] = 0.0f;
-		mat4[2][0] = std::sinf(fRotY); mat4[2][1] = 0.0f; mat4[2][2] = std::cosf(fRotY); mat4[2][3] = 0.0f;
+		mat4[2][0] = std::sin(fRotY); mat4[2][1] = 0.0f; mat4[2][2] = std::cos(fRotY); mat4[2][3] = 0.0f;
 		mat4[3][0] = 0.0f; mat4[3][1] = 0.0f; mat4[3][2] = 0.0f; mat4[3][3] = 1.0f;
 		return;
 	}
 
-	mat4[0][0] = std::cosf(fRotY); mat4[0][1] = 0.0f; mat4[0][2] = std::sinf(fRotY); mat4[0][3] = 0.0f;
+	mat4[0][0] = std::cos(fRotY); mat4[0][1] = 0.0f; mat4[0][2] = std::sin(fRotY); mat4[0][3] = 0.0f;
 	mat4[1][0] = 0.0f; mat4[1][1] = 1.0f; mat4[1][2] = 0.0f; mat4[1][3] = 0.0f;
-	mat4[2][0] = -std::sinf(fRotY); mat4[2][1] = 0.0f; mat4[2][2] = std::cosf(fRotY); mat4[2][3] = 0.0f;
+	mat4[2][0] = -std::sin(fRotY); mat4[2][1] = 0.0f; mat4[2][2] = std::cos(fRotY); mat4[2][3] = 0.0f;
 	mat4[3][0] = 0.0f; mat4[3][1] = 0.0f; mat4[3][2] = 0.0f; mat4[3][3] = 1.0f;
 }
 
@@ -83,15 +83,15 @@ void CMatrix4Df::InitRotationZ(const float fRotZ, const bool bLeftHanded)
 	/* Rotate The Matrix in Left Handed Coordinate System Around Z Axis */
 	if (bLeftHanded)
 	{
-		mat4[0][0] = std::cosf(fRotZ); mat4[0][1] = std::sinf(fRotZ); mat4[0][2] = 0.0f; mat4[0][3] = 0.0f;
-		mat4[1][0] = -std::sinf(fRotZ); mat4[1][1] = std::cosf(fRotZ); mat4[1][2] = 0.0f; mat4[1][3] = 0.0f;
+		mat4[0][0] = std::cos(fRotZ); mat4[0][1] = std::sin(fRotZ); mat4[0][2] = 0.0f; mat4[0][3] = 0.0f;
+		mat4[1][0] = -std::sin(fRotZ); mat4[1][1] = std::cos(fRotZ); mat4[1][2] = 0.0f; mat4[1][3] = 0.0f;
 		mat4[2][0] = 0.0f; mat4[2][1] = 0.0f; mat4[2][2] = 1.0f; mat4[2][3] = 0.0f;
 		mat4[3][0] = 0.0f; mat4[3][1] = 0.0f; mat4[3][2] = 0.0f; mat4[3][3] = 1.0f;
 		return;
 	}
 
-	mat4[0][0] = std::cosf(fRotZ); mat4[0][1] = -std::sinf(fRotZ); mat4[0][2] = 0.0f; mat4[0][3] = 0.0f;
-	mat4[1][0] = std::sinf(fRotZ); mat4[1][1] = std::cosf(fRotZ); mat4[1][2] = 0.0f; mat4[1][3] = 0.0f;
+	mat4[0][0] = std::cos(fRotZ); mat4[0][1] = -std::sin(fRotZ); mat4[0][2] = 0.0f; mat4[0][3] = 0.0f;
+	mat4[1][0] = std::sin(fRotZ); mat4[1][1] = std::cos(fRotZ); mat4[1][2] = 0.0f; mat4[1][3] = 0.0f;
 	mat4[2][0] = 0.0f; mat4[2][1] = 0.0f; mat4[2][2] = 1.0f; mat4[2][3] = 0.0f;
 	mat4[3][0] = 0.0f; mat4[3][1] = 0.0f; mat4[3][2] = 0.0f; mat4[3][3] = 1.0f;
 }
@@ -533,7 +533,7 @@ void CMatrix4Df::InitPersProjTransform(const SPersProjInfo& sPersProj, const boo
 	{
 		const float fAspectRatio = sPersProj.Height / sPersProj.Width;
 		const float fZRange = sPersProj.zNear - sPersProj.zFar;
-		const float fTanHalfFOV = std::tanf(ToRadian(sPersProj.FOV / 2.0f));
+		const float fTanHalfFOV = std::tan(ToRadian(sPersProj.FOV / 2.0f));
 
 		mat4[0][0] = 1.0f / fTanHalfFOV;
 		mat4[0][1] = 0.0f;
@@ -570,7 +570,7 @@ void CMatrix4Df::InitPersProjTransform(const SPersProjInfo& sPersProj, const boo
 
 	const float fAspectRatio = sPersProj.Width / sPersProj.Height;
 	const float fZRange = sPersProj.zNear - sPersProj.zFar;
-	const float fTanHalfFOV = std::tanf(ToRadian(sPersProj.FOV / 2.0f));
+	const float fTanHalfFOV = std::tan(ToRadian(sPersProj.FOV / 2.0f));
 
 	mat4[0][0] = 1.0f / (fTanHalfFOV * fAspectRatio);
 	mat4[0][1] = 0.0f;
@@ -758,14 +758,14 @@ void CMatrix3Df::InitRotationX(const float fRotX, const bool bLeftHanded)
 	if (bLeftHanded)
 	{
 		mat3[0][0] = 1.0f; mat3[0][1] = 0.0f; mat3[0][2] = 0.0f;
-		mat3[1][0] = 0.0f; mat3[1][1] = std::cosf(fRotX); mat3[1][2] = std::sinf(fRotX);
-		mat3[2][0] = 0.0f; mat3[2][1] = -std::sinf(fRotX); mat3[2][2] = std::cosf(fRotX);
+		mat3[1][0] = 0.0f; mat3[1][1] = std::cos(fRotX); mat3[1][2] = std::sin(fRotX);
+		mat3[2][0] = 0.0f; mat3[2][1] = -std::sin(fRotX); mat3[2][2] = std::cos(fRotX);
 		return;
 	}
 
 	mat3[0][0] = 1.0f; mat3[0][1] = 0.0f; mat3[0][2] = 0.0f;
-	mat3[1][0] = 0.0f; mat3[1][1] = std::cosf(fRotX); mat3[1][2] = -std::sinf(fRotX);
-	mat3[2][0] = 0.0f; mat3[2][1] = std::sinf(fRotX); mat3[2][2] = std::cosf(fRotX);
+	mat3[1][0] = 0.0f; mat3[1][1] = std::cos(fRotX); mat3[1][2] = -std::sin(fRotX);
+	mat3[2][0] = 0.0f; mat3[2][1] = std::sin(fRotX); mat3[2][2] = std::cos(fRotX);
 }
 
 /**
@@ -783,15 +783,15 @@ void CMatrix3Df::InitRotationY(const float fRotY, const bool bLeftHanded)
 	/* Rotate The Matrix in Left Handed Coordinate System Around Y Axis */
 	if (bLeftHanded)
 	{
-		mat3[0][0] = std::cosf(fRotY); mat3[0][1] = 0.0f; mat3[0][2] = -std::sinf(fRotY);
+		mat3[0][0] = std::cos(fRotY); mat3[0][1] = 0.0f; mat3[0][2] = -std::sin(fRotY);
 		mat3[1][0] = 0.0f; mat3[1][1] = 1.0f; mat3[1][2] = 0.0f;
-		mat3[2][0] = std::sinf(fRotY); mat3[2][1] = 0.0f; mat3[2][2] = std::cosf(fRotY);
+		mat3[2][0] = std::sin(fRotY); mat3[2][1] = 0.0f; mat3[2][2] = std::cos(fRotY);
 		return;
 	}
 
-	mat3[0][0] = std::cosf(fRotY); mat3[0][1] = 0.0f; mat3[0][2] = std::sinf(fRotY);
+	mat3[0][0] = std::cos(fRotY); mat3[0][1] = 0.0f; mat3[0][2] = std::sin(fRotY);
 	mat3[1][0] = 0.0f; mat3[1][1] = 1.0f; mat3[1][2] = 0.0f;
-	mat3[2][0] = -std::sinf(fRotY); mat3[2][1] = 0.0f; mat3[2][2] = std::cosf(fRotY);
+	mat3[2][0] = -std::sin(fRotY); mat3[2][1] = 0.0f; mat3[2][2] = std::cos(fRotY);
 }
 
 /**
@@ -809,14 +809,14 @@ void CMatrix3Df::InitRotationZ(const float fRotZ, const bool bLeftHanded)
 	/* Rotate The Matrix in Left Handed Coordinate System Around Z Axis */
 	if (bLeftHanded)
 	{
-		mat3[0][0] = std::cosf(fRotZ); mat3[0][1] = std::sinf(fRotZ); mat3[0][2] = 0.0f;
-		mat3[1][0] = -std::sinf(fRotZ); mat3[1][1] = std::cosf(fRotZ); mat3[1][2] = 0.0f;
+		mat3[0][0] = std::cos(fRotZ); mat3[0][1] = std::sin(fRotZ); mat3[0][2] = 0.0f;
+		mat3[1][0] = -std::sin(fRotZ); mat3[1][1] = std::cos(fRotZ); mat3[1][2] = 0.0f;
 		mat3[2][0] = 0.0f; mat3[2][1] = 0.0f; mat3[2][2] = 1.0f;
 		return;
 	}
 
-	mat3[0][0] = std::cosf(fRotZ); mat3[0][1] = -std::sinf(fRotZ); mat3[0][2] = 0.0f;
-	mat3[1][0] = std::sinf(fRotZ); mat3[1][1] = std::cosf(fRotZ); mat3[1][2] = 0.0f;
+	mat3[0][0] = std::cos(fRotZ); mat3[0][1] = -std::sin(fRotZ); mat3[0][2] = 0.0f;
+	mat3[1][0] = std::sin(fRotZ); mat3[1][1] = std::cos(fRotZ); mat3[1][2] = 0.0f;
 	mat3[2][0] = 0.0f; mat3[2][1] = 0.0f; mat3[2][2] = 1.0f;
 }
 
@@ -15,6 +15,7 @@
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
 #include "vectors.h"
+#include "simd.h"
 #include <iostream>
 
 class CMatrix3Df;
@@ -151,18 +152,11 @@ public:
 	 *
 	 * @return The product of the two matrices.
 	 */
-	CMatrix4Df operator*(const CMatrix4Df& rightMat)
+	CMatrix4Df operator*(const CMatrix4Df& rightMat) const
 	{
-		CMatrix4Df newMat{};
-		for (int8_t i = 0; i < 4; i++)
-		{
-			for (int8_t j = 0; j < 4; j++)
-			{
-				newMat.mat4[i][j] = mat4[i][0] * rightMat.mat4[0][j] + mat4[i][1] * rightMat.mat4[1][j] + mat4[i][2] * rightMat.mat4[2][j] + mat4[i][3] * rightMat.mat4[3][j];
-			}
-		}
+		CMatrix4Df newMat;
+		MathSimd::Mul4x4(&mat4[0][0], &rightMat.mat4[0][0], &newMat.mat4[0][0]);
 		return (newMat);
-
 	}
 
 	CMatrix4Df operator=(const glm::mat4& glmMat)
@@ -173,27 +167,6 @@ public:
 		mat4[3][0] = glmMat[3][0]; mat4[3][1] = glmMat[3][1]; mat4[3][2] = glmMat[3][2]; mat4[3][3] = glmMat[3][3];
 	}
 
-	/**
-	 * Multiplies a CMatrix4Df and an SVector4Df.
-	 *
-	 * This operator overloads the multiplication operator for CMatrix4Df and SVector4Df objects,
-	 * performing matrix-vector multiplication.
-	 *
-	 * @param vec: The vector to multiply.
-	 *
-	 * @return The product of the matrix and the vector.
-	 */
-	SVector4Df operator*(const SVector4Df& vec)
-	{
-		SVector4Df newVec{};
-
-		newVec.x = mat4[0][0] * vec.x + mat4[0][1] * vec.y + mat4[0][2] * vec.z + mat4[0][3] * vec.w;
-		newVec.y = mat4[1][0] * vec.x + mat4[1][1] * vec.y + mat4[1][2] * vec.z + mat4[1][3] * vec.w;
-		newVec.z = mat4[2][0] * vec.x + mat4[2][1] * vec.y + mat4[2][2] * vec.z + mat4[2][3] * vec.w;
-		newVec.w = mat4[3][0] * vec.x + mat4[3][1] * vec.y + mat4[3][2] * vec.z + mat4[3][3] * vec.w;
-		return (newVec);
-	}
-
 	/**
 	 * Multiplies a CMatrix4Df and an SVector4Df const.
 	 *
@@ -206,12 +179,8 @@ public:
 	 */
 	SVector4Df operator*(const SVector4Df& vec) const
 	{
-		SVector4Df newVec{};
-
-		newVec.x = mat4[0][0] * vec.x + mat4[0][1] * vec.y + mat4[0][2] * vec.z + mat4[0][3] * vec.w;
-		newVec.y = mat4[1][0] * vec.x + mat4[1][1] * vec.y + mat4[1][2] * vec.z + mat4[1][3] * vec.w;
-		newVec.z = mat4[2][0] * vec.x + mat4[2][1] * vec.y + mat4[2][2] * vec.z + mat4[2][3] * vec.w;
-		newVec.w = mat4[3][0] * vec.x + mat4[3][1] * vec.y + mat4[3][2] * vec.z + mat4[3][3] * vec.w;
+		SVector4Df newVec;
+		MathSimd::Transform4(&mat4[0][0], &vec.x, &newVec.x);
 		return (newVec);
 	}
 
@@ -297,16 +266,8 @@ public:
 	 */
 	CMatrix4Df Transpose() const
 	{
-		CMatrix4Df newMat{};
-
-		for (int8_t i = 0; i < 4; i++)
-		{
-			for (int8_t j = 0; j < 4; j++)
-			{
-				newMat.mat4[i][j] = mat4[j][i];
-			}
-		}
-
+		CMatrix4Df newMat;
+		MathSimd::Transpose4x4(&mat4[0][0], &newMat.mat4[0][0]);
 		return (newMat);
 	}
 
@@ -360,93 +321,20 @@ public:
 	/**
 	 * Calculates the inverse of the matrix.
 	 *
-	 * This function calculates the inverse of the 4x4 matrix using the adjugate matrix and the determinant.
+	 * This function calculates the inverse of the 4x4 matrix with the block (2x2 adjugate) method on SSE builds and the
+	 * cofactor expansion otherwise, both match glm::inverse.
 	 *
 	 * @return The inverse of the matrix.
 	 */
 	CMatrix4Df Inverse() const
 	{
-		// Compute the reciprocal determinant first
-
-		float det = Determinant();
-
-		if (det == 0.0f)
+		CMatrix4Df res;
+		if (!MathSimd::Inverse4x4(&mat4[0][0], &res.mat4[0][0]))
 		{
-			ASSERT(det == 0.0f, "Matrix Determinant Is 0");
+			// Singular, keep the old behaviour of handing the matrix back
 			return (*this);
 		}
 
-		// Calculate the inverse determinant
-		float fInvDet = 1.0f / det;
-
-		// Calculate the adjugate matrix (transpose of the cofactor matrix) (https://byjus.com/maths/inverse-matrix/)
-		CMatrix4Df res{};
-
-		// Calcualte First Element --- Inverse Is Positive
-		res.mat4[0][0] = fInvDet * (mat4[1][1] * (mat4[2][2] * mat4[3][3] - mat4[2][3] * mat4[3][2]) + mat4[1][2] * 
-			(mat4[2][3] * mat4[3][1] - mat4[2][1] * mat4[3][3]) + mat4[1][3] * (mat4[2][1] * mat4[3][2] - mat4[2][2] * mat4[3][1]));
-
-		// Same as the previous just switch the [1][x] to [0][x] --- Inverse Is Negative
-		res.mat4[0][1] = -fInvDet * (mat4[0][1] * (mat4[2][2] * mat4[3][3] - mat4[2][3] * mat4[3][2]) + mat4[0][2] *
-			(mat4[2][3] * mat4[3][1] - mat4[2][1] * mat4[3][3]) + mat4[0][3] * (mat4[2][1] * mat4[3][2] - mat4[2][2] * mat4[3][1]));
-
-		// Same as the previous just switch the [2][x] to [1][x] --- Inverse Is Positive
-		res.mat4[0][2] = fInvDet * (mat4[0][1] * (mat4[1][2] * mat4[3][3] - mat4[1][3] * mat4[3][2]) + mat4[0][2] *
-			(mat4[1][3] * mat4[3][1] - mat4[1][1] * mat4[3][3]) + mat4[0][3] * (mat4[1][1] * mat4[3][2] - mat4[1][2] * mat4[3][1]));
-
-		// Same as the previous just switch the [3][x] to [2][x] --- Inverse Is Negative
-		res.mat4[0][3] = -fInvDet * (mat4[0][1] * (mat4[1][2] * mat4[2][3] - mat4[1][3] * mat4[2][2]) + mat4[0][2] *
-			(mat4[1][3] * mat4[2][1] - mat4[1][1] * mat4[2][3]) + mat4[0][3] * (mat4[1][1] * mat4[2][2] - mat4[1][2] * mat4[2][1]));
-
-		// Same as the FIRST just switch the [x][1] to [x][0] --- Inverse Is Negative
-		res.mat4[1][0] = -fInvDet * (mat4[1][0] * (mat4[2][2] * mat4[3][3] - mat4[2][3] * mat4[3][2]) + mat4[1][2] *
-			(mat4[2][3] * mat4[3][0] - mat4[2][0] * mat4[3][3]) + mat4[1][3] * (mat4[2][0] * mat4[3][2] - mat4[2][2] * mat4[3][0]));
-
-		// Same as the previous just switch the [1][x] to [0][x] --- Inverse Is Positive
-		res.mat4[1][1] = fInvDet * (mat4[0][0] * (mat4[2][2] * mat4[3][3] - mat4[2][3] * mat4[3][2]) + mat4[0][2] *
-			(mat4[2][3] * mat4[3][0] - mat4[2][0] * mat4[3][3]) + mat4[0][3] * (mat4[2][0] * mat4[3][2] - mat4[2][2] * mat4[3][0]));
-
-		// Same as the previous just switch the [2][x] to [1][x] --- Inverse Is Negative
-		res.mat4[1][2] = -fInvDet * (mat4[0][0] * (mat4[1][2] * mat4[3][3] - mat4[1][3] * mat4[3][2]) + mat4[0][2] *
-			(mat4[1][3] * mat4[3][0] - mat4[1][0] * mat4[3][3]) + mat4[0][3] * (mat4[1][0] * mat4[3][2] - mat4[1][2] * mat4[3][0]));
-
-		// Same as the previous just switch the [3][x] to [2][x] --- Inverse Is Positive
-		res.mat4[1][3] = fInvDet * (mat4[0][0] * (mat4[1][2] * mat4[2][3] - mat4[1][3] * mat4[2][2]) + mat4[0][2] *
-			(mat4[1][3] * mat4[2][0] - mat4[1][0] * mat4[2][3]) + mat4[0][3] * (mat4[1][0] * mat4[2][2] - mat4[1][2] * mat4[2][0]));
-
-		// Same as [1][0] ELEMENT calculation, just switch the [x][2] to [x][1] --- Inverse Is Positive
-		res.mat4[2][0] = fInvDet * (mat4[1][0] * (mat4[2][1] * mat4[3][3] - mat4[2][3] * mat4[3][1]) + mat4[1][1] *
-			(mat4[2][3] * mat4[3][0] - mat4[2][0] * mat4[3][3]) + mat4[1][3] * (mat4[2][0] * mat4[3][1] - mat4[2][1] * mat4[3][0]));
-
-		// Same as the previous just switch the [1][x] to [0][x] --- Inverse Is Negative
-		res.mat4[2][1] = -fInvDet * (mat4[0][0] * (mat4[2][1] * mat4[3][3] - mat4[2][3] * mat4[3][1]) + mat4[0][1] *
-			(mat4[2][3] * mat4[3][0] - mat4[2][0] * mat4[3][3]) + mat4[0][3] * (mat4[2][0] * mat4[3][1] - mat4[2][1] * mat4[3][0]));
-
-		// Same as the previous just switch the [2][x] to [1][x] --- Inverse Is Positive
-		res.mat4[2][2] = fInvDet * (mat4[0][0] * (mat4[1][1] * mat4[3][3] - mat4[1][3] * mat4[3][1]) + mat4[0][1] *
-			(mat4[1][3] * mat4[3][0] - mat4[1][0] * mat4[3][3]) + mat4[0][3] * (mat4[1][0] * mat4[3][1] - mat4[1][1] * mat4[3][0]));
-
-		// Same as the previous just switch the [3][x] to [2][x] --- Inverse Is Negative
-		res.mat4[2][3] = -fInvDet * (mat4[0][0] * (mat4[1][1] * mat4[2][3] - mat4[1][3] * mat4[2][1]) + mat4[0][1] *
-			(mat4[1][3] * mat4[2][0] - mat4[1][0] * mat4[2][3]) + mat4[0][3] * (mat4[1][0] * mat4[2][1] - mat4[1][1] * mat4[2][0]));
-
-		// Same as [2][0] ELEMENT calculation, just switch the [x][3] to [x][2] --- Inverse Is Negative
-		res.mat4[3][0] = -fInvDet * (mat4[1][0] * (mat4[2][1] * mat4[3][2] - mat4[2][2] * mat4[3][1]) + mat4[1][1] *
-			(mat4[2][2] * mat4[3][0] - mat4[2][0] * mat4[3][2]) + mat4[1][2] * (mat4[2][0] * mat4[3][1] - mat4[2][1] * mat4[3][0]));
-
-		// Same as the previous just switch the [1][x] to [0][x] --- Inverse Is Positive
-		res.mat4[3][1] = fInvDet * (mat4[0][0] * (mat4[2][1] * mat4[3][2] - mat4[2][2] * mat4[3][1]) + mat4[0][1] *
-			(mat4[2][2] * mat4[3][0] - mat4[2][0] * mat4[3][2]) + mat4[0][2] * (mat4[2][0] * mat4[3][1] - mat4[2][1] * mat4[3][0]));
-
-		// Same as the previous just switch the [2][x] to [1][x] --- Inverse Is Negative
-		res.mat4[3][2] = -fInvDet * (mat4[0][0] * (mat4[1][1] * mat4[3][2] - mat4[1][2] * mat4[3][1]) + mat4[0][1] *
-			(mat4[1][2] * mat4[3][0] - mat4[1][0] * mat4[3][2]) + mat4[0][2] * (mat4[2][0] * mat4[3][1] - mat4[1][1] * mat4[3][0]));
-
-		// Same as the previous just switch the [3][x] to [2][x] --- Inverse Is Positive
-		res.mat4[3][3] = fInvDet * (mat4[0][0] * (mat4[1][1] * mat4[2][2] - mat4[1][2] * mat4[2][1]) + mat4[0][1] *
-			(mat4[1][2] * mat4[3][0] - mat4[1][0] * mat4[2][2]) + mat4[0][2] * (mat4[2][0] * mat4[2][1] - mat4[1][1] * mat4[2][0]));
-
-		// The Pattern -> Previous Calculation (make sure of fInvDet sign) and each time make [x][n] = [x-1][n] , ex: [3][2] -> [2][2], [2][2] -> [1][2], [1][2] -> [0][2]
 		return (res);
 	}
 
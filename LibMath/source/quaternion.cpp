@@ -58,10 +58,10 @@ void Quaternion_FromAxisAngle(float vAxis[3], float fAngle, LPQUAT qOutput, bool
 	if (bRadian)
 		angleRad = -ToRadian(fAngle);
 
-	qOutput->w = std::cosf(angleRad / 2.0f);
+	qOutput->w = std::cos(angleRad / 2.0f);
 
 	//the sine of half the rotation angle
-	float c = std::sinf(angleRad / 2.0f);
+	float c = std::sin(angleRad / 2.0f);
 	qOutput->x = c * vAxis[0];
 	qOutput->y = c * vAxis[1];
 	qOutput->z = c * vAxis[2];
@@ -77,10 +77,10 @@ void Quaternion_FromAxisAngle(const SVector3Df& vAxis, float fAngle, LPQUAT qOut
 	if (bRadian)
 		angleRad = -ToRadian(fAngle);
 
-	qOutput->w = std::cosf(angleRad / 2.0f);
+	qOutput->w = std::cos(angleRad / 2.0f);
 
 	//the sine of half the rotation angle
-	float c = std::sinf(angleRad / 2.0f);
+	float c = std::sin(angleRad / 2.0f);
 	qOutput->x = c * vAxis.x;
 	qOutput->y = c * vAxis.y;
 	qOutput->z = c * vAxis.z;
@@ -91,8 +91,8 @@ float Quaternion_ToAxisAngle(LPQUAT quat, float fOutput[3])
 	assert(fOutput != nullptr && quat != nullptr);
 	// Formula from http://www.euclideanspace.com/maths/geometry/rotations/conversions/quaternionToAngle/
 
-	float Angle = 2.0f * std::acosf(quat->w);
-	float divider = std::sqrtf(1.0f - quat->w * quat->w);
+	float Angle = 2.0f * std::acos(quat->w);
+	float divider = std::sqrt(1.0f - quat->w * quat->w);
 
 	if (divider != 0.0f)
 	{
@@ -116,8 +116,8 @@ float Quaternion_ToAxisAngle(LPQUAT quat, SVector3Df& vec3Output)
 	assert(quat != nullptr);
 	// Formula from http://www.euclideanspace.com/maths/geometry/rotations/conversions/quaternionToAngle/
 
-	float Angle = 2.0f * std::acosf(quat->w);
-	float divider = std::sqrtf(1.0f - quat->w * quat->w);
+	float Angle = 2.0f * std::acos(quat->w);
+	float divider = std::sqrt(1.0f - quat->w * quat->w);
 
 	if (divider != 0.0f)
 	{
@@ -162,12 +162,12 @@ void Quaternion_FromEulerZYX(float eulerZYX[3], LPQUAT qOutput)
 	assert(qOutput != nullptr);
 	// Based on https://en.wikipedia.org/wiki/Conversion_between_quaternions_and_Euler_angles
 
-	float cy = std::cosf(eulerZYX[2] * 0.5f);
-	float sy = std::sinf(eulerZYX[2] * 0.5f);
-	float cr = std::cosf(eulerZYX[0] * 0.5f);
-	float sr = std::sinf(eulerZYX[0] * 0.5f);
-	float cp = std::cosf(eulerZYX[1] * 0.5f);
-	float sp = std::sinf(eulerZYX[1] * 0.5f);
+	float cy = std::cos(eulerZYX[2] * 0.5f);
+	float sy = std::sin(eulerZYX[2] * 0.5f);
+	float cr = std::cos(eulerZYX[0] * 0.5f);
+	float sr = std::sin(eulerZYX[0] * 0.5f);
+	float cp = std::cos(eulerZYX[1] * 0.5f);
+	float sp = std::sin(eulerZYX[1] * 0.5f);
 
 	qOutput->w = cy * cr * cp + sy * sr * sp;
 	qOutput->x = cy * sr * cp - sy * cr * sp;
@@ -180,12 +180,12 @@ void Quaternion_FromEulerZYX(const SVector3Df& v3EulerZYX, LPQUAT qOutput)
 	assert(qOutput != nullptr);
 	// Based on https://en.wikipedia.org/wiki/Conversion_between_quaternions_and_Euler_angles
 
-	float cy = std::cosf(v3EulerZYX.z * 0.5f);
-	float sy = std::sinf(v3EulerZYX.z * 0.5f);
-	float cr = std::cosf(v3EulerZYX.x * 0.5f);
-	float sr = std::sinf(v3EulerZYX.x * 0.5f);
-	float cp = std::cosf(v3EulerZYX.y * 0.5f);
-	float sp = std::sinf(v3EulerZYX.y * 0.5f);
+	float cy = std::cos(v3EulerZYX.z * 0.5f);
+	float sy = std::sin(v3EulerZYX.z * 0.5f);
+	float cr = std::cos(v3EulerZYX.x * 0.5f);
+	float sr = std::sin(v3EulerZYX.x * 0.5f);
+	float cp = std::cos(v3EulerZYX.y * 0.5f);
+	float sp = std::sin(v3EulerZYX.y * 0.5f);
 
 	qOutput->w = cy * cr * cp + sy * sr * sp;
 	qOutput->x = cy * sr * cp - sy * cr * sp;
@@ -200,17 +200,17 @@ void Quaternion_ToEulerZYX(LPQUAT quat, float fOutput[3])
 	// roll (x-axis rotation)
 	float sinr_cosp = 2.0f * (quat->w * quat->x + quat->y * quat->z);
 	float cosr_cosp = 1.0f - 2.0f * (quat->x * quat->x + quat->y * quat->y);
-	fOutput[0] = std::atan2f(sinr_cosp, cosr_cosp);
+	fOutput[0] = std::atan2(sinr_cosp, cosr_cosp);
 
 	// pitch (y-axis rotation)
-	float sinp = std::sqrtf(1.0f + 2.0f * (quat->w * quat->y - quat->x * quat->z));
-	float cosp = std::sqrtf(1.0f - 2.0f * (quat->w * quat->y - quat->x * quat->z));
-	fOutput[1] = 2.0f * std::atan2f(sinp, cosp) - static_cast<float>(M_PI) / 2.0f;
+	float sinp = std::sqrt(1.0f + 2.0f * (quat->w * quat->y - quat->x * quat->z));
+	float cosp = std::sqrt(1.0f - 2.0f * (quat->w * quat->y - quat->x * quat->z));
+	fOutput[1] = 2.0f * std::atan2(sinp, cosp) - static_cast<float>(M_PI) / 2.0f;
 
 	// yaw (z-axis rotation)
 	float siny_cosp = 2.0f * (quat->w * quat->z + quat->x * quat->y);
 	float cosy_cosp = 1.0f - 2.0f * (quat->y * quat->y + quat->z * quat->z);
-	fOutput[2] = std::atan2f(siny_cosp, cosy_cosp);
+	fOutput[2] = std::atan2(siny_cosp, cosy_cosp);
 }
 
 void Quaternion_ToEulerZYX(LPQUAT quat, SVector3Df& v3EulerZYX)
@@ -220,17 +220,17 @@ void Quaternion_ToEulerZYX(LPQUAT quat, SVector3Df& v3EulerZYX)
 	// roll (x-axis rotation)
 	float sinr_cosp = 2.0f * (quat->w * quat->x + quat->y * quat->z);
 	float cosr_cosp = 1.0f - 2.0f * (quat->x * quat->x + quat->y * quat->y);
-	v3EulerZYX.x = std::atan2f(sinr_cosp, cosr_cosp);
+	v3EulerZYX.x = std::atan2(sinr_cosp, cosr_cosp);
 
 	// pitch (y-axis rotation)
-	float sinp = std::sqrtf(1.0f + 2.0f * (quat->w * quat->y - quat->x * quat->z));
-	float cosp = std::sqrtf(1.0f - 2.0f * (quat->w * quat->y - quat->x * quat->z));
-	v3EulerZYX.y = 2.0f * std::atan2f(sinp, cosp) - static_cast<float>(M_PI) / 2.0f;
+	float sinp = std::sqrt(1.0f + 2.0f * (quat->w * quat->y - quat->x * quat->z));
+	float cosp = std::sqrt(1.0f - 2.0f * (quat->w * quat->y - quat->x * quat->z));
+	v3EulerZYX.y = 2.0f * std::atan2(sinp, cosp) - static_cast<float>(M_PI) / 2.0f;
 
 	// yaw (z-axis rotation)
 	float siny_cosp = 2.0f * (quat->w * quat->z + quat->x * quat->y);
 	float cosy_cosp = 1.0f - 2.0f * (quat->y * quat->y + quat->z * quat->z);
-	v3EulerZYX.z = std::atan2f(siny_cosp, cosy_cosp);
+	v3EulerZYX.z = std::atan2(siny_cosp, cosy_cosp);
 }
 
 void Quaternion_Conjugate(LPQUAT quat, LPQUAT qOutput)
@@ -375,8 +375,8 @@ void Quaternion_Slerp(LPQUAT q1, LPQUAT q2, float t, LPQUAT qOutput)
 		return;
 	}
 
-	float halfTheta = std::acosf(cosHalfTheta);
-	float sinHalfTheta = std::sqrtf(1.0f - cosHalfTheta * cosHalfTheta);
+	float halfTheta = std::acos(cosHalfTheta);
+	float sinHalfTheta = std::sqrt(1.0f - cosHalfTheta * cosHalfTheta);
 
 	// if theta = 180 degrees then result is not fully defined
 	// we could rotate around any axis normal to q1 or q2
@@ -391,8 +391,8 @@ void Quaternion_Slerp(LPQUAT q1, LPQUAT q2, float t, LPQUAT qOutput)
 	else
 	{
 		// Default quaternion calculation
-		float ratioA = std::sinf((1 - t) * halfTheta) / sinHalfTheta;
-		float ratioB = std::sinf(t * halfTheta) / sinHalfTheta;
+		float ratioA = std::sin((1 - t) * halfTheta) / sinHalfTheta;
+		float ratioB = std::sin(t * halfTheta) / sinHalfTheta;
 
 		result.w = (q1->w * ratioA + q2->w * ratioB);
 		result.x = (q1->x * ratioA + q2->x * ratioB);
@@ -403,7 +403,7 @@ void Quaternion_Slerp(LPQUAT q1, LPQUAT q2, float t, LPQUAT qOutput)
 	*qOutput = result;
 }
 
-void Quaternion_ToMatrix(LPQUAT q, CMatrix4Df mat)
+void Quaternion_ToMatrix(LPQUAT q, CMatrix4Df& mat)
 {
 	assert(q != nullptr);
 
@@ -60,6 +60,6 @@ extern void Quaternion_Rotate(LPQUAT quat, float v[3], float fOutput[3]);
 extern void Quaternion_Rotate(LPQUAT quat, const SVector3Df& vec3, SVector3Df& vec3OutPut);
 
 extern void Quaternion_Slerp(LPQUAT q1, LPQUAT q2, float t, LPQUAT qOutput);
-extern void Quaternion_ToMatrix(LPQUAT q, CMatrix4Df mat);
+extern void Quaternion_ToMatrix(LPQUAT q, CMatrix4Df& mat);
 extern void Quaternion_RotateVector(const LPQUAT quat, const float v[3], float result[3]);
 extern void Quaternion_RotateVector(const LPQUAT quat, const SVector3Df& vec3, SVector3Df& vec3OutPut);
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "stdafx.h"
+#include "quaternion_simd.h"
+
+CQuaternion CQuaternion::FromAxisAngle(const SVector3Df& v3Axis, float fRadians)
+{
+	const float fHalf = fRadians * 0.5f;
+	const float fSin = std::sin(fHalf);
+
+	return (CQuaternion(v3Axis.x * fSin, v3Axis.y * fSin, v3Axis.z * fSin, std::cos(fHalf)));
+}
+
+CQuaternion CQuaternion::FromMatrix(const CMatrix4Df& mat)
+{
+	const float(&m)[4][4] = mat.mat4;
+	const float fTrace = m[0][0] + m[1][1] + m[2][2];
+
+	// Take the largest of w, x, y, z first so the division stays well conditioned
+	CQuaternion res;
+	if (fTrace > 0.0f)
+	{
+		const float s = 0.5f / std::sqrt(fTrace + 1.0f);
+		res.w = 0.25f / s;
+		res.x = (m[2][1] - m[1][2]) * s;
+		res.y = (m[0][2] - m[2][0]) * s;
+		res.z = (m[1][0] - m[0][1]) * s;
+	}
+	else if (m[0][0] > m[1][1] && m[0][0] > m[2][2])
+	{
+		const float s = 2.0f * std::sqrt(1.0f + m[0][0] - m[1][1] - m[2][2]);
+		res.w = (m[2][1] - m[1][2]) / s;
+		res.x = 0.25f * s;
+		res.y = (m[0][1] + m[1][0]) / s;
+		res.z = (m[0][2] + m[2][0]) / s;
+	}
+	else if (m[1][1] > m[2][2])
+	{
+		const float s = 2.0f * std::sqrt(1.0f + m[1][1] - m[0][0] - m[2][2]);
+		res.w = (m[0][2] - m[2][0]) / s;
+		res.x = (m[0][1] + m[1][0]) / s;
+		res.y = 0.25f * s;
+		res.z = (m[1][2] + m[2][1]) / s;
+	}
+	else
+	{
+		const float s = 2.0f * std::sqrt(1.0f + m[2][2] - m[0][0] - m[1][1]);
+		res.w = (m[1][0] - m[0][1]) / s;
+		res.x = (m[0][2] + m[2][0]) / s;
+		res.y = (m[1][2] + m[2][1]) / s;
+		res.z = 0.25f * s;
+	}
+
+	return (res.Normalized());
+}
+
+CMatrix4Df CQuaternion::ToMatrix() const
+{
+	const float xx = x * x, yy = y * y, zz = z * z;
+	const float xy = x * y, xz = x * z, yz = y * z;
+	const float wx = w * x, wy = w * y, wz = w * z;
+
+	return (CMatrix4Df(
+		1.0f - 2.0f * (yy + zz), 2.0f * (xy - wz), 2.0f * (xz + wy), 0.0f,
+		2.0f * (xy + wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz - wx), 0.0f,
+		2.0f * (xz - wy), 2.0f * (yz + wx), 1.0f - 2.0f * (xx + yy), 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+CQuaternion CQuaternion::Slerp(const CQuaternion& qFrom, const CQuaternion& qTo, float t)
+{
+	float fCos = qFrom.Dot(qTo);
+	CQuaternion qEnd = qTo;
+
+	if (fCos < 0.0f)
+	{
+		fCos = -fCos;
+		qEnd = CQuaternion(-qTo.x, -qTo.y, -qTo.z, -qTo.w);
+	}
+
+	// sin(theta) goes to 0, the weights below would blow up
+	if (fCos > 0.9995f)
+	{
+		return (Nlerp(qFrom, qEnd, t));
+	}
+
+	// sin(acos(c)) = sqrt(1 - c^2), one transcendental call less per pair
+	const float fTheta = std::acos(fCos);
+	const float fInvSin = 1.0f / std::sqrt(1.0f - fCos * fCos);
+	const float fWeightFrom = std::sin((1.0f - t) * fTheta) * fInvSin;
+	const float fWeightTo = std::sin(t * fTheta) * fInvSin;
+
+	return (CQuaternion(
+		qFrom.x * fWeightFrom + qEnd.x * fWeightTo,
+		qFrom.y * fWeightFrom + qEnd.y * fWeightTo,
+		qFrom.z * fWeightFrom + qEnd.z * fWeightTo,
+		qFrom.w * fWeightFrom + qEnd.w * fWeightTo));
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "matrix.h"
+#include "quaternion.h"
+
+/*
+ * Value type quaternion on the simd.h backend
+ *
+ * Stored as (x, y, z, w) in one 16 byte aligned register so the products, normalization and
+ * blends are a handful of SSE instructions. Uses the usual Hamilton product: (a * b) rotates by
+ * b first, then by a. TQuaternion/Quaternion_* stay for the existing callers, convert with
+ * the TQuaternion constructor and ToQuat().
+ */
+class alignas(16) CQuaternion
+{
+public:
+	float x;
+	float y;
+	float z;
+	float w;
+
+	// Identity rotation
+	CQuaternion() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+	CQuaternion(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+	explicit CQuaternion(const TQuaternion& quat) : x(quat.x), y(quat.y), z(quat.z), w(quat.w) {}
+
+	TQuaternion ToQuat() const
+	{
+		TQuaternion quat = { w, x, y, z };
+		return (quat);
+	}
+
+	// fRadians around the (normalized) axis, counter clockwise when looking down the axis
+	static CQuaternion FromAxisAngle(const SVector3Df& v3Axis, float fRadians);
+
+	// Rotation part of mat, the upper 3x3 has to be orthonormal
+	static CQuaternion FromMatrix(const CMatrix4Df& mat);
+
+	// mat * v == Rotate(v) for the CMatrix4Df convention (vec.x = row 0 . v)
+	CMatrix4Df ToMatrix() const;
+
+	CQuaternion operator*(const CQuaternion& quat) const
+	{
+#if defined(MATH_SIMD_SSE)
+		const __m128 a = Load();
+		const __m128 b = quat.Load();
+
+		const __m128 signYW = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+		const __m128 signZW = _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f);
+		const __m128 signXW = _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f);
+
+		__m128 res = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b);
+		res = _mm_add_ps(res, _mm_xor_ps(signYW, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)))));
+		res = _mm_add_ps(res, _mm_xor_ps(signZW, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)))));
+		res = _mm_add_ps(res, _mm_xor_ps(signXW, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)))));
+		return (Store(res));
+#else
+		return (CQuaternion(
+			w * quat.x + x * quat.w + y * quat.z - z * quat.y,
+			w * quat.y - x * quat.z + y * quat.w + z * quat.x,
+			w * quat.z + x * quat.y - y * quat.x + z * quat.w,
+			w * quat.w - x * quat.x - y * quat.y - z * quat.z));
+#endif
+	}
+
+	CQuaternion& operator*=(const CQuaternion& quat)
+	{
+		*this = *this * quat;
+		return (*this);
+	}
+
+	CQuaternion Conjugate() const
+	{
+		return (CQuaternion(-x, -y, -z, w));
+	}
+
+	float Dot(const CQuaternion& quat) const
+	{
+#if defined(MATH_SIMD_SSE)
+		return (_mm_cvtss_f32(Dot4(Load(), quat.Load())));
+#else
+		return (x * quat.x + y * quat.y + z * quat.z + w * quat.w);
+#endif
+	}
+
+	float Length() const
+	{
+		return (std::sqrt(Dot(*this)));
+	}
+
+	CQuaternion Normalized() const
+	{
+#if defined(MATH_SIMD_SSE)
+		const __m128 q = Load();
+		const __m128 len = _mm_sqrt_ps(Dot4(q, q));
+		if (_mm_cvtss_f32(len) == 0.0f)
+		{
+			return (CQuaternion());
+		}
+
+		return (Store(_mm_div_ps(q, len)));
+#else
+		const float fLength = Length();
+		if (fLength == 0.0f)
+		{
+			return (CQuaternion());
+		}
+
+		const float fInvLength = 1.0f / fLength;
+		return (CQuaternion(x * fInvLength, y * fInvLength, z * fInvLength, w * fInvLength));
+#endif
+	}
+
+	CQuaternion& Normalize()
+	{
+		*this = Normalized();
+		return (*this);
+	}
+
+	// v + 2w (u x v) + 2 u x (u x v), u = (x, y, z), expects a unit quaternion
+	SVector3Df Rotate(const SVector3Df& v3Vec) const
+	{
+		const float tx = 2.0f * (y * v3Vec.z - z * v3Vec.y);
+		const float ty = 2.0f * (z * v3Vec.x - x * v3Vec.z);
+		const float tz = 2.0f * (x * v3Vec.y - y * v3Vec.x);
+
+		return (SVector3Df(
+			v3Vec.x + w * tx + (y * tz - z * ty),
+			v3Vec.y + w * ty + (z * tx - x * tz),
+			v3Vec.z + w * tz + (x * ty - y * tx)));
+	}
+
+	// Linear blend on the shorter arc, renormalized. Cheaper than Slerp and close for small angles
+	static CQuaternion Nlerp(const CQuaternion& qFrom, const CQuaternion& qTo, float t)
+	{
+#if defined(MATH_SIMD_SSE)
+		const __m128 a = qFrom.Load();
+		__m128 b = qTo.Load();
+		if (_mm_cvtss_f32(Dot4(a, b)) < 0.0f)
+		{
+			b = _mm_xor_ps(b, _mm_set1_ps(-0.0f));
+		}
+
+		return (Store(_mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(t)))).Normalized());
+#else
+		const float fSign = (qFrom.Dot(qTo) < 0.0f) ? -1.0f : 1.0f;
+		return (CQuaternion(
+			qFrom.x + (fSign * qTo.x - qFrom.x) * t,
+			qFrom.y + (fSign * qTo.y - qFrom.y) * t,
+			qFrom.z + (fSign * qTo.z - qFrom.z) * t,
+			qFrom.w + (fSign * qTo.w - qFrom.w) * t).Normalized());
+#endif
+	}
+
+	// Constant angular speed on the shorter arc, falls back to Nlerp for nearly equal rotations
+	static CQuaternion Slerp(const CQuaternion& qFrom, const CQuaternion& qTo, float t);
+
+private:
+#if defined(MATH_SIMD_SSE)
+	__m128 Load() const
+	{
+		return (_mm_load_ps(&x));
+	}
+
+	static CQuaternion Store(__m128 v)
+	{
+		CQuaternion res;
+		_mm_store_ps(&res.x, v);
+		return (res);
+	}
+
+	// Dot product in every lane
+	static __m128 Dot4(__m128 a, __m128 b)
+	{
+		__m128 v = _mm_mul_ps(a, b);
+		v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return (_mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2))));
+	}
+#endif
+};
+
+static_assert(sizeof(CQuaternion) == 4 * sizeof(float), "CQuaternion must stay a plain xyzw quadruple");
@@ -0,0 +1,257 @@
+#include "stdafx.h"
+#include "random.h"
+#include "simd.h"
+#include <atomic>
+#include <random>
+
+namespace
+{
+	constexpr uint32_t PHILOX_M0 = 0xD2511F53;
+	constexpr uint32_t PHILOX_M1 = 0xCD9E8D57;
+	constexpr uint32_t PHILOX_W0 = 0x9E3779B9;
+	constexpr uint32_t PHILOX_W1 = 0xBB67AE85;
+	constexpr int PHILOX_ROUNDS = 10;
+	constexpr float PHILOX_FLOAT_SCALE = 1.0f / 16777216.0f;	// 2^-24
+
+	// The ThreadLocal() generators start from seed 0 until SetGlobalSeed is called, like rand() before srand()
+	std::atomic<uint64_t> s_ulGlobalSeed{ 0 };
+	std::atomic<uint32_t> s_uiSeedGeneration{ 0 };
+	std::atomic<uint64_t> s_ulNextStream{ 0 };
+
+	void Philox4x32(const uint32_t auiCounter[4], uint64_t ulKey, uint32_t auiOut[4])
+	{
+		uint32_t c0 = auiCounter[0];
+		uint32_t c1 = auiCounter[1];
+		uint32_t c2 = auiCounter[2];
+		uint32_t c3 = auiCounter[3];
+		uint32_t k0 = static_cast<uint32_t>(ulKey);
+		uint32_t k1 = static_cast<uint32_t>(ulKey >> 32);
+
+		for (int i = 0; i < PHILOX_ROUNDS; i++)
+		{
+			const uint64_t ulProd0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+			const uint64_t ulProd1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+
+			c0 = static_cast<uint32_t>(ulProd1 >> 32) ^ c1 ^ k0;
+			c1 = static_cast<uint32_t>(ulProd1);
+			c2 = static_cast<uint32_t>(ulProd0 >> 32) ^ c3 ^ k1;
+			c3 = static_cast<uint32_t>(ulProd0);
+
+			k0 += PHILOX_W0;
+			k1 += PHILOX_W1;
+		}
+
+		auiOut[0] = c0;
+		auiOut[1] = c1;
+		auiOut[2] = c2;
+		auiOut[3] = c3;
+	}
+
+	void MakeCounter(uint64_t ulBlock, uint64_t ulStream, uint32_t auiCounter[4])
+	{
+		auiCounter[0] = static_cast<uint32_t>(ulBlock);
+		auiCounter[1] = static_cast<uint32_t>(ulBlock >> 32);
+		auiCounter[2] = static_cast<uint32_t>(ulStream);
+		auiCounter[3] = static_cast<uint32_t>(ulStream >> 32);
+	}
+
+	float ToUnitFloat(uint32_t uiValue)
+	{
+		return (static_cast<float>(uiValue >> 8) * PHILOX_FLOAT_SCALE);
+	}
+
+#if defined(MATH_SIMD_SSE)
+	// One Philox round on a whole block: _mm_mul_epu32 gives (lo0, hi0, lo1, hi1) from lanes 0 and 2,
+	// reversed that is (hi1, lo1, hi0, lo0) and only lanes 0 and 2 still need c1 ^ k0 and c3 ^ k1
+	__m128i PhiloxRound(__m128i ctr, __m128i mul, __m128i key, __m128i maskEven)
+	{
+		const __m128i prod = _mm_shuffle_epi32(_mm_mul_epu32(ctr, mul), _MM_SHUFFLE(0, 1, 2, 3));
+		const __m128i odd = _mm_and_si128(_mm_shuffle_epi32(ctr, _MM_SHUFFLE(0, 3, 0, 1)), maskEven);
+		return (_mm_xor_si128(prod, _mm_xor_si128(odd, key)));
+	}
+#endif
+}
+
+CRandom::CRandom(uint64_t ulSeed, uint64_t ulStream)
+{
+	Seed(ulSeed, ulStream);
+}
+
+void CRandom::Seed(uint64_t ulSeed, uint64_t ulStream)
+{
+	m_ulSeed = ulSeed;
+	m_ulStream = ulStream;
+	m_ulPosition = 0;
+	m_ulBufferedBlock = UINT64_MAX;
+}
+
+uint64_t CRandom::GetSeed() const
+{
+	return (m_ulSeed);
+}
+
+uint64_t CRandom::GetStream() const
+{
+	return (m_ulStream);
+}
+
+void CRandom::Refill()
+{
+	uint32_t auiCounter[4];
+	m_ulBufferedBlock = m_ulPosition >> 2;
+	MakeCounter(m_ulBufferedBlock, m_ulStream, auiCounter);
+	Philox4x32(auiCounter, m_ulSeed, m_auiBuffer);
+}
+
+uint32_t CRandom::NextU32()
+{
+	if ((m_ulPosition >> 2) != m_ulBufferedBlock)
+	{
+		Refill();
+	}
+
+	return (m_auiBuffer[m_ulPosition++ & 3]);
+}
+
+uint64_t CRandom::NextU64()
+{
+	const uint64_t ulLow = NextU32();
+	return (ulLow | (static_cast<uint64_t>(NextU32()) << 32));
+}
+
+float CRandom::NextFloat()
+{
+	return (ToUnitFloat(NextU32()));
+}
+
+float CRandom::Range(float fMin, float fMax)
+{
+	return (fMin + (fMax - fMin) * NextFloat());
+}
+
+int32_t CRandom::RangeInt(int32_t iMin, int32_t iMax)
+{
+	if (iMax <= iMin)
+	{
+		return (iMin);
+	}
+
+	// Multiply shift instead of modulo, the bias is below 2^-32 * range
+	const uint64_t ulRange = static_cast<uint64_t>(static_cast<int64_t>(iMax) - iMin) + 1;
+	return (static_cast<int32_t>(iMin + static_cast<int64_t>((NextU32() * ulRange) >> 32)));
+}
+
+void CRandom::NextFloat8(float* pOut)
+{
+#if defined(MATH_SIMD_SSE)
+	// The two blocks only line up with the scalar sequence on a block boundary
+	if ((m_ulPosition & 3) != 0)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			pOut[i] = NextFloat();
+		}
+		return;
+	}
+
+	const uint64_t ulBlock = m_ulPosition >> 2;
+	__m128i ctr0 = _mm_set_epi32(static_cast<int>(m_ulStream >> 32), static_cast<int>(m_ulStream), static_cast<int>(ulBlock >> 32), static_cast<int>(ulBlock));
+	__m128i ctr1 = _mm_set_epi32(static_cast<int>(m_ulStream >> 32), static_cast<int>(m_ulStream), static_cast<int>((ulBlock + 1) >> 32), static_cast<int>(ulBlock + 1));
+
+	const __m128i mul = _mm_set_epi32(0, static_cast<int>(PHILOX_M1), 0, static_cast<int>(PHILOX_M0));
+	const __m128i maskEven = _mm_set_epi32(0, -1, 0, -1);
+	const __m128i bump = _mm_set_epi32(0, static_cast<int>(PHILOX_W1), 0, static_cast<int>(PHILOX_W0));
+	__m128i key = _mm_set_epi32(0, static_cast<int>(m_ulSeed >> 32), 0, static_cast<int>(m_ulSeed));
+
+	for (int i = 0; i < PHILOX_ROUNDS; i++)
+	{
+		ctr0 = PhiloxRound(ctr0, mul, key, maskEven);
+		ctr1 = PhiloxRound(ctr1, mul, key, maskEven);
+		key = _mm_add_epi32(key, bump);
+	}
+
+	// The top 24 bits fit a signed int, so the signed convert is exact
+	const __m128 scale = _mm_set1_ps(PHILOX_FLOAT_SCALE);
+	_mm_storeu_ps(pOut, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(ctr0, 8)), scale));
+	_mm_storeu_ps(pOut + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(ctr1, 8)), scale));
+
+	m_ulPosition += 8;
+#else
+	for (int i = 0; i < 8; i++)
+	{
+		pOut[i] = NextFloat();
+	}
+#endif
+}
+
+void CRandom::Fill(float* pOut, size_t uiCount, float fMin, float fMax)
+{
+	const float fDelta = fMax - fMin;
+	size_t i = 0;
+
+	// Get onto a block boundary first so every NextFloat8 takes the two block path
+	for (; i < uiCount && (m_ulPosition & 3) != 0; i++)
+	{
+		pOut[i] = fMin + fDelta * NextFloat();
+	}
+
+	for (; i + 8 <= uiCount; i += 8)
+	{
+		NextFloat8(pOut + i);
+		for (size_t j = i; j < i + 8; j++)
+		{
+			pOut[j] = fMin + fDelta * pOut[j];
+		}
+	}
+
+	for (; i < uiCount; i++)
+	{
+		pOut[i] = fMin + fDelta * NextFloat();
+	}
+}
+
+void CRandom::Discard(uint64_t ulCount)
+{
+	m_ulPosition += ulCount;
+}
+
+CRandom CRandom::Split(uint64_t ulStream) const
+{
+	return (CRandom(m_ulSeed, ulStream));
+}
+
+float CRandom::FloatAt(uint64_t ulSeed, uint32_t a, uint32_t b, uint32_t c)
+{
+	const uint32_t auiCounter[4] = { a, b, c, 0 };
+	uint32_t auiOut[4];
+	Philox4x32(auiCounter, ulSeed, auiOut);
+	return (ToUnitFloat(auiOut[0]));
+}
+
+CRandom& CRandom::ThreadLocal()
+{
+	thread_local uint32_t s_uiGeneration = s_uiSeedGeneration.load(std::memory_order_acquire);
+	thread_local CRandom s_Random(s_ulGlobalSeed.load(std::memory_order_relaxed), s_ulNextStream.fetch_add(1, std::memory_order_relaxed));
+
+	const uint32_t uiGeneration = s_uiSeedGeneration.load(std::memory_order_acquire);
+	if (uiGeneration != s_uiGeneration)
+	{
+		s_uiGeneration = uiGeneration;
+		s_Random.Seed(s_ulGlobalSeed.load(std::memory_order_relaxed), s_Random.GetStream());
+	}
+
+	return (s_Random);
+}
+
+void CRandom::SetGlobalSeed(uint64_t ulSeed)
+{
+	s_ulGlobalSeed.store(ulSeed, std::memory_order_relaxed);
+	s_uiSeedGeneration.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t CRandom::MakeSeed()
+{
+	std::random_device rd;
+	const uint64_t ulHigh = rd();
+	return ((ulHigh << 32) | rd());
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Counter based random number generator (Philox4x32-10)
+ *
+ * Every block of 4 words is a pure function of (seed, stream, block index), so a generator can
+ * jump anywhere in its sequence, streams with the same seed never overlap and a position on the
+ * terrain can be hashed straight to a value (FloatAt) without any state. Results only depend on
+ * the seed, never on the platform or on how many threads produced them.
+ */
+class CRandom
+{
+public:
+	explicit CRandom(uint64_t ulSeed = 0, uint64_t ulStream = 0);
+
+	void Seed(uint64_t ulSeed, uint64_t ulStream = 0);
+	uint64_t GetSeed() const;
+	uint64_t GetStream() const;
+
+	uint32_t NextU32();
+	uint64_t NextU64();
+
+	// [0, 1) with 24 bits of precision
+	float NextFloat();
+
+	// [fMin, fMax)
+	float Range(float fMin, float fMax);
+
+	// [iMin, iMax], both inclusive
+	int32_t RangeInt(int32_t iMin, int32_t iMax);
+
+	// 8 floats in [0, 1), same values as 8 NextFloat() calls but two Philox blocks at once
+	void NextFloat8(float* pOut);
+
+	// uiCount floats in [fMin, fMax)
+	void Fill(float* pOut, size_t uiCount, float fMin = 0.0f, float fMax = 1.0f);
+
+	// Skip ulCount 32 bit draws
+	void Discard(uint64_t ulCount);
+
+	// Same seed, independent sequence. Give each worker or system its own stream
+	CRandom Split(uint64_t ulStream) const;
+
+	// Stateless draw in [0, 1) for (a, b, c), used for per cell noise
+	static float FloatAt(uint64_t ulSeed, uint32_t a, uint32_t b, uint32_t c = 0);
+
+	// Generator of the calling thread. Each thread gets its own stream of the global seed
+	static CRandom& ThreadLocal();
+
+	// Reseeds every ThreadLocal() generator on its next use
+	static void SetGlobalSeed(uint64_t ulSeed);
+	static uint64_t MakeSeed();
+
+private:
+	void Refill();
+
+	uint64_t m_ulSeed;
+	uint64_t m_ulStream;
+	uint64_t m_ulPosition;			// Index of the next 32 bit word
+	uint64_t m_ulBufferedBlock;		// Block held in m_auiBuffer
+	uint32_t m_auiBuffer[4];
+};
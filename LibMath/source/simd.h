@@ -0,0 +1,317 @@
+#pragma once
+
+/*
+ * 4x4 float kernels behind CMatrix4Df
+ *
+ * The backend is picked at compile time: AVX when the compiler targets it (/arch:AVX, -mavx),
+ * SSE2 on every x64 build, the scalar loops otherwise or when MATH_NO_SIMD is defined.
+ * All kernels work on row-major float[16] with unaligned loads, so CMatrix4Df keeps its layout
+ * and can live anywhere (std::vector, SSBO staging structs, ...). The Scalar* versions are
+ * always compiled so benchmarks can compare against them.
+ */
+
+#if !defined(MATH_NO_SIMD)
+	#if defined(__AVX__)
+		#define MATH_SIMD_AVX
+		#define MATH_SIMD_SSE
+	#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define MATH_SIMD_SSE
+	#endif
+#endif
+
+#if defined(MATH_SIMD_SSE)
+	#include <immintrin.h>
+#endif
+
+namespace MathSimd
+{
+	// out = a * b, out may alias a or b
+	inline void ScalarMul4x4(const float* a, const float* b, float* out)
+	{
+		float res[16];
+		for (int i = 0; i < 4; i++)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				res[i * 4 + j] = a[i * 4 + 0] * b[0 * 4 + j] + a[i * 4 + 1] * b[1 * 4 + j] + a[i * 4 + 2] * b[2 * 4 + j] + a[i * 4 + 3] * b[3 * 4 + j];
+			}
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			out[i] = res[i];
+		}
+	}
+
+	// out = m * v (column vector), out may alias v
+	inline void ScalarTransform4(const float* m, const float* v, float* out)
+	{
+		const float x = v[0], y = v[1], z = v[2], w = v[3];
+		out[0] = m[0] * x + m[1] * y + m[2] * z + m[3] * w;
+		out[1] = m[4] * x + m[5] * y + m[6] * z + m[7] * w;
+		out[2] = m[8] * x + m[9] * y + m[10] * z + m[11] * w;
+		out[3] = m[12] * x + m[13] * y + m[14] * z + m[15] * w;
+	}
+
+	inline void ScalarTranspose4x4(const float* m, float* out)
+	{
+		float res[16];
+		for (int i = 0; i < 4; i++)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				res[i * 4 + j] = m[j * 4 + i];
+			}
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			out[i] = res[i];
+		}
+	}
+
+	// Cofactor expansion (same as glm::inverse), returns false and leaves out untouched when singular
+	inline bool ScalarInverse4x4(const float* m, float* out)
+	{
+		const float c00 = m[10] * m[15] - m[14] * m[11];
+		const float c02 = m[6] * m[15] - m[14] * m[7];
+		const float c03 = m[6] * m[11] - m[10] * m[7];
+		const float c04 = m[9] * m[15] - m[13] * m[11];
+		const float c06 = m[5] * m[15] - m[13] * m[7];
+		const float c07 = m[5] * m[11] - m[9] * m[7];
+		const float c08 = m[9] * m[14] - m[13] * m[10];
+		const float c10 = m[5] * m[14] - m[13] * m[6];
+		const float c11 = m[5] * m[10] - m[9] * m[6];
+		const float c12 = m[8] * m[15] - m[12] * m[11];
+		const float c14 = m[4] * m[15] - m[12] * m[7];
+		const float c15 = m[4] * m[11] - m[8] * m[7];
+		const float c16 = m[8] * m[14] - m[12] * m[10];
+		const float c18 = m[4] * m[14] - m[12] * m[6];
+		const float c19 = m[4] * m[10] - m[8] * m[6];
+		const float c20 = m[8] * m[13] - m[12] * m[9];
+		const float c22 = m[4] * m[13] - m[12] * m[5];
+		const float c23 = m[4] * m[9] - m[8] * m[5];
+
+		const float fac0[4] = { c00, c00, c02, c03 };
+		const float fac1[4] = { c04, c04, c06, c07 };
+		const float fac2[4] = { c08, c08, c10, c11 };
+		const float fac3[4] = { c12, c12, c14, c15 };
+		const float fac4[4] = { c16, c16, c18, c19 };
+		const float fac5[4] = { c20, c20, c22, c23 };
+
+		const float vec0[4] = { m[4], m[0], m[0], m[0] };
+		const float vec1[4] = { m[5], m[1], m[1], m[1] };
+		const float vec2[4] = { m[6], m[2], m[2], m[2] };
+		const float vec3[4] = { m[7], m[3], m[3], m[3] };
+
+		float inv[16];
+		for (int i = 0; i < 4; i++)
+		{
+			const float fSignA = (i & 1) ? -1.0f : 1.0f;
+			inv[0 + i] = fSignA * (vec1[i] * fac0[i] - vec2[i] * fac1[i] + vec3[i] * fac2[i]);
+			inv[4 + i] = -fSignA * (vec0[i] * fac0[i] - vec2[i] * fac3[i] + vec3[i] * fac4[i]);
+			inv[8 + i] = fSignA * (vec0[i] * fac1[i] - vec1[i] * fac3[i] + vec3[i] * fac5[i]);
+			inv[12 + i] = -fSignA * (vec0[i] * fac2[i] - vec1[i] * fac4[i] + vec2[i] * fac5[i]);
+		}
+
+		// inv is the adjugate, the first row of m dotted with its first column is the determinant
+		const float fDet = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+		if (fDet == 0.0f)
+		{
+			return (false);
+		}
+
+		const float fInvDet = 1.0f / fDet;
+		for (int i = 0; i < 16; i++)
+		{
+			out[i] = inv[i] * fInvDet;
+		}
+
+		return (true);
+	}
+
+#if defined(MATH_SIMD_SSE)
+	inline void SseMul4x4(const float* a, const float* b, float* out)
+	{
+		const __m128 b0 = _mm_loadu_ps(b + 0);
+		const __m128 b1 = _mm_loadu_ps(b + 4);
+		const __m128 b2 = _mm_loadu_ps(b + 8);
+		const __m128 b3 = _mm_loadu_ps(b + 12);
+
+		// Each result row is a[i][0] * b.row0 + ... + a[i][3] * b.row3
+		__m128 r[4];
+		for (int i = 0; i < 4; i++)
+		{
+			const __m128 a_row = _mm_loadu_ps(a + i * 4);
+			__m128 v = _mm_mul_ps(_mm_shuffle_ps(a_row, a_row, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+			v = _mm_add_ps(v, _mm_mul_ps(_mm_shuffle_ps(a_row, a_row, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+			v = _mm_add_ps(v, _mm_mul_ps(_mm_shuffle_ps(a_row, a_row, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+			v = _mm_add_ps(v, _mm_mul_ps(_mm_shuffle_ps(a_row, a_row, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+			r[i] = v;
+		}
+
+		_mm_storeu_ps(out + 0, r[0]);
+		_mm_storeu_ps(out + 4, r[1]);
+		_mm_storeu_ps(out + 8, r[2]);
+		_mm_storeu_ps(out + 12, r[3]);
+	}
+
+	inline void SseTranspose4x4(const float* m, float* out)
+	{
+		__m128 r0 = _mm_loadu_ps(m + 0);
+		__m128 r1 = _mm_loadu_ps(m + 4);
+		__m128 r2 = _mm_loadu_ps(m + 8);
+		__m128 r3 = _mm_loadu_ps(m + 12);
+
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+		_mm_storeu_ps(out + 0, r0);
+		_mm_storeu_ps(out + 4, r1);
+		_mm_storeu_ps(out + 8, r2);
+		_mm_storeu_ps(out + 12, r3);
+	}
+
+	#define MATH_SIMD_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+	#define MATH_SIMD_SWIZZLE(a, x, y, z, w) _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(a), _MM_SHUFFLE(w, z, y, x)))
+
+	// 2x2 blocks are stored as (m00, m01, m10, m11)
+	inline __m128 SseMat2Mul(__m128 a, __m128 b)
+	{
+		return (_mm_add_ps(_mm_mul_ps(a, MATH_SIMD_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(MATH_SIMD_SWIZZLE(a, 1, 0, 3, 2), MATH_SIMD_SWIZZLE(b, 2, 1, 2, 1))));
+	}
+
+	// adj(a) * b
+	inline __m128 SseMat2AdjMul(__m128 a, __m128 b)
+	{
+		return (_mm_sub_ps(_mm_mul_ps(MATH_SIMD_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(MATH_SIMD_SWIZZLE(a, 1, 1, 2, 2), MATH_SIMD_SWIZZLE(b, 2, 3, 0, 1))));
+	}
+
+	// a * adj(b)
+	inline __m128 SseMat2MulAdj(__m128 a, __m128 b)
+	{
+		return (_mm_sub_ps(_mm_mul_ps(a, MATH_SIMD_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(MATH_SIMD_SWIZZLE(a, 1, 0, 3, 2), MATH_SIMD_SWIZZLE(b, 2, 1, 2, 1))));
+	}
+
+	// Block inverse of | A B ; C D | with 2x2 adjugates, returns false and leaves out untouched when singular
+	inline bool SseInverse4x4(const float* m, float* out)
+	{
+		const __m128 r0 = _mm_loadu_ps(m + 0);
+		const __m128 r1 = _mm_loadu_ps(m + 4);
+		const __m128 r2 = _mm_loadu_ps(m + 8);
+		const __m128 r3 = _mm_loadu_ps(m + 12);
+
+		const __m128 A = _mm_movelh_ps(r0, r1);
+		const __m128 B = _mm_movehl_ps(r1, r0);
+		const __m128 C = _mm_movelh_ps(r2, r3);
+		const __m128 D = _mm_movehl_ps(r3, r2);
+
+		// (|A|, |B|, |C|, |D|)
+		const __m128 detSub = _mm_sub_ps(
+			_mm_mul_ps(MATH_SIMD_SHUFFLE(r0, r2, 0, 2, 0, 2), MATH_SIMD_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+			_mm_mul_ps(MATH_SIMD_SHUFFLE(r0, r2, 1, 3, 1, 3), MATH_SIMD_SHUFFLE(r1, r3, 0, 2, 0, 2)));
+		const __m128 detA = MATH_SIMD_SWIZZLE(detSub, 0, 0, 0, 0);
+		const __m128 detB = MATH_SIMD_SWIZZLE(detSub, 1, 1, 1, 1);
+		const __m128 detC = MATH_SIMD_SWIZZLE(detSub, 2, 2, 2, 2);
+		const __m128 detD = MATH_SIMD_SWIZZLE(detSub, 3, 3, 3, 3);
+
+		const __m128 D_C = SseMat2AdjMul(D, C);
+		const __m128 A_B = SseMat2AdjMul(A, B);
+
+		__m128 X_ = _mm_sub_ps(_mm_mul_ps(detD, A), SseMat2Mul(B, D_C));
+		__m128 W_ = _mm_sub_ps(_mm_mul_ps(detA, D), SseMat2Mul(C, A_B));
+		__m128 Y_ = _mm_sub_ps(_mm_mul_ps(detB, C), SseMat2MulAdj(D, A_B));
+		__m128 Z_ = _mm_sub_ps(_mm_mul_ps(detC, B), SseMat2MulAdj(A, D_C));
+
+		// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+		__m128 tr = _mm_mul_ps(A_B, MATH_SIMD_SWIZZLE(D_C, 0, 2, 1, 3));
+		tr = _mm_add_ps(tr, MATH_SIMD_SWIZZLE(tr, 1, 0, 3, 2));
+		tr = _mm_add_ps(tr, MATH_SIMD_SWIZZLE(tr, 2, 3, 0, 1));
+		const __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+		if (_mm_cvtss_f32(detM) == 0.0f)
+		{
+			return (false);
+		}
+
+		const __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+		X_ = _mm_mul_ps(X_, rDetM);
+		Y_ = _mm_mul_ps(Y_, rDetM);
+		Z_ = _mm_mul_ps(Z_, rDetM);
+		W_ = _mm_mul_ps(W_, rDetM);
+
+		// The final adjugate of each block is folded into the store shuffle
+		_mm_storeu_ps(out + 0, MATH_SIMD_SHUFFLE(X_, Y_, 3, 1, 3, 1));
+		_mm_storeu_ps(out + 4, MATH_SIMD_SHUFFLE(X_, Y_, 2, 0, 2, 0));
+		_mm_storeu_ps(out + 8, MATH_SIMD_SHUFFLE(Z_, W_, 3, 1, 3, 1));
+		_mm_storeu_ps(out + 12, MATH_SIMD_SHUFFLE(Z_, W_, 2, 0, 2, 0));
+
+		return (true);
+	}
+
+	#undef MATH_SIMD_SHUFFLE
+	#undef MATH_SIMD_SWIZZLE
+#endif
+
+#if defined(MATH_SIMD_AVX)
+	// Two result rows per iteration, b's rows are duplicated into both 128 bit lanes
+	inline void AvxMul4x4(const float* a, const float* b, float* out)
+	{
+		const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 0));
+		const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+		const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+		const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12));
+
+		const __m256 a01 = _mm256_loadu_ps(a + 0);
+		const __m256 a23 = _mm256_loadu_ps(a + 8);
+
+		__m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x00), b0);
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x55), b1));
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xAA), b2));
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xFF), b3));
+
+		__m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x00), b0);
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x55), b1));
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0xAA), b2));
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0xFF), b3));
+
+		_mm256_storeu_ps(out + 0, r01);
+		_mm256_storeu_ps(out + 8, r23);
+	}
+#endif
+
+	inline void Mul4x4(const float* a, const float* b, float* out)
+	{
+#if defined(MATH_SIMD_AVX)
+		AvxMul4x4(a, b, out);
+#elif defined(MATH_SIMD_SSE)
+		SseMul4x4(a, b, out);
+#else
+		ScalarMul4x4(a, b, out);
+#endif
+	}
+
+	// The rows would need four products and a transpose for the horizontal sums, which loses
+	// to the scalar dot products on a single vector. Streams go through MathBatch instead
+	inline void Transform4(const float* m, const float* v, float* out)
+	{
+		ScalarTransform4(m, v, out);
+	}
+
+	inline void Transpose4x4(const float* m, float* out)
+	{
+#if defined(MATH_SIMD_SSE)
+		SseTranspose4x4(m, out);
+#else
+		ScalarTranspose4x4(m, out);
+#endif
+	}
+
+	inline bool Inverse4x4(const float* m, float* out)
+	{
+#if defined(MATH_SIMD_SSE)
+		return (SseInverse4x4(m, out));
+#else
+		return (ScalarInverse4x4(m, out));
+#endif
+	}
+}
@@ -13,6 +13,9 @@
 #include "vectors.h"
 #include "quaternion.h"
 #include "matrix.h"
+#include "quaternion_simd.h"
+#include "batch_transform.h"
+#include "random.h"
 #include "frustum.h"
 #include "world_translation.h"
 #include "../../LibGL/source/stdafx.h"
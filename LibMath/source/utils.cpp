@@ -4,32 +4,29 @@
 /**
  * RandomFloat: Generates a random floating-point number between 0.0 and 1.0.
  *
- * This function uses the system's random number generator to produce a random
- * integer and scales it to a floating-point value between 0.0 and 1.0.
+ * This function draws from the calling thread's CRandom::ThreadLocal() stream,
+ * so it is safe to call from worker threads. Reseed with SRANDOM().
  *
  * @return A random floating-point number between 0.0 and 1.0.
  */
 float RandomFloat()
 {
-    /* Maximum possible value of random integer */
-    float Max = RAND_MAX;
-
     /* Return the generated random float */
-    return ((float)RANDOM() / Max);
+    return (CRandom::ThreadLocal().NextFloat());
 }
 
 /**
  * RandomInteger: Generates a random integer.
  *
- * This function utilizes a platform-specific random number generator (RANDOM)
- * to produce a random integer.
+ * This function draws from the calling thread's CRandom::ThreadLocal() stream
+ * and returns a non-negative integer, like rand() did.
  *
- * @return A random integer generated by the system's random number generator.
+ * @return A random non-negative integer.
  */
 int RandomInteger()
 {
     /* Return the generated random integer */
-    return (RANDOM());
+    return (static_cast<int>(CRandom::ThreadLocal().NextU32() >> 1));
 }
 
 /**
@@ -122,7 +119,7 @@ int RandomIntegerRangeI(int Start, int End, const char* file, int line)
     if (Delta != 0)
     {
         /* Generate the random value in the range */
-        RandomValue = RandomInteger() % Delta + Start;
+        RandomValue = CRandom::ThreadLocal().RangeInt(Start, End);
     }
     else
     {
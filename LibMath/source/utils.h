@@ -44,6 +44,7 @@
 
 #include <glm/glm.hpp>
 #include "vectors.h"
+#include "random.h"
 #include <glad/glad.h>
 
 #include "../../LibGL/source/stb_image.h"
@@ -54,16 +55,15 @@ struct SVector3Df;
 #if defined(_WIN64) || defined(_WIN32)
 #define SNPRINTF _snprintf_s
 #define VSNPRINTF vsnprintf_s
-#define RANDOM rand
-#define SRANDOM() srand((unsigned int)time(nullptr))
 #pragma warning (disable: 4566)
 #else
 #define SNPRINTF snprintf
 #define VSNPRINTF vsnprintf
-#define RANDOM random
-#define SRANDOM srandom(getpid())
 #endif
 
+// Reseeds the CRandom::ThreadLocal() generators behind RandomFloat/RandomInteger
+#define SRANDOM() CRandom::SetGlobalSeed(CRandom::MakeSeed())
+
 #define powi(base,exp) (int)powf((float)(base), (float)(exp))
 
 #define ToRadian(x) (float)(((x) * M_PI / 180.0f))
@@ -72,8 +72,8 @@ struct SVector3Df;
 /**
  * RandomFloat: Generates a random floating-point number between 0.0 and 1.0.
  *
- * This function uses the system's random number generator to produce a random
- * integer and scales it to a floating-point value between 0.0 and 1.0.
+ * This function draws from the calling thread's CRandom::ThreadLocal() stream,
+ * so it is safe to call from worker threads. Reseed with SRANDOM().
  *
  * Returns:
  *   A random floating-point number between 0.0 and 1.0.
@@ -83,11 +83,11 @@ extern float RandomFloat();
 /**
  * RandomInteger: Generates a random integer.
  *
- * This function utilizes a platform-specific random number generator (RANDOM)
- * to produce a random integer.
+ * This function draws from the calling thread's CRandom::ThreadLocal() stream
+ * and returns a non-negative integer, like rand() did.
  *
  * Returns:
- *   A random integer generated by the system's random number generator.
+ *   A random non-negative integer.
  */
 extern int RandomInteger();
 
@@ -408,28 +408,24 @@ namespace MyMath
 
     inline glm::vec3 GenerateRandomVec3GLM()
     {
-        std::random_device rd;  //Will be used to obtain a seed for the random number engine
-        std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
-        std::uniform_real_distribution<float> dis(0.0, 100.0);
+        CRandom& rng = CRandom::ThreadLocal();
 
         float x, y, z;
-        x = dis(gen);
-        y = dis(gen);
-        z = dis(gen);
+        x = rng.Range(0.0f, 100.0f);
+        y = rng.Range(0.0f, 100.0f);
+        z = rng.Range(0.0f, 100.0f);
 
         return glm::vec3(x, y, z);
     }
 
     inline SVector3Df GenerateRandomVector3()
     {
-        std::random_device rd;  //Will be used to obtain a seed for the random number engine
-        std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
-        std::uniform_real_distribution<float> dis(0.0, 100.0);
+        CRandom& rng = CRandom::ThreadLocal();
 
         float x, y, z;
-        x = dis(gen);
-        y = dis(gen);
-        z = dis(gen);
+        x = rng.Range(0.0f, 100.0f);
+        y = rng.Range(0.0f, 100.0f);
+        z = rng.Range(0.0f, 100.0f);
 
         return SVector3Df(x, y, z);
     }
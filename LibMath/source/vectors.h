@@ -20,6 +20,9 @@
 
 #include <glm/glm.hpp>
 #include <array>
+#include <cmath>
+#include <cassert>
+#include <stdexcept>
 
 /**
  * SVector2Di: A 2D integer vector struct.
@@ -1822,3 +1825,5 @@ SVector4Df operator*(const SVector4Df& vec1, const SVector4Df& vec2);
  * @throws std::domain_error If any component of the divisor is zero.
  */
 SVector4Df operator/(const SVector4Df& vec1, const SVector4Df& vec2);
+
+#include "vectors.inl"
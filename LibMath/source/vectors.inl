@@ -0,0 +1,1412 @@
+#pragma once
+
+// Definitions of the float vector operations, included at the end of vectors.h so the
+// compiler can inline them into the hot loops (normals, brushes, culling, picking)
+
+/**
+ * Constructs an SVector2Df object with both x and y components initialized to the same value.
+ *
+ * @param fVal The initial value for both x and y components.
+ */
+inline SVector2Df::SVector2Df(float fVal)
+{
+	x = y = fVal;
+}
+
+/**
+ * Constructs an SVector2Df object with specified x and y components.
+ *
+ * @param _x The initial value for the x component.
+ * @param _y The initial value for the y component.
+ */
+inline SVector2Df::SVector2Df(float _x, float _y)
+{
+	x = _x;
+	y = _y;
+}
+
+/**
+ * Constructs an SVector2Df object with both x and y components initialized to the same value.
+ *
+ * @param fVal The initial value for both x and y components.
+ */
+inline SVector2Df::SVector2Df(int iVal)
+{
+	x = y = static_cast<float>(iVal);
+}
+
+/**
+ * Constructs an SVector2Df object with specified x and y components.
+ *
+ * @param _x The initial value for the x component.
+ * @param _y The initial value for the y component.
+ */
+inline SVector2Df::SVector2Df(int _x, int _y)
+{
+	x = static_cast<float>(_x);
+	y = static_cast<float>(_y);
+}
+
+/**
+ * Constructs an SVector2Df object by copying the components from a glm::vec2 vector.
+ *
+ * @param vec The glm::vec2 vector to copy from.
+ */
+inline SVector2Df::SVector2Df(const glm::vec2& vec)
+{
+	x = vec.x;
+	y = vec.y;
+}
+
+/**
+ * Adds two SVector2Df objects component-wise.
+ *
+ * @param vec The SVector2Df object to add.
+ * @return The resulting SVector2Df object.
+ */
+inline SVector2Df SVector2Df::operator+(const SVector2Df& vec)
+{
+	return (SVector2Df(x + vec.x, y + vec.y));
+}
+
+/**
+ * Subtracts one SVector2Df object from another component-wise.
+ *
+ * @param vec The SVector2Df object to subtract.
+ * @return The resulting SVector2Df object.
+ */
+inline SVector2Df SVector2Df::operator-(const SVector2Df& vec)
+{
+	return (SVector2Df(x - vec.x, y - vec.y));
+}
+
+/**
+ * Multiplies two SVector2Df objects component-wise.
+ *
+ * @param vec The SVector2Df object to multiply.
+ * @return The resulting SVector2Df object.
+ */
+inline SVector2Df SVector2Df::operator*(const SVector2Df& vec)
+{
+	return (SVector2Df(x * vec.x, y * vec.y));
+}
+
+/**
+ * Divides one SVector2Df object by another component-wise.
+ *
+ * @param vec The SVector2Df object to divide by.
+ * @return The resulting SVector2Df object.
+ * @throws std::domain_error If either component of the divisor is zero.
+ */
+inline SVector2Df SVector2Df::operator/(const SVector2Df& vec)
+{
+	assert(vec.x != 0.0f && vec.y != 0.0f);
+	return (SVector2Df(x / vec.x, y / vec.y));
+}
+
+/**
+ * Adds a scalar value to both components of an SVector2Df object.
+ *
+ * @param fVal The scalar value to add.
+ * @return The resulting SVector2Df object.
+ */
+inline SVector2Df SVector2Df::operator+(const float fVal)
+{
+	return (SVector2Df(x + fVal, y + fVal));
+}
+
+/**
+ * Subtracts a scalar value from both components of an SVector2Df object.
+ *
+ * @param fVal The scalar value to subtract.
+ * @return The resulting SVector2Df object.
+ */
+inline SVector2Df SVector2Df::operator-(const float fVal)
+{
+	return (SVector2Df(x - fVal, y - fVal));
+}
+
+/**
+ * Multiplies both components of an SVector2Df object by a scalar value.
+ *
+ * @param fVal The scalar value to multiply by.
+ * @return The resulting SVector2Df object.
+ */
+inline SVector2Df SVector2Df::operator*(const float fVal)
+{
+	return (SVector2Df(x * fVal, y * fVal));
+}
+
+/**
+ * Divides both components of an SVector2Df object by a scalar value.
+ *
+ * @param fVal The scalar value to divide by.
+ * @return The resulting SVector2Df object.
+ * @throws std::domain_error If the divisor is zero.
+ */
+inline SVector2Df SVector2Df::operator/(const float fVal)
+{
+	assert(fVal != 0.0f);
+	return (SVector2Df(x / fVal, y / fVal));
+}
+
+/**
+ * Adds another SVector2Df object to this one, modifying this object in-place.
+ *
+ * @param vec The SVector2Df object to add.
+ * @return A reference to this modified SVector2Df object.
+ */
+inline SVector2Df& SVector2Df::operator+=(const SVector2Df& vec)
+{
+	x += vec.x;
+	y += vec.y;
+	return (*this);
+}
+
+/**
+ * Subtracts another SVector2Df object from this one, modifying this object in-place.
+ *
+ * @param vec The SVector2Df object to subtract.
+ * @return A reference to this modified SVector2Df object.
+ */
+inline SVector2Df& SVector2Df::operator-=(const SVector2Df& vec)
+{
+	x -= vec.x;
+	y -= vec.y;
+	return (*this);
+}
+
+/**
+ * Multiplies this SVector2Df object by another one, modifying this object in-place.
+ *
+ * @param vec The SVector2Df object to multiply by.
+ * @return A reference to this modified SVector2Df object.
+ */
+inline SVector2Df& SVector2Df::operator*=(const SVector2Df& vec)
+{
+	x *= vec.x;
+	y *= vec.y;
+	return (*this);
+}
+
+/**
+ * Divides this SVector2Df object by another one, modifying this object in-place.
+ *
+ * @param vec The SVector2Df object to divide by.
+ * @return A reference to this modified SVector2Df object.
+ * @throws std::domain_error If either component of the divisor is zero.
+ */
+inline SVector2Df& SVector2Df::operator/=(const SVector2Df& vec)
+{
+	assert(vec.x != 0.0f && vec.y != 0.0f);
+	x /= vec.x;
+	y /= vec.y;
+	return (*this);
+}
+
+/**
+ * Adds a scalar value to both components of this SVector2Df object, modifying it in-place.
+ *
+ * @param fVal The scalar value to add.
+ * @return A reference to this modified SVector2Df object.
+ */
+inline SVector2Df& SVector2Df::operator+=(const float fVal)
+{
+	x += fVal;
+	y += fVal;
+	return (*this);
+}
+
+/**
+ * Subtracts a scalar value from both components of this SVector2Df object, modifying it in-place.
+ *
+ * @param fVal The scalar value to subtract.
+ * @return A reference to this modified SVector2Df object.
+ */
+inline SVector2Df& SVector2Df::operator-=(const float fVal)
+{
+	x -= fVal;
+	y -= fVal;
+	return (*this);
+}
+
+/**
+ * Multiplies both components of this SVector2Df object by a scalar value, modifying it in-place.
+ *
+ * @param fVal The scalar value to multiply by.
+ * @return A reference to this modified SVector2Df object.
+ */
+inline SVector2Df& SVector2Df::operator*=(const float fVal)
+{
+	x *= fVal;
+	y *= fVal;
+	return (*this);
+}
+
+/**
+ * Divides both components of this SVector2Df object by a scalar value, modifying it in-place.
+ *
+ * @param fVal The scalar value to divide by.
+ * @return A reference to this modified SVector2Df object.
+ * @throws std::domain_error If the divisor is zero.
+ */
+inline SVector2Df& SVector2Df::operator/=(const float fVal)
+{
+	assert(fVal != 0.0f);
+	x /= fVal;
+	y /= fVal;
+	return (*this);
+}
+
+/**
+ * Compares two SVector2Df objects for equality.
+ *
+ * @param vec The SVector2Df object to compare to.
+ * @return true if the two objects are equal, false otherwise.
+ */
+inline bool SVector2Df::operator==(const SVector2Df& vec)
+{
+	return (x == vec.x && y == vec.y);
+}
+
+/**
+ * Compares two SVector2Df objects for inequality.
+ *
+ * @param vec The SVector2Df object to compare to.
+ * @return true if the two objects are not equal, false otherwise.
+ */
+inline bool SVector2Df::operator!=(const SVector2Df& vec)
+{
+	return (!(*this == vec));
+}
+
+/**
+ * Provides a const pointer to the underlying float array.
+ *
+ * This allows direct access to the x and y components as a float array.
+ *
+ * @return A const pointer to the float array.
+ */
+inline SVector2Df::operator const float* () const
+{
+	return (&(x));
+}
+
+/**
+ * Calculates the length (magnitude) of the SVector2Df object.
+ *
+ * @return The length of the vector.
+ */
+inline float SVector2Df::length() const
+{
+	float fLen = sqrtf(x * x + y * y); // Corrected the calculation
+	return (fLen);
+}
+
+/**
+ * Normalizes the SVector2Df object, making its length 1.
+ *
+ * @return A reference to this modified SVector2Df object.
+ * @throws std::domain_error If the vector is zero.
+ */
+inline SVector2Df& SVector2Df::normalize()
+{
+	float fLen = length();
+	assert(fLen != 0.0f);
+	x /= fLen;
+	y /= fLen;
+	return (*this);
+}
+
+/**
+ * Returns a pointer to the underlying float array.
+ *
+ * This allows direct access to the x and y components as a float array.
+ *
+ * @return A pointer to the float array.
+ */
+inline float* SVector2Df::data()
+{
+	return &(x);
+}
+
+/**
+ * Checks if both components of the SVector2Df object are zero.
+ *
+ * @return true if both components are zero, false otherwise.
+ */
+inline bool SVector2Df::IsZero() const
+{
+	return ((x == 0.0f) && (y == 0.0f)); // Corrected the condition
+}
+
+/**
+ * Sets both components of the SVector2Df object to the specified value.
+ *
+ * @param fVal The value to set both components to.
+ */
+inline void SVector2Df::SetAll(float fVal)
+{
+	x = y = fVal;
+}
+
+/**
+ * Sets both components of the SVector2Df object to zero.
+ */
+inline void SVector2Df::SetToZero()
+{
+	SetAll(0.0f);
+}
+
+/**
+ * Converts the SVector2Df object to a glm::vec2 object.
+ *
+ * @return The equivalent glm::vec2 object.
+ */
+inline glm::vec2 SVector2Df::ToGLM() const
+{
+	return (glm::vec2(x, y));
+}
+
+/**
+ * Adds a scalar value to both components of an SVector2Df object.
+ *
+ * @param vec The SVector2Df object to add to.
+ * @param fVal The scalar value to add.
+ * @return The resulting SVector2Df object.
+ */
+inline SVector2Df operator+(const SVector2Df& vec, float fVal)
+{
+	SVector2Df Result(vec.x + fVal, vec.y + fVal);
+	return (Result);
+}
+
+/**
+ * Subtracts a scalar value from both components of an SVector2Df object.
+ *
+ * @param vec The SVector2Df object to subtract from.
+ * @param fVal The scalar value to subtract.
+ * @return The resulting SVector2Df object.
+ */
+inline SVector2Df operator-(const SVector2Df& vec, float fVal)
+{
+	SVector2Df Result(vec.x - fVal, vec.y - fVal);
+	return (Result);
+}
+
+/**
+ * Multiplies both components of an SVector2Df object by a scalar value.
+ *
+ * @param vec The SVector2Df object to multiply.
+ * @param fVal The scalar value to multiply by.
+ * @return The resulting SVector2Df object.
+ */
+inline SVector2Df operator*(const SVector2Df& vec, float fVal)
+{
+	SVector2Df Result(vec.x * fVal, vec.y * fVal);
+	return (Result);
+}
+
+/**
+ * Divides both components of an SVector2Df object by a scalar value.
+ *
+ * @param vec The SVector2Df object to divide.
+ * @param fVal The scalar value to divide by.
+ * @return The resulting SVector2Df object.
+ * @throws std::domain_error If the divisor is zero.
+ */
+inline SVector2Df operator/(const SVector2Df& vec, float fVal)
+{
+	assert(fVal != 0.0f);
+	SVector2Df Result(vec.x / fVal, vec.y / fVal);
+	return (Result);
+}
+
+/************************************************************************************************/
+/************************************************************************************************/
+/************************************************************************************************/
+/************************************************************************************************/
+/************************************************************************************************/
+
+/**
+ * Constructs an SVector3Df object with all components set to the same value.
+ *
+ * @param fVal The value to set all components to.
+ */
+inline SVector3Df::SVector3Df(const float fVal)
+{
+	x = y = z = fVal;
+}
+
+/**
+ * Constructs an SVector3Df object with specified values for each component.
+ *
+ * @param _x The value for the x component.
+ * @param _y The value for the y component.
+ * @param _z The value for the z component. 
+ */
+inline SVector3Df::SVector3Df(const float _x, const float _y, const float _z)
+{
+	x = _x;
+	y = _y;
+	z = _z;
+}
+
+/**
+ * Constructs an SVector3Df object from a pointer to a float array.
+ *
+ * @param pVec The pointer to the float array.
+ * @throws std::runtime_error If the pointer is null.
+ */
+inline SVector3Df::SVector3Df(const float* pVec)
+{
+	if (!pVec)
+	{
+		x = y = z = 0.0f;
+		return;
+	}
+
+	x = pVec[0];
+	y = pVec[1];
+	z = pVec[2];
+}
+
+/**
+ * Constructs an SVector3Df object from an SVector2Df object, setting the z component to zero.
+ *
+ * @param vec The SVector2Df object to construct from.
+ */
+inline SVector3Df::SVector3Df(const SVector2Df& vec)
+{
+	x = vec.x;
+	y = vec.y;
+	z = 0.0f;
+}
+
+/**
+ * Constructs an SVector3Df object from a glm::vec3 object.
+ *
+ * @param vec The glm::vec3 object to construct from.
+ */
+inline SVector3Df::SVector3Df(const glm::vec3& vec)
+{
+	x = vec.x;
+	y = vec.y;
+	z = vec.z;
+}
+
+/**
+ * Constructs an SVector3Df object from a SVector3Df object.
+ *
+ * @param vec The glm::vec3 object to construct from.
+ */
+inline SVector3Df::SVector3Df(const SVector3Df& vec)
+{
+	x = vec.x;
+	y = vec.y;
+	z = vec.z;
+}
+
+/**
+ * Constructs an SVector3Df object from a SVector4Df object.
+ *
+ * @param vec The glm::vec3 object to construct from.
+ */
+inline SVector3Df::SVector3Df(const SVector4Df& vec)
+{
+	x = vec.x;
+	y = vec.y;
+	z = vec.z;
+}
+
+/**
+ * Constructs an SVector3Df object from a glm::vec4 object.
+ *
+ * @param vec The glm::vec3 object to construct from.
+ */
+inline SVector3Df::SVector3Df(const glm::vec4& vec)
+{
+	x = vec.x;
+	y = vec.y;
+	z = vec.z;
+}
+
+/**
+ * Adds two SVector3Df objects component-wise.
+ *
+ * @param vec The SVector3Df object to add.
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df SVector3Df::operator+(const SVector3Df& vec)
+{
+	return (SVector3Df(x + vec.x, y + vec.y, z + vec.z));
+}
+
+/**
+ * Subtracts one SVector3Df object from another component-wise.
+ *
+ * @param vec The SVector3Df object to subtract.
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df SVector3Df::operator-(const SVector3Df& vec)
+{
+	return (SVector3Df(x - vec.x, y - vec.y, z - vec.z));
+}
+
+/**
+ * Multiplies two SVector3Df objects component-wise.
+ *
+ * @param vec The SVector3Df object to multiply.
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df SVector3Df::operator*(const SVector3Df& vec)
+{
+	return (SVector3Df(x * vec.x, y * vec.y, z * vec.z));
+}
+
+/**
+ * Divides one SVector3Df object by another component-wise.
+ *
+ * @param vec The SVector3Df object to divide by.
+ * @return The resulting SVector3Df object.
+ * @throws std::domain_error If any component of the divisor is zero.
+ */
+inline SVector3Df SVector3Df::operator/(const SVector3Df& vec)
+{
+	assert(vec.x != 0 && vec.y != 0);
+	return (SVector3Df(x / vec.x, y / vec.y, z / vec.z));
+}
+
+/**
+ * Adds a scalar value to all components of an SVector3Df object.
+ *
+ * @param fVal The scalar value to add.
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df SVector3Df::operator+(const float fVal)
+{
+	return (SVector3Df(x + fVal, y + fVal, z + fVal));
+}
+
+/**
+ * Subtracts a scalar value from all components of an SVector3Df object.
+ *
+ * @param fVal The scalar value to subtract.
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df SVector3Df::operator-(const float fVal)
+{
+	return (SVector3Df(x - fVal, y - fVal, z - fVal));
+}
+
+/**
+ * Subtracts a scalar value from all components of an SVector3Df object.
+ *
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df SVector3Df::operator-() const
+{
+	return (SVector3Df(-x, -y, -z));
+}
+
+/**
+ * Multiplies all components of an SVector3Df object by a scalar value.
+ *
+ * @param fVal The scalar value to multiply by.
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df SVector3Df::operator*(const float fVal)
+{
+	return (SVector3Df(x * fVal, y * fVal, z * fVal));
+}
+
+/**
+ * Divides all components of an SVector3Df object by a scalar value.
+ *
+ * @param fVal The scalar value to divide by.
+ * @return The resulting SVector3Df object.
+ * @throws std::domain_error If the divisor is zero.
+ */
+inline SVector3Df SVector3Df::operator/(const float fVal)
+{
+	assert(fVal != 0.0f);
+	return (SVector3Df(x / fVal, y / fVal, z / fVal));
+}
+
+/**
+ * Adds another SVector3Df object to this one, modifying this object in-place.
+ *
+ * @param vec The SVector3Df object to add.
+ * @return A reference to this modified SVector3Df object.
+ */
+inline SVector3Df& SVector3Df::operator+=(const SVector3Df& vec)
+{
+	x += vec.x;
+	y += vec.y;
+	z += vec.z;
+	return (*this);
+}
+
+/**
+ * Subtracts another SVector3Df object from this one, modifying this object in-place.
+ *
+ * @param vec The SVector3Df object to subtract.
+ * @return A reference to this modified SVector3Df object.
+ */
+inline SVector3Df& SVector3Df::operator-=(const SVector3Df& vec)
+{
+	x -= vec.x;
+	y -= vec.y;
+	z -= vec.z;
+	return (*this);
+}
+
+/**
+ * Multiplies this SVector3Df object by another one, modifying this object in-place.
+ *
+ * @param vec The SVector3Df object to multiply by.
+ * @return A reference to this modified SVector3Df object.
+ */
+inline SVector3Df& SVector3Df::operator*=(const SVector3Df& vec)
+{
+	x *= vec.x;
+	y *= vec.y;
+	z *= vec.z;
+	return (*this);
+}
+
+/**
+ * Divides this SVector3Df object by another one, modifying this object in-place.
+ *
+ * @param vec The SVector3Df object to divide by.
+ * @return A reference to this modified SVector3Df object.
+ * @throws std::domain_error If any component of the divisor is zero.
+ */
+inline SVector3Df& SVector3Df::operator/=(const SVector3Df& vec)
+{
+	assert(vec.x != 0.0f && vec.y != 0.0f && vec.z != 0.0f);
+	x /= vec.x;
+	y /= vec.y;
+	z /= vec.z;
+	return (*this);
+}
+
+/**
+ * Adds a scalar value to all components of this SVector3Df object, modifying it in-place.
+ *
+ * @param fVal The scalar value to add.
+ * @return A reference to this modified SVector3Df object.
+ */
+inline SVector3Df& SVector3Df::operator+=(const float fVal)
+{
+	x += fVal;
+	y += fVal;
+	z += fVal;
+	return (*this);
+}
+
+/**
+ * Subtracts a scalar value from all components of this SVector3Df object, modifying it in-place.
+ *
+ * @param fVal The scalar value to subtract.
+ * @return A reference to this modified SVector3Df object.
+ */
+inline SVector3Df& SVector3Df::operator-=(const float fVal)
+{
+	x -= fVal;
+	y -= fVal;
+	z -= fVal;
+	return (*this);
+}
+
+/**
+ * Multiplies all components of this SVector3Df object by a scalar value, modifying it in-place.
+ *
+ * @param fVal The scalar value to multiply by.
+ * @return A reference to this modified SVector3Df object.
+ */
+inline SVector3Df& SVector3Df::operator*=(const float fVal)
+{
+	x *= fVal;
+	y *= fVal;
+	z *= fVal;
+	return (*this);
+}
+
+/**
+ * Divides all components of this SVector3Df object by a scalar value, modifying it in-place.
+ *
+ * @param fVal The scalar value to divide by.
+ * @return A reference to this modified SVector3Df object.
+ * @throws std::domain_error If the divisor is zero.
+ */
+inline SVector3Df& SVector3Df::operator/=(const float fVal)
+{
+	assert(fVal != 0);
+	x /= fVal;
+	y /= fVal;
+	z /= fVal;
+	return (*this);
+}
+
+/**
+ * Compares two SVector3Df objects for equality.
+ *
+ * @param vec The SVector3Df object to compare to.
+ * @return true if the two objects are equal, false otherwise.
+ */
+inline bool SVector3Df::operator == (const SVector3Df& vec)
+{
+	return (x == vec.x && y == vec.y && z == vec.z);
+}
+
+/**
+ * Compares two SVector3Df objects for inequality.
+ *
+ * @param vec The SVector3Df object to compare to.
+ * @return true if the two objects are not equal, false otherwise.
+ */
+inline bool SVector3Df::operator != (const SVector3Df& vec)
+{
+	return (!(*this == vec));
+}
+
+/**
+ * Provides a const pointer to the underlying float array.
+ *
+ * This allows direct access to the x, y, and z components as a float array.
+ *
+ * @return A const pointer to the float array.
+ */
+inline SVector3Df::operator const float* () const
+{
+	return (&(x));
+}
+
+/**
+ * Calculates the length (magnitude) of the SVector3Df object.
+ *
+ * @return The length of the vector.
+ */
+inline float SVector3Df::length() const
+{
+	float fLen = std::sqrt(x * x + y * y + z * z); // works
+	return (std::abs(fLen));
+}
+
+/**
+ * Normalizes the SVector3Df object, making its length 1.
+ *
+ * @return A reference to this modified SVector3Df object.
+ * @throws std::domain_error If the vector is zero.
+ */
+inline SVector3Df& SVector3Df::normalize()
+{
+	float fLen = length();
+	assert(fLen != 0.0f);
+	x /= fLen;
+	y /= fLen;
+	z /= fLen;
+	return (*this);
+}
+
+/**
+ * Check if the vector can be normalized
+ *
+ * @return true if the Vector can be normalized, otherwise false
+ */
+inline bool SVector3Df::CanNormalize() const
+{
+	if (length() > 0.0f)
+		return (true);
+
+	return (false);
+}
+
+/**
+ * Calculates the dot product of two SVector3Df objects.
+ *
+ * @param vec The SVector3Df object to calculate the dot product with.
+ * @return The dot product of the two vectors.
+ */
+inline float SVector3Df::dot(const SVector3Df& vec) const
+{
+	float fRet = x * vec.x + y * vec.y + z * vec.z;
+	return (fRet);
+}
+
+/**
+ * Calculates the cross product of two SVector3Df objects.
+ *
+ * @param vec The SVector3Df object to calculate the cross product with.
+ * @return The cross product of the two vectors.
+ */
+inline SVector3Df SVector3Df::cross(const SVector3Df& vec) const
+{
+	const float _x = y * vec.z - z * vec.y;
+	const float _y = z * vec.x - x * vec.z;
+	const float _z = x * vec.y - y * vec.x;
+	return SVector3Df(_x, _y, _z);
+}
+
+/**
+ * Calculates the Euclidean distance between two SVector3Df objects.
+ *
+ * @param vec The SVector3Df object to calculate the distance to.
+ * @return The distance between the two vectors.
+ */
+inline float SVector3Df::distance(const SVector3Df& vec) const
+{
+	float delta_x = x - vec.x;
+	float delta_y = y - vec.y;
+	float delta_z = z - vec.z;
+
+	float distance = sqrtf(delta_x * delta_x + delta_y * delta_y + delta_z * delta_z);
+	return (distance);
+}
+
+/**
+ * Negates all components of the SVector3Df object.
+ *
+ * @return The negated SVector3Df object.
+ */
+inline SVector3Df SVector3Df::negate() const
+{
+	SVector3Df result(-x, -y, -z);
+	return (result);
+}
+
+/**
+ * Returns a pointer to the underlying float array.
+ *
+ * This allows direct access to the x, y, and z components as a float array.
+ *
+ * @return A pointer to the float array.
+ */
+inline float* SVector3Df::data()
+{
+	return &(x);
+}
+
+/**
+ * Checks if all components of the SVector3Df object are zero.
+ *
+ * @return true if all components are zero, false otherwise.
+ */
+inline bool SVector3Df::IsZero() const
+{
+	return ((x + y + z) == 0.0f);
+}
+
+/**
+ * Sets all components of the SVector3Df object to the specified value.
+ *
+ * @param fVal The value to set all components to.
+ */
+inline void SVector3Df::SetAll(float fVal)
+{
+	x = y = z = fVal;
+}
+
+/**
+ * Sets all components of the SVector3Df object to zero.
+ */
+inline void SVector3Df::SetToZero()
+{
+	SetAll(0.0f);
+}
+
+/**
+ * Converts the SVector3Df object to a glm::vec3 object.
+ *
+ * @return The equivalent glm::vec3 object.
+ */
+inline glm::vec3 SVector3Df::ToGLM() const
+{
+	return (glm::vec3(x, y, z));
+}
+
+/**
+ * Adds a scalar value to all components of an SVector3Df object.
+ *
+ * @param vec The SVector3Df object to add to.
+ * @param fVal The scalar value to add.
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df operator+(const SVector3Df& vec, float fVal)
+{
+	SVector3Df Result(vec.x + fVal, vec.y + fVal, vec.z + fVal);
+	return (Result);
+}
+
+/**
+ * Subtracts a scalar value from all components of an SVector3Df object.
+ *
+ * @param vec The SVector3Df object to subtract from.
+ * @param fVal The scalar value to subtract.
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df operator-(const SVector3Df& vec, float fVal)
+{
+	SVector3Df Result(vec.x - fVal, vec.y - fVal, vec.z - fVal);
+	return (Result);
+}
+
+/**
+ * Multiplies all components of an SVector3Df object by a scalar value.
+ *
+ * @param vec The SVector3Df object to multiply.
+ * @param fVal The scalar value to multiply by.
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df operator*(const SVector3Df& vec, float fVal)
+{
+	SVector3Df Result(vec.x * fVal, vec.y * fVal, vec.z * fVal);
+	return (Result);
+}
+
+/**
+ * Divides all components of an SVector3Df object by a scalar value.
+ *
+ * @param vec The SVector3Df object to divide.
+ * @param fVal The scalar value to divide by.
+ * @return The resulting SVector3Df object.
+ * @throws std::domain_error If the divisor is zero.
+ */
+inline SVector3Df operator/(const SVector3Df& vec, float fVal)
+{
+	assert(fVal != 0.0f);
+	SVector3Df Result(vec.x / fVal, vec.y / fVal, vec.z / fVal);
+	return (Result);
+}
+
+/**
+ * Adds two SVector3Df objects component-wise.
+ *
+ * @param vec1 The first SVector3Df object.
+ * @param vec2 The second SVector3Df object.
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df operator+(const SVector3Df& vec1, const SVector3Df& vec2)
+{
+	SVector3Df Result(vec1.x + vec2.x, vec1.y + vec2.y, vec1.z + vec2.z);
+	return (Result);
+}
+
+/**
+ * Subtracts one SVector3Df object from another component-wise.
+ *
+ * @param vec1 The first SVector3Df object.
+ * @param vec2 The second SVector3Df object to subtract.
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df operator-(const SVector3Df& vec1, const SVector3Df& vec2)
+{
+	SVector3Df Result(vec1.x - vec2.x, vec1.y - vec2.y, vec1.z - vec2.z);
+	return (Result);
+}
+
+/**
+ * Multiplies two SVector3Df objects component-wise.
+ *
+ * @param vec1 The first SVector3Df object.
+ * @param vec2 The second SVector3Df object to multiply.
+ * @return The resulting SVector3Df object.
+ */
+inline SVector3Df operator*(const SVector3Df& vec1, const SVector3Df& vec2)
+{
+	SVector3Df Result(vec1.x * vec2.x, vec1.y * vec2.y, vec1.z * vec2.z);
+	return (Result);
+}
+
+/**
+ * Divides one SVector3Df object by another component-wise.
+ *
+ * @param vec1 The first SVector3Df object.
+ * @param vec2 The second SVector3Df object to divide by.
+ * @return The resulting SVector3Df object.
+ * @throws std::domain_error If any component of the divisor is zero.
+ */
+inline SVector3Df operator/(const SVector3Df& vec1, const SVector3Df& vec2)
+{
+	assert(vec2.x != 0.0f && vec2.y != 0.0f && vec2.z != 0.0f);
+	SVector3Df Result(vec1.x / vec2.x, vec1.y / vec2.y, vec1.z / vec2.z);
+	return (Result);
+}
+
+/************************************************************************************************/
+/************************************************************************************************/
+/************************************************************************************************/
+/************************************************************************************************/
+/************************************************************************************************/
+
+/**
+ * SVector4Df constructor that initializes all components to a single value.
+ *
+ * @param fVal The value to initialize all components to.
+ */
+inline SVector4Df::SVector4Df(const float fVal)
+{
+	x = y = z = w = fVal;
+}
+
+/**
+ * SVector4Df constructor that initializes each component with a separate value.
+ *
+ * @param _x The value for the x component.
+ * @param _y The value for the y component.
+ * @param _z The value for the z component.
+ * @param _w The value for the w component. (scalar)
+ */
+inline SVector4Df::SVector4Df(const float _x, const float _y, const float _z, const float _w)
+{
+	x = _x;
+	y = _y;
+	z = _z;
+	w = _w;
+}
+
+/**
+ * SVector4Df constructor that initializes from a raw float pointer.
+ *
+ * If the pointer is null, all components are set to zero.
+ *
+ * @param pVec The pointer to a float array (length 4).
+ */
+inline SVector4Df::SVector4Df(const float* pVec)
+{
+	if (!pVec)
+	{
+		x = y = z = w = 0;
+		return;
+	}
+
+	x = pVec[0];
+	y = pVec[1];
+	z = pVec[2];
+	w = pVec[3];
+}
+
+/**
+ * SVector4Df constructor that initializes from an SVector2Df and two additional values.
+ *
+ * @param vec The SVector2Df object to copy from.
+ * @param _z The value for the z component.
+ * @param _w The value for the w component.
+ */
+inline SVector4Df::SVector4Df(const SVector2Df& vec, const float _z, const float _w)
+{
+	x = vec.x;
+	y = vec.y;
+	z = _z;
+	w = _w;
+}
+
+/**
+ * SVector4Df constructor that initializes from an SVector3Df and one additional value.
+ *
+ * @param vec The SVector3Df object to copy from.
+ * @param _w The value for the w component.
+ */
+inline SVector4Df::SVector4Df(const SVector3Df& vec, const float _w)
+{
+	x = vec.x;
+	y = vec.y;
+	z = vec.z;
+	w = _w;
+}
+
+/**
+ * SVector4Df constructor that initializes from a glm::vec3 and a scalar value.
+ *
+ * @param vec The glm::vec3 object to copy from.
+ * @param _w The value for the w component.
+ */
+inline SVector4Df::SVector4Df(const glm::vec3& vec, const float _w)
+{
+	x = vec.x;
+	y = vec.y;
+	z = vec.z;
+	w = _w;
+}
+
+/**
+ * SVector4Df copy constructor.
+ *
+ * @param vec The SVector4Df object to copy.
+ */
+inline SVector4Df::SVector4Df(const SVector4Df& vec)
+{
+	x = vec.x;
+	y = vec.y;
+	z = vec.z;
+	w = vec.w;
+}
+
+/**
+ * SVector4Df constructor that initializes from a glm::vec4 object.
+ *
+ * @param vec The glm::vec4 object to copy from.
+ */
+inline SVector4Df::SVector4Df(const glm::vec4& vec)
+{
+	x = vec.x;
+	y = vec.y;
+	z = vec.z;
+	w = vec.w;
+}
+
+/**
+ * Compares two SVector4Df objects for equality.
+ *
+ * @param vec The SVector4Df object to compare to.
+ * @return true if the two objects are equal, false otherwise.
+ */
+inline bool SVector4Df::operator == (const SVector4Df& vec)
+{
+	return (x == vec.x && y == vec.y && z == vec.z && w == vec.w);
+}
+
+/**
+ * Compares two SVector4Df objects for inequality.
+ *
+ * @param vec The SVector4Df object to compare to.
+ * @return true if the two objects are not equal, false otherwise.
+ */
+inline bool SVector4Df::operator != (const SVector4Df& vec)
+{
+	return (!(*this == vec));
+}
+
+/**
+ * Provides a const pointer to the underlying float array.
+ *
+ * This allows direct access to the x, y, z, and w components as a float array.
+ *
+ * @return A const pointer to the float array.
+ */
+inline SVector4Df::operator const float* () const
+{
+	return (&(x));
+}
+
+/**
+ * Calculates the length (magnitude) of the SVector4Df object.
+ *
+ * @return The length of the vector.
+ */
+inline float SVector4Df::length() const
+{
+	float fLen = sqrtf(x * x + y * y + z * z + w * w);
+	return (fLen);
+}
+
+/**
+ * Normalizes the SVector4Df object, making its length 1.
+ *
+ * @return A reference to this modified SVector4Df object.
+ * @throws std::domain_error If the vector is zero.
+ */
+inline SVector4Df& SVector4Df::normalize()
+{
+	float fLen = length();
+	assert(fLen != 0.0f);
+	x /= fLen;
+	y /= fLen;
+	z /= fLen;
+	w /= fLen;
+	return (*this);
+}
+
+/**
+ * Calculates the dot product of two SVector4Df objects.
+ *
+ * @param vec The SVector4Df object to calculate the dot product with.
+ * @return The dot product of the two vectors.
+ */
+inline float SVector4Df::dot(const SVector4Df& vec) const
+{
+	float fRet = x * vec.x + y * vec.y + z * vec.z + w * vec.w;
+	return (fRet);
+}
+
+/**
+ * Returns a pointer to the underlying float array.
+ *
+ * This allows direct access to the x, y, z, and w components as a float array.
+ *
+ * @return A pointer to the float array.
+ */
+inline float* SVector4Df::data()
+{
+	return (&(x));
+}
+
+/**
+ * Checks if all components of the SVector4Df object are zero.
+ *
+ * @return true if all components are zero, false otherwise.
+ */
+inline bool SVector4Df::IsZero() const
+{
+	return ((x + y + z + w) == 0.0f);
+}
+
+/**
+ * Sets all components of the SVector4Df object to the specified value.
+ *
+ * @param fVal The value to set all components to.
+ */
+inline void SVector4Df::SetAll(const float fVal)
+{
+	x = y = z = w = fVal;
+}
+
+/**
+ * Sets all components of the SVector4Df object to zero.
+ */
+inline void SVector4Df::SetToZero()
+{
+	SetAll(0.0f);
+}
+
+/**
+ * Converts the SVector4Df object to a glm::vec4 object.
+ *
+ * @return The equivalent glm::vec4 object.
+ */
+inline glm::vec4 SVector4Df::ToGLM() const
+{
+	return (glm::vec4(x, y, z, w));
+}
+
+/************************************************************************************************/
+/************************************************************************************************/
+/************************************************************************************************/
+/************************************************************************************************/
+/************************************************************************************************/
+
+/**
+ * Converts the SVector4Df object to an SVector3Df object by discarding the w component.
+ *
+ * @return The equivalent SVector3Df object.
+ */
+inline SVector3Df SVector4Df::To3D() const
+{
+	return SVector3Df(x, y, z);
+}
+
+/************************************************************************************************/
+/************************************************************************************************/
+/************************************************************************************************/
+/************************************************************************************************/
+/************************************************************************************************/
+
+/**
+ * Adds a scalar value to all components of an SVector4Df object.
+ *
+ * @param vec The SVector4Df object to add to.
+ * @param fVal The scalar value to add.
+ * @return The resulting SVector4Df object.
+ */
+inline SVector4Df operator+(const SVector4Df& vec, float fVal)
+{
+	SVector4Df Result(vec.x + fVal, vec.y + fVal, vec.z + fVal, vec.w + fVal);
+	return (Result);
+}
+
+/**
+ * Subtracts a scalar value from all components of an SVector4Df object.
+ *
+ * @param vec The SVector4Df object to subtract from.
+ * @param fVal The scalar value to subtract.
+ * @return The resulting SVector4Df object.
+ */
+inline SVector4Df operator-(const SVector4Df& vec, float fVal)
+{
+	SVector4Df Result(vec.x - fVal, vec.y - fVal, vec.z - fVal, vec.w - fVal);
+	return (Result);
+}
+
+/**
+ * Multiplies all components of an SVector4Df object by a scalar value.
+ *
+ * @param vec The SVector4Df object to multiply.
+ * @param fVal The scalar value to multiply by.
+ * @return The resulting SVector4Df object.
+ */
+inline SVector4Df operator*(const SVector4Df& vec, float fVal)
+{
+	SVector4Df Result(vec.x * fVal, vec.y * fVal, vec.z * fVal, vec.w * fVal);
+	return (Result);
+}
+
+/**
+ * Divides all components of an SVector4Df object by a scalar value.
+ *
+ * @param vec The SVector4Df object to divide.
+ * @param fVal The scalar value to divide by.
+ * @return The resulting SVector4Df object.
+ * @throws std::domain_error If the divisor is zero.
+ */
+inline SVector4Df operator/(const SVector4Df& vec, float fVal)
+{
+	assert(fVal != 0.0f);
+	SVector4Df Result(vec.x / fVal, vec.y / fVal, vec.z / fVal, vec.w / fVal);
+	return (Result);
+}
+
+/**
+ * Adds two SVector4Df objects component-wise.
+ *
+ * @param vec1 The first SVector4Df object.
+ * @param vec2 The second SVector4Df object.
+ * @return The resulting SVector4Df object.
+ */
+inline SVector4Df operator+(const SVector4Df& vec1, const SVector4Df& vec2)
+{
+	SVector4Df Result(vec1.x + vec2.x, vec1.y + vec2.y, vec1.z + vec2.z, vec1.w + vec2.w);
+	return (Result);
+}
+
+/**
+ * Subtracts one SVector4Df object from another component-wise.
+ *
+ * @param vec1 The first SVector4Df object.
+ * @param vec2 The second SVector4Df object to subtract.
+ * @return The resulting SVector4Df object.
+ */
+inline SVector4Df operator-(const SVector4Df& vec1, const SVector4Df& vec2)
+{
+	SVector4Df Result(vec1.x - vec2.x, vec1.y - vec2.y, vec1.z - vec2.z, vec1.w - vec2.w);
+	return (Result);
+}
+
+/**
+ * Multiplies two SVector4Df objects component-wise.
+ *
+ * @param vec1 The first SVector4Df object.
+ * @param vec2 The second SVector4Df object to multiply.
+ * @return The resulting SVector4Df object.
+ */
+inline SVector4Df operator*(const SVector4Df& vec1, const SVector4Df& vec2)
+{
+	SVector4Df Result(vec1.x * vec2.x, vec1.y * vec2.y, vec1.z * vec2.z, vec1.w * vec2.w);
+	return (Result);
+}
+
+/**
+ * Divides one SVector4Df object by another component-wise.
+ *
+ * @param vec1 The first SVector4Df object.
+ * @param vec2 The second SVector4Df object to divide by.
+ * @return The resulting SVector4Df object.
+ * @throws std::domain_error If any component of the divisor is zero.
+ */
+inline SVector4Df operator/(const SVector4Df& vec1, const SVector4Df& vec2)
+{
+	assert(vec2.x != 0.0f && vec2.y != 0.0f && vec2.z != 0.0f && vec2.w != 0.0f);
+	SVector4Df Result(vec1.x / vec2.x, vec1.y / vec2.y, vec1.z / vec2.z, vec1.w / vec2.w);
+	return (Result);
+
+}
@@ -0,0 +1,373 @@
+#include "stdafx.h"
+#include "auto_splat.h"
+#include "texture_set.h"
+#include <thread>
+#include <atomic>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define AUTO_SPLAT_SSE
+#endif
+
+#if defined(_WIN64)
+#undef max
+#undef min
+#undef minmax
+#endif
+
+namespace
+{
+	constexpr GLfloat AUTO_SPLAT_OPEN_BOUND = 1.0e30f;
+	constexpr GLfloat AUTO_SPLAT_MIN_BLEND = 1.0e-3f;
+	constexpr GLfloat AUTO_SPLAT_MIN_WEIGHT = 1.0e-4f;
+
+	// Converts a [fMin, fMax] band into the kernel form; open bounds never fade out
+	void MakeBand(GLfloat fMin, GLfloat fMax, GLfloat fBlend, bool bOpenMin, bool bOpenMax, GLfloat& fOutMin, GLfloat& fOutMax, GLfloat& fOutInvBlend)
+	{
+		const GLfloat fBlendWidth = std::max((fMax - fMin) * fBlend, AUTO_SPLAT_MIN_BLEND);
+
+		fOutMin = bOpenMin ? -AUTO_SPLAT_OPEN_BOUND : fMin;
+		fOutMax = bOpenMax ? AUTO_SPLAT_OPEN_BOUND : fMax;
+		fOutInvBlend = 1.0f / fBlendWidth;
+	}
+
+	inline GLfloat Band(GLfloat fValue, GLfloat fMin, GLfloat fMax, GLfloat fInvBlend)
+	{
+		const GLfloat fRise = std::clamp((fValue - fMin) * fInvBlend + 1.0f, 0.0f, 1.0f);
+		const GLfloat fFall = std::clamp((fMax - fValue) * fInvBlend + 1.0f, 0.0f, 1.0f);
+		return (fRise * fFall);
+	}
+
+#if defined(AUTO_SPLAT_SSE)
+	inline __m128 Band4(__m128 v, __m128 vMin, __m128 vMax, __m128 vInvBlend)
+	{
+		const __m128 vOne = _mm_set1_ps(1.0f);
+		const __m128 vZero = _mm_setzero_ps();
+
+		__m128 vRise = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(v, vMin), vInvBlend), vOne);
+		__m128 vFall = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(vMax, v), vInvBlend), vOne);
+		vRise = _mm_min_ps(_mm_max_ps(vRise, vZero), vOne);
+		vFall = _mm_min_ps(_mm_max_ps(vFall, vZero), vOne);
+
+		return (_mm_mul_ps(vRise, vFall));
+	}
+#endif
+}
+
+CTerrainAutoSplat::CTerrainAutoSplat()
+{
+	m_iWidth = 0;
+	m_iDepth = 0;
+	m_fWorldScale = 1.0f;
+	m_pRulesSource = nullptr;
+	m_uiRulesRevision = 0;
+}
+
+CTerrainAutoSplat::~CTerrainAutoSplat()
+{
+	Destroy();
+}
+
+void CTerrainAutoSplat::Destroy()
+{
+	m_vHeights.clear();
+	m_vSlopes.clear();
+	m_vCurvatures.clear();
+	m_vRules.clear();
+	m_pRulesSource = nullptr;
+	m_iWidth = 0;
+	m_iDepth = 0;
+}
+
+void CTerrainAutoSplat::Resize(GLint iWidth, GLint iDepth, GLfloat fWorldScale)
+{
+	m_iWidth = iWidth;
+	m_iDepth = iDepth;
+	m_fWorldScale = fWorldScale;
+
+	const size_t iSize = static_cast<size_t>(iWidth) * iDepth;
+	m_vHeights.assign(iSize, 0.0f);
+	m_vSlopes.assign(iSize, 0.0f);
+	m_vCurvatures.assign(iSize, 0.0f);
+}
+
+GLfloat* CTerrainAutoSplat::GetHeights()
+{
+	return (m_vHeights.data());
+}
+
+void CTerrainAutoSplat::UpdateDerivatives(GLint iMinX, GLint iMinZ, GLint iMaxX, GLint iMaxZ)
+{
+	if (m_vHeights.empty())
+	{
+		return;
+	}
+
+	iMinX = std::max(iMinX, 0);
+	iMinZ = std::max(iMinZ, 0);
+	iMaxX = std::min(iMaxX, m_iWidth - 1);
+	iMaxZ = std::min(iMaxZ, m_iDepth - 1);
+
+	const GLfloat fRadToDeg = 180.0f / 3.14159265f;
+	const GLfloat fInvScaleSq = 1.0f / (m_fWorldScale * m_fWorldScale);
+
+	for (GLint z = iMinZ; z <= iMaxZ; z++)
+	{
+		const GLint z0 = std::max(z - 1, 0);
+		const GLint z1 = std::min(z + 1, m_iDepth - 1);
+
+		for (GLint x = iMinX; x <= iMaxX; x++)
+		{
+			const GLint x0 = std::max(x - 1, 0);
+			const GLint x1 = std::min(x + 1, m_iWidth - 1);
+
+			const GLfloat h = m_vHeights[z * m_iWidth + x];
+			const GLfloat hL = m_vHeights[z * m_iWidth + x0];
+			const GLfloat hR = m_vHeights[z * m_iWidth + x1];
+			const GLfloat hD = m_vHeights[z0 * m_iWidth + x];
+			const GLfloat hU = m_vHeights[z1 * m_iWidth + x];
+
+			// Central differences, one-sided on the borders
+			const GLfloat fDx = (hR - hL) / (static_cast<GLfloat>(x1 - x0) * m_fWorldScale);
+			const GLfloat fDz = (hU - hD) / (static_cast<GLfloat>(z1 - z0) * m_fWorldScale);
+
+			m_vSlopes[z * m_iWidth + x] = std::atan(std::sqrt(fDx * fDx + fDz * fDz)) * fRadToDeg;
+			m_vCurvatures[z * m_iWidth + x] = (hL + hR + hD + hU - 4.0f * h) * fInvScaleSq;
+		}
+	}
+}
+
+bool CTerrainAutoSplat::BuildRules(CTerrainTextureSet* pTextureSet)
+{
+	m_vRules.clear();
+	m_pRulesSource = pTextureSet;
+
+	if (!pTextureSet)
+	{
+		return (false);
+	}
+
+	m_uiRulesRevision = pTextureSet->GetRevision();
+
+	// Index 0 is the eraser, it is only used as the fallback layer
+	for (size_t i = 1; i < pTextureSet->GetTexturesCount(); i++)
+	{
+		const TTerrainTexture& tex = pTextureSet->GetTexture(i);
+
+		if (!tex.m_bIsSplat || tex.m_stFileName.empty() || tex.m_uiHeightMax <= tex.m_uiHeightMin)
+		{
+			continue;
+		}
+
+		TAutoSplatRule rule{};
+		rule.iTextureIndex = static_cast<GLint>(i);
+
+		MakeBand(static_cast<GLfloat>(tex.m_uiHeightMin), static_cast<GLfloat>(tex.m_uiHeightMax), tex.m_fRuleBlend,
+			tex.m_uiHeightMin == 0, tex.m_uiHeightMax >= TERRAIN_HEIGHT_UNBOUNDED,
+			rule.fHeightMin, rule.fHeightMax, rule.fHeightInvBlend);
+
+		MakeBand(tex.m_fSlopeMin, tex.m_fSlopeMax, tex.m_fRuleBlend,
+			tex.m_fSlopeMin <= 0.0f, tex.m_fSlopeMax >= TERRAIN_SLOPE_MAX,
+			rule.fSlopeMin, rule.fSlopeMax, rule.fSlopeInvBlend);
+
+		MakeBand(tex.m_fCurvatureMin, tex.m_fCurvatureMax, tex.m_fRuleBlend,
+			tex.m_fCurvatureMin <= -TERRAIN_CURVATURE_LIMIT, tex.m_fCurvatureMax >= TERRAIN_CURVATURE_LIMIT,
+			rule.fCurvatureMin, rule.fCurvatureMax, rule.fCurvatureInvBlend);
+
+		m_vRules.push_back(rule);
+	}
+
+	return (!m_vRules.empty());
+}
+
+bool CTerrainAutoSplat::UpdateRules(CTerrainTextureSet* pTextureSet)
+{
+	if (!pTextureSet || pTextureSet != m_pRulesSource || pTextureSet->GetRevision() != m_uiRulesRevision)
+	{
+		return (BuildRules(pTextureSet));
+	}
+
+	return (!m_vRules.empty());
+}
+
+size_t CTerrainAutoSplat::GetRulesCount() const
+{
+	return (m_vRules.size());
+}
+
+void CTerrainAutoSplat::Evaluate(const std::vector<TAutoSplatPatch>& vPatches, GLint iSplatRes, GLfloat fTexelSize)
+{
+	if (vPatches.empty() || m_vHeights.empty())
+	{
+		return;
+	}
+
+	const GLint iNumJobs = static_cast<GLint>(vPatches.size());
+	const GLint iNumThreads = std::min(static_cast<GLint>(std::max(std::thread::hardware_concurrency(), 1u)), iNumJobs);
+
+	if (iNumThreads <= 1)
+	{
+		std::vector<GLfloat> vScratch;
+		for (const auto& patch : vPatches)
+		{
+			EvaluatePatch(patch, iSplatRes, fTexelSize, vScratch);
+		}
+		return;
+	}
+
+	std::atomic<GLint> iNextJob(0);
+	std::vector<std::thread> vWorkers;
+	vWorkers.reserve(iNumThreads);
+
+	for (GLint t = 0; t < iNumThreads; t++)
+	{
+		vWorkers.emplace_back([&]()
+			{
+				std::vector<GLfloat> vScratch;
+				for (GLint iJob = iNextJob++; iJob < iNumJobs; iJob = iNextJob++)
+				{
+					EvaluatePatch(vPatches[iJob], iSplatRes, fTexelSize, vScratch);
+				}
+			});
+	}
+
+	for (auto& worker : vWorkers)
+	{
+		worker.join();
+	}
+}
+
+void CTerrainAutoSplat::EvaluatePatch(const TAutoSplatPatch& patch, GLint iSplatRes, GLfloat fTexelSize, std::vector<GLfloat>& vScratch) const
+{
+	const GLint iCount = patch.iTexelX1 - patch.iTexelX0 + 1;
+	if (iCount <= 0 || patch.iTexelZ1 < patch.iTexelZ0)
+	{
+		return;
+	}
+
+	// Rows are padded to the SIMD width, the scratch holds 3 input rows followed by one weight row per rule
+	const GLint iPadded = (iCount + 3) & ~3;
+	const size_t iNumRules = m_vRules.size();
+	vScratch.resize(static_cast<size_t>(iPadded) * (3 + iNumRules));
+
+	GLfloat* pHeight = vScratch.data();
+	GLfloat* pSlope = pHeight + iPadded;
+	GLfloat* pCurvature = pSlope + iPadded;
+	const GLfloat* pWeights = pCurvature + iPadded;
+
+	const GLfloat fInvScale = 1.0f / m_fWorldScale;
+	const GLfloat fMaxX = static_cast<GLfloat>(m_iWidth - 1);
+	const GLfloat fMaxZ = static_cast<GLfloat>(m_iDepth - 1);
+
+	for (GLint z = patch.iTexelZ0; z <= patch.iTexelZ1; z++)
+	{
+		// Bilinear sample of the vertex fields at the texel centres
+		const GLfloat fGridZ = std::clamp((patch.fOriginZ + (z + 0.5f) * fTexelSize) * fInvScale, 0.0f, fMaxZ);
+		const GLint iZ0 = std::min(static_cast<GLint>(fGridZ), m_iDepth - 2);
+		const GLfloat fTz = fGridZ - static_cast<GLfloat>(iZ0);
+
+		for (GLint i = 0; i < iPadded; i++)
+		{
+			const GLint x = std::min(patch.iTexelX0 + i, patch.iTexelX1);
+			const GLfloat fGridX = std::clamp((patch.fOriginX + (x + 0.5f) * fTexelSize) * fInvScale, 0.0f, fMaxX);
+			const GLint iX0 = std::min(static_cast<GLint>(fGridX), m_iWidth - 2);
+			const GLfloat fTx = fGridX - static_cast<GLfloat>(iX0);
+
+			const size_t i00 = static_cast<size_t>(iZ0) * m_iWidth + iX0;
+			const size_t i01 = i00 + m_iWidth;
+
+			auto Lerp2 = [&](const std::vector<GLfloat>& v)
+				{
+					const GLfloat a = v[i00] + (v[i00 + 1] - v[i00]) * fTx;
+					const GLfloat b = v[i01] + (v[i01 + 1] - v[i01]) * fTx;
+					return (a + (b - a) * fTz);
+				};
+
+			pHeight[i] = Lerp2(m_vHeights);
+			pSlope[i] = Lerp2(m_vSlopes);
+			pCurvature[i] = Lerp2(m_vCurvatures);
+		}
+
+		EvaluateRow(pHeight, pSlope, pCurvature, iPadded, vScratch);
+
+		// Keep the 4 strongest layers of every texel
+		for (GLint i = 0; i < iCount; i++)
+		{
+			GLint iBestIndex[4] = { 0, 0, 0, 0 };
+			GLfloat fBestWeight[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+			for (size_t r = 0; r < iNumRules; r++)
+			{
+				GLfloat fWeight = pWeights[r * iPadded + i];
+				if (fWeight <= fBestWeight[3])
+				{
+					continue;
+				}
+
+				GLint iIndex = m_vRules[r].iTextureIndex;
+				for (GLint s = 0; s < 4; s++)
+				{
+					if (fWeight > fBestWeight[s])
+					{
+						std::swap(fWeight, fBestWeight[s]);
+						std::swap(iIndex, iBestIndex[s]);
+					}
+				}
+			}
+
+			const GLfloat fSum = fBestWeight[0] + fBestWeight[1] + fBestWeight[2] + fBestWeight[3];
+			const size_t iTexel = static_cast<size_t>(z) * iSplatRes + patch.iTexelX0 + i;
+
+			if (fSum < AUTO_SPLAT_MIN_WEIGHT)
+			{
+				// No rule matches, fall back to the base layer
+				patch.pIndexData[iTexel] = glm::uvec4(0, 0, 0, 0);
+				patch.pWeightData[iTexel] = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+				continue;
+			}
+
+			const GLfloat fInvSum = 1.0f / fSum;
+			patch.pIndexData[iTexel] = glm::uvec4(iBestIndex[0], iBestIndex[1], iBestIndex[2], iBestIndex[3]);
+			patch.pWeightData[iTexel] = glm::vec4(fBestWeight[0], fBestWeight[1], fBestWeight[2], fBestWeight[3]) * fInvSum;
+		}
+	}
+}
+
+void CTerrainAutoSplat::EvaluateRow(const GLfloat* pHeight, const GLfloat* pSlope, const GLfloat* pCurvature, GLint iCount, std::vector<GLfloat>& vScratch) const
+{
+	GLfloat* pWeights = vScratch.data() + static_cast<size_t>(iCount) * 3;
+
+	for (size_t r = 0; r < m_vRules.size(); r++)
+	{
+		const TAutoSplatRule& rule = m_vRules[r];
+		GLfloat* pOut = pWeights + r * iCount;
+
+#if defined(AUTO_SPLAT_SSE)
+		const __m128 vHeightMin = _mm_set1_ps(rule.fHeightMin);
+		const __m128 vHeightMax = _mm_set1_ps(rule.fHeightMax);
+		const __m128 vHeightInv = _mm_set1_ps(rule.fHeightInvBlend);
+		const __m128 vSlopeMin = _mm_set1_ps(rule.fSlopeMin);
+		const __m128 vSlopeMax = _mm_set1_ps(rule.fSlopeMax);
+		const __m128 vSlopeInv = _mm_set1_ps(rule.fSlopeInvBlend);
+		const __m128 vCurvMin = _mm_set1_ps(rule.fCurvatureMin);
+		const __m128 vCurvMax = _mm_set1_ps(rule.fCurvatureMax);
+		const __m128 vCurvInv = _mm_set1_ps(rule.fCurvatureInvBlend);
+
+		// iCount is a multiple of 4
+		for (GLint i = 0; i < iCount; i += 4)
+		{
+			__m128 vWeight = Band4(_mm_loadu_ps(pHeight + i), vHeightMin, vHeightMax, vHeightInv);
+			vWeight = _mm_mul_ps(vWeight, Band4(_mm_loadu_ps(pSlope + i), vSlopeMin, vSlopeMax, vSlopeInv));
+			vWeight = _mm_mul_ps(vWeight, Band4(_mm_loadu_ps(pCurvature + i), vCurvMin, vCurvMax, vCurvInv));
+			_mm_storeu_ps(pOut + i, vWeight);
+		}
+#else
+		for (GLint i = 0; i < iCount; i++)
+		{
+			pOut[i] = Band(pHeight[i], rule.fHeightMin, rule.fHeightMax, rule.fHeightInvBlend) *
+				Band(pSlope[i], rule.fSlopeMin, rule.fSlopeMax, rule.fSlopeInvBlend) *
+				Band(pCurvature[i], rule.fCurvatureMin, rule.fCurvatureMax, rule.fCurvatureInvBlend);
+		}
+#endif
+	}
+}
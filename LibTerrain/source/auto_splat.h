@@ -0,0 +1,86 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <glm/glm.hpp>
+
+class CTerrainTextureSet;
+
+// Slope and curvature of a vertex read its direct neighbours
+constexpr GLint AUTO_SPLAT_STENCIL_RADIUS = 1;
+
+/*
+ * Rule-based auto texturing.
+ * Every splat texel samples height, slope (degrees) and curvature (height laplacian) from the grid,
+ * each rule turns them into a weight with soft band edges, and the 4 strongest rules are written
+ * into the texel's index/weight pair.
+ */
+typedef struct SAutoSplatRule
+{
+	GLint iTextureIndex;
+
+	GLfloat fHeightMin;
+	GLfloat fHeightMax;
+	GLfloat fHeightInvBlend;
+
+	GLfloat fSlopeMin;
+	GLfloat fSlopeMax;
+	GLfloat fSlopeInvBlend;
+
+	GLfloat fCurvatureMin;
+	GLfloat fCurvatureMax;
+	GLfloat fCurvatureInvBlend;
+} TAutoSplatRule;
+
+typedef struct SAutoSplatPatch
+{
+	glm::uvec4* pIndexData;		// Splat texels of the patch (iSplatRes * iSplatRes)
+	glm::vec4* pWeightData;
+	GLfloat fOriginX;			// World position of texel (0, 0)
+	GLfloat fOriginZ;
+	GLint iTexelX0;				// Inclusive texel window to evaluate
+	GLint iTexelZ0;
+	GLint iTexelX1;
+	GLint iTexelZ1;
+} TAutoSplatPatch;
+
+class CTerrainAutoSplat
+{
+public:
+	CTerrainAutoSplat();
+	~CTerrainAutoSplat();
+
+	void Destroy();
+	void Resize(GLint iWidth, GLint iDepth, GLfloat fWorldScale);
+
+	// Row-major height field (iWidth * iDepth), kept up to date by the owning grid
+	GLfloat* GetHeights();
+
+	// Recomputes slope and curvature for the vertices in [iMinX, iMaxX] x [iMinZ, iMaxZ]
+	void UpdateDerivatives(GLint iMinX, GLint iMinZ, GLint iMaxX, GLint iMaxZ);
+
+	bool BuildRules(CTerrainTextureSet* pTextureSet);
+	// Rebuilds the rules only when the texture set changed since the last build
+	bool UpdateRules(CTerrainTextureSet* pTextureSet);
+	size_t GetRulesCount() const;
+
+	// Patches are independent and evaluated on worker threads
+	void Evaluate(const std::vector<TAutoSplatPatch>& vPatches, GLint iSplatRes, GLfloat fTexelSize);
+
+protected:
+	void EvaluatePatch(const TAutoSplatPatch& patch, GLint iSplatRes, GLfloat fTexelSize, std::vector<GLfloat>& vScratch) const;
+	void EvaluateRow(const GLfloat* pHeight, const GLfloat* pSlope, const GLfloat* pCurvature, GLint iCount, std::vector<GLfloat>& vScratch) const;
+
+private:
+	GLint m_iWidth;
+	GLint m_iDepth;
+	GLfloat m_fWorldScale;
+
+	std::vector<GLfloat> m_vHeights;
+	std::vector<GLfloat> m_vSlopes;
+	std::vector<GLfloat> m_vCurvatures;
+
+	std::vector<TAutoSplatRule> m_vRules;
+	const CTerrainTextureSet* m_pRulesSource;
+	GLuint m_uiRulesRevision;
+};
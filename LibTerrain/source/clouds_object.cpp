@@ -69,8 +69,8 @@ void CCloudsObject::GenerateModelTextures()
 		PerlinWorleyComp.Use();
 		PerlinWorleyComp.setVec3("u_resolution", SVector3Df(128.0f, 128.0f, 128.0f));
 		PerlinWorleyComp.setInt("outVolTex", 0);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_3D, m_pPerlinTex->GetTextureID());
+		CGLState::ActiveTexture(GL_TEXTURE0);
+		CGLState::BindTexture(GL_TEXTURE_3D, m_pPerlinTex->GetTextureID());
 		glBindImageTexture(0, m_pPerlinTex->GetTextureID(), 0, GL_TRUE, 0, GL_READ_WRITE, GL_RGBA8);
 
 		sys_log("CCloudsObject::GenerateModelTextures: Computing PerlinWorley..");
@@ -92,8 +92,8 @@ void CCloudsObject::GenerateModelTextures()
 
 		// Compute
 		WorleyComp.Use();
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_3D, m_pWorley32Tex->GetTextureID());
+		CGLState::ActiveTexture(GL_TEXTURE0);
+		CGLState::BindTexture(GL_TEXTURE_3D, m_pWorley32Tex->GetTextureID());
 		glBindImageTexture(0, m_pWorley32Tex->GetTextureID(), 0, GL_TRUE, 0, GL_READ_WRITE, GL_RGBA8);
 
 		sys_log("CCloudsObject::GenerateModelTextures: Computing Worley32..");
@@ -133,6 +133,8 @@ void CCloudsObject::GenerateWeatherMap()
 
 void CCloudsObject::Update()
 {
+	PROFILE_SCOPE("Clouds");
+
 	m_v3Seed = m_pScene->v3Seed;
 	if (m_v3Seed != m_v3OldSeed)
 	{
@@ -1,7 +1,11 @@
 #include "stdafx.h"
 #include "geomip_grid.h"
 #include "terrain.h"
+#include "splat_file.h"
+#include "../../LibGL/source/mapped_file.h"
 #include <algorithm>
+#include <fstream>
+#include <cfloat>
 
 #if defined(_WIN64)
 #undef max
@@ -26,6 +30,9 @@ CGeoMipGrid::CGeoMipGrid()
 	m_uiSplatIndexHandlesSSBO = 0;		// SSBO for texture handles
 	m_uiSplatWeightHandlesSSBO = 0;		// SSBO for texture handles
 	m_iSplatTexResolution = 128 + 128;
+	m_bAutoSplatOnSculpt = false;
+	m_ulNoiseSeed = CRandom::ThreadLocal().NextU64();
+	m_uiNoiseStamp = 0;
 }
 
 CGeoMipGrid::~CGeoMipGrid()
@@ -37,44 +44,52 @@ void CGeoMipGrid::Destroy()
 {
 	if (m_uiVAO)
 	{
-		glDeleteVertexArrays(1, &m_uiVAO);
+		CGLState::DeleteVertexArrays(1, &m_uiVAO);
 	}
 	if (m_uiVBO)
 	{
-		glDeleteBuffers(1, &m_uiVBO);
+		CGLState::DeleteBuffers(1, &m_uiVBO);
 	}
 	if (m_uiIdxBuf)
 	{
-		glDeleteBuffers(1, &m_uiIdxBuf);
+		CGLState::DeleteBuffers(1, &m_uiIdxBuf);
 	}
 	if (m_uiSplatIndexHandlesSSBO)
 	{
-		glDeleteBuffers(1, &m_uiSplatIndexHandlesSSBO);
+		CGLState::DeleteBuffers(1, &m_uiSplatIndexHandlesSSBO);
+		m_uiSplatIndexHandlesSSBO = 0;
 	}
 	if (m_uiSplatWeightHandlesSSBO)
 	{
-		glDeleteBuffers(1, &m_uiSplatWeightHandlesSSBO);
+		CGLState::DeleteBuffers(1, &m_uiSplatWeightHandlesSSBO);
+		m_uiSplatWeightHandlesSSBO = 0;
 	}
 
 	// Clear Splats Data
-	for (auto& tex : m_vIndexMaps)
+	for (GLint i = 0; i < static_cast<GLint>(m_vIndexMaps.size()); i++)
 	{
-		if (tex)
-		{
-			safe_delete(tex);
-		}
+		ReleasePatchMaps(i);
 	}
-	for (auto& tex : m_vWeightMaps)
+	for (auto& tile : m_vConstantTiles)
 	{
-		if (tex)
+		if (tile.pIndexMap)
 		{
-			safe_delete(tex);
+			tile.pIndexMap->MakeNonResident();
+			tile.pWeightMap->MakeNonResident();
+			safe_delete(tile.pIndexMap);
+			safe_delete(tile.pWeightMap);
 		}
 	}
 
+	m_vConstantTiles.clear();
 	m_vIndexMaps.clear();
 	m_vWeightMaps.clear();
 	m_vSplatData.clear();
+	m_vSplatDirty.clear();
+	m_vPendingStamps.clear();
+	m_vPatchBounds.clear();
+	m_vLodErrors.clear();
+	m_AutoSplat.Destroy();
 }
 
 void CGeoMipGrid::CreateGeoMipGrid(GLint iWidth, GLint iDepth, GLint iPatchSize, CBaseTerrain* pTerrain)
@@ -118,15 +133,27 @@ void CGeoMipGrid::CreateGeoMipGrid(GLint iWidth, GLint iDepth, GLint iPatchSize,
 	m_iMaxLOD = CLodManager::Instance().InitLodManager(iPatchSize, m_iNumPatchesX, m_iNumPatchesZ, m_fWorldScale);
 	m_vLodInfo.resize(m_iMaxLOD + 1);
 
-	CreateGLState();
+	// A headless terrain has no context, the grid keeps its CPU data and never creates a GL object
+	if (!pTerrain->IsHeadless())
+	{
+		CreateGLState();
+	}
+
 	PopulateBuffers(pTerrain);
+	InitPatchMetrics();
+	UpdatePatchMetrics();
 	SetupSplatTextures();
 	UploadSplatBindings();
 	ResetAllSplatmapsToBaseTexture();
 
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	m_AutoSplat.Resize(m_iWidth, m_iDepth, m_fWorldScale);
+
+	if (HasGLState())
+	{
+		CGLState::BindVertexArray(0);
+		CGLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+		CGLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
 
 	sys_log("CGeoMipGrid::CreateTriangleList Created Triangle List Size: %d, Width: %d, Depth: %d", iWidth * iDepth, iWidth, iDepth);
 }
@@ -201,13 +228,13 @@ void CGeoMipGrid::CreateGLState()
 	else
 	{
 		glGenVertexArrays(1, &m_uiVAO);
-		glBindVertexArray(m_uiVAO);
+		CGLState::BindVertexArray(m_uiVAO);
 
 		glGenBuffers(1, &m_uiVBO);
-		glBindBuffer(GL_ARRAY_BUFFER, m_uiVBO);
+		CGLState::BindBuffer(GL_ARRAY_BUFFER, m_uiVBO);
 
 		glGenBuffers(1, &m_uiIdxBuf);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_uiIdxBuf);
+		CGLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_uiIdxBuf);
 
 		const GLint POS_LOC = 0;
 		const GLint	TEX_LOC = 1;
@@ -232,6 +259,31 @@ void CGeoMipGrid::CreateGLState()
 }
 
 void CGeoMipGrid::PopulateBuffers(CBaseTerrain* pTerrain)
+{
+	InitBuffers(pTerrain);
+
+	if (!HasGLState())
+	{
+		return;
+	}
+
+	if (IsGLVersionHigher(4, 5))
+	{
+		// Upload vertex data using DSA
+		glNamedBufferData(m_uiVBO, sizeof(m_vecVertices[0]) * m_vecVertices.size(), m_vecVertices.data(), GL_STATIC_DRAW);
+
+		// Upload index data using DSA
+		glNamedBufferData(m_uiIdxBuf, sizeof(m_vecIndices[0]) * m_vecIndices.size(), m_vecIndices.data(), GL_STATIC_DRAW);
+	}
+	else
+	{
+		glBufferData(GL_ARRAY_BUFFER, sizeof(m_vecVertices[0]) * m_vecVertices.size(), &m_vecVertices[0], GL_STATIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(m_vecIndices[0]) * m_vecIndices.size(), &m_vecIndices[0], GL_STATIC_DRAW);
+	}
+}
+
+// Vertices, the index sets of every LOD and the normals, no GL involved
+void CGeoMipGrid::InitBuffers(CBaseTerrain* pTerrain)
 {
 	m_vecVertices.resize(m_iWidth * m_iDepth);
 
@@ -249,20 +301,6 @@ void CGeoMipGrid::PopulateBuffers(CBaseTerrain* pTerrain)
 #endif
 
 	CalculateNormals();
-
-	if (IsGLVersionHigher(4, 5))
-	{
-		// Upload vertex data using DSA
-		glNamedBufferData(m_uiVBO, sizeof(m_vecVertices[0]) * m_vecVertices.size(), m_vecVertices.data(), GL_STATIC_DRAW);
-
-		// Upload index data using DSA
-		glNamedBufferData(m_uiIdxBuf, sizeof(m_vecIndices[0]) * m_vecIndices.size(), m_vecIndices.data(), GL_STATIC_DRAW);
-	}
-	else
-	{
-		glBufferData(GL_ARRAY_BUFFER, sizeof(m_vecVertices[0]) * m_vecVertices.size(), &m_vecVertices[0], GL_STATIC_DRAW);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(m_vecIndices[0]) * iNumIndices, &m_vecIndices[0], GL_STATIC_DRAW);
-	}
 }
 
 GLint CGeoMipGrid::CalculateNumIndices() const
@@ -535,10 +573,12 @@ void CGeoMipGrid::Render()
 	CLodManager::Instance().Update();
 
 	// Bind SSBO to index 0
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_uiSplatIndexHandlesSSBO);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_uiSplatWeightHandlesSSBO);
+	CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_uiSplatIndexHandlesSSBO);
+	CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_uiSplatWeightHandlesSSBO);
+
+	CGLState::BindVertexArray(m_uiVAO);
 
-	glBindVertexArray(m_uiVAO);
+	const SFrustumCulling& sFC = CCameraManager::Instance().GetCurrentCamera()->GetFrustumCulling();
 
 	for (GLint iPatchZ = 0; iPatchZ < m_iNumPatchesZ; iPatchZ++)
 	{
@@ -547,8 +587,6 @@ void CGeoMipGrid::Render()
 			GLint iX = iPatchX * (m_iPatchSize - 1);
 			GLint iZ = iPatchZ * (m_iPatchSize - 1);
 
-			SFrustumCulling sFC(CCameraManager::Instance().GetCurrentCamera()->GetViewProjMatrix());
-
 			if (!IsPatchInsideViewFrustumWorldSpace(iX, iZ, sFC))
 			{
 				continue;
@@ -569,10 +607,10 @@ void CGeoMipGrid::Render()
 		}
 	}
 
-	glBindVertexArray(0);
+	CGLState::BindVertexArray(0);
 	// Unbind SSBO to index 1
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, 0);
+	CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
+	CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, 0);
 
 }
 
@@ -584,60 +622,115 @@ void CGeoMipGrid::Render(const SVector3Df& CameraPos, const CMatrix4Df& ViewProj
 		exit(EXIT_FAILURE);
 	}
 
-	CLodManager::Instance().Update(CameraPos);
+	{
+		PROFILE_SCOPE("LOD Update");
+		CLodManager::Instance().Update(CameraPos);
+	}
 
-	SFrustumCulling sFC(ViewProj);
+	{
+		PROFILE_SCOPE("Culling");
+		CullPatches(ViewProj);
+	}
+
+	PROFILE_SCOPE("Terrain Draw");
 
 	// Bind SSBO to index 0
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_uiSplatIndexHandlesSSBO);
+	CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_uiSplatIndexHandlesSSBO);
 
-	glBindVertexArray(m_uiVAO);
+	CGLState::BindVertexArray(m_uiVAO);
 	// Set tessellation levels, you may want to adjust these based on your LOD (level of detail)
 	glPatchParameteri(GL_PATCH_VERTICES, 3);  // Assuming each patch is a triangle (3 vertices)
 
-	for (GLint iPatchZ = 0; iPatchZ < m_iNumPatchesZ; iPatchZ++)
+	for (const glm::ivec2& v2Patch : m_vVisiblePatches)
 	{
-		for (GLint iPatchX = 0; iPatchX < m_iNumPatchesX; iPatchX++)
-		{
-			GLint iX = iPatchX * (m_iPatchSize - 1);
-			GLint iZ = iPatchZ * (m_iPatchSize - 1);
+		const GLint iPatchX = v2Patch.x;
+		const GLint iPatchZ = v2Patch.y;
+		GLint iX = iPatchX * (m_iPatchSize - 1);
+		GLint iZ = iPatchZ * (m_iPatchSize - 1);
 
+		const TPatchLod& pLOD = CLodManager::Instance().GetPatchLod(iPatchX, iPatchZ);
+		GLint iCore = pLOD.iCore;
+		GLint iLeft = pLOD.iLeft;
+		GLint iRight = pLOD.iRight;
+		GLint iTop = pLOD.iTop;
+		GLint iBottom = pLOD.iBottom;
 
-			if (!IsPatchInsideViewFrustumWorldSpace(iX, iZ, sFC))
-			//if (!IsPatchInsideViewFrustumViewSpace(iX, iZ, ViewProj))
-			{
-				continue;
-			}
+		GLint iPatchIndex = iPatchZ * m_iNumPatchesX + iPatchX;
 
-			const TPatchLod& pLOD = CLodManager::Instance().GetPatchLod(iPatchX, iPatchZ);
-			GLint iCore = pLOD.iCore;
-			GLint iLeft = pLOD.iLeft;
-			GLint iRight = pLOD.iRight;
-			GLint iTop = pLOD.iTop;
-			GLint iBottom = pLOD.iBottom;
+		m_pTerrain->GetTerrainShader()->Use();
+		m_pTerrain->GetTerrainShader()->setInt("iLodLevel", iCore);
+		m_pTerrain->GetTerrainShader()->setInt("iLodLevelMax", m_iMaxLOD);
+		m_pTerrain->GetTerrainShader()->setInt("iPatchIndex", iPatchIndex); // for bindless IDs
+		m_pTerrain->GetTerrainShader()->setVec2("numPatches", glm::vec2(m_iNumPatchesX, m_iNumPatchesZ)); // for bindless IDs
 
-			GLint iPatchIndex = iPatchZ * m_iNumPatchesX + iPatchX;
+		size_t sBaseIndex = sizeof(GLuint) * m_vLodInfo[iCore].LodInfo[iLeft][iRight][iTop][iBottom].iStart;
 
-			m_pTerrain->GetTerrainShader()->Use();
-			m_pTerrain->GetTerrainShader()->setInt("iLodLevel", iCore);
-			m_pTerrain->GetTerrainShader()->setInt("iLodLevelMax", m_iMaxLOD);
-			m_pTerrain->GetTerrainShader()->setInt("iPatchIndex", iPatchIndex); // for bindless IDs
-			m_pTerrain->GetTerrainShader()->setVec2("numPatches", glm::vec2(m_iNumPatchesX, m_iNumPatchesZ)); // for bindless IDs
+		GLint iBaseVertex = iZ * m_iWidth + iX;
 
-			size_t sBaseIndex = sizeof(GLuint) * m_vLodInfo[iCore].LodInfo[iLeft][iRight][iTop][iBottom].iStart;
+		glDrawElementsBaseVertex(GL_PATCHES, m_vLodInfo[iCore].LodInfo[iLeft][iRight][iTop][iBottom].iCount, GL_UNSIGNED_INT, (void*)sBaseIndex, iBaseVertex);
 
-			GLint iBaseVertex = iZ * m_iWidth + iX;
+		CGLState::ActiveTexture(GL_TEXTURE0 + COLOR_TEXTURE_UNIT_INDEX_5);
+		CGLState::BindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	CGLState::BindVertexArray(0);
+	// Unbind SSBO to index 1
+	CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
+}
+
+size_t CGeoMipGrid::CullPatches(const CMatrix4Df& ViewProj)
+{
+	SFrustumCulling sFC(ViewProj);
+
+	m_vVisiblePatches.clear();
+	if (!m_vPatchBounds.empty())
+	{
+		// The top level is a single node, a rejected node skips every patch below it
+		CullNode(static_cast<GLint>(m_vPatchBounds.size()) - 1, 0, 0, sFC);
+	}
+
+	return (m_vVisiblePatches.size());
+}
+
+void CGeoMipGrid::CullNode(GLint iLevel, GLint iNodeX, GLint iNodeZ, const SFrustumCulling& sFrustumCulling)
+{
+	const TPatchBoundsLevel& level = m_vPatchBounds[iLevel];
+	const SVector2Df& v2MinMax = level.vNodes[iNodeZ * level.iWidth + iNodeX];
 
-			glDrawElementsBaseVertex(GL_PATCHES, m_vLodInfo[iCore].LodInfo[iLeft][iRight][iTop][iBottom].iCount, GL_UNSIGNED_INT, (void*)sBaseIndex, iBaseVertex);
+	// A node spans 2^level patches a side, the last ones are cut by the grid border
+	const GLfloat fPatchWorldSize = static_cast<GLfloat>(m_iPatchSize - 1) * m_fWorldScale;
+	const GLint iPatchX0 = iNodeX << iLevel;
+	const GLint iPatchZ0 = iNodeZ << iLevel;
+	const GLint iPatchX1 = std::min((iNodeX + 1) << iLevel, m_iNumPatchesX);
+	const GLint iPatchZ1 = std::min((iNodeZ + 1) << iLevel, m_iNumPatchesZ);
 
-			glActiveTexture(GL_TEXTURE0 + COLOR_TEXTURE_UNIT_INDEX_5);
-			glBindTexture(GL_TEXTURE_2D, 0);
+	const SVector3Df v3Min(iPatchX0 * fPatchWorldSize, v2MinMax.x, iPatchZ0 * fPatchWorldSize);
+	const SVector3Df v3Max(iPatchX1 * fPatchWorldSize, v2MinMax.y, iPatchZ1 * fPatchWorldSize);
+
+	if (sFrustumCulling.IsBoxOutsideViewFrustum(v3Min, v3Max))
+	{
+		return;
+	}
+
+	if (iLevel == 0)
+	{
+		m_vVisiblePatches.emplace_back(iNodeX, iNodeZ);
+		return;
+	}
+
+	const TPatchBoundsLevel& child = m_vPatchBounds[iLevel - 1];
+	for (GLint iChildZ = iNodeZ * 2; iChildZ <= std::min(iNodeZ * 2 + 1, child.iDepth - 1); iChildZ++)
+	{
+		for (GLint iChildX = iNodeX * 2; iChildX <= std::min(iNodeX * 2 + 1, child.iWidth - 1); iChildX++)
+		{
+			CullNode(iLevel - 1, iChildX, iChildZ, sFrustumCulling);
 		}
 	}
+}
 
-	glBindVertexArray(0);
-	// Unbind SSBO to index 1
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
+const std::vector<glm::ivec2>& CGeoMipGrid::GetVisiblePatches() const
+{
+	return (m_vVisiblePatches);
 }
 
 bool CGeoMipGrid::IsPatchInsideViewFrustumViewSpace(GLint iX, GLint iZ, const CMatrix4Df& matViewProj) const
@@ -663,48 +756,237 @@ bool CGeoMipGrid::IsPatchInsideViewFrustumViewSpace(GLint iX, GLint iZ, const CM
 
 bool CGeoMipGrid::IsPatchInsideViewFrustumWorldSpace(GLint iX, GLint iZ, const SFrustumCulling& sFrustumCulling) const
 {
-	GLint iX0 = iX;
-	GLint iX1 = iX + m_iPatchSize - 1;
-	GLint iZ0 = iZ;
-	GLint iZ1 = iZ + m_iPatchSize - 1;
+	if (m_vPatchBounds.empty())
+	{
+		return (true);
+	}
 
-	float fH00 = m_pTerrain->GetHeight(iX0, iZ0);
-	float fH01 = m_pTerrain->GetHeight(iX0, iZ1);
-	float fH10 = m_pTerrain->GetHeight(iX1, iZ0);
-	float fH11 = m_pTerrain->GetHeight(iX1, iZ1);
+	const TPatchBoundsLevel& patches = m_vPatchBounds[0];
+	const SVector2Df& v2MinMax = patches.vNodes[(iZ / (m_iPatchSize - 1)) * patches.iWidth + iX / (m_iPatchSize - 1)];
 
-	float fMinHeight = std::min(fH00, std::min(fH01, std::min(fH10, fH11)));
-	float fMaxHeight = std::max(fH00, std::max(fH01, std::max(fH10, fH11)));
+	const SVector3Df v3Min(static_cast<float>(iX) * m_fWorldScale, v2MinMax.x, static_cast<float>(iZ) * m_fWorldScale);
+	const SVector3Df v3Max(static_cast<float>(iX + m_iPatchSize - 1) * m_fWorldScale, v2MinMax.y, static_cast<float>(iZ + m_iPatchSize - 1) * m_fWorldScale);
 
-	const SVector3Df point00_low = SVector3Df(static_cast<float>(iX0) * m_fWorldScale, fMinHeight, (static_cast<float>(iZ0) * m_fWorldScale));
-	const SVector3Df point01_low = SVector3Df(static_cast<float>(iX0) * m_fWorldScale, fMinHeight, (static_cast<float>(iZ1) * m_fWorldScale));
-	const SVector3Df point10_low = SVector3Df(static_cast<float>(iX1) * m_fWorldScale, fMinHeight, (static_cast<float>(iZ0) * m_fWorldScale));
-	const SVector3Df point11_low = SVector3Df(static_cast<float>(iX1) * m_fWorldScale, fMinHeight, (static_cast<float>(iZ1) * m_fWorldScale));
+	return (!sFrustumCulling.IsBoxOutsideViewFrustum(v3Min, v3Max));
+}
+
+void CGeoMipGrid::UpdateVertexBuffer()
+{
+	if (!HasGLState())
+	{
+		return;
+	}
 
-	const SVector3Df point00_high = SVector3Df(static_cast<float>(iX0) * m_fWorldScale, fMaxHeight, (static_cast<float>(iZ0) * m_fWorldScale));
-	const SVector3Df point01_high = SVector3Df(static_cast<float>(iX0) * m_fWorldScale, fMaxHeight, (static_cast<float>(iZ1) * m_fWorldScale));
-	const SVector3Df point10_high = SVector3Df(static_cast<float>(iX1) * m_fWorldScale, fMaxHeight, (static_cast<float>(iZ0) * m_fWorldScale));
-	const SVector3Df point11_high = SVector3Df(static_cast<float>(iX1) * m_fWorldScale, fMaxHeight, (static_cast<float>(iZ1) * m_fWorldScale));
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_uiVBO);  // Bind the vertex buffer
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(m_vecVertices[0]) * m_vecVertices.size(), m_vecVertices.data());
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, 0);  // Unbind after update
+}
 
-	bool bInsideViewFrustum = (
-		(sFrustumCulling.IsPointInsideViewFrustum(point00_low)) ||
-		(sFrustumCulling.IsPointInsideViewFrustum(point01_low)) ||
-		(sFrustumCulling.IsPointInsideViewFrustum(point10_low)) ||
-		(sFrustumCulling.IsPointInsideViewFrustum(point11_low)) ||
+void CGeoMipGrid::UpdateVertexBuffer(const TGridRegion& region)
+{
+	if (region.IsEmpty() || !HasGLState())
+	{
+		return;
+	}
 
-		(sFrustumCulling.IsPointInsideViewFrustum(point00_high)) ||
-		(sFrustumCulling.IsPointInsideViewFrustum(point01_high)) ||
-		(sFrustumCulling.IsPointInsideViewFrustum(point10_high)) ||
-		(sFrustumCulling.IsPointInsideViewFrustum(point11_high)));
+	// Include the normal ring, then upload the contiguous rows that cover the region
+	const GLint iMinZ = std::max(0, region.iMinZ - 1);
+	const GLint iMaxZ = std::min(m_iDepth - 1, region.iMaxZ + 1);
 
-	return (bInsideViewFrustum);
+	const size_t sFirstVertex = static_cast<size_t>(iMinZ) * m_iWidth;
+	const size_t sNumVertices = static_cast<size_t>(iMaxZ - iMinZ + 1) * m_iWidth;
+
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_uiVBO);  // Bind the vertex buffer
+	glBufferSubData(GL_ARRAY_BUFFER, sizeof(m_vecVertices[0]) * sFirstVertex, sizeof(m_vecVertices[0]) * sNumVertices, &m_vecVertices[sFirstVertex]);
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, 0);  // Unbind after update
 }
 
-void CGeoMipGrid::UpdateVertexBuffer()
+bool CGeoMipGrid::RaycastHeightmap(const SVector3Df& rayOrigin, const SVector3Df& rayDir, SVector3Df& intersectionPoint) const
 {
-	glBindBuffer(GL_ARRAY_BUFFER, m_uiVBO);  // Bind the vertex buffer
-	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(m_vecVertices[0]) * m_vecVertices.size(), m_vecVertices.data());
-	glBindBuffer(GL_ARRAY_BUFFER, 0);  // Unbind after update
+	if (rayDir.y >= 0.0f)
+		return false; // Only works for rays pointing downward
+
+	// Find where the ray crosses the ground plane
+	float t = -rayOrigin.y / rayDir.y;
+	SVector3Df groundPoint = rayOrigin + rayDir * t;
+
+	const GLint width = m_iWidth;
+	const GLint depth = m_iDepth;
+
+	float fx = groundPoint.x;
+	float fz = groundPoint.z;
+
+	if (fx < 0.0f || fx >= width - 1 || fz < 0.0f || fz >= depth - 1)
+		return false; // Out of terrain bounds
+
+	GLint ix = static_cast<GLint>(fx);
+	GLint iz = static_cast<GLint>(fz);
+
+	float localX = fx - ix;
+	float localZ = fz - iz;
+
+	// Get 4 corner heights
+	float h00 = m_vecVertices[iz * width + ix].m_v3Pos.y;
+	float h10 = m_vecVertices[iz * width + (ix + 1)].m_v3Pos.y;
+	float h01 = m_vecVertices[(iz + 1) * width + ix].m_v3Pos.y;
+	float h11 = m_vecVertices[(iz + 1) * width + (ix + 1)].m_v3Pos.y;
+
+	// Bilinear interpolation
+	float h0 = h00 + (h10 - h00) * localX;
+	float h1 = h01 + (h11 - h01) * localX;
+	float height = h0 + (h1 - h0) * localZ;
+
+	if (groundPoint.y <= height)
+	{
+		intersectionPoint = SVector3Df(groundPoint.x, height, groundPoint.z);
+		return true;
+	}
+
+	return false;
+}
+
+bool CGeoMipGrid::RaycastHeightmapFast(const SVector3Df& rayOrigin, const SVector3Df& rayDir, SVector3Df& intersectionPoint) const
+{
+	if (rayDir.y >= 0.0f)
+		return false; // Only works for downward rays
+
+	if (m_vPatchBounds.empty())
+		return false;
+
+	const float stepSize = 1.0f;
+	const int maxSteps = 102400;    // Max distance = 1024 units
+
+	const GLint width = m_iWidth;
+	const GLint depth = m_iDepth;
+	const float maxX = static_cast<float>(width - 2);
+	const float maxZ = static_cast<float>(depth - 2);
+
+	// Clip the ray to the terrain box, the pyramid root holds the height range of the whole terrain
+	const SVector2Df& v2Range = m_vPatchBounds.back().vNodes[0];
+	const float fEdgeX = static_cast<float>(width - 1);
+	const float fEdgeZ = static_cast<float>(depth - 1);
+
+	float tEnter = (v2Range.y - rayOrigin.y) / rayDir.y;
+	float tExit = (v2Range.x - rayOrigin.y) / rayDir.y;
+	auto ClipSlab = [&](float fOrigin, float fDir, float fEdge)
+	{
+		if (fDir == 0.0f)
+			return (fOrigin >= 0.0f && fOrigin <= fEdge);
+
+		const float t0 = (0.0f - fOrigin) / fDir;
+		const float t1 = (fEdge - fOrigin) / fDir;
+		tEnter = std::max(tEnter, std::min(t0, t1));
+		tExit = std::min(tExit, std::max(t0, t1));
+		return (true);
+	};
+
+	if (!ClipSlab(rayOrigin.x, rayDir.x, fEdgeX) || !ClipSlab(rayOrigin.z, rayDir.z, fEdgeZ))
+		return false;
+
+	tEnter = std::max(tEnter, 0.0f);
+	if (tEnter > tExit)
+		return false;
+
+	const TPatchBoundsLevel& patches = m_vPatchBounds.front();
+	const GLint iPatchVertices = m_iPatchSize - 1;
+
+	SVector3Df currentPos = rayOrigin + rayDir * tEnter;
+
+	for (int step = 0; step < maxSteps; ++step)
+	{
+		float fx = std::clamp(currentPos.x, 0.0f, maxX);
+		float fz = std::clamp(currentPos.z, 0.0f, maxZ);
+
+		GLint ix = static_cast<GLint>(fx);
+		GLint iz = static_cast<GLint>(fz);
+
+		// Above the highest vertex of the patch, jump to where the ray leaves it or drops below that height
+		const GLint iPatchX = ix / iPatchVertices;
+		const GLint iPatchZ = iz / iPatchVertices;
+		const float fPatchMaxY = patches.vNodes[iPatchZ * patches.iWidth + iPatchX].y;
+		if (currentPos.y > fPatchMaxY)
+		{
+			auto ExitDistance = [](float fPos, float fDir, float fMin, float fMax)
+			{
+				if (fDir > 0.0f)
+					return ((fMax - fPos) / fDir);
+				if (fDir < 0.0f)
+					return ((fMin - fPos) / fDir);
+				return (FLT_MAX);
+			};
+
+			const float fPatchX0 = static_cast<float>(iPatchX * iPatchVertices);
+			const float fPatchZ0 = static_cast<float>(iPatchZ * iPatchVertices);
+			const float tSkip = std::min({ (fPatchMaxY - currentPos.y) / rayDir.y,
+				ExitDistance(currentPos.x, rayDir.x, fPatchX0, fPatchX0 + iPatchVertices),
+				ExitDistance(currentPos.z, rayDir.z, fPatchZ0, fPatchZ0 + iPatchVertices) });
+
+			currentPos += rayDir * std::max(tSkip, stepSize);
+			if (currentPos.x < 0.0f || currentPos.x >= width || currentPos.z < 0.0f || currentPos.z >= depth)
+				return false;
+			continue;
+		}
+
+		float localX = fx - ix;
+		float localZ = fz - iz;
+
+		const auto& v00 = m_vecVertices[iz * width + ix].m_v3Pos.y;
+		const auto& v10 = m_vecVertices[iz * width + (ix + 1)].m_v3Pos.y;
+		const auto& v01 = m_vecVertices[(iz + 1) * width + ix].m_v3Pos.y;
+		const auto& v11 = m_vecVertices[(iz + 1) * width + (ix + 1)].m_v3Pos.y;
+
+		float h0 = v00 + (v10 - v00) * localX;
+		float h1 = v01 + (v11 - v01) * localX;
+		float height = h0 + (h1 - h0) * localZ;
+
+		if (currentPos.y <= height)
+		{
+			// Optional: binary refinement for smoother brush edge
+			SVector3Df backtrack = currentPos - rayDir * stepSize;
+			for (int j = 0; j < 4; ++j)
+			{
+				SVector3Df mid = (currentPos + backtrack) * 0.5f;
+				float mx = std::clamp(mid.x, 0.0f, maxX);
+				float mz = std::clamp(mid.z, 0.0f, maxZ);
+				GLint mix = static_cast<GLint>(mx);
+				GLint miz = static_cast<GLint>(mz);
+				float lx = mx - mix;
+				float lz = mz - miz;
+
+				float mh0 = m_vecVertices[miz * width + mix].m_v3Pos.y +
+					(m_vecVertices[miz * width + (mix + 1)].m_v3Pos.y -
+						m_vecVertices[miz * width + mix].m_v3Pos.y) * lx;
+
+				float mh1 = m_vecVertices[(miz + 1) * width + mix].m_v3Pos.y +
+					(m_vecVertices[(miz + 1) * width + (mix + 1)].m_v3Pos.y -
+						m_vecVertices[(miz + 1) * width + mix].m_v3Pos.y) * lx;
+
+				float midHeight = mh0 + (mh1 - mh0) * lz;
+
+				if (mid.y <= midHeight)
+					currentPos = mid;
+				else
+					backtrack = mid;
+			}
+
+			intersectionPoint = currentPos;
+			intersectionPoint.y = height;
+			return true;
+		}
+
+		currentPos += rayDir * stepSize;
+
+		// early out if ray is too far
+		if (currentPos.x < 0.0f || currentPos.x >= width || currentPos.z < 0.0f || currentPos.z >= depth)
+			return false;
+	}
+
+	return false;
+}
+
+bool CGeoMipGrid::HasGLState() const
+{
+	return (m_uiVAO != 0);
 }
 
 std::vector<CGeoMipGrid::TVertex>& CGeoMipGrid::GetVertices()
@@ -772,6 +1054,109 @@ GLuint CGeoMipGrid::GetCurrentTexture() const
 
 void CGeoMipGrid::ApplyTerrainBrush_World(EBrushType eBrushType, GLfloat worldX, GLfloat worldZ, GLfloat fRadius, GLfloat fStrength)
 {
+	TBrushStamp stamp{};
+	stamp.eBrushType = eBrushType;
+	stamp.v2WorldPos = SVector2Df(worldX, worldZ);
+	stamp.fRadius = fRadius;
+	stamp.fStrength = fStrength;
+	stamp.iTextureIndex = m_iCurTextureIndex;
+
+	// Sample base height if flattening
+	GLint centerX = static_cast<GLint>(worldX / m_pTerrain->GetWorldScale());
+	GLint centerZ = static_cast<GLint>(worldZ / m_pTerrain->GetWorldScale());
+	GLint centerIndex = centerZ * m_iWidth + centerX;
+	stamp.fBaseHeight = (centerIndex >= 0 && centerIndex < m_vecVertices.size()) ? m_vecVertices[centerIndex].m_v3Pos.y : 0.0f;
+
+	QueueBrushStamp(stamp);
+	FlushBrushStamps();
+}
+
+void CGeoMipGrid::QueueBrushStamp(const TBrushStamp& stamp)
+{
+	m_vPendingStamps.push_back(stamp);
+}
+
+void CGeoMipGrid::FlushBrushStamps()
+{
+	if (m_vPendingStamps.empty())
+	{
+		return;
+	}
+
+	TGridRegion region;
+	bool bPaintedSplat = false;
+
+	for (const auto& stamp : m_vPendingStamps)
+	{
+		if (stamp.eBrushType >= BRUSH_TYPE_UP && stamp.eBrushType <= BRUSH_TYPE_NOISE)
+		{
+			ApplyHeightStamp(stamp, region);
+		}
+		else if (stamp.eBrushType == BRUSH_TYPE_TEXTURE || stamp.eBrushType == BRUSH_TYPE_ERASER)
+		{
+			TBrushParams brush{};
+			brush.v2WorldPos = stamp.v2WorldPos;
+			brush.fRadius = stamp.fRadius;
+			brush.fStrength = stamp.fStrength;
+			brush.fAlpha = 1.0f;
+			brush.iSelectedTextureIndex = stamp.iTextureIndex;
+
+			PaintSplatmapStamp(brush);
+			bPaintedSplat = true;
+		}
+	}
+
+	m_vPendingStamps.clear();
+
+	// One normal recompute and one upload for everything stamped this frame
+	if (!region.IsEmpty())
+	{
+		UpdateNormals(region);
+		UpdateVertexBuffer(region);
+		UpdatePatchMetrics(region);
+
+		if (m_bAutoSplatOnSculpt)
+		{
+			AutoSplatRegion(region);
+			bPaintedSplat = true;
+		}
+	}
+
+	if (bPaintedSplat)
+	{
+		UploadDirtySplatmaps();
+	}
+
+	m_LastModifiedRegion = region;
+	m_EditedRegion.Merge(region);
+}
+
+const TGridRegion& CGeoMipGrid::GetLastModifiedRegion() const
+{
+	return (m_LastModifiedRegion);
+}
+
+TGridRegion CGeoMipGrid::TakeEditedRegion()
+{
+	const TGridRegion region = m_EditedRegion;
+	m_EditedRegion.Reset();
+	return (region);
+}
+
+void CGeoMipGrid::ApplyHeightStamp(const TBrushStamp& stamp, TGridRegion& region)
+{
+	const EBrushType eBrushType = stamp.eBrushType;
+	const GLfloat worldX = stamp.v2WorldPos.x;
+	const GLfloat worldZ = stamp.v2WorldPos.y;
+	const GLfloat fRadius = stamp.fRadius;
+	const GLfloat fStrength = stamp.fStrength;
+	const GLfloat baseHeight = stamp.fBaseHeight;
+
+	if (fRadius <= 0.0f)
+	{
+		return;
+	}
+
 	GLfloat fWorldScale = m_pTerrain->GetWorldScale();
 	GLfloat gridX = worldX / fWorldScale;
 	GLfloat gridZ = worldZ / fWorldScale;
@@ -781,23 +1166,15 @@ void CGeoMipGrid::ApplyTerrainBrush_World(EBrushType eBrushType, GLfloat worldX,
 	GLint startZ = std::max(0, static_cast<GLint>(gridZ - fRadius / fWorldScale));
 	GLint endZ = std::min(m_iDepth - 1, static_cast<GLint>(gridZ + fRadius / fWorldScale));
 
-	float baseHeight = 0.0f;
-
-	// Sample base height if flattening
-	if (eBrushType == BRUSH_TYPE_FLATTEN)
+	if (startX > endX || startZ > endZ)
 	{
-		GLint centerX = static_cast<GLint>(gridX);
-		GLint centerZ = static_cast<GLint>(gridZ);
-		GLint centerIndex = centerZ * m_iWidth + centerX;
-		if (centerIndex >= 0 && centerIndex < m_vecVertices.size())
-		{
-			baseHeight = m_vecVertices[centerIndex].m_v3Pos.y;
-		}
+		return;
 	}
 
-	std::vector<GLfloat> originalHeights(m_vecVertices.size());
-	for (size_t i = 0; i < m_vecVertices.size(); ++i)
-		originalHeights[i] = m_vecVertices[i].m_v3Pos.y;
+	region.Merge(startX, startZ, endX, endZ);
+
+	// Every noise stamp gets its own pattern, otherwise a stroke keeps pushing the same cells the same way
+	const uint32_t uiNoiseStamp = (eBrushType == BRUSH_TYPE_NOISE) ? m_uiNoiseStamp++ : 0;
 
 	for (GLint z = startZ; z <= endZ; ++z)
 	{
@@ -852,7 +1229,6 @@ void CGeoMipGrid::ApplyTerrainBrush_World(EBrushType eBrushType, GLfloat worldX,
 							{
 								GLint ni = nz * m_iWidth + nx;
 								sum += m_vecVertices[ni].m_v3Pos.y;
-								//sum += originalHeights[ni]; // Use originalHeights
 								count++;
 							}
 						}
@@ -866,72 +1242,273 @@ void CGeoMipGrid::ApplyTerrainBrush_World(EBrushType eBrushType, GLfloat worldX,
 				}
 				else if (eBrushType == BRUSH_TYPE_NOISE)
 				{
-					GLfloat noise = glm::fract(std::sin(x * 12.9898f + z * 78.233f) * 43758.5453f); // Random-ish
+					GLfloat noise = CRandom::FloatAt(m_ulNoiseSeed, static_cast<uint32_t>(x), static_cast<uint32_t>(z), uiNoiseStamp);
 					GLfloat heightChange = (noise - 0.5f) * 2.0f * fStrength * falloff;
 					currentHeight += heightChange;
 				}
-				else if (eBrushType == BRUSH_TYPE_TEXTURE)
-				{
-					/*TBrushParams brush{};
-					brush.v2WorldPos = SVector2Df(worldX, worldZ);
-					brush.fRadius = 5.0f;
-					brush.fStrength = 1.0f;
-					brush.iSelectedTexChannel = 1; // G channel (for grass, e.g.)
-
-					PaintSplatmap(brush);*/
-				}
 			}
 		}
 	}
-	UpdateNormals();
-	UpdateVertexBuffer();
 }
 
-void CGeoMipGrid::UpdateNormals()
+void CGeoMipGrid::CopyHeights(std::vector<GLfloat>& vHeights) const
 {
-	std::vector<SVector3Df> normals(m_vecVertices.size(), SVector3Df(0.0f));
-	int gridWidth = m_iWidth;	/* your grid width */
-	int gridHeight = m_iDepth;	/* your grid height */
-
-	for (int z = 0; z < gridHeight; z++) {
-		for (int x = 0; x < gridWidth; x++) {
-			int idx = z * gridWidth + x;
-			SVector3Df pos = m_vecVertices[idx].m_v3Pos;
-
-			// Get neighboring positions (with boundary checks)
-			SVector3Df right = (x + 1 < gridWidth) ? m_vecVertices[idx + 1].m_v3Pos : pos;
-			SVector3Df left = (x - 1 >= 0) ? m_vecVertices[idx - 1].m_v3Pos : pos;
-			SVector3Df up = (z - 1 >= 0) ? m_vecVertices[idx - gridWidth].m_v3Pos : pos;
-			SVector3Df down = (z + 1 < gridHeight) ? m_vecVertices[idx + gridWidth].m_v3Pos : pos;
+	vHeights.resize(m_vecVertices.size());
 
-			// Compute vectors to neighbors
-			SVector3Df dx = right - left;
-			SVector3Df dz = down - up;
-
-			// Cross product to get normal
-			SVector3Df normal = dz.cross(dx).normalize();
-			normals[idx] = normal;
-		}
+	for (size_t i = 0; i < m_vecVertices.size(); i++)
+	{
+		vHeights[i] = m_vecVertices[i].m_v3Pos.y;
 	}
+}
 
-	// Assign normals back to vertices
+void CGeoMipGrid::SetHeights(const GLfloat* pHeights, bool bUpdatePatchMetrics)
+{
 	for (size_t i = 0; i < m_vecVertices.size(); i++)
 	{
-		m_vecVertices[i].m_v3Normals = normals[i]; // Assuming m_vecVertices has a normal field
+		m_vecVertices[i].m_v3Pos.y = pHeights[i];
+	}
+
+	UpdateNormals();
+	UpdateVertexBuffer();
+
+	if (bUpdatePatchMetrics)
+	{
+		UpdatePatchMetrics();
 	}
+
+	m_EditedRegion.Merge(0, 0, m_iWidth - 1, m_iDepth - 1);
 }
 
-void CGeoMipGrid::SetCurrentTextureIndex(GLint iTexIdx)
+const std::vector<TPatchBoundsLevel>& CGeoMipGrid::GetPatchBounds() const
 {
-	m_iCurTextureIndex = iTexIdx;
+	return (m_vPatchBounds);
 }
 
-GLint CGeoMipGrid::GetPatchIndexFromWorldPos(const SVector2Df& v2WorldPos) const
+const std::vector<GLfloat>& CGeoMipGrid::GetLodErrors() const
 {
-	GLint iPatchX = static_cast<GLint>(v2WorldPos.x / m_iPatchSize);
-	GLint iPatchZ = static_cast<GLint>(v2WorldPos.y / m_iPatchSize);	// note: y here means Z in 2D terrain
+	return (m_vLodErrors);
+}
 
-	if (iPatchX < 0 || iPatchX >= m_iNumPatchesX || iPatchZ < 0 || iPatchZ >= m_iNumPatchesZ)
+bool CGeoMipGrid::SetPatchBoundsLevel(GLint iLevel, const SVector2Df* pNodes, GLint iWidth, GLint iDepth)
+{
+	if (!pNodes || iLevel < 0 || iLevel >= static_cast<GLint>(m_vPatchBounds.size()))
+	{
+		return (false);
+	}
+
+	TPatchBoundsLevel& level = m_vPatchBounds[iLevel];
+	if (level.iWidth != iWidth || level.iDepth != iDepth)
+	{
+		return (false);
+	}
+
+	std::copy(pNodes, pNodes + level.vNodes.size(), level.vNodes.begin());
+	return (true);
+}
+
+bool CGeoMipGrid::SetLodErrors(const GLfloat* pErrors, size_t iCount)
+{
+	if (!pErrors || iCount != m_vLodErrors.size())
+	{
+		return (false);
+	}
+
+	std::copy(pErrors, pErrors + iCount, m_vLodErrors.begin());
+	CLodManager::Instance().SetLodErrors(m_vLodErrors);
+	return (true);
+}
+
+void CGeoMipGrid::InitPatchMetrics()
+{
+	m_vPatchBounds.clear();
+
+	GLint iWidth = m_iNumPatchesX;
+	GLint iDepth = m_iNumPatchesZ;
+
+	while (true)
+	{
+		TPatchBoundsLevel& level = m_vPatchBounds.emplace_back();
+		level.iWidth = iWidth;
+		level.iDepth = iDepth;
+		level.vNodes.assign(static_cast<size_t>(iWidth) * iDepth, SVector2Df(0.0f, 0.0f));
+
+		if (iWidth == 1 && iDepth == 1)
+		{
+			break;
+		}
+
+		iWidth = (iWidth + 1) / 2;
+		iDepth = (iDepth + 1) / 2;
+	}
+
+	m_vLodErrors.assign(static_cast<size_t>(m_iNumPatchesX) * m_iNumPatchesZ * (m_iMaxLOD + 1), 0.0f);
+}
+
+void CGeoMipGrid::UpdatePatchMetrics()
+{
+	TGridRegion region;
+	region.Merge(0, 0, m_iWidth - 1, m_iDepth - 1);
+
+	UpdatePatchMetrics(region);
+}
+
+void CGeoMipGrid::UpdatePatchMetrics(const TGridRegion& region)
+{
+	if (region.IsEmpty() || m_vPatchBounds.empty())
+	{
+		return;
+	}
+
+	const GLint iStep = m_iPatchSize - 1;
+	const GLint iNumLods = m_iMaxLOD + 1;
+
+	// Border vertices are shared by the patches on both sides
+	GLint iNodeX0 = std::clamp((region.iMinX - 1) / iStep, 0, m_iNumPatchesX - 1);
+	GLint iNodeZ0 = std::clamp((region.iMinZ - 1) / iStep, 0, m_iNumPatchesZ - 1);
+	GLint iNodeX1 = std::clamp(region.iMaxX / iStep, 0, m_iNumPatchesX - 1);
+	GLint iNodeZ1 = std::clamp(region.iMaxZ / iStep, 0, m_iNumPatchesZ - 1);
+
+	auto Height = [&](GLint x, GLint z) { return (m_vecVertices[static_cast<size_t>(z) * m_iWidth + x].m_v3Pos.y); };
+
+	TPatchBoundsLevel& patches = m_vPatchBounds[0];
+	for (GLint iPatchZ = iNodeZ0; iPatchZ <= iNodeZ1; iPatchZ++)
+	{
+		for (GLint iPatchX = iNodeX0; iPatchX <= iNodeX1; iPatchX++)
+		{
+			const GLint x0 = iPatchX * iStep;
+			const GLint z0 = iPatchZ * iStep;
+
+			SVector2Df v2MinMax(FLT_MAX, -FLT_MAX);
+			for (GLint z = z0; z <= z0 + iStep; z++)
+			{
+				for (GLint x = x0; x <= x0 + iStep; x++)
+				{
+					v2MinMax.x = std::min(v2MinMax.x, Height(x, z));
+					v2MinMax.y = std::max(v2MinMax.y, Height(x, z));
+				}
+			}
+			patches.vNodes[iPatchZ * patches.iWidth + iPatchX] = v2MinMax;
+
+			// LOD n skips 2^n - 1 vertices, its error is the worst height the coarser grid misses
+			GLfloat* pErrors = &m_vLodErrors[static_cast<size_t>(iPatchZ * m_iNumPatchesX + iPatchX) * iNumLods];
+			pErrors[0] = 0.0f;
+
+			for (GLint iLOD = 1; iLOD < iNumLods; iLOD++)
+			{
+				const GLint iLodStep = 1 << iLOD;
+
+				GLfloat fError = 0.0f;
+				for (GLint z = z0; z <= z0 + iStep; z++)
+				{
+					const GLint cz = std::min(z0 + ((z - z0) / iLodStep) * iLodStep, z0 + iStep - iLodStep);
+					const GLfloat tz = static_cast<GLfloat>(z - cz) / iLodStep;
+
+					for (GLint x = x0; x <= x0 + iStep; x++)
+					{
+						const GLint cx = std::min(x0 + ((x - x0) / iLodStep) * iLodStep, x0 + iStep - iLodStep);
+						const GLfloat tx = static_cast<GLfloat>(x - cx) / iLodStep;
+
+						const GLfloat a = Height(cx, cz) + (Height(cx + iLodStep, cz) - Height(cx, cz)) * tx;
+						const GLfloat b = Height(cx, cz + iLodStep) + (Height(cx + iLodStep, cz + iLodStep) - Height(cx, cz + iLodStep)) * tx;
+						fError = std::max(fError, std::abs(Height(x, z) - (a + (b - a) * tz)));
+					}
+				}
+
+				pErrors[iLOD] = fError;
+			}
+		}
+	}
+
+	// Parents of the changed nodes
+	for (size_t iLevel = 1; iLevel < m_vPatchBounds.size(); iLevel++)
+	{
+		const TPatchBoundsLevel& child = m_vPatchBounds[iLevel - 1];
+		TPatchBoundsLevel& parent = m_vPatchBounds[iLevel];
+
+		iNodeX0 /= 2;
+		iNodeZ0 /= 2;
+		iNodeX1 /= 2;
+		iNodeZ1 /= 2;
+
+		for (GLint iNodeZ = iNodeZ0; iNodeZ <= iNodeZ1; iNodeZ++)
+		{
+			for (GLint iNodeX = iNodeX0; iNodeX <= iNodeX1; iNodeX++)
+			{
+				SVector2Df v2MinMax(FLT_MAX, -FLT_MAX);
+				for (GLint iChildZ = iNodeZ * 2; iChildZ <= std::min(iNodeZ * 2 + 1, child.iDepth - 1); iChildZ++)
+				{
+					for (GLint iChildX = iNodeX * 2; iChildX <= std::min(iNodeX * 2 + 1, child.iWidth - 1); iChildX++)
+					{
+						const SVector2Df& v2Child = child.vNodes[iChildZ * child.iWidth + iChildX];
+						v2MinMax.x = std::min(v2MinMax.x, v2Child.x);
+						v2MinMax.y = std::max(v2MinMax.y, v2Child.y);
+					}
+				}
+				parent.vNodes[iNodeZ * parent.iWidth + iNodeX] = v2MinMax;
+			}
+		}
+	}
+
+	CLodManager::Instance().SetLodErrors(m_vLodErrors);
+}
+
+void CGeoMipGrid::UpdateNormals()
+{
+	TGridRegion region;
+	region.Merge(0, 0, m_iWidth - 1, m_iDepth - 1);
+
+	UpdateNormals(region);
+}
+
+void CGeoMipGrid::UpdateNormals(const TGridRegion& region)
+{
+	if (region.IsEmpty())
+	{
+		return;
+	}
+
+	int gridWidth = m_iWidth;	/* your grid width */
+	int gridHeight = m_iDepth;	/* your grid height */
+
+	// Normals depend on the direct neighbours, so the ring around the region changes too
+	const int iMinX = std::max(0, region.iMinX - 1);
+	const int iMaxX = std::min(gridWidth - 1, region.iMaxX + 1);
+	const int iMinZ = std::max(0, region.iMinZ - 1);
+	const int iMaxZ = std::min(gridHeight - 1, region.iMaxZ + 1);
+
+	// Normals are derived from positions only, so they can be written in place
+	for (int z = iMinZ; z <= iMaxZ; z++) {
+		for (int x = iMinX; x <= iMaxX; x++) {
+			int idx = z * gridWidth + x;
+			const SVector3Df& pos = m_vecVertices[idx].m_v3Pos;
+
+			// Get neighboring positions (with boundary checks)
+			const SVector3Df& right = (x + 1 < gridWidth) ? m_vecVertices[idx + 1].m_v3Pos : pos;
+			const SVector3Df& left = (x - 1 >= 0) ? m_vecVertices[idx - 1].m_v3Pos : pos;
+			const SVector3Df& up = (z - 1 >= 0) ? m_vecVertices[idx - gridWidth].m_v3Pos : pos;
+			const SVector3Df& down = (z + 1 < gridHeight) ? m_vecVertices[idx + gridWidth].m_v3Pos : pos;
+
+			// Compute vectors to neighbors
+			SVector3Df dx = right - left;
+			SVector3Df dz = down - up;
+
+			// Cross product to get normal
+			m_vecVertices[idx].m_v3Normals = dz.cross(dx).normalize();
+		}
+	}
+}
+
+void CGeoMipGrid::SetCurrentTextureIndex(GLint iTexIdx)
+{
+	m_iCurTextureIndex = iTexIdx;
+}
+
+GLint CGeoMipGrid::GetPatchIndexFromWorldPos(const SVector2Df& v2WorldPos) const
+{
+	GLint iPatchX = static_cast<GLint>(v2WorldPos.x / m_iPatchSize);
+	GLint iPatchZ = static_cast<GLint>(v2WorldPos.y / m_iPatchSize);	// note: y here means Z in 2D terrain
+
+	if (iPatchX < 0 || iPatchX >= m_iNumPatchesX || iPatchZ < 0 || iPatchZ >= m_iNumPatchesZ)
 		return -1; // outside bounds
 
 	return (iPatchZ * m_iNumPatchesX + iPatchX);
@@ -940,71 +1517,314 @@ GLint CGeoMipGrid::GetPatchIndexFromWorldPos(const SVector2Df& v2WorldPos) const
 /// Splat map Implementation
 void CGeoMipGrid::SetupSplatTextures()
 {
-    const GLint iNumPatches = m_iNumPatchesX * m_iNumPatchesZ;
-    const GLint iSplatRes = m_iSplatTexResolution;
+	const GLint iNumPatches = m_iNumPatchesX * m_iNumPatchesZ;
 
-    m_vIndexMaps.resize(iNumPatches);
-    m_vWeightMaps.resize(iNumPatches);
-    m_vSplatData.resize(iNumPatches);
+	// Nothing is allocated per patch until it gets painted
+	m_vIndexMaps.assign(iNumPatches, nullptr);
+	m_vWeightMaps.assign(iNumPatches, nullptr);
+	m_vSplatData.assign(iNumPatches, TSplatData());
+	m_vSplatDirty.assign(iNumPatches, false);
 
-    for (GLint i = 0; i < iNumPatches; i++) {
-        // Index Map (unsigned int RGBA32UI)
-        m_vIndexMaps[i] = new CTexture(GL_TEXTURE_2D);
-        m_vIndexMaps[i]->GenerateEmptyTexture2D(iSplatRes, iSplatRes, GL_RGBA32UI);
-		m_vIndexMaps[i]->MakeResident();
-
-        // Weight Map (float RGBA32F)
-        m_vWeightMaps[i] = new CTexture(GL_TEXTURE_2D);
-        m_vWeightMaps[i]->GenerateEmptyTexture2D(iSplatRes, iSplatRes, GL_RGBA32F);
-		m_vWeightMaps[i]->MakeResident();
-
-        // Initialize CPU data
-        m_vSplatData[i].indexData.resize(iSplatRes * iSplatRes, glm::uvec4(0));
-        m_vSplatData[i].weightData.resize(iSplatRes * iSplatRes, glm::vec4(0.0f));
-    }
-	glBindTexture(GL_TEXTURE_2D, 0);
+	// Base layer tile
+	GetConstantTile(glm::uvec4(0), glm::vec4(1.0f, 0.0f, 0.0f, 0.0f));
 }
 
 void CGeoMipGrid::UploadSplatBindings()
 {
+	if (!HasGLState())
+	{
+		return;
+	}
+
+	std::vector<GLuint64> IndexHandles(m_vSplatData.size());
+	std::vector<GLuint64> weightHandles(m_vSplatData.size());
+
+	for (size_t i = 0; i < m_vSplatData.size(); i++)
+	{
+		if (m_vIndexMaps[i])
+		{
+			IndexHandles[i] = m_vIndexMaps[i]->GetHandle();
+			weightHandles[i] = m_vWeightMaps[i]->GetHandle();
+		}
+		else
+		{
+			const TSplatConstantTile& tile = m_vConstantTiles[m_vSplatData[i].iConstantTile];
+			IndexHandles[i] = tile.pIndexMap->GetHandle();
+			weightHandles[i] = tile.pWeightMap->GetHandle();
+		}
+	}
+
 	// SSBO #1: index-map handles
 	if (!m_uiSplatIndexHandlesSSBO)
 	{
 		glGenBuffers(1, &m_uiSplatIndexHandlesSSBO);
 	}
 
-	std::vector<GLuint64> IndexHandles;
-	for (auto* t : m_vIndexMaps)
+	CGLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiSplatIndexHandlesSSBO);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, IndexHandles.size() * sizeof(GLuint64), IndexHandles.data(), GL_DYNAMIC_DRAW); 	// Indices + weights
+	CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_uiSplatIndexHandlesSSBO); // Binding point 1
+
+	// SSBO #2: weight-map handles
+	if (!m_uiSplatWeightHandlesSSBO)
 	{
-		IndexHandles.push_back(t->GetHandle());
+		glGenBuffers(1, &m_uiSplatWeightHandlesSSBO);
 	}
 
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiSplatIndexHandlesSSBO);
-	glBufferData(GL_SHADER_STORAGE_BUFFER, IndexHandles.size() * sizeof(GLuint64), IndexHandles.data(), GL_DYNAMIC_DRAW); 	// Indices + weights
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_uiSplatIndexHandlesSSBO); // Binding point 1
+	CGLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiSplatWeightHandlesSSBO);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, weightHandles.size() * sizeof(GLuint64), weightHandles.data(), GL_DYNAMIC_DRAW);
+	CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_uiSplatWeightHandlesSSBO);
+}
 
-	// SSBO #2: weight-map handles
-	glGenBuffers(1, &m_uiSplatWeightHandlesSSBO);
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiSplatWeightHandlesSSBO);
-	std::vector<GLuint64> weightHandles;
-	for (auto* t : m_vWeightMaps)
+void CGeoMipGrid::UpdatePatchBinding(GLint iPatchIndex)
+{
+	if (!m_uiSplatIndexHandlesSSBO || !m_uiSplatWeightHandlesSSBO)
+	{
+		return;
+	}
+
+	GLuint64 uiIndexHandle = 0;
+	GLuint64 uiWeightHandle = 0;
+
+	if (m_vIndexMaps[iPatchIndex])
+	{
+		uiIndexHandle = m_vIndexMaps[iPatchIndex]->GetHandle();
+		uiWeightHandle = m_vWeightMaps[iPatchIndex]->GetHandle();
+	}
+	else
+	{
+		const TSplatConstantTile& tile = m_vConstantTiles[m_vSplatData[iPatchIndex].iConstantTile];
+		uiIndexHandle = tile.pIndexMap->GetHandle();
+		uiWeightHandle = tile.pWeightMap->GetHandle();
+	}
+
+	const GLintptr iOffset = static_cast<GLintptr>(iPatchIndex) * sizeof(GLuint64);
+	glNamedBufferSubData(m_uiSplatIndexHandlesSSBO, iOffset, sizeof(GLuint64), &uiIndexHandle);
+	glNamedBufferSubData(m_uiSplatWeightHandlesSSBO, iOffset, sizeof(GLuint64), &uiWeightHandle);
+}
+
+GLint CGeoMipGrid::GetConstantTile(const glm::uvec4& index, const glm::vec4& weight)
+{
+	for (GLint i = 0; i < static_cast<GLint>(m_vConstantTiles.size()); i++)
+	{
+		if (m_vConstantTiles[i].index == index && m_vConstantTiles[i].weight == weight)
+		{
+			return (i);
+		}
+	}
+
+	// Bound the tile count, patches with a rare value simply stay materialized
+	if (m_vConstantTiles.size() >= SPLAT_MAX_CONSTANT_TILES)
 	{
-		weightHandles.push_back(t->GetHandle());
+		return (-1);
 	}
-	glBufferData(GL_SHADER_STORAGE_BUFFER, weightHandles.size() * sizeof(GLuint64), weightHandles.data(), GL_STATIC_DRAW);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_uiSplatWeightHandlesSSBO);
 
+	TSplatConstantTile tile{};
+	tile.index = index;
+	tile.weight = weight;
+
+	// Headless grids only track the value, there is nothing to sample it
+	if (!HasGLState())
+	{
+		m_vConstantTiles.push_back(tile);
+		return (static_cast<GLint>(m_vConstantTiles.size()) - 1);
+	}
+
+	tile.pIndexMap = new CTexture(GL_TEXTURE_2D);
+	tile.pIndexMap->GenerateEmptyTexture2D(1, 1, GL_RGBA32UI);
+	glClearTexImage(tile.pIndexMap->GetTextureID(), 0, GL_RGBA_INTEGER, GL_UNSIGNED_INT, &index);
+	tile.pIndexMap->MakeResident();
+
+	tile.pWeightMap = new CTexture(GL_TEXTURE_2D);
+	tile.pWeightMap->GenerateEmptyTexture2D(1, 1, GL_RGBA32F);
+	glClearTexImage(tile.pWeightMap->GetTextureID(), 0, GL_RGBA, GL_FLOAT, &weight);
+	tile.pWeightMap->MakeResident();
+
+	m_vConstantTiles.push_back(tile);
+	return (static_cast<GLint>(m_vConstantTiles.size()) - 1);
+}
+
+void CGeoMipGrid::MaterializePatch(GLint iPatchIndex)
+{
+	auto& patchData = m_vSplatData[iPatchIndex];
+	const size_t iTexels = static_cast<size_t>(m_iSplatTexResolution) * m_iSplatTexResolution;
+
+	if (!patchData.IsMaterialized())
+	{
+		patchData.indexData.assign(iTexels, patchData.constantIndex);
+		patchData.weightData.assign(iTexels, patchData.constantWeight);
+	}
+
+	if (!m_vIndexMaps[iPatchIndex] && HasGLState())
+	{
+		m_vIndexMaps[iPatchIndex] = new CTexture(GL_TEXTURE_2D);
+		m_vIndexMaps[iPatchIndex]->GenerateEmptyTexture2D(m_iSplatTexResolution, m_iSplatTexResolution, GL_RGBA32UI);
+		m_vIndexMaps[iPatchIndex]->MakeResident();
+
+		m_vWeightMaps[iPatchIndex] = new CTexture(GL_TEXTURE_2D);
+		m_vWeightMaps[iPatchIndex]->GenerateEmptyTexture2D(m_iSplatTexResolution, m_iSplatTexResolution, GL_RGBA32F);
+		m_vWeightMaps[iPatchIndex]->MakeResident();
+
+		// Content is uploaded by the caller once painted, until then it shows the constant value
+		glClearTexImage(m_vIndexMaps[iPatchIndex]->GetTextureID(), 0, GL_RGBA_INTEGER, GL_UNSIGNED_INT, &patchData.constantIndex);
+		glClearTexImage(m_vWeightMaps[iPatchIndex]->GetTextureID(), 0, GL_RGBA, GL_FLOAT, &patchData.constantWeight);
+
+		UpdatePatchBinding(iPatchIndex);
+	}
+}
+
+bool CGeoMipGrid::CollapsePatch(GLint iPatchIndex)
+{
+	auto& patchData = m_vSplatData[iPatchIndex];
+
+	if (patchData.IsMaterialized())
+	{
+		patchData.constantIndex = patchData.indexData[0];
+		patchData.constantWeight = patchData.weightData[0];
+	}
+
+	const GLint iTile = GetConstantTile(patchData.constantIndex, patchData.constantWeight);
+	if (iTile < 0)
+	{
+		return (false);
+	}
+
+	patchData.iConstantTile = iTile;
+	std::vector<glm::uvec4>().swap(patchData.indexData);
+	std::vector<glm::vec4>().swap(patchData.weightData);
+
+	ReleasePatchMaps(iPatchIndex);
+	UpdatePatchBinding(iPatchIndex);
+
+	return (true);
+}
+
+void CGeoMipGrid::ReleasePatchMaps(GLint iPatchIndex)
+{
+	if (m_vIndexMaps[iPatchIndex])
+	{
+		m_vIndexMaps[iPatchIndex]->MakeNonResident();
+		safe_delete(m_vIndexMaps[iPatchIndex]);
+	}
+	if (m_vWeightMaps[iPatchIndex])
+	{
+		m_vWeightMaps[iPatchIndex]->MakeNonResident();
+		safe_delete(m_vWeightMaps[iPatchIndex]);
+	}
+}
+
+bool CGeoMipGrid::IsPatchUniform(GLint iPatchIndex) const
+{
+	const auto& patchData = m_vSplatData[iPatchIndex];
+	if (!patchData.IsMaterialized())
+	{
+		return (true);
+	}
+
+	const glm::uvec4 index = patchData.indexData[0];
+	const glm::vec4 weight = patchData.weightData[0];
+
+	for (size_t i = 1; i < patchData.indexData.size(); i++)
+	{
+		if (patchData.indexData[i] != index || patchData.weightData[i] != weight)
+		{
+			return (false);
+		}
+	}
+
+	return (true);
+}
+
+size_t CGeoMipGrid::GetMaterializedPatchesCount() const
+{
+	size_t iCount = 0;
+	for (const auto& patchData : m_vSplatData)
+	{
+		if (patchData.IsMaterialized())
+		{
+			iCount++;
+		}
+	}
+
+	return (iCount);
+}
+
+GLfloat CGeoMipGrid::GetSplatWeight(GLfloat fWorldX, GLfloat fWorldZ, GLint iTextureIndex) const
+{
+	if (m_vSplatData.empty())
+	{
+		return (0.0f);
+	}
+
+	const GLfloat fPatchWorldSize = (m_iPatchSize - 1) * m_fWorldScale;
+	const GLint iPatchX = std::clamp(static_cast<GLint>(fWorldX / fPatchWorldSize), 0, m_iNumPatchesX - 1);
+	const GLint iPatchZ = std::clamp(static_cast<GLint>(fWorldZ / fPatchWorldSize), 0, m_iNumPatchesZ - 1);
+	const TSplatData& patchData = m_vSplatData[iPatchZ * m_iNumPatchesX + iPatchX];
+
+	glm::uvec4 index = patchData.constantIndex;
+	glm::vec4 weight = patchData.constantWeight;
+
+	if (patchData.IsMaterialized())
+	{
+		// Same texel layout as PaintBrushOnSinglePatch
+		const GLint R = m_iSplatTexResolution;
+		const GLfloat fTexelSize = fPatchWorldSize / R;
+		const GLint iTexelX = std::clamp(static_cast<GLint>((fWorldX - iPatchX * fPatchWorldSize) / fTexelSize), 0, R - 1);
+		const GLint iTexelZ = std::clamp(static_cast<GLint>((fWorldZ - iPatchZ * fPatchWorldSize) / fTexelSize), 0, R - 1);
+
+		index = patchData.indexData[iTexelZ * R + iTexelX];
+		weight = patchData.weightData[iTexelZ * R + iTexelX];
+	}
+
+	GLfloat fWeight = 0.0f;
+	for (GLint i = 0; i < 4; i++)
+	{
+		if (index[i] == static_cast<GLuint>(iTextureIndex))
+		{
+			fWeight += weight[i];
+		}
+	}
+
+	return (fWeight);
 }
 
 void CGeoMipGrid::PaintSplatmap(const TBrushParams& brush)
 {
+	PaintSplatmapStamp(brush);
+	UploadDirtySplatmaps();
+}
+
+void CGeoMipGrid::PaintSplatmapStamp(const TBrushParams& brush)
+{
+	m_EditedRegion.Merge(static_cast<GLint>(std::floor((brush.v2WorldPos.x - brush.fRadius) / m_fWorldScale)),
+		static_cast<GLint>(std::floor((brush.v2WorldPos.y - brush.fRadius) / m_fWorldScale)),
+		static_cast<GLint>(std::ceil((brush.v2WorldPos.x + brush.fRadius) / m_fWorldScale)),
+		static_cast<GLint>(std::ceil((brush.v2WorldPos.y + brush.fRadius) / m_fWorldScale)));
+
 	// Iterate over all patches
 	for (int i = 0; i < m_vSplatData.size(); ++i)
 	{
 		if (BrushIntersectsPatch(i, brush))
 		{
-			// Paint on the overlapping patch
+			// Paint on the overlapping patch, upload is deferred to UploadDirtySplatmaps
+			MaterializePatch(i);
 			PaintBrushOnSinglePatch(brush, i);
+			m_vSplatDirty[i] = true;
+		}
+	}
+}
+
+void CGeoMipGrid::UploadDirtySplatmaps()
+{
+	for (GLint i = 0; i < static_cast<GLint>(m_vSplatDirty.size()); ++i)
+	{
+		if (m_vSplatDirty[i])
+		{
+			// Patches that became uniform again (fully erased or filled) go back to a shared tile
+			if (!IsPatchUniform(i) || !CollapsePatch(i))
+			{
+				UploadSplatmapToGPU(i);
+			}
+			m_vSplatDirty[i] = false;
 		}
 	}
 }
@@ -1107,20 +1927,23 @@ void CGeoMipGrid::PaintBrushOnSinglePatch(const TBrushParams& brush, int iPatchI
 				weights /= sum;
 		}
 	}
-
-	UploadSplatmapToGPU(iPatchIndex);
 }
 
 void CGeoMipGrid::UploadSplatmapToGPU(GLint iPatchIndex)
 {
+	if (!m_vSplatData[iPatchIndex].IsMaterialized() || !m_vIndexMaps[iPatchIndex])
+	{
+		return;
+	}
+
 	const GLint iSplatResolution = m_iSplatTexResolution; // Resolution per patch
 
 	// Upload index map
-	glBindTexture(GL_TEXTURE_2D, m_vIndexMaps[iPatchIndex]->GetTextureID());
+	CGLState::BindTexture(GL_TEXTURE_2D, m_vIndexMaps[iPatchIndex]->GetTextureID());
 	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, iSplatResolution, iSplatResolution, GL_RGBA_INTEGER, GL_UNSIGNED_INT, m_vSplatData[iPatchIndex].indexData.data());
 
 	// Upload weight map
-	glBindTexture(GL_TEXTURE_2D, m_vWeightMaps[iPatchIndex]->GetTextureID());
+	CGLState::BindTexture(GL_TEXTURE_2D, m_vWeightMaps[iPatchIndex]->GetTextureID());
 	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, iSplatResolution, iSplatResolution, GL_RGBA, GL_FLOAT, m_vSplatData[iPatchIndex].weightData.data());
 }
 
@@ -1139,18 +1962,236 @@ glm::vec2 CGeoMipGrid::GetPatchOrigin(int patchIndex) const
 
 void CGeoMipGrid::ResetAllSplatmapsToBaseTexture()
 {
-	for (auto& patchData : m_vSplatData)
+	for (GLint i = 0; i < static_cast<GLint>(m_vSplatData.size()); ++i)
+	{
+		auto& patchData = m_vSplatData[i];
+		std::vector<glm::uvec4>().swap(patchData.indexData);
+		std::vector<glm::vec4>().swap(patchData.weightData);
+		patchData.constantIndex = glm::uvec4(0, 0, 0, 0);
+		patchData.constantWeight = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+
+		CollapsePatch(i);
+		m_vSplatDirty[i] = false;
+	}
+
+	m_EditedRegion.Merge(0, 0, m_iWidth - 1, m_iDepth - 1);
+}
+
+void CGeoMipGrid::EncodeSplatmaps(std::vector<uint8_t>& vOut) const
+{
+	CSplatFile::Encode(m_vSplatData, m_iSplatTexResolution, m_iNumPatchesX, m_iNumPatchesZ, vOut);
+}
+
+bool CGeoMipGrid::SaveSplatmaps(const std::string& stFileName) const
+{
+	std::vector<uint8_t> vBlob;
+	EncodeSplatmaps(vBlob);
+
+	std::ofstream file(stFileName, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		sys_err("CGeoMipGrid::SaveSplatmaps: Failed to open %s for writing", stFileName.c_str());
+		return (false);
+	}
+
+	file.write(reinterpret_cast<const char*>(vBlob.data()), static_cast<std::streamsize>(vBlob.size()));
+	if (!file.good())
+	{
+		sys_err("CGeoMipGrid::SaveSplatmaps: Failed to write %zu bytes to %s", vBlob.size(), stFileName.c_str());
+		return (false);
+	}
+
+	sys_log("CGeoMipGrid::SaveSplatmaps: Saved %s (%zu bytes)", stFileName.c_str(), vBlob.size());
+	return (true);
+}
+
+bool CGeoMipGrid::LoadSplatmaps(const std::string& stFileName)
+{
+	CMappedFile file;
+	if (!file.Open(stFileName))
+	{
+		return (false);
+	}
+
+	if (!LoadSplatmaps(file.GetData(), file.GetSize()))
+	{
+		sys_err("CGeoMipGrid::LoadSplatmaps: Failed to load %s", stFileName.c_str());
+		return (false);
+	}
+
+	sys_log("CGeoMipGrid::LoadSplatmaps: Loaded %s", stFileName.c_str());
+	return (true);
+}
+
+bool CGeoMipGrid::LoadSplatmaps(const uint8_t* pData, size_t iSize)
+{
+	CSplatFile splatFile;
+	if (!splatFile.Open(pData, iSize))
+	{
+		return (false);
+	}
+
+	const TSplatFileHeader& header = splatFile.GetHeader();
+	if (header.uiResolution != static_cast<uint32_t>(m_iSplatTexResolution) ||
+		header.uiNumPatchesX != static_cast<uint32_t>(m_iNumPatchesX) ||
+		header.uiNumPatchesZ != static_cast<uint32_t>(m_iNumPatchesZ))
 	{
-		const int texelCount = m_iSplatTexResolution * m_iSplatTexResolution;
-		for (int i = 0; i < texelCount; ++i)
+		sys_err("CGeoMipGrid::LoadSplatmaps: Layout mismatch, file %ux%u patches at %u, terrain %dx%d patches at %d",
+			header.uiNumPatchesX, header.uiNumPatchesZ, header.uiResolution, m_iNumPatchesX, m_iNumPatchesZ, m_iSplatTexResolution);
+		return (false);
+	}
+
+	const GLint R = m_iSplatTexResolution;
+	const size_t iTexels = static_cast<size_t>(R) * R;
+
+	m_EditedRegion.Merge(0, 0, m_iWidth - 1, m_iDepth - 1);
+
+	for (GLint i = 0; i < splatFile.GetChunksCount(); i++)
+	{
+		auto& patchData = m_vSplatData[i];
+
+		if (!splatFile.DecodeChunk(i, patchData))
+		{
+			sys_err("CGeoMipGrid::LoadSplatmaps: Patch %d is corrupted, reset to the base layer", i);
+			std::vector<glm::uvec4>().swap(patchData.indexData);
+			std::vector<glm::vec4>().swap(patchData.weightData);
+			patchData.constantIndex = glm::uvec4(0);
+			patchData.constantWeight = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+		}
+
+		m_vSplatDirty[i] = false;
+
+		// Uniform patches only need their shared tile
+		if (!patchData.IsMaterialized() && CollapsePatch(i))
 		{
-			patchData.indexData[i] = glm::uvec4(0, 0, 0, 0);
-			patchData.weightData[i] = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+			continue;
+		}
+
+		MaterializePatch(i);
+
+		const TSplatChunk& chunk = splatFile.GetChunk(i);
+		if (chunk.uiEncoding == SPLAT_CHUNK_RAW)
+		{
+			// Raw patches go to the GPU straight from the mapped file
+			const uint8_t* pPayload = splatFile.GetPayload(i);
+
+			CGLState::BindTexture(GL_TEXTURE_2D, m_vIndexMaps[i]->GetTextureID());
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, R, R, GL_RGBA_INTEGER, GL_UNSIGNED_INT, pPayload);
+
+			CGLState::BindTexture(GL_TEXTURE_2D, m_vWeightMaps[i]->GetTextureID());
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, R, R, GL_RGBA, GL_FLOAT, pPayload + iTexels * sizeof(glm::uvec4));
+		}
+		else
+		{
+			UploadSplatmapToGPU(i);
 		}
 	}
 
-	for (int i = 0; i < m_vSplatData.size(); ++i)
-		UploadSplatmapToGPU(i);
+	CGLState::BindTexture(GL_TEXTURE_2D, 0);
+	return (true);
+}
+
+bool CGeoMipGrid::AutoSplat()
+{
+	if (!m_AutoSplat.BuildRules(CBaseTerrain::Instance().GetTextureSet()))
+	{
+		sys_err("CGeoMipGrid::AutoSplat: The texture set has no auto splat rules (height max must be above height min)");
+		return (false);
+	}
+
+	TGridRegion region;
+	region.Merge(0, 0, m_iWidth - 1, m_iDepth - 1);
+	AutoSplatRegion(region);
+	UploadDirtySplatmaps();
+
+	sys_log("CGeoMipGrid::AutoSplat: Applied %zu rules on %zu patches", m_AutoSplat.GetRulesCount(), m_vSplatData.size());
+	return (true);
+}
+
+void CGeoMipGrid::AutoSplatRegion(const TGridRegion& region)
+{
+	if (region.IsEmpty() || m_vecVertices.empty())
+	{
+		return;
+	}
+
+	// Kept until the texture set changes
+	if (!m_AutoSplat.UpdateRules(CBaseTerrain::Instance().GetTextureSet()))
+	{
+		return;
+	}
+
+	// The texels below sample the vertices up to 2 away from the change (1 texel of margin and the
+	// bilinear footprint), the derivatives of those read the heights one stencil radius further
+	const GLint iMinX = std::max(region.iMinX - 2, 0);
+	const GLint iMinZ = std::max(region.iMinZ - 2, 0);
+	const GLint iMaxX = std::min(region.iMaxX + 2, m_iWidth - 1);
+	const GLint iMaxZ = std::min(region.iMaxZ + 2, m_iDepth - 1);
+
+	const GLint iCopyMinX = std::max(iMinX - AUTO_SPLAT_STENCIL_RADIUS, 0);
+	const GLint iCopyMinZ = std::max(iMinZ - AUTO_SPLAT_STENCIL_RADIUS, 0);
+	const GLint iCopyMaxX = std::min(iMaxX + AUTO_SPLAT_STENCIL_RADIUS, m_iWidth - 1);
+	const GLint iCopyMaxZ = std::min(iMaxZ + AUTO_SPLAT_STENCIL_RADIUS, m_iDepth - 1);
+
+	GLfloat* pHeights = m_AutoSplat.GetHeights();
+	for (GLint z = iCopyMinZ; z <= iCopyMaxZ; z++)
+	{
+		for (GLint x = iCopyMinX; x <= iCopyMaxX; x++)
+		{
+			pHeights[z * m_iWidth + x] = m_vecVertices[z * m_iWidth + x].m_v3Pos.y;
+		}
+	}
+	m_AutoSplat.UpdateDerivatives(iMinX, iMinZ, iMaxX, iMaxZ);
+	m_EditedRegion.Merge(iMinX, iMinZ, iMaxX, iMaxZ);
+
+	// Texel windows of the patches overlapping the changed vertices
+	const GLint R = m_iSplatTexResolution;
+	const GLfloat fPatchWorldSize = (m_iPatchSize - 1) * m_fWorldScale;
+	const GLfloat fTexelSize = fPatchWorldSize / R;
+
+	const GLfloat fWorldX0 = (region.iMinX - 1) * m_fWorldScale;
+	const GLfloat fWorldZ0 = (region.iMinZ - 1) * m_fWorldScale;
+	const GLfloat fWorldX1 = (region.iMaxX + 1) * m_fWorldScale;
+	const GLfloat fWorldZ1 = (region.iMaxZ + 1) * m_fWorldScale;
+
+	std::vector<TAutoSplatPatch> vPatches;
+
+	for (GLint i = 0; i < static_cast<GLint>(m_vSplatData.size()); i++)
+	{
+		const glm::vec2 v2Origin = GetPatchOrigin(i);
+		if (fWorldX1 < v2Origin.x || fWorldX0 > v2Origin.x + fPatchWorldSize ||
+			fWorldZ1 < v2Origin.y || fWorldZ0 > v2Origin.y + fPatchWorldSize)
+		{
+			continue;
+		}
+
+		MaterializePatch(i);
+
+		TAutoSplatPatch patch{};
+		patch.pIndexData = m_vSplatData[i].indexData.data();
+		patch.pWeightData = m_vSplatData[i].weightData.data();
+		patch.fOriginX = v2Origin.x;
+		patch.fOriginZ = v2Origin.y;
+		patch.iTexelX0 = std::max(static_cast<GLint>(std::floor((fWorldX0 - v2Origin.x) / fTexelSize)), 0);
+		patch.iTexelZ0 = std::max(static_cast<GLint>(std::floor((fWorldZ0 - v2Origin.y) / fTexelSize)), 0);
+		patch.iTexelX1 = std::min(static_cast<GLint>(std::ceil((fWorldX1 - v2Origin.x) / fTexelSize)), R - 1);
+		patch.iTexelZ1 = std::min(static_cast<GLint>(std::ceil((fWorldZ1 - v2Origin.y) / fTexelSize)), R - 1);
+
+		vPatches.push_back(patch);
+		m_vSplatDirty[i] = true;
+	}
+
+	m_AutoSplat.Evaluate(vPatches, R, fTexelSize);
+}
+
+void CGeoMipGrid::SetAutoSplatOnSculpt(bool bEnable)
+{
+	m_bAutoSplatOnSculpt = bEnable;
+}
+
+bool CGeoMipGrid::IsAutoSplatOnSculpt() const
+{
+	return (m_bAutoSplatOnSculpt);
 }
 
 glm::ivec2 CGeoMipGrid::GetPatchIndexFromWorldPos2D(glm::vec2 worldPos)
@@ -2,10 +2,16 @@
 
 #include <glad/glad.h>
 #include <vector>
+#include <string>
+#include <climits>
+#include <algorithm>
 #include "lod_manager.h"
+#include "auto_splat.h"
 
 class CBaseTerrain;
 
+constexpr size_t SPLAT_MAX_CONSTANT_TILES = 64;
+
 enum EBrushType
 {
 	BRUSH_TYPE_NONE,
@@ -46,6 +52,63 @@ typedef struct SBrushParams
 	GLfloat fAlpha = 1.0f; // Add this
 } TBrushParams;
 
+typedef struct SBrushStamp
+{
+	EBrushType eBrushType;
+	SVector2Df v2WorldPos;			// Stamp center (X, Z)
+	GLfloat fRadius;				// Stamp radius
+	GLfloat fStrength;				// Height change (or paint intensity) of this single stamp
+	GLfloat fBaseHeight;			// Reference height for the flatten brush, sampled at stroke start
+	GLint iTextureIndex;			// Texture brush only
+} TBrushStamp;
+
+typedef struct SGridRegion
+{
+	GLint iMinX;
+	GLint iMinZ;
+	GLint iMaxX;
+	GLint iMaxZ;
+
+	SGridRegion()
+	{
+		Reset();
+	}
+
+	void Reset()
+	{
+		iMinX = iMinZ = INT_MAX;
+		iMaxX = iMaxZ = INT_MIN;
+	}
+
+	bool IsEmpty() const
+	{
+		return (iMinX > iMaxX || iMinZ > iMaxZ);
+	}
+
+	void Merge(GLint iX0, GLint iZ0, GLint iX1, GLint iZ1)
+	{
+		iMinX = (std::min)(iMinX, iX0);
+		iMinZ = (std::min)(iMinZ, iZ0);
+		iMaxX = (std::max)(iMaxX, iX1);
+		iMaxZ = (std::max)(iMaxZ, iZ1);
+	}
+
+	void Merge(const SGridRegion& region)
+	{
+		if (!region.IsEmpty())
+		{
+			Merge(region.iMinX, region.iMinZ, region.iMaxX, region.iMaxZ);
+		}
+	}
+} TGridRegion;
+
+typedef struct SPatchBoundsLevel
+{
+	GLint iWidth;
+	GLint iDepth;
+	std::vector<SVector2Df> vNodes;	// (min, max) height, row major
+} TPatchBoundsLevel;
+
 class CGeoMipGrid
 {
 public:
@@ -56,6 +119,17 @@ public:
 	void Render();
 	void Render(const SVector3Df& CameraPos, const CMatrix4Df& ViewProj);
 
+	// Frustum test over the patch bounds pyramid, fills the list Render draws from. Returns the visible count
+	size_t CullPatches(const CMatrix4Df& ViewProj);
+	const std::vector<glm::ivec2>& GetVisiblePatches() const;
+
+	// Picking against the vertex heights, both only accept rays pointing downward
+	bool RaycastHeightmap(const SVector3Df& rayOrigin, const SVector3Df& rayDir, SVector3Df& intersectionPoint) const;
+	bool RaycastHeightmapFast(const SVector3Df& rayOrigin, const SVector3Df& rayDir, SVector3Df& intersectionPoint) const;
+
+	// False when built for a headless terrain: CPU data only, every upload is skipped
+	bool HasGLState() const;
+
 	bool IsPatchInsideViewFrustumViewSpace(GLint iX, GLint iZ, const CMatrix4Df& matViewProj) const;
 	bool IsPatchInsideViewFrustumWorldSpace(GLint iX, GLint iZ, const SFrustumCulling& sFrustumCulling) const;
 
@@ -86,15 +160,46 @@ public:
 
 	void ApplyTerrainBrush_World(EBrushType eBrushType, GLfloat worldX, GLfloat worldZ, GLfloat fRadius, GLfloat fStrength);
 	void UpdateNormals();
+	void UpdateNormals(const TGridRegion& region);
 	void UpdateVertexBuffer();
+	void UpdateVertexBuffer(const TGridRegion& region);
 	void SetCurrentTextureIndex(GLint iTexIdx);
 
+	// Heights are row major, m_iWidth * m_iDepth
+	void CopyHeights(std::vector<GLfloat>& vHeights) const;
+	// A world file load passes false and hands over its stored patch bounds and LOD errors
+	void SetHeights(const GLfloat* pHeights, bool bUpdatePatchMetrics = true);
+
+	// Patch height bounds, [0] holds one node per patch and every level above merges 2x2 nodes
+	const std::vector<TPatchBoundsLevel>& GetPatchBounds() const;
+	// Largest height each LOD misses inside a patch, (max LOD + 1) per patch. Feeds the LOD manager
+	const std::vector<GLfloat>& GetLodErrors() const;
+	// False when the layout doesn't match this grid, the caller then recomputes them
+	bool SetPatchBoundsLevel(GLint iLevel, const SVector2Df* pNodes, GLint iWidth, GLint iDepth);
+	bool SetLodErrors(const GLfloat* pErrors, size_t iCount);
+	void UpdatePatchMetrics();
+	void UpdatePatchMetrics(const TGridRegion& region);
+
 	GLint GetPatchIndexFromWorldPos(const SVector2Df& v3WorldPos) const;
 
+	// Stroke editing: stamps are queued during the frame and merged into a single region update
+	void QueueBrushStamp(const TBrushStamp& stamp);
+	void FlushBrushStamps();
+	const TGridRegion& GetLastModifiedRegion() const;
+
+	// Every height and splat change since the previous call, in vertex coordinates. For the
+	// systems that cache data derived from the terrain, the scatter takes it once per frame
+	TGridRegion TakeEditedRegion();
+
 protected:
+	void ApplyHeightStamp(const TBrushStamp& stamp, TGridRegion& region);
+
+	void InitPatchMetrics();
+	void CullNode(GLint iLevel, GLint iNodeX, GLint iNodeZ, const SFrustumCulling& sFrustumCulling);
 
 	void CreateGLState();
 	void PopulateBuffers(CBaseTerrain* pTerrain);
+	void InitBuffers(CBaseTerrain* pTerrain);
 
 	GLint CalculateNumIndices() const;
 
@@ -126,19 +231,50 @@ private:
 	std::vector<SVertex> m_vecVertices;
 	std::vector<GLuint> m_vecIndices;
 
+	std::vector<glm::ivec2> m_vVisiblePatches;	// Patches that passed the frustum test this frame
+	std::vector<TPatchBoundsLevel> m_vPatchBounds;
+	std::vector<GLfloat> m_vLodErrors;
+
+	std::vector<TBrushStamp> m_vPendingStamps;
+	TGridRegion m_LastModifiedRegion;
+	TGridRegion m_EditedRegion;		// Accumulated until TakeEditedRegion
+	uint64_t m_ulNoiseSeed;			// Noise brush: CRandom::FloatAt(seed, x, z, stamp)
+	uint32_t m_uiNoiseStamp;
+
 // SplatData Implementation
 public:
 	struct TSplatData
 	{
-		std::vector<glm::uvec4> indexData;  // Texture indices (per texel)
+		std::vector<glm::uvec4> indexData;  // Texture indices (per texel), empty until the patch is painted
 		std::vector<glm::vec4> weightData;   // Blending weights (per texel)
+
+		// Value of every texel while the patch isn't materialized
+		glm::uvec4 constantIndex = glm::uvec4(0);
+		glm::vec4 constantWeight = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+		GLint iConstantTile = 0;
+
+		bool IsMaterialized() const
+		{
+			return (!indexData.empty());
+		}
 	};
 
+	// 1x1 splat textures shared by every uniform patch with the same value, [0] is the base layer
+	typedef struct SSplatConstantTile
+	{
+		glm::uvec4 index;
+		glm::vec4 weight;
+		CTexture* pIndexMap;
+		CTexture* pWeightMap;
+	} TSplatConstantTile;
+
 	void SetupSplatTextures();
 	void UploadSplatBindings();
 	void PaintSplatmap(EBrushType eBrushType, const TBrushParams& brush);
 	void UploadSplatmapToGPU(GLint iPatchIndex);
 	void PaintSplatmap(const TBrushParams& brush);
+	void PaintSplatmapStamp(const TBrushParams& brush);
+	void UploadDirtySplatmaps();
 	float SmoothBrushFalloff(float dist, float radius, float hardness = 0.8f);
 	glm::vec2 GetPatchOrigin(int patchIndex) const;
 	void ResetAllSplatmapsToBaseTexture();
@@ -147,11 +283,41 @@ public:
 	int GetPatchLinearIndex(int px, int py);
 	bool BrushIntersectsPatch(int patchIndex, const TBrushParams& brush);
 
+	// Sparse patches: painted patches own their maps, the others sample a shared constant tile
+	void MaterializePatch(GLint iPatchIndex);
+	bool CollapsePatch(GLint iPatchIndex);
+	bool IsPatchUniform(GLint iPatchIndex) const;
+	size_t GetMaterializedPatchesCount() const;
+
+	// Weight of a texture set entry at a world position (nearest texel), 0 when it isn't one of the 4 layers
+	GLfloat GetSplatWeight(GLfloat fWorldX, GLfloat fWorldZ, GLint iTextureIndex) const;
+
+	// Binary splat maps (see splat_file.h)
+	void EncodeSplatmaps(std::vector<uint8_t>& vOut) const;
+	bool SaveSplatmaps(const std::string& stFileName) const;
+	bool LoadSplatmaps(const std::string& stFileName);
+	bool LoadSplatmaps(const uint8_t* pData, size_t iSize);
+
+	// Rule-based texturing from the texture set height/slope/curvature ranges
+	bool AutoSplat();
+	void AutoSplatRegion(const TGridRegion& region);
+	void SetAutoSplatOnSculpt(bool bEnable);
+	bool IsAutoSplatOnSculpt() const;
+
+protected:
+	GLint GetConstantTile(const glm::uvec4& index, const glm::vec4& weight);
+	void UpdatePatchBinding(GLint iPatchIndex);
+	void ReleasePatchMaps(GLint iPatchIndex);
+
 private:
-	std::vector<CTexture*> m_vIndexMaps;    // GL_RGBA32UI textures
+	std::vector<CTexture*> m_vIndexMaps;    // GL_RGBA32UI textures, nullptr while the patch isn't materialized
 	std::vector<CTexture*> m_vWeightMaps;   // GL_RGBA32F textures
+	std::vector<TSplatConstantTile> m_vConstantTiles;
 	std::vector<TSplatData> m_vSplatData;   // CPU-side data
+	std::vector<bool> m_vSplatDirty;		// Patches painted since the last upload
 	GLuint m_uiSplatIndexHandlesSSBO;		// SSBO for texture handles
 	GLuint m_uiSplatWeightHandlesSSBO;		// SSBO for texture handles
 
+	CTerrainAutoSplat m_AutoSplat;
+	bool m_bAutoSplatOnSculpt;				// Re-run the rules where a height brush just changed the terrain
 };
\ No newline at end of file
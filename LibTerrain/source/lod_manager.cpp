@@ -22,6 +22,7 @@ GLint CLodManager::InitLodManager(GLint iPatchSize, GLint iNumPatchesX, GLint iN
 	TPatchLod Zero{};
 	m_gMap.InitGrid(iNumPatchesX, iNumPatchesZ, Zero);
 	m_vRegions.resize(m_iMaxLod + 1);
+	m_vLodErrors.clear();
 
 	CalcLodRegions();
 
@@ -34,12 +35,14 @@ void CLodManager::Update()
 	const SVector3Df& vCameraPos = camera->GetPosition();
 
 	UpdateLodMapPassOne(vCameraPos);
+	LimitLodSteps();
 	UpdateLodMapPassTwo(vCameraPos);
 }
 
 void CLodManager::Update(const SVector3Df& vCameraPos)
 {
 	UpdateLodMapPassOne(vCameraPos);
+	LimitLodSteps();
 	UpdateLodMapPassTwo(vCameraPos);
 }
 
@@ -48,6 +51,17 @@ const TPatchLod& CLodManager::GetPatchLod(GLint iPatchX, GLint iPatchZ) const
 	return (m_gMap.Get(iPatchX, iPatchZ));
 }
 
+void CLodManager::SetLodErrors(const std::vector<GLfloat>& vLodErrors)
+{
+	if (vLodErrors.size() != static_cast<size_t>(m_iNumPatchesX) * m_iNumPatchesZ * (m_iMaxLod + 1))
+	{
+		m_vLodErrors.clear();
+		return;
+	}
+
+	m_vLodErrors = vLodErrors;
+}
+
 void CLodManager::PrintLodMap() const
 {
 	for (GLint iLodMapZ = m_iNumPatchesZ - 1; iLodMapZ >= 0; iLodMapZ--)
@@ -90,14 +104,14 @@ void CLodManager::CalcLodRegions()
 bool CLodManager::CalcMaxLOD()
 {
 	const GLint iNumSegments = m_iPatchSize - 1;
-	if (std::ceilf(std::log2f(static_cast<float>(iNumSegments))) != std::floorf(std::log2f(static_cast<float>(iNumSegments))))
+	if (std::ceil(std::log2(static_cast<float>(iNumSegments))) != std::floor(std::log2(static_cast<float>(iNumSegments))))
 	{
 		sys_err("The number of vertices in the patch minus one must be a power of two");
-		sys_err("%f %f", std::ceilf(std::log2f(static_cast<float>(iNumSegments))), std::floorf(std::log2f(static_cast<float>(iNumSegments))));
+		sys_err("%f %f", std::ceil(std::log2(static_cast<float>(iNumSegments))), std::floor(std::log2(static_cast<float>(iNumSegments))));
 		return false;
 	}
 
-	const GLint iPatchSizeLog2 = static_cast<GLint>(std::log2f(static_cast<float>(iNumSegments)));
+	const GLint iPatchSizeLog2 = static_cast<GLint>(std::log2(static_cast<float>(iNumSegments)));
 
 #if defined(_DEBUG)
 	sys_log("CalcMaxLOD: log2 of patch size %d is %d", m_iPatchSize, iPatchSizeLog2);
@@ -122,7 +136,7 @@ void CLodManager::UpdateLodMapPassOne(const SVector3Df& vCameraPos)
 
 			const float fDistanceToCamera = vCameraPos.distance(v3PatchCenter);
 
-			const GLint iCoreLOD = DistanceToLod(fDistanceToCamera);
+			const GLint iCoreLOD = std::max(DistanceToLod(fDistanceToCamera), ErrorToLod(iLodMapZ * m_iNumPatchesX + iLodMapX, fDistanceToCamera));
 
 			TPatchLod* pPatchLOD = m_gMap.GetAddr(iLodMapX, iLodMapZ);
 			pPatchLOD->iCore = iCoreLOD;
@@ -221,4 +235,70 @@ GLint CLodManager::DistanceToLod(float fDistance)
 	}
 
 	return (iLod);
+}
+
+GLint CLodManager::ErrorToLod(GLint iPatchIndex, float fDistance) const
+{
+	if (m_vLodErrors.empty())
+	{
+		return (0);
+	}
+
+	const GLfloat* pErrors = &m_vLodErrors[static_cast<size_t>(iPatchIndex) * (m_iMaxLod + 1)];
+	const float fMaxError = fDistance * LOD_ERROR_PER_DISTANCE;
+
+	GLint iLod = 0;
+	while (iLod < m_iMaxLod && pErrors[iLod + 1] <= fMaxError)
+	{
+		iLod++;
+	}
+
+	return (iLod);
+}
+
+// The stitched edges only bridge one LOD, the error based LODs can jump further between neighbours.
+// Patches are only ever refined here, down to one above their finest neighbour
+void CLodManager::LimitLodSteps()
+{
+	if (m_vLodErrors.empty())
+	{
+		return;
+	}
+
+	bool bChanged = true;
+	while (bChanged)
+	{
+		bChanged = false;
+
+		for (GLint iLodMapZ = 0; iLodMapZ < m_iNumPatchesZ; iLodMapZ++)
+		{
+			for (GLint iLodMapX = 0; iLodMapX < m_iNumPatchesX; iLodMapX++)
+			{
+				GLint iLimit = m_gMap.Get(iLodMapX, iLodMapZ).iCore;
+
+				if (iLodMapX > 0)
+				{
+					iLimit = std::min(iLimit, m_gMap.Get(iLodMapX - 1, iLodMapZ).iCore + 1);
+				}
+				if (iLodMapX < m_iNumPatchesX - 1)
+				{
+					iLimit = std::min(iLimit, m_gMap.Get(iLodMapX + 1, iLodMapZ).iCore + 1);
+				}
+				if (iLodMapZ > 0)
+				{
+					iLimit = std::min(iLimit, m_gMap.Get(iLodMapX, iLodMapZ - 1).iCore + 1);
+				}
+				if (iLodMapZ < m_iNumPatchesZ - 1)
+				{
+					iLimit = std::min(iLimit, m_gMap.Get(iLodMapX, iLodMapZ + 1).iCore + 1);
+				}
+
+				if (iLimit < m_gMap.Get(iLodMapX, iLodMapZ).iCore)
+				{
+					m_gMap.At(iLodMapX, iLodMapZ).iCore = iLimit;
+					bChanged = true;
+				}
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -27,6 +27,10 @@ typedef struct SSingleLodInfo
 	}
 } TSingleLodInfo;
 
+// A patch may take a coarser LOD than its distance gives while the height it misses stays below
+// this fraction of the distance, about a pixel at 1080p with a 60 degree field of view
+constexpr float LOD_ERROR_PER_DISTANCE = 0.001f;
+
 constexpr GLint LEFT = 2;
 constexpr GLint RIGHT = 2;
 constexpr GLint TOP = 2;
@@ -50,6 +54,9 @@ public:
 
 	const TPatchLod& GetPatchLod(GLint iPatchX, GLint iPatchZ) const;
 
+	// Largest height each LOD misses, (max LOD + 1) per patch, see CGeoMipGrid::GetLodErrors
+	void SetLodErrors(const std::vector<GLfloat>& vLodErrors);
+
 	void PrintLodMap() const;
 
 private:
@@ -60,6 +67,8 @@ private:
 	void UpdateLodMapPassTwo(const SVector3Df& vCameraPos);
 
 	GLint DistanceToLod(float fDistance);
+	GLint ErrorToLod(GLint iPatchIndex, float fDistance) const;
+	void LimitLodSteps();
 
 private:
 	GLint m_iMaxLod;
@@ -70,4 +79,5 @@ private:
 
 	CGrid<TPatchLod> m_gMap;
 	std::vector<GLint> m_vRegions;
+	std::vector<GLfloat> m_vLodErrors;	// Empty until the grid sets them, the LOD is then distance only
 };
\ No newline at end of file
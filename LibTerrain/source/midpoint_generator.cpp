@@ -0,0 +1,134 @@
+#include "stdafx.h"
+#include "midpoint_generator.h"
+
+bool CMidPointGenerator::Generate(CGrid<GLfloat>& grid, GLint iTerrainSize, float fRoughness, float fMinHeight, float fMaxHeight, uint64_t ulSeed)
+{
+	if (fRoughness < 0.0f)
+	{
+		sys_err("CMidPointGenerator::Generate Roughness Must be Positive!");
+		return (false);
+	}
+
+	m_iTerrainSize = iTerrainSize;
+	m_Random.Seed(ulSeed);
+
+	grid.InitGrid(iTerrainSize, iTerrainSize, 0.0f);
+
+	GLint iRectSize = CalculateNextPowerOfTwo(m_iTerrainSize);
+	float fCurHeight = static_cast<float>(iRectSize) / 2.0f;
+	const float fHeightReduce = std::pow(2.0f, -fRoughness);
+
+	while (iRectSize > 0)
+	{
+		DiamondStep(grid, iRectSize, fCurHeight);
+		SquareStep(grid, iRectSize, fCurHeight);
+
+		iRectSize /= 2;
+		fCurHeight *= fHeightReduce;
+	}
+
+	m_vRandomRow.clear();
+	m_vRandomRow.shrink_to_fit();
+
+	grid.Normalize(fMinHeight, fMaxHeight);
+	return (true);
+}
+
+// One batch of displacements per row, in [-fCurHeight, fCurHeight)
+void CMidPointGenerator::FillRandomRow(size_t uiCount, float fCurHeight)
+{
+	m_vRandomRow.resize(uiCount);
+	m_Random.Fill(m_vRandomRow.data(), uiCount, -fCurHeight, fCurHeight);
+}
+
+void CMidPointGenerator::DiamondStep(CGrid<GLfloat>& grid, GLint iRectSize, float fCurHeight)
+{
+	const GLint iHalfRectangle = iRectSize / 2;
+	const size_t uiCellsPerRow = static_cast<size_t>((m_iTerrainSize + iRectSize - 1) / iRectSize);
+
+	for (GLint y = 0; y < m_iTerrainSize; y += iRectSize)
+	{
+		FillRandomRow(uiCellsPerRow, fCurHeight);
+		const float* pRandom = m_vRandomRow.data();
+
+		for (GLint x = 0; x < m_iTerrainSize; x += iRectSize)
+		{
+			GLint iNextX = (x + iRectSize) % m_iTerrainSize;
+			GLint iNextY = (y + iRectSize) % m_iTerrainSize;
+
+			if (iNextX < x)
+			{
+				iNextX = m_iTerrainSize - 1;
+			}
+
+			if (iNextY < y)
+			{
+				iNextY = m_iTerrainSize - 1;
+			}
+
+			const float fTopLeft = grid.Get(x, y);
+			const float fTopRight = grid.Get(iNextX, y);
+			const float fBottomLeft = grid.Get(x, iNextY);
+			const float fBottomRight = grid.Get(iNextX, iNextY);
+
+			const GLint iMidX = (x + iHalfRectangle) % m_iTerrainSize;
+			const GLint iMidY = (y + iHalfRectangle) % m_iTerrainSize;
+
+			const float fRandValue = *pRandom++;
+			const float fMidPoint = (fTopLeft + fTopRight + fBottomLeft + fBottomRight) / 4.0f;
+
+			grid.Set(iMidX, iMidY, fMidPoint + fRandValue);
+		}
+	}
+}
+
+void CMidPointGenerator::SquareStep(CGrid<GLfloat>& grid, GLint iRectSize, float fCurHeight)
+{
+	//CurTopMid = avg(PrevYCenter, CurTopLeft, CurTopRight, CurCenter)
+	//CurLeftMid = avg(CurPrevXCenterm CurTopleft, CurBotLeft, CurCenter)
+
+	const GLint iHalfRectangle = iRectSize / 2;
+	const size_t uiCellsPerRow = static_cast<size_t>((m_iTerrainSize + iRectSize - 1) / iRectSize);
+
+	for (GLint y = 0; y < m_iTerrainSize; y += iRectSize)
+	{
+		FillRandomRow(uiCellsPerRow * 2, fCurHeight);
+		const float* pRandom = m_vRandomRow.data();
+
+		for (GLint x = 0; x < m_iTerrainSize; x += iRectSize)
+		{
+			GLint iNextX = (x + iRectSize) % m_iTerrainSize;
+			GLint iNextY = (y + iRectSize) % m_iTerrainSize;
+
+			if (iNextX < x)
+			{
+				iNextX = m_iTerrainSize - 1;
+			}
+
+			if (iNextY < y)
+			{
+				iNextY = m_iTerrainSize - 1;
+			}
+
+			const GLint iMidX = (x + iHalfRectangle) % m_iTerrainSize;
+			const GLint iMidY = (y + iHalfRectangle) % m_iTerrainSize;
+
+			const GLint iPrevMidX = (x - iHalfRectangle + m_iTerrainSize) % m_iTerrainSize;
+			const GLint iPrevMidY = (y - iHalfRectangle + m_iTerrainSize) % m_iTerrainSize;
+
+			const float fCurTopLeft = grid.Get(x, y);
+			const float fCurTopRight = grid.Get(iNextX, y);
+			const float fCurCenter = grid.Get(iMidX, iMidY);
+			const float fPrevYCenter = grid.Get(iMidX, iPrevMidY);
+			const float fCurBottomLeft = grid.Get(x, iNextY);
+			const float fPrevXCenter = grid.Get(iPrevMidX, iMidY);
+
+			const float fCurLeftMid = (fCurTopLeft + fCurCenter + fCurBottomLeft + fPrevXCenter) / 4.0f + pRandom[0];
+			const float fCurTopMid = (fCurTopLeft + fCurCenter + fCurTopRight + fPrevYCenter) / 4.0f + pRandom[1];
+			pRandom += 2;
+
+			grid.Set(iMidX, y, fCurTopMid);
+			grid.Set(x, iMidY, fCurLeftMid);
+		}
+	}
+}
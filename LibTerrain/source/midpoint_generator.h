@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <cstdint>
+#include "../../LibMath/source/stdafx.h"
+#include "../../LibMath/source/grid.h"
+
+/*
+ * Diamond-square (midpoint displacement) height map generator
+ *
+ * The displacements of a row are drawn as one batch from CRandom, so the same seed always gives
+ * the same terrain on every platform. GL free, the result is written into a CGrid and the caller
+ * decides what to build from it.
+ */
+class CMidPointGenerator
+{
+public:
+	CMidPointGenerator() = default;
+
+	// Resizes the grid to iTerrainSize * iTerrainSize and fills it with heights in [fMinHeight, fMaxHeight]
+	bool Generate(CGrid<GLfloat>& grid, GLint iTerrainSize, float fRoughness, float fMinHeight, float fMaxHeight, uint64_t ulSeed = 0);
+
+protected:
+	void DiamondStep(CGrid<GLfloat>& grid, GLint iRectSize, float fCurHeight);
+	void SquareStep(CGrid<GLfloat>& grid, GLint iRectSize, float fCurHeight);
+	void FillRandomRow(size_t uiCount, float fCurHeight);
+
+private:
+	GLint m_iTerrainSize = 0;
+	CRandom m_Random;
+	std::vector<float> m_vRandomRow;
+};
@@ -1,13 +1,15 @@
 #pragma once
 
 #include "terrain.h"
+#include "../midpoint_generator.h"
 
 class CMidPointTerrain : public CBaseTerrain
 {
 public:
 	CMidPointTerrain() = default;
 
-	void CreateMidPointTerrain(GLint iTerrainSize, GLint iNumPatches, float fRoughness, float fMinHeight, float fMaxHeight);
+	// The same seed always gives the same terrain
+	void CreateMidPointTerrain(GLint iTerrainSize, GLint iNumPatches, float fRoughness, float fMinHeight, float fMaxHeight, uint64_t ulSeed = 0);
 
 	virtual void Render();
 	virtual void SetGUI();
@@ -16,7 +18,5 @@ public:
 	virtual void Update() {}
 
 protected:
-	void CreateMidPointTerrainF32(float fRoughness);
-	void DiamondStep(GLint iRectSize, float fCurHeight);
-	void SquareStep(GLint iRectSize, float fCurHeight);
+	CMidPointGenerator m_Generator;
 };
\ No newline at end of file
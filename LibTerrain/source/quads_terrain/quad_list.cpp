@@ -14,6 +14,8 @@ CQuadList::CQuadList()
 	m_vecVertices.clear();
 	m_vecIndices.clear();
 	m_pTerrain = nullptr;
+	m_ulNoiseSeed = CRandom::ThreadLocal().NextU64();
+	m_uiNoiseStamp = 0;
 }
 
 CQuadList::~CQuadList()
@@ -25,17 +27,17 @@ void CQuadList::Destroy() const
 {
 	if (m_uiVAO)
 	{
-		glDeleteVertexArrays(1, &m_uiVAO);
+		CGLState::DeleteVertexArrays(1, &m_uiVAO);
 	}
 
 	if (m_uiVBO)
 	{
-		glDeleteBuffers(1, &m_uiVBO);
+		CGLState::DeleteBuffers(1, &m_uiVBO);
 	}
 
 	if (m_uiIB)
 	{
-		glDeleteBuffers(1, &m_uiIB);
+		CGLState::DeleteBuffers(1, &m_uiIB);
 	}
 }
 
@@ -51,9 +53,9 @@ void CQuadList::CreateQuadList(GLint iWidth, GLint iDepth, const CBaseTerrain* p
 
 	PopulateBuffers(pTerrain);
 	
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	CGLState::BindVertexArray(0);
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+	CGLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 void CQuadList::CreateGLState()
@@ -62,7 +64,7 @@ void CQuadList::CreateGLState()
 	{
 		// Create and bind VAO
 		glCreateVertexArrays(1, &m_uiVAO);
-		glBindVertexArray(m_uiVAO);
+		CGLState::BindVertexArray(m_uiVAO);
 
 		// Create VBO using DSA (Direct State Access)
 		glCreateBuffers(1, &m_uiVBO);
@@ -122,13 +124,13 @@ void CQuadList::CreateGLState()
 	else
 	{
 		glGenVertexArrays(1, &m_uiVAO);
-		glBindVertexArray(m_uiVAO);
+		CGLState::BindVertexArray(m_uiVAO);
 
 		glGenBuffers(1, &m_uiVBO);
-		glBindBuffer(GL_ARRAY_BUFFER, m_uiVBO);
+		CGLState::BindBuffer(GL_ARRAY_BUFFER, m_uiVBO);
 
 		glGenBuffers(1, &m_uiIB);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_uiIB);
+		CGLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_uiIB);
 
 		const GLint iPos = 0;
 		const GLint iNormals = 1;
@@ -328,12 +330,12 @@ void CQuadList::CalculateNormals()
 
 void CQuadList::Render() const
 {
-	glBindVertexArray(m_uiVAO);
+	CGLState::BindVertexArray(m_uiVAO);
 
 	glPatchParameteri(GL_PATCH_VERTICES, 4);
 	glDrawElements(GL_PATCHES, (m_iDepth - 1) * (m_iWidth - 1) * 4, GL_UNSIGNED_INT, NULL);
 	//glDrawElementsInstanced(GL_PATCHES, (m_iDepth - 1) * (m_iWidth - 1) * 4, GL_UNSIGNED_INT, 0, m_vecVertices.size());
-	glBindVertexArray(0);
+	CGLState::BindVertexArray(0);
 }
 
 void CQuadList::UpdateVertexBuffer()
@@ -345,9 +347,9 @@ void CQuadList::UpdateVertexBuffer()
 	}
 	else
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_uiVBO);  // Bind the vertex buffer
+		CGLState::BindBuffer(GL_ARRAY_BUFFER, m_uiVBO);  // Bind the vertex buffer
 		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(TQuadVertex) * m_vecVertices.size(), m_vecVertices.data());
-		glBindBuffer(GL_ARRAY_BUFFER, 0);  // Unbind after update
+		CGLState::BindBuffer(GL_ARRAY_BUFFER, 0);  // Unbind after update
 	}
 }
 
@@ -414,6 +416,7 @@ void CQuadList::ApplyTerrainBrush_World(EBrushType eBrushType, float worldX, flo
 	GLint endZ = std::min(m_iDepth - 1, static_cast<GLint>(gridZ + fRadius / fWorldScale));
 
 	float baseHeight = 0.0f;
+	const uint32_t uiNoiseStamp = (eBrushType == BRUSH_TYPE_NOISE) ? m_uiNoiseStamp++ : 0;
 
 	// Sample base height if flattening
 	if (eBrushType == BRUSH_TYPE_FLATTEN)
@@ -498,7 +501,7 @@ void CQuadList::ApplyTerrainBrush_World(EBrushType eBrushType, float worldX, flo
 				}
 				else if (eBrushType == BRUSH_TYPE_NOISE)
 				{
-					GLfloat noise = glm::fract(std::sin(x * 12.9898f + z * 78.233f) * 43758.5453f); // Random-ish
+					GLfloat noise = CRandom::FloatAt(m_ulNoiseSeed, static_cast<uint32_t>(x), static_cast<uint32_t>(z), uiNoiseStamp);
 					GLfloat heightChange = (noise - 0.5f) * 2.0f * fStrength * falloff;
 					currentHeight += heightChange;
 				}
@@ -74,6 +74,8 @@
 		std::vector<TQuadVertex> m_vecVertices;
 		std::vector<GLuint> m_vecIndices;
 		const CBaseTerrain* m_pTerrain;
+		uint64_t m_ulNoiseSeed;
+		uint32_t m_uiNoiseStamp;
 
 		std::vector<uint8_t> m_BlendMapData; // RGBA8
 	};
\ No newline at end of file
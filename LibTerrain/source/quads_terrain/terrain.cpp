@@ -293,10 +293,10 @@ void CBaseTerrain::Finalize()
 
 void CBaseTerrain::Render(const CCamera& rCamera)
 {
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_CULL_FACE);
+	CGLState::Enable(GL_DEPTH_TEST);
+	CGLState::Enable(GL_CULL_FACE);
 	glFrontFace(GL_CCW);
-	glCullFace(GL_BACK);
+	CGLState::CullFace(GL_BACK);
 	RenderTerrain(rCamera);
 	//RenderWater(rCamera);
 }
@@ -0,0 +1,136 @@
+#include "stdafx.h"
+#include "scatter.h"
+#include "terrain.h"
+#include "../../LibGL/source/mesh.h"
+#include "../../LibImageUI/imgui.h"
+
+CTerrainScatter::CTerrainScatter()
+{
+	m_pTerrain = nullptr;
+	m_bDrawInstances = true;
+	m_uiVisibleInstances = 0;
+	m_uiLastRebuiltCells = 0;
+
+	// Mesh fragment shader, the instanced vertex shader reads the WVP from the instance attributes
+	m_pShader = std::make_unique<CShader>("ScatterShader");
+	m_pShader->AttachShader("shaders/model_instanced.vert");
+	m_pShader->AttachShader("shaders/model_shader.frag");
+	m_pShader->LinkPrograms();
+}
+
+CTerrainScatter::~CTerrainScatter()
+{
+	m_Grid.Destroy();
+}
+
+void CTerrainScatter::Create(CBaseTerrain* pTerrain, uint64_t ulSeed)
+{
+	m_pTerrain = pTerrain;
+	m_Grid.Create(pTerrain, ulSeed);
+
+	// Edits made before this point are covered by the full build
+	pTerrain->GetGeoMipGrid()->TakeEditedRegion();
+}
+
+size_t CTerrainScatter::AddLayer(const TScatterLayer& layer, CMesh* pMesh)
+{
+	m_vMeshes.push_back(pMesh);
+	return (m_Grid.AddLayer(layer));
+}
+
+CScatterGrid& CTerrainScatter::GetGrid()
+{
+	return (m_Grid);
+}
+
+void CTerrainScatter::Update()
+{
+	if (!m_pTerrain)
+	{
+		return;
+	}
+
+	PROFILE_SCOPE("Scatter Update");
+
+	m_Grid.Invalidate(m_pTerrain->GetGeoMipGrid()->TakeEditedRegion());
+
+	const size_t uiRebuilt = m_Grid.Generate();
+	if (uiRebuilt)
+	{
+		m_uiLastRebuiltCells = uiRebuilt;
+	}
+}
+
+void CTerrainScatter::Render()
+{
+	if (!m_pTerrain || !m_bDrawInstances)
+	{
+		return;
+	}
+
+	PROFILE_SCOPE("Scatter Draw");
+
+	CCamera* pCamera = CCameraManager::Instance().GetCurrentCamera();
+	const CMatrix4Df& matViewProj = pCamera->GetViewProjMatrix();
+
+	m_uiVisibleInstances = m_Grid.CollectVisible(matViewProj, pCamera->GetPosition(), m_vVisible);
+	if (m_uiVisibleInstances == 0)
+	{
+		return;
+	}
+
+	m_pShader->Use();
+
+	for (size_t i = 0; i < m_vVisible.size(); i++)
+	{
+		const std::vector<CMatrix4Df>& vWorld = m_vVisible[i];
+		if (vWorld.empty() || !m_vMeshes[i])
+		{
+			continue;
+		}
+
+		m_vWVP.resize(vWorld.size());
+		MathBatch::PreMultiplyMatrices(matViewProj, vWorld.data(), m_vWVP.data(), vWorld.size());
+
+		m_vMeshes[i]->Render(static_cast<GLuint>(vWorld.size()), m_vWVP.data(), vWorld.data());
+	}
+}
+
+void CTerrainScatter::SetGUI()
+{
+	ImGui::Begin("Scatter");
+
+	ImGui::Checkbox("Draw instances", &m_bDrawInstances);
+	ImGui::Text("Cells: %d x %d, visible %zu", m_Grid.GetCellsX(), m_Grid.GetCellsZ(), m_Grid.GetVisibleCellsCount());
+	ImGui::Text("Instances: %zu, visible %zu", m_Grid.GetInstancesCount(), m_uiVisibleInstances);
+	ImGui::Text("Last rebuild: %zu cells", m_uiLastRebuiltCells);
+
+	bool bChanged = false;
+	for (size_t i = 0; i < m_Grid.GetLayersCount(); i++)
+	{
+		TScatterLayer& layer = m_Grid.GetLayer(i);
+
+		ImGui::PushID(static_cast<int>(i));
+		if (ImGui::CollapsingHeader(layer.stName.c_str()))
+		{
+			bChanged |= ImGui::SliderFloat("Min distance", &layer.fMinDistance, 0.5f, 50.0f);
+			bChanged |= ImGui::SliderFloat("Density", &layer.fDensity, 0.0f, 1.0f);
+			bChanged |= ImGui::DragFloatRange2("Height", &layer.fHeightMin, &layer.fHeightMax, 1.0f, -1000.0f, 5000.0f);
+			bChanged |= ImGui::DragFloatRange2("Slope", &layer.fSlopeMin, &layer.fSlopeMax, 0.5f, 0.0f, 90.0f);
+			bChanged |= ImGui::InputInt("Splat texture", &layer.iSplatTexture);
+			bChanged |= ImGui::SliderFloat("Splat min weight", &layer.fSplatMinWeight, 0.0f, 1.0f);
+			bChanged |= ImGui::DragFloatRange2("Scale", &layer.fScaleMin, &layer.fScaleMax, 0.01f, 0.01f, 10.0f);
+
+			// Culling only, no rebuild
+			ImGui::SliderFloat("Draw distance", &layer.fDrawDistance, 10.0f, 5000.0f);
+		}
+		ImGui::PopID();
+	}
+
+	if (bChanged)
+	{
+		m_Grid.InvalidateAll();
+	}
+
+	ImGui::End();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <memory>
+#include "../../LibGL/source/shader.h"
+#include "object.h"
+#include "scatter_grid.h"
+
+class CBaseTerrain;
+class CMesh;
+
+/*
+ * Draws the scatter layers of CScatterGrid, one instanced CMesh per layer
+ *
+ * Update takes the terrain edits of the frame and rebuilds only the cells they touched.
+ * Render culls the cells against the current camera and hands every layer's visible instances
+ * to CMesh::Render(uiNumInstances, matWVP, matWorld) in a single call.
+ */
+class CTerrainScatter : public CObject
+{
+public:
+	CTerrainScatter();
+	~CTerrainScatter();
+
+	// Seeded per terrain, the same seed always places the same instances
+	void Create(CBaseTerrain* pTerrain, uint64_t ulSeed);
+
+	// The mesh isn't owned and has to outlive the scatter
+	size_t AddLayer(const TScatterLayer& layer, CMesh* pMesh);
+
+	CScatterGrid& GetGrid();
+
+	virtual void Render();
+	virtual void SetGUI();
+	virtual void Update();
+
+private:
+	CBaseTerrain* m_pTerrain;
+	CScatterGrid m_Grid;
+	std::vector<CMesh*> m_vMeshes;
+	std::unique_ptr<CShader> m_pShader;
+
+	// Reused between frames
+	std::vector<std::vector<CMatrix4Df>> m_vVisible;
+	std::vector<CMatrix4Df> m_vWVP;
+
+	bool m_bDrawInstances;
+	size_t m_uiVisibleInstances;
+	size_t m_uiLastRebuiltCells;
+};
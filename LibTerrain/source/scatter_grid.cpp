@@ -0,0 +1,539 @@
+#include "stdafx.h"
+#include "scatter_grid.h"
+#include "terrain.h"
+#include <thread>
+#include <atomic>
+#include <cfloat>
+
+#if defined(_WIN64)
+#undef max
+#undef min
+#undef minmax
+#endif
+
+namespace
+{
+	constexpr GLfloat SCATTER_PI = 3.14159265f;
+	constexpr GLfloat SCATTER_RAD_TO_DEG = 180.0f / SCATTER_PI;
+
+	// Keeps the Poisson lookup grid of one cell below 512 x 512 entries
+	constexpr GLfloat SCATTER_MIN_RADIUS_FRACTION = 1.0f / 362.0f;
+
+	// Offsets of the stateless draws of an instance, CRandom::FloatAt(seed, cell, point, layer * 4 + draw)
+	enum EScatterDraw
+	{
+		SCATTER_DRAW_CHANCE,
+		SCATTER_DRAW_YAW,
+		SCATTER_DRAW_SCALE,
+		SCATTER_DRAW_COUNT = 4
+	};
+}
+
+CScatterGrid::CScatterGrid()
+{
+	m_pTerrain = nullptr;
+	m_pGrid = nullptr;
+	m_ulSeed = 0;
+	m_iCellsX = 0;
+	m_iCellsZ = 0;
+	m_iCellVertices = 1;
+	m_fCellSize = 1.0f;
+	m_fWorldScale = 1.0f;
+	m_uiVisibleCells = 0;
+}
+
+CScatterGrid::~CScatterGrid()
+{
+	Destroy();
+}
+
+void CScatterGrid::Create(CBaseTerrain* pTerrain, uint64_t ulSeed)
+{
+	Destroy();
+
+	m_pTerrain = pTerrain;
+	m_pGrid = pTerrain->GetGeoMipGrid();
+	m_ulSeed = ulSeed;
+	m_iCellsX = m_pGrid->GetNumPatchesX();
+	m_iCellsZ = m_pGrid->GetNumPatchesZ();
+	m_iCellVertices = m_pGrid->GetPatchSize() - 1;
+	m_fWorldScale = pTerrain->GetWorldScale();
+	m_fCellSize = static_cast<GLfloat>(m_iCellVertices) * m_fWorldScale;
+
+	m_vCells.resize(static_cast<size_t>(m_iCellsX) * m_iCellsZ);
+	for (auto& cell : m_vCells)
+	{
+		cell.fMinY = FLT_MAX;
+		cell.fMaxY = -FLT_MAX;
+	}
+	InvalidateAll();
+}
+
+void CScatterGrid::Destroy()
+{
+	m_vCells.clear();
+	m_pTerrain = nullptr;
+	m_pGrid = nullptr;
+	m_iCellsX = 0;
+	m_iCellsZ = 0;
+	m_uiVisibleCells = 0;
+}
+
+size_t CScatterGrid::AddLayer(const TScatterLayer& layer)
+{
+	m_vLayers.push_back(layer);
+	InvalidateAll();
+
+	return (m_vLayers.size() - 1);
+}
+
+TScatterLayer& CScatterGrid::GetLayer(size_t iIndex)
+{
+	return (m_vLayers[iIndex]);
+}
+
+size_t CScatterGrid::GetLayersCount() const
+{
+	return (m_vLayers.size());
+}
+
+void CScatterGrid::Invalidate(const TGridRegion& region)
+{
+	if (region.IsEmpty() || m_vCells.empty())
+	{
+		return;
+	}
+
+	// Slopes come from the vertex normals, which also change one vertex around the edit. A vertex
+	// on a cell border belongs to both cells
+	const GLint iCellX0 = std::clamp((region.iMinX - 2) / m_iCellVertices, 0, m_iCellsX - 1);
+	const GLint iCellZ0 = std::clamp((region.iMinZ - 2) / m_iCellVertices, 0, m_iCellsZ - 1);
+	const GLint iCellX1 = std::clamp((region.iMaxX + 1) / m_iCellVertices, 0, m_iCellsX - 1);
+	const GLint iCellZ1 = std::clamp((region.iMaxZ + 1) / m_iCellVertices, 0, m_iCellsZ - 1);
+
+	for (GLint z = iCellZ0; z <= iCellZ1; z++)
+	{
+		for (GLint x = iCellX0; x <= iCellX1; x++)
+		{
+			m_vCells[z * m_iCellsX + x].bDirty = true;
+		}
+	}
+}
+
+void CScatterGrid::InvalidateAll()
+{
+	for (auto& cell : m_vCells)
+	{
+		cell.bDirty = true;
+	}
+}
+
+bool CScatterGrid::IsLayoutStale() const
+{
+	return (m_pGrid && (m_pGrid->GetNumPatchesX() != m_iCellsX || m_pGrid->GetNumPatchesZ() != m_iCellsZ ||
+		m_pGrid->GetPatchSize() - 1 != m_iCellVertices || m_pTerrain->GetWorldScale() != m_fWorldScale));
+}
+
+size_t CScatterGrid::Generate()
+{
+	if (!m_pGrid)
+	{
+		return (0);
+	}
+
+	// LoadWorld or a new terrain re-initialized the grid under us, the layers and the seed are kept
+	if (IsLayoutStale())
+	{
+		Create(m_pTerrain, m_ulSeed);
+	}
+
+	std::vector<GLint> vJobs;
+	for (GLint i = 0; i < static_cast<GLint>(m_vCells.size()); i++)
+	{
+		if (m_vCells[i].bDirty)
+		{
+			vJobs.push_back(i);
+		}
+	}
+
+	if (vJobs.empty())
+	{
+		return (0);
+	}
+
+	// Cells only write to themselves and only read the terrain
+	const GLint iNumJobs = static_cast<GLint>(vJobs.size());
+	const GLint iNumThreads = std::min(static_cast<GLint>(std::max(std::thread::hardware_concurrency(), 1u)), iNumJobs);
+
+	if (iNumThreads <= 1)
+	{
+		std::vector<SVector2Df> vPoints;
+		std::vector<GLint> vLookup, vActive;
+		for (GLint iCell : vJobs)
+		{
+			GenerateCell(iCell, vPoints, vLookup, vActive);
+		}
+		return (vJobs.size());
+	}
+
+	std::atomic<GLint> iNextJob(0);
+	std::vector<std::thread> vWorkers;
+	vWorkers.reserve(iNumThreads);
+
+	for (GLint t = 0; t < iNumThreads; t++)
+	{
+		vWorkers.emplace_back([&]()
+			{
+				std::vector<SVector2Df> vPoints;
+				std::vector<GLint> vLookup, vActive;
+				for (GLint iJob = iNextJob++; iJob < iNumJobs; iJob = iNextJob++)
+				{
+					GenerateCell(vJobs[iJob], vPoints, vLookup, vActive);
+				}
+			});
+	}
+
+	for (auto& worker : vWorkers)
+	{
+		worker.join();
+	}
+
+	return (vJobs.size());
+}
+
+void CScatterGrid::GenerateCell(GLint iCell, std::vector<SVector2Df>& vPoints, std::vector<GLint>& vLookup, std::vector<GLint>& vActive)
+{
+	TScatterCell& cell = m_vCells[iCell];
+	cell.vInstances.resize(m_vLayers.size());
+	cell.fMinY = FLT_MAX;
+	cell.fMaxY = -FLT_MAX;
+	cell.bDirty = false;
+
+	const GLfloat fOriginX = static_cast<GLfloat>(iCell % m_iCellsX) * m_fCellSize;
+	const GLfloat fOriginZ = static_cast<GLfloat>(iCell / m_iCellsX) * m_fCellSize;
+
+	for (GLint iLayer = 0; iLayer < static_cast<GLint>(m_vLayers.size()); iLayer++)
+	{
+		const TScatterLayer& layer = m_vLayers[iLayer];
+		std::vector<CMatrix4Df>& vInstances = cell.vInstances[iLayer];
+		vInstances.clear();
+
+		if (layer.fMinDistance <= 0.0f || layer.fDensity <= 0.0f)
+		{
+			continue;
+		}
+
+		SamplePoissonDisk(iCell, iLayer, layer.fMinDistance, vPoints, vLookup, vActive);
+
+		const uint32_t uiDrawBase = static_cast<uint32_t>(iLayer) * SCATTER_DRAW_COUNT;
+
+		for (GLint iPoint = 0; iPoint < static_cast<GLint>(vPoints.size()); iPoint++)
+		{
+			const GLfloat fWorldX = fOriginX + vPoints[iPoint].x;
+			const GLfloat fWorldZ = fOriginZ + vPoints[iPoint].y;
+
+			GLfloat fHeight, fSlope;
+			SampleTerrain(fWorldX, fWorldZ, fHeight, fSlope);
+
+			if (fHeight < layer.fHeightMin || fHeight > layer.fHeightMax || fSlope < layer.fSlopeMin || fSlope > layer.fSlopeMax)
+			{
+				continue;
+			}
+
+			GLfloat fChance = layer.fDensity;
+			if (layer.iSplatTexture >= 0)
+			{
+				const GLfloat fWeight = m_pGrid->GetSplatWeight(fWorldX, fWorldZ, layer.iSplatTexture);
+				if (fWeight < layer.fSplatMinWeight)
+				{
+					continue;
+				}
+				fChance *= fWeight;
+			}
+
+			if (CRandom::FloatAt(m_ulSeed, static_cast<uint32_t>(iCell), static_cast<uint32_t>(iPoint), uiDrawBase + SCATTER_DRAW_CHANCE) >= fChance)
+			{
+				continue;
+			}
+
+			const GLfloat fYaw = CRandom::FloatAt(m_ulSeed, static_cast<uint32_t>(iCell), static_cast<uint32_t>(iPoint), uiDrawBase + SCATTER_DRAW_YAW) * 2.0f * SCATTER_PI;
+			const GLfloat fScale = layer.fScaleMin + (layer.fScaleMax - layer.fScaleMin) * CRandom::FloatAt(m_ulSeed, static_cast<uint32_t>(iCell), static_cast<uint32_t>(iPoint), uiDrawBase + SCATTER_DRAW_SCALE);
+			const GLfloat fCos = std::cos(fYaw) * fScale;
+			const GLfloat fSin = std::sin(fYaw) * fScale;
+
+			// Translation * RotationY * Scale, written out
+			CMatrix4Df& matWorld = vInstances.emplace_back();
+			matWorld.mat4[0][0] = fCos;	matWorld.mat4[0][1] = 0.0f;		matWorld.mat4[0][2] = fSin;	matWorld.mat4[0][3] = fWorldX;
+			matWorld.mat4[1][0] = 0.0f;	matWorld.mat4[1][1] = fScale;	matWorld.mat4[1][2] = 0.0f;	matWorld.mat4[1][3] = fHeight;
+			matWorld.mat4[2][0] = -fSin;	matWorld.mat4[2][1] = 0.0f;		matWorld.mat4[2][2] = fCos;	matWorld.mat4[2][3] = fWorldZ;
+			matWorld.mat4[3][0] = 0.0f;	matWorld.mat4[3][1] = 0.0f;		matWorld.mat4[3][2] = 0.0f;	matWorld.mat4[3][3] = 1.0f;
+
+			cell.fMinY = std::min(cell.fMinY, fHeight);
+			cell.fMaxY = std::max(cell.fMaxY, fHeight + layer.fBoundsHeight * fScale);
+		}
+	}
+}
+
+void CScatterGrid::SamplePoissonDisk(GLint iCell, GLint iLayer, GLfloat fRadius, std::vector<SVector2Df>& vPoints, std::vector<GLint>& vLookup, std::vector<GLint>& vActive) const
+{
+	vPoints.clear();
+	vActive.clear();
+
+	fRadius = std::max(fRadius, m_fCellSize * SCATTER_MIN_RADIUS_FRACTION);
+
+	// Lookup cells of r / sqrt(2) hold at most one point, a candidate checks the 5 x 5 around it
+	const GLfloat fLookupSize = fRadius / std::sqrt(2.0f);
+	const GLint iLookupRes = std::max(static_cast<GLint>(std::ceil(m_fCellSize / fLookupSize)), 1);
+	vLookup.assign(static_cast<size_t>(iLookupRes) * iLookupRes, -1);
+
+	const GLfloat fRadiusSq = fRadius * fRadius;
+	CRandom random(m_ulSeed, (static_cast<uint64_t>(iLayer) << 32) | static_cast<uint32_t>(iCell));
+
+	auto AddPoint = [&](const SVector2Df& v2Point)
+		{
+			const GLint iX = std::min(static_cast<GLint>(v2Point.x / fLookupSize), iLookupRes - 1);
+			const GLint iZ = std::min(static_cast<GLint>(v2Point.y / fLookupSize), iLookupRes - 1);
+
+			vLookup[iZ * iLookupRes + iX] = static_cast<GLint>(vPoints.size());
+			vActive.push_back(static_cast<GLint>(vPoints.size()));
+			vPoints.push_back(v2Point);
+		};
+
+	auto IsFree = [&](const SVector2Df& v2Point)
+		{
+			const GLint iX = std::min(static_cast<GLint>(v2Point.x / fLookupSize), iLookupRes - 1);
+			const GLint iZ = std::min(static_cast<GLint>(v2Point.y / fLookupSize), iLookupRes - 1);
+
+			for (GLint z = std::max(iZ - 2, 0); z <= std::min(iZ + 2, iLookupRes - 1); z++)
+			{
+				for (GLint x = std::max(iX - 2, 0); x <= std::min(iX + 2, iLookupRes - 1); x++)
+				{
+					const GLint iOther = vLookup[z * iLookupRes + x];
+					if (iOther < 0)
+					{
+						continue;
+					}
+
+					const GLfloat fDx = vPoints[iOther].x - v2Point.x;
+					const GLfloat fDz = vPoints[iOther].y - v2Point.y;
+					if (fDx * fDx + fDz * fDz < fRadiusSq)
+					{
+						return (false);
+					}
+				}
+			}
+
+			return (true);
+		};
+
+	const GLfloat fFirstX = random.Range(0.0f, m_fCellSize);
+	const GLfloat fFirstZ = random.Range(0.0f, m_fCellSize);
+	AddPoint(SVector2Df(fFirstX, fFirstZ));
+
+	while (!vActive.empty() && vPoints.size() < SCATTER_MAX_CELL_INSTANCES)
+	{
+		const GLint iActive = random.RangeInt(0, static_cast<GLint>(vActive.size()) - 1);
+		const SVector2Df v2Center = vPoints[vActive[iActive]];
+
+		bool bPlaced = false;
+		for (GLint iAttempt = 0; iAttempt < SCATTER_POISSON_ATTEMPTS; iAttempt++)
+		{
+			// Uniform over the annulus [r, 2r]
+			const GLfloat fAngle = random.NextFloat() * 2.0f * SCATTER_PI;
+			const GLfloat fDistance = fRadius * std::sqrt(1.0f + 3.0f * random.NextFloat());
+			const SVector2Df v2Candidate(v2Center.x + std::cos(fAngle) * fDistance, v2Center.y + std::sin(fAngle) * fDistance);
+
+			if (v2Candidate.x < 0.0f || v2Candidate.y < 0.0f || v2Candidate.x >= m_fCellSize || v2Candidate.y >= m_fCellSize)
+			{
+				continue;
+			}
+
+			if (IsFree(v2Candidate))
+			{
+				AddPoint(v2Candidate);
+				bPlaced = true;
+				break;
+			}
+		}
+
+		if (!bPlaced)
+		{
+			vActive[iActive] = vActive.back();
+			vActive.pop_back();
+		}
+	}
+}
+
+void CScatterGrid::SampleTerrain(GLfloat fWorldX, GLfloat fWorldZ, GLfloat& fHeight, GLfloat& fSlope) const
+{
+	const std::vector<CGeoMipGrid::TVertex>& vVertices = m_pGrid->GetVertices();
+	const GLint iWidth = m_pGrid->GetWidth();
+	const GLint iDepth = m_pGrid->GetDepth();
+
+	// Bilinear over the vertex quad, the same surface the terrain draws at its finest LOD
+	const GLfloat fGridX = std::clamp(fWorldX / m_fWorldScale, 0.0f, static_cast<GLfloat>(iWidth - 1));
+	const GLfloat fGridZ = std::clamp(fWorldZ / m_fWorldScale, 0.0f, static_cast<GLfloat>(iDepth - 1));
+	const GLint iX0 = std::min(static_cast<GLint>(fGridX), iWidth - 2);
+	const GLint iZ0 = std::min(static_cast<GLint>(fGridZ), iDepth - 2);
+	const GLfloat fTx = fGridX - static_cast<GLfloat>(iX0);
+	const GLfloat fTz = fGridZ - static_cast<GLfloat>(iZ0);
+
+	const CGeoMipGrid::TVertex& v00 = vVertices[iZ0 * iWidth + iX0];
+	const CGeoMipGrid::TVertex& v10 = vVertices[iZ0 * iWidth + iX0 + 1];
+	const CGeoMipGrid::TVertex& v01 = vVertices[(iZ0 + 1) * iWidth + iX0];
+	const CGeoMipGrid::TVertex& v11 = vVertices[(iZ0 + 1) * iWidth + iX0 + 1];
+
+	const GLfloat fW00 = (1.0f - fTx) * (1.0f - fTz);
+	const GLfloat fW10 = fTx * (1.0f - fTz);
+	const GLfloat fW01 = (1.0f - fTx) * fTz;
+	const GLfloat fW11 = fTx * fTz;
+
+	fHeight = v00.m_v3Pos.y * fW00 + v10.m_v3Pos.y * fW10 + v01.m_v3Pos.y * fW01 + v11.m_v3Pos.y * fW11;
+
+	const GLfloat fNx = v00.m_v3Normals.x * fW00 + v10.m_v3Normals.x * fW10 + v01.m_v3Normals.x * fW01 + v11.m_v3Normals.x * fW11;
+	const GLfloat fNy = v00.m_v3Normals.y * fW00 + v10.m_v3Normals.y * fW10 + v01.m_v3Normals.y * fW01 + v11.m_v3Normals.y * fW11;
+	const GLfloat fNz = v00.m_v3Normals.z * fW00 + v10.m_v3Normals.z * fW10 + v01.m_v3Normals.z * fW01 + v11.m_v3Normals.z * fW11;
+
+	fSlope = std::atan2(std::sqrt(fNx * fNx + fNz * fNz), fNy) * SCATTER_RAD_TO_DEG;
+}
+
+size_t CScatterGrid::CollectVisible(const CMatrix4Df& matViewProj, const SVector3Df& v3CameraPos, std::vector<std::vector<CMatrix4Df>>& vVisible)
+{
+	vVisible.resize(m_vLayers.size());
+	for (auto& vLayer : vVisible)
+	{
+		vLayer.clear();
+	}
+
+	m_uiVisibleCells = 0;
+
+	GLfloat fMaxDrawDistance = 0.0f;
+	for (const auto& layer : m_vLayers)
+	{
+		fMaxDrawDistance = std::max(fMaxDrawDistance, layer.fDrawDistance);
+	}
+
+	const SFrustumCulling sFC(matViewProj);
+
+	for (GLint iCell = 0; iCell < static_cast<GLint>(m_vCells.size()); iCell++)
+	{
+		const TScatterCell& cell = m_vCells[iCell];
+
+		// Empty, or never generated
+		if (cell.fMinY > cell.fMaxY)
+		{
+			continue;
+		}
+
+		const GLfloat fCellDistance = GetCellDistance(iCell, v3CameraPos);
+		if (fCellDistance > fMaxDrawDistance || !IsCellVisible(iCell, sFC, v3CameraPos))
+		{
+			continue;
+		}
+
+		m_uiVisibleCells++;
+
+		for (size_t iLayer = 0; iLayer < m_vLayers.size(); iLayer++)
+		{
+			const GLfloat fDrawDistance = m_vLayers[iLayer].fDrawDistance;
+			if (fCellDistance > fDrawDistance || iLayer >= cell.vInstances.size())
+			{
+				continue;
+			}
+
+			const GLfloat fDrawDistanceSq = fDrawDistance * fDrawDistance;
+			std::vector<CMatrix4Df>& vOut = vVisible[iLayer];
+
+			for (const CMatrix4Df& matWorld : cell.vInstances[iLayer])
+			{
+				const GLfloat fDx = matWorld.mat4[0][3] - v3CameraPos.x;
+				const GLfloat fDy = matWorld.mat4[1][3] - v3CameraPos.y;
+				const GLfloat fDz = matWorld.mat4[2][3] - v3CameraPos.z;
+
+				if (fDx * fDx + fDy * fDy + fDz * fDz <= fDrawDistanceSq)
+				{
+					vOut.push_back(matWorld);
+				}
+			}
+		}
+	}
+
+	size_t uiCount = 0;
+	for (const auto& vLayer : vVisible)
+	{
+		uiCount += vLayer.size();
+	}
+
+	return (uiCount);
+}
+
+GLfloat CScatterGrid::GetCellDistance(GLint iCell, const SVector3Df& v3CameraPos) const
+{
+	const GLfloat fX0 = static_cast<GLfloat>(iCell % m_iCellsX) * m_fCellSize;
+	const GLfloat fZ0 = static_cast<GLfloat>(iCell / m_iCellsX) * m_fCellSize;
+
+	// Distance on the ground plane to the closest point of the cell, 0 inside it
+	const GLfloat fDx = std::max(std::max(fX0 - v3CameraPos.x, v3CameraPos.x - (fX0 + m_fCellSize)), 0.0f);
+	const GLfloat fDz = std::max(std::max(fZ0 - v3CameraPos.z, v3CameraPos.z - (fZ0 + m_fCellSize)), 0.0f);
+
+	return (std::sqrt(fDx * fDx + fDz * fDz));
+}
+
+bool CScatterGrid::IsCellVisible(GLint iCell, const SFrustumCulling& sFrustumCulling, const SVector3Df& v3CameraPos) const
+{
+	const TScatterCell& cell = m_vCells[iCell];
+	const GLfloat fX0 = static_cast<GLfloat>(iCell % m_iCellsX) * m_fCellSize;
+	const GLfloat fZ0 = static_cast<GLfloat>(iCell / m_iCellsX) * m_fCellSize;
+	const GLfloat fX1 = fX0 + m_fCellSize;
+	const GLfloat fZ1 = fZ0 + m_fCellSize;
+
+	// The corner test below misses the cell under the camera when the view looks past its corners
+	if (v3CameraPos.x >= fX0 && v3CameraPos.x <= fX1 && v3CameraPos.z >= fZ0 && v3CameraPos.z <= fZ1)
+	{
+		return (true);
+	}
+
+	// Same test as the terrain patches, with the bounds of the instances
+	return (sFrustumCulling.IsPointInsideViewFrustum(SVector3Df(fX0, cell.fMinY, fZ0)) ||
+		sFrustumCulling.IsPointInsideViewFrustum(SVector3Df(fX0, cell.fMinY, fZ1)) ||
+		sFrustumCulling.IsPointInsideViewFrustum(SVector3Df(fX1, cell.fMinY, fZ0)) ||
+		sFrustumCulling.IsPointInsideViewFrustum(SVector3Df(fX1, cell.fMinY, fZ1)) ||
+		sFrustumCulling.IsPointInsideViewFrustum(SVector3Df(fX0, cell.fMaxY, fZ0)) ||
+		sFrustumCulling.IsPointInsideViewFrustum(SVector3Df(fX0, cell.fMaxY, fZ1)) ||
+		sFrustumCulling.IsPointInsideViewFrustum(SVector3Df(fX1, cell.fMaxY, fZ0)) ||
+		sFrustumCulling.IsPointInsideViewFrustum(SVector3Df(fX1, cell.fMaxY, fZ1)));
+}
+
+GLint CScatterGrid::GetCellsX() const
+{
+	return (m_iCellsX);
+}
+
+GLint CScatterGrid::GetCellsZ() const
+{
+	return (m_iCellsZ);
+}
+
+const TScatterCell& CScatterGrid::GetCell(GLint iCell) const
+{
+	return (m_vCells[iCell]);
+}
+
+size_t CScatterGrid::GetInstancesCount() const
+{
+	size_t uiCount = 0;
+	for (const auto& cell : m_vCells)
+	{
+		for (const auto& vInstances : cell.vInstances)
+		{
+			uiCount += vInstances.size();
+		}
+	}
+
+	return (uiCount);
+}
+
+size_t CScatterGrid::GetVisibleCellsCount() const
+{
+	return (m_uiVisibleCells);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <string>
+#include "geomip_grid.h"
+
+#define SCATTER_MAX_CELL_INSTANCES 8192		// per cell and layer, the Poisson sampling stops there
+#define SCATTER_POISSON_ATTEMPTS 30			// candidates around an active point before it is retired
+
+/*
+ * Instanced props scattered over the terrain
+ *
+ * Instances are binned into cells that match the terrain patches. A layer fills every cell with a
+ * Poisson-disk point set (Bridson) seeded from the cell and the layer, then keeps each point with
+ * the probability its rules give: a height band, a slope band (degrees) and optionally the weight
+ * of one splat texture. The point set never depends on the terrain and the per point draws are
+ * stateless (CRandom::FloatAt), so an edit only adds or removes the instances whose rules changed
+ * and regenerating a cell gives the same result as a full rebuild.
+ *
+ * Cells are sampled on their own, two instances on both sides of a cell border can be closer than
+ * fMinDistance. In exchange cells are independent jobs for the workers and for partial updates.
+ */
+typedef struct SScatterLayer
+{
+	std::string stName;
+
+	GLfloat fMinDistance;		// Poisson-disk radius, world units
+	GLfloat fDensity;			// [0, 1], scales the probability the rules give
+
+	GLfloat fHeightMin;
+	GLfloat fHeightMax;
+	GLfloat fSlopeMin;
+	GLfloat fSlopeMax;
+
+	GLint iSplatTexture;		// Texture set index, -1 ignores the splat maps
+	GLfloat fSplatMinWeight;	// Below it the texture counts as absent
+
+	GLfloat fScaleMin;
+	GLfloat fScaleMax;
+	GLfloat fBoundsHeight;		// Height of an instance at scale 1, extends the cell bounds for culling
+	GLfloat fDrawDistance;		// Farther instances are skipped
+} TScatterLayer;
+
+typedef struct SScatterCell
+{
+	std::vector<std::vector<CMatrix4Df>> vInstances;	// World matrices, one list per layer
+	GLfloat fMinY;
+	GLfloat fMaxY;
+	bool bDirty;
+} TScatterCell;
+
+class CScatterGrid
+{
+public:
+	CScatterGrid();
+	~CScatterGrid();
+
+	// One cell per terrain patch, every cell starts dirty. Generate re-creates the cells by itself
+	// when the terrain was re-initialized with another size, patch size or world scale
+	void Create(CBaseTerrain* pTerrain, uint64_t ulSeed);
+	void Destroy();
+
+	size_t AddLayer(const TScatterLayer& layer);
+	TScatterLayer& GetLayer(size_t iIndex);
+	size_t GetLayersCount() const;
+
+	// Region in vertex coordinates, as the terrain grid reports its edits
+	void Invalidate(const TGridRegion& region);
+	void InvalidateAll();
+
+	// Rebuilds the dirty cells on worker threads, returns how many were rebuilt
+	size_t Generate();
+	bool IsLayoutStale() const;
+
+	// Frustum and distance culling, vVisible[layer] receives the world matrices to draw.
+	// Returns the total instance count
+	size_t CollectVisible(const CMatrix4Df& matViewProj, const SVector3Df& v3CameraPos, std::vector<std::vector<CMatrix4Df>>& vVisible);
+
+	GLint GetCellsX() const;
+	GLint GetCellsZ() const;
+	const TScatterCell& GetCell(GLint iCell) const;
+	size_t GetInstancesCount() const;
+	size_t GetVisibleCellsCount() const;
+
+protected:
+	void GenerateCell(GLint iCell, std::vector<SVector2Df>& vPoints, std::vector<GLint>& vLookup, std::vector<GLint>& vActive);
+	void SamplePoissonDisk(GLint iCell, GLint iLayer, GLfloat fRadius, std::vector<SVector2Df>& vPoints, std::vector<GLint>& vLookup, std::vector<GLint>& vActive) const;
+	void SampleTerrain(GLfloat fWorldX, GLfloat fWorldZ, GLfloat& fHeight, GLfloat& fSlope) const;
+	GLfloat GetCellDistance(GLint iCell, const SVector3Df& v3CameraPos) const;
+	bool IsCellVisible(GLint iCell, const SFrustumCulling& sFrustumCulling, const SVector3Df& v3CameraPos) const;
+
+private:
+	CBaseTerrain* m_pTerrain;
+	CGeoMipGrid* m_pGrid;
+	uint64_t m_ulSeed;
+
+	GLint m_iCellsX;
+	GLint m_iCellsZ;
+	GLint m_iCellVertices;		// Patch size - 1
+	GLfloat m_fCellSize;		// World units
+	GLfloat m_fWorldScale;
+
+	std::vector<TScatterLayer> m_vLayers;
+	std::vector<TScatterCell> m_vCells;
+	size_t m_uiVisibleCells;
+};
@@ -0,0 +1,67 @@
+#include "stdafx.h"
+#include "scene_constants.h"
+
+GLuint CSceneConstants::ms_uiBuffer = 0;
+TSceneConstants CSceneConstants::ms_Constants{};
+
+bool CSceneConstants::Create()
+{
+	if (ms_uiBuffer)
+	{
+		return (true);
+	}
+
+	glCreateBuffers(1, &ms_uiBuffer);
+	if (!ms_uiBuffer)
+	{
+		sys_err("CSceneConstants::Create: Failed to create the uniform buffer");
+		return (false);
+	}
+
+	glNamedBufferStorage(ms_uiBuffer, sizeof(TSceneConstants), nullptr, GL_DYNAMIC_STORAGE_BIT);
+	CGLState::BindBufferBase(GL_UNIFORM_BUFFER, SCENE_CONSTANTS_BINDING, ms_uiBuffer);
+	return (true);
+}
+
+void CSceneConstants::Destroy()
+{
+	if (ms_uiBuffer)
+	{
+		CGLState::DeleteBuffers(1, &ms_uiBuffer);
+		ms_uiBuffer = 0;
+	}
+}
+
+void CSceneConstants::Update(const SSceneElements& rScene, const CCamera& rCamera, GLint iWidth, GLint iHeight, float fTime, float fDeltaTime)
+{
+	SVector3Df v3LightDir = rScene.v3LightDir;
+	v3LightDir.normalize();
+
+	// The camera keeps these cached, only the frames it moved rebuild them
+	ms_Constants.m4View = rCamera.GetMatrix();
+	ms_Constants.m4Proj = rCamera.GetProjectionMat();
+	ms_Constants.m4ViewProj = rCamera.GetViewProjMatrix();
+	ms_Constants.m4InvView = rCamera.GetViewMatrixInverse();
+	ms_Constants.m4InvProj = rCamera.GetProjectionMatInverse();
+	ms_Constants.m4InvViewProj = rCamera.GetViewProjMatrixInverse();
+	ms_Constants.v4CameraPos = SVector4Df(rCamera.GetPosition(), 1.0f);
+	ms_Constants.v4LightDir = SVector4Df(v3LightDir, 0.0f);
+	ms_Constants.v4LightColor = SVector4Df(rScene.v3LightColor, 1.0f);
+	ms_Constants.v4FogColor = SVector4Df(rScene.v3FogColor, 1.0f);
+	ms_Constants.v4Screen = SVector4Df(static_cast<float>(iWidth), static_cast<float>(iHeight), fTime, fDeltaTime);
+
+	glNamedBufferSubData(ms_uiBuffer, 0, sizeof(TSceneConstants), &ms_Constants);
+
+	// Elided unless something else used the binding point
+	CGLState::BindBufferBase(GL_UNIFORM_BUFFER, SCENE_CONSTANTS_BINDING, ms_uiBuffer);
+}
+
+const TSceneConstants& CSceneConstants::Get()
+{
+	return (ms_Constants);
+}
+
+GLuint CSceneConstants::GetBuffer()
+{
+	return (ms_uiBuffer);
+}
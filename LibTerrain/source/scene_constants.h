@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "object.h"
+#include "../../LibGL/source/shader_blocks.h"
+
+/*
+ * Owner of the SceneConstants uniform buffer
+ *
+ * Update is called once per frame, after the camera moved and before anything is drawn,
+ * and leaves the buffer bound at SCENE_CONSTANTS_BINDING for the whole frame.
+ *
+ * GL thread only.
+ */
+class CSceneConstants
+{
+public:
+	static bool Create();
+	static void Destroy();
+
+	static void Update(const SSceneElements& rScene, const CCamera& rCamera, GLint iWidth, GLint iHeight, float fTime, float fDeltaTime);
+
+	// CPU copy of what was uploaded last
+	static const TSceneConstants& Get();
+	static GLuint GetBuffer();
+
+private:
+	static GLuint ms_uiBuffer;
+	static TSceneConstants ms_Constants;
+};
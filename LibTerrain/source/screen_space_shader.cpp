@@ -40,19 +40,19 @@ void CScreenSpaceShader::Render()
 
 void CScreenSpaceShader::DrawQuad()
 {
-	glBindVertexArray(m_uiQuadVAO);
+	CGLState::BindVertexArray(m_uiQuadVAO);
 	glDrawArrays(GL_TRIANGLES, 0, 6);
-	glBindVertexArray(0);
+	CGLState::BindVertexArray(0);
 }
 
 void CScreenSpaceShader::EnableDepthTest()
 {
-	glEnable(GL_DEPTH_TEST);
+	CGLState::Enable(GL_DEPTH_TEST);
 }
 
 void CScreenSpaceShader::DisableDepthTest()
 {
-	glDisable(GL_DEPTH_TEST);
+	CGLState::Disable(GL_DEPTH_TEST);
 }
 
 void CScreenSpaceShader::InitializeQuad()
@@ -96,10 +96,10 @@ void CScreenSpaceShader::InitializeQuad()
 		{
 			// Create vertex array and buffer
 			glGenVertexArrays(1, &m_uiQuadVAO);
-			glBindVertexArray(m_uiQuadVAO);
+			CGLState::BindVertexArray(m_uiQuadVAO);
 
 			glGenBuffers(1, &m_uiQuadVBO);
-			glBindBuffer(GL_ARRAY_BUFFER, m_uiQuadVBO);
+			CGLState::BindBuffer(GL_ARRAY_BUFFER, m_uiQuadVBO);
 
 			// Upload vertex data to the buffer
 			glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
@@ -57,10 +57,10 @@ void CSimpleWater::Render(const SVector3Df& v3CameraPos, const CMatrix4Df& viewP
 	m_gDudvMapTex.Bind(DUDV_TEXTURE_UNIT);
 	m_gNormalMapTex.Bind(NORMAL_MAP_TEXTURE_UNIT);
 
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	CGLState::Enable(GL_BLEND);
+	CGLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	m_gWater.Render();
-	glDisable(GL_BLEND);
+	CGLState::Disable(GL_BLEND);
 }
 
 void CSimpleWater::StartReflectionPass()
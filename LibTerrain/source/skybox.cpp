@@ -36,6 +36,8 @@ CSkyBox::CSkyBox(CWindow* pWindow)
 
 void CSkyBox::Render()
 {
+	PROFILE_SCOPE("Skybox");
+
     SSceneElements* scene = CObject::pScene;
     if (!scene)
     {
@@ -45,25 +47,16 @@ void CSkyBox::Render()
 	m_pSkyBoxNew->BindForWriting();
 
 	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-	glDisable(GL_DEPTH_TEST);
-	glDisable(GL_CULL_FACE); // Ensure culling doesnt interfere
-	glDisable(GL_BLEND); // Disable blending to avoid transparency issues
+	CGLState::Disable(GL_DEPTH_TEST);
+	CGLState::Disable(GL_CULL_FACE); // Ensure culling doesnt interfere
+	CGLState::Disable(GL_BLEND); // Disable blending to avoid transparency issues
 
     // Set up shader
     m_pSkyboxScreenSpace->GetShader().Use();
-    m_pSkyboxScreenSpace->GetShader().setMat4("m4Inv_proj", scene->pCamera->GetProjectionMat().Inverse());
-    m_pSkyboxScreenSpace->GetShader().setMat4("m4Inv_view", scene->pCamera->GetViewMatrix().Inverse());
-    m_pSkyboxScreenSpace->GetShader().setVec2("v2Resolution", SVector2Df(static_cast<float>(m_pWindow->GetWidth()), static_cast<float>(m_pWindow->GetHeight())));
-
-	SVector3Df v3LightDir = (scene->v3LightPos - scene->pCamera->GetPosition());
-	v3LightDir.normalize();
-
-    m_pSkyboxScreenSpace->GetShader().setVec3("v3LightDir", v3LightDir);
+    // Inverse matrices, resolution, sun direction and time come from the SceneConstants block
     m_pSkyboxScreenSpace->GetShader().setVec3("v3SkyColorTop", m_v3SkyColorTop);
     m_pSkyboxScreenSpace->GetShader().setVec3("v3SkyColorBottom", m_v3SkyColorBottom);
 
-	float currentTime = static_cast<float>(glfwGetTime());
-	m_pSkyboxScreenSpace->GetShader().setFloat("fTime", currentTime);
 	m_pSkyboxScreenSpace->GetShader().setBool("bIsNight", m_bIsNight);
 	m_pSkyboxScreenSpace->GetShader().setFloat("fStarDensity", m_fStarDensity); // [0.5 - 3.0]
 	m_pSkyboxScreenSpace->GetShader().setFloat("fStarBrightness", m_fStarBrightness); // [0.1 - 2.0]
@@ -80,8 +73,8 @@ void CSkyBox::Render()
 	// Go back to default for further rendering
 	m_pSkyBoxNew->UnBindWriting();
 
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_BLEND); // Disable blending to avoid transparency issues
+	CGLState::Enable(GL_DEPTH_TEST);
+	CGLState::Enable(GL_BLEND); // Disable blending to avoid transparency issues
 }
 
 void CSkyBox::SetGUI()
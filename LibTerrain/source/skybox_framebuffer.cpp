@@ -4,7 +4,7 @@
 
 void BindFrameBuffer(GLuint frameBuffer, GLint width, GLint height)
 {
-	glBindTexture(GL_TEXTURE_2D, 0); //To make sure the texture isn't bound
+	CGLState::BindTexture(GL_TEXTURE_2D, 0); //To make sure the texture isn't bound
 	glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer);
 	glViewport(0, 0, width, height);
 }
@@ -36,7 +36,7 @@ GLuint CreateTextureAttachment(GLint width, GLint height)
 {
 	GLuint uiTexture;
 	glGenTextures(1, &uiTexture);
-	glBindTexture(GL_TEXTURE_2D, uiTexture);
+	CGLState::BindTexture(GL_TEXTURE_2D, uiTexture);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
 	glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -55,7 +55,7 @@ GLuint* CreateColorAttachments(GLint width, GLint height, GLuint nColorAttachmen
 
 	for (GLuint i = 0; i < nColorAttachments; i++)
 	{
-		glBindTexture(GL_TEXTURE_2D, pColorAttachments[i]);
+		CGLState::BindTexture(GL_TEXTURE_2D, pColorAttachments[i]);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
 		glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -71,7 +71,7 @@ GLuint CreateDepthTextureAttachment(GLint width, GLint height)
 {
 	GLuint uiTexture;
 	glGenTextures(1, &uiTexture);
-	glBindTexture(GL_TEXTURE_2D, uiTexture);
+	CGLState::BindTexture(GL_TEXTURE_2D, uiTexture);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
 	glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -0,0 +1,320 @@
+#include "stdafx.h"
+#include "splat_file.h"
+#include <cstring>
+
+namespace
+{
+	inline bool TexelEquals(const CGeoMipGrid::TSplatData& patch, size_t a, size_t b)
+	{
+		return (patch.indexData[a] == patch.indexData[b] && patch.weightData[a] == patch.weightData[b]);
+	}
+
+	inline void AppendBytes(std::vector<uint8_t>& vOut, const void* pData, size_t iSize)
+	{
+		const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+		vOut.insert(vOut.end(), pBytes, pBytes + iSize);
+	}
+
+	inline void AppendTexel(std::vector<uint8_t>& vOut, const CGeoMipGrid::TSplatData& patch, size_t iTexel)
+	{
+		TSplatTexel texel{ patch.indexData[iTexel], patch.weightData[iTexel] };
+		AppendBytes(vOut, &texel, sizeof(texel));
+	}
+
+	inline size_t AlignUp(size_t iValue)
+	{
+		return ((iValue + SPLAT_FILE_ALIGNMENT - 1) & ~(SPLAT_FILE_ALIGNMENT - 1));
+	}
+}
+
+CSplatFile::CSplatFile()
+{
+	m_pData = nullptr;
+	m_iSize = 0;
+	m_pHeader = nullptr;
+	m_pChunks = nullptr;
+}
+
+bool CSplatFile::IsUniform(const CGeoMipGrid::TSplatData& patch)
+{
+	for (size_t i = 1; i < patch.indexData.size(); i++)
+	{
+		if (!TexelEquals(patch, 0, i))
+		{
+			return (false);
+		}
+	}
+
+	return (true);
+}
+
+void CSplatFile::EncodeRLE(const CGeoMipGrid::TSplatData& patch, std::vector<uint8_t>& vOut)
+{
+	const size_t iCount = patch.indexData.size();
+	size_t i = 0;
+
+	while (i < iCount)
+	{
+		// Repeat packet for runs of at least 2 equal texels
+		size_t iRun = 1;
+		while (i + iRun < iCount && iRun < ~SPLAT_RLE_REPEAT && TexelEquals(patch, i, i + iRun))
+		{
+			iRun++;
+		}
+
+		if (iRun >= 2)
+		{
+			const uint32_t uiPacket = SPLAT_RLE_REPEAT | static_cast<uint32_t>(iRun);
+			AppendBytes(vOut, &uiPacket, sizeof(uiPacket));
+			AppendTexel(vOut, patch, i);
+			i += iRun;
+			continue;
+		}
+
+		// Literal packet until the next run starts
+		size_t iLiteral = 1;
+		while (i + iLiteral < iCount && iLiteral < ~SPLAT_RLE_REPEAT)
+		{
+			if (i + iLiteral + 1 < iCount && TexelEquals(patch, i + iLiteral, i + iLiteral + 1))
+			{
+				break;
+			}
+			iLiteral++;
+		}
+
+		const uint32_t uiPacket = static_cast<uint32_t>(iLiteral);
+		AppendBytes(vOut, &uiPacket, sizeof(uiPacket));
+		for (size_t j = 0; j < iLiteral; j++)
+		{
+			AppendTexel(vOut, patch, i + j);
+		}
+		i += iLiteral;
+	}
+}
+
+bool CSplatFile::DecodeRLE(const uint8_t* pPayload, size_t iSize, CGeoMipGrid::TSplatData& patch)
+{
+	const size_t iCount = patch.indexData.size();
+	size_t iTexel = 0;
+	size_t iPos = 0;
+
+	while (iPos + sizeof(uint32_t) <= iSize && iTexel < iCount)
+	{
+		uint32_t uiPacket = 0;
+		std::memcpy(&uiPacket, pPayload + iPos, sizeof(uiPacket));
+		iPos += sizeof(uiPacket);
+
+		const bool bRepeat = (uiPacket & SPLAT_RLE_REPEAT) != 0;
+		const size_t iRun = uiPacket & ~SPLAT_RLE_REPEAT;
+		const size_t iBytes = bRepeat ? sizeof(TSplatTexel) : sizeof(TSplatTexel) * iRun;
+
+		if (iRun == 0 || iTexel + iRun > iCount || iPos + iBytes > iSize)
+		{
+			return (false);
+		}
+
+		TSplatTexel texel{};
+		for (size_t j = 0; j < iRun; j++)
+		{
+			if (!bRepeat || j == 0)
+			{
+				std::memcpy(&texel, pPayload + iPos, sizeof(texel));
+				iPos += sizeof(texel);
+			}
+
+			patch.indexData[iTexel] = texel.index;
+			patch.weightData[iTexel] = texel.weight;
+			iTexel++;
+		}
+	}
+
+	return (iTexel == iCount);
+}
+
+void CSplatFile::Encode(const std::vector<CGeoMipGrid::TSplatData>& vPatches, GLint iResolution, GLint iNumPatchesX, GLint iNumPatchesZ, std::vector<uint8_t>& vOut)
+{
+	const size_t iNumPatches = vPatches.size();
+	const size_t iTexels = static_cast<size_t>(iResolution) * iResolution;
+	const size_t iRawSize = iTexels * (sizeof(glm::uvec4) + sizeof(glm::vec4));
+
+	TSplatFileHeader header{};
+	header.uiMagic = SPLAT_FILE_MAGIC;
+	header.uiVersion = SPLAT_FILE_VERSION;
+	header.uiResolution = static_cast<uint32_t>(iResolution);
+	header.uiNumPatchesX = static_cast<uint32_t>(iNumPatchesX);
+	header.uiNumPatchesZ = static_cast<uint32_t>(iNumPatchesZ);
+
+	std::vector<TSplatChunk> vChunks(iNumPatches);
+	std::vector<uint8_t> vPayload;
+	std::vector<uint8_t> vRLE;
+
+	const size_t iTableEnd = AlignUp(sizeof(TSplatFileHeader) + sizeof(TSplatChunk) * iNumPatches);
+
+	for (size_t i = 0; i < iNumPatches; i++)
+	{
+		const auto& patch = vPatches[i];
+		TSplatChunk& chunk = vChunks[i];
+
+		vPayload.resize(AlignUp(vPayload.size()), 0);
+		chunk.uiOffset = iTableEnd + vPayload.size();
+
+		if (!patch.IsMaterialized() || patch.indexData.size() != iTexels || patch.weightData.size() != iTexels || IsUniform(patch))
+		{
+			TSplatTexel texel{ patch.constantIndex, patch.constantWeight };
+			if (patch.IsMaterialized())
+			{
+				texel.index = patch.indexData[0];
+				texel.weight = patch.weightData[0];
+			}
+
+			chunk.uiEncoding = SPLAT_CHUNK_CONSTANT;
+			chunk.uiSize = sizeof(texel);
+			AppendBytes(vPayload, &texel, sizeof(texel));
+			continue;
+		}
+
+		vRLE.clear();
+		EncodeRLE(patch, vRLE);
+
+		// Only keep the RLE stream when it really pays off, RAW uploads straight from the file
+		if (vRLE.size() < iRawSize * 3 / 4)
+		{
+			chunk.uiEncoding = SPLAT_CHUNK_RLE;
+			chunk.uiSize = static_cast<uint32_t>(vRLE.size());
+			AppendBytes(vPayload, vRLE.data(), vRLE.size());
+		}
+		else
+		{
+			chunk.uiEncoding = SPLAT_CHUNK_RAW;
+			chunk.uiSize = static_cast<uint32_t>(iRawSize);
+			AppendBytes(vPayload, patch.indexData.data(), iTexels * sizeof(glm::uvec4));
+			AppendBytes(vPayload, patch.weightData.data(), iTexels * sizeof(glm::vec4));
+		}
+	}
+
+	vOut.clear();
+	vOut.reserve(iTableEnd + vPayload.size());
+	AppendBytes(vOut, &header, sizeof(header));
+	AppendBytes(vOut, vChunks.data(), vChunks.size() * sizeof(TSplatChunk));
+	vOut.resize(iTableEnd, 0);
+	AppendBytes(vOut, vPayload.data(), vPayload.size());
+}
+
+bool CSplatFile::Open(const uint8_t* pData, size_t iSize)
+{
+	m_pData = nullptr;
+	m_iSize = 0;
+	m_pHeader = nullptr;
+	m_pChunks = nullptr;
+
+	if (!pData || iSize < sizeof(TSplatFileHeader))
+	{
+		sys_err("CSplatFile::Open: Data is too small (%zu bytes)", iSize);
+		return (false);
+	}
+
+	const TSplatFileHeader* pHeader = reinterpret_cast<const TSplatFileHeader*>(pData);
+	if (pHeader->uiMagic != SPLAT_FILE_MAGIC || pHeader->uiVersion != SPLAT_FILE_VERSION)
+	{
+		sys_err("CSplatFile::Open: Bad magic or unsupported version (%u)", pHeader->uiVersion);
+		return (false);
+	}
+
+	const size_t iNumChunks = static_cast<size_t>(pHeader->uiNumPatchesX) * pHeader->uiNumPatchesZ;
+	if (sizeof(TSplatFileHeader) + iNumChunks * sizeof(TSplatChunk) > iSize)
+	{
+		sys_err("CSplatFile::Open: Chunk table is truncated");
+		return (false);
+	}
+
+	const TSplatChunk* pChunks = reinterpret_cast<const TSplatChunk*>(pData + sizeof(TSplatFileHeader));
+	for (size_t i = 0; i < iNumChunks; i++)
+	{
+		if (pChunks[i].uiOffset > iSize || pChunks[i].uiSize > iSize - pChunks[i].uiOffset)
+		{
+			sys_err("CSplatFile::Open: Chunk %zu is out of range", i);
+			return (false);
+		}
+	}
+
+	m_pData = pData;
+	m_iSize = iSize;
+	m_pHeader = pHeader;
+	m_pChunks = pChunks;
+	return (true);
+}
+
+const TSplatFileHeader& CSplatFile::GetHeader() const
+{
+	return (*m_pHeader);
+}
+
+GLint CSplatFile::GetChunksCount() const
+{
+	if (!m_pHeader)
+	{
+		return (0);
+	}
+
+	return (static_cast<GLint>(m_pHeader->uiNumPatchesX * m_pHeader->uiNumPatchesZ));
+}
+
+const TSplatChunk& CSplatFile::GetChunk(GLint iIndex) const
+{
+	return (m_pChunks[iIndex]);
+}
+
+const uint8_t* CSplatFile::GetPayload(GLint iIndex) const
+{
+	return (m_pData + m_pChunks[iIndex].uiOffset);
+}
+
+bool CSplatFile::DecodeChunk(GLint iIndex, CGeoMipGrid::TSplatData& patch) const
+{
+	const size_t iTexels = static_cast<size_t>(m_pHeader->uiResolution) * m_pHeader->uiResolution;
+	const TSplatChunk& chunk = GetChunk(iIndex);
+	const uint8_t* pPayload = GetPayload(iIndex);
+
+	if (chunk.uiEncoding == SPLAT_CHUNK_CONSTANT)
+	{
+		if (chunk.uiSize < sizeof(TSplatTexel))
+		{
+			return (false);
+		}
+
+		// Uniform patches stay unmaterialized
+		TSplatTexel texel{};
+		std::memcpy(&texel, pPayload, sizeof(texel));
+		std::vector<glm::uvec4>().swap(patch.indexData);
+		std::vector<glm::vec4>().swap(patch.weightData);
+		patch.constantIndex = texel.index;
+		patch.constantWeight = texel.weight;
+		return (true);
+	}
+
+	patch.indexData.resize(iTexels);
+	patch.weightData.resize(iTexels);
+
+	switch (chunk.uiEncoding)
+	{
+
+	case SPLAT_CHUNK_RAW:
+	{
+		if (chunk.uiSize != iTexels * (sizeof(glm::uvec4) + sizeof(glm::vec4)))
+		{
+			return (false);
+		}
+
+		std::memcpy(patch.indexData.data(), pPayload, iTexels * sizeof(glm::uvec4));
+		std::memcpy(patch.weightData.data(), pPayload + iTexels * sizeof(glm::uvec4), iTexels * sizeof(glm::vec4));
+		return (true);
+	}
+
+	case SPLAT_CHUNK_RLE:
+		return (DecodeRLE(pPayload, chunk.uiSize, patch));
+
+	default:
+		sys_err("CSplatFile::DecodeChunk: Unknown chunk encoding %u", chunk.uiEncoding);
+		return (false);
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <cstdint>
+#include "geomip_grid.h"
+
+/*
+ * Binary splat map format
+ *
+ * [TSplatFileHeader][TSplatChunk x patches][payloads, each aligned to SPLAT_FILE_ALIGNMENT]
+ *
+ * A chunk holds one patch, stored as
+ *  - CONSTANT: a single texel, for patches that were never painted or are uniform again (loaded unmaterialized)
+ *  - RLE:      repeat/literal packets of texels, for partially painted patches
+ *  - RAW:      the index map followed by the weight map, laid out as the GPU textures
+ *
+ * Offsets are relative to the start of the blob, so the same data can be embedded in a bigger file.
+ */
+enum ESplatChunkEncoding : uint32_t
+{
+	SPLAT_CHUNK_CONSTANT,
+	SPLAT_CHUNK_RAW,
+	SPLAT_CHUNK_RLE,
+};
+
+constexpr uint32_t SPLAT_FILE_MAGIC = 0x544C5053; // "SPLT"
+constexpr uint32_t SPLAT_FILE_VERSION = 1;
+constexpr size_t SPLAT_FILE_ALIGNMENT = 16;
+constexpr uint32_t SPLAT_RLE_REPEAT = 0x80000000;
+
+#pragma pack(push, 1)
+typedef struct SSplatFileHeader
+{
+	uint32_t uiMagic;
+	uint32_t uiVersion;
+	uint32_t uiResolution;
+	uint32_t uiNumPatchesX;
+	uint32_t uiNumPatchesZ;
+	uint32_t uiReserved[3];
+} TSplatFileHeader;
+
+typedef struct SSplatChunk
+{
+	uint32_t uiEncoding;
+	uint32_t uiSize;
+	uint64_t uiOffset;
+} TSplatChunk;
+
+typedef struct SSplatTexel
+{
+	glm::uvec4 index;
+	glm::vec4 weight;
+} TSplatTexel;
+#pragma pack(pop)
+
+class CSplatFile
+{
+public:
+	CSplatFile();
+
+	static void Encode(const std::vector<CGeoMipGrid::TSplatData>& vPatches, GLint iResolution, GLint iNumPatchesX, GLint iNumPatchesZ, std::vector<uint8_t>& vOut);
+
+	// Validates the header and chunk table, pData must outlive this object
+	bool Open(const uint8_t* pData, size_t iSize);
+
+	const TSplatFileHeader& GetHeader() const;
+	GLint GetChunksCount() const;
+	const TSplatChunk& GetChunk(GLint iIndex) const;
+	const uint8_t* GetPayload(GLint iIndex) const;
+
+	bool DecodeChunk(GLint iIndex, CGeoMipGrid::TSplatData& patch) const;
+
+protected:
+	static bool IsUniform(const CGeoMipGrid::TSplatData& patch);
+	static void EncodeRLE(const CGeoMipGrid::TSplatData& patch, std::vector<uint8_t>& vOut);
+	static bool DecodeRLE(const uint8_t* pPayload, size_t iSize, CGeoMipGrid::TSplatData& patch);
+
+private:
+	const uint8_t* m_pData;
+	size_t m_iSize;
+	const TSplatFileHeader* m_pHeader;
+	const TSplatChunk* m_pChunks;
+};
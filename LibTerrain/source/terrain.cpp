@@ -1,17 +1,22 @@
 #include "stdafx.h"
 #include "terrain.h"
+#include "terrain_file.h"
 #include "../../LibImageUI/imgui.h"
 #include "../../LibImageUI/ImGuiFileDialog.h"
 #include "../../LibImageUI/ImGuiFileDialogConfig.h"
+#include <cstring>
 
 CTerrainTextureSet* CBaseTerrain::ms_pTerrainTextureSet = nullptr;
 
-CBaseTerrain::CBaseTerrain()
+CBaseTerrain::CBaseTerrain(bool bHeadless)
 {
+	m_bHeadless = bHeadless;
+
 	m_pMapGrid = new CGrid<float>();
 	m_pGeoMapGrid = new CGeoMipGrid();
-	m_pTerrainShader = new CShader("TerrainShader");
+	m_pTerrainShader = bHeadless ? nullptr : new CShader("TerrainShader");
 	m_pWorldTranslation = new CWorldTranslation();
+	m_pWorldFile = new CTerrainWorldFile();
 
 	m_iTerrainSize = 32;
 	m_iPatchSize = 1;
@@ -21,8 +26,12 @@ CBaseTerrain::CBaseTerrain()
 	m_v3LightDir = SVector3Df(0.0f, 1.0f, 1.0f);
 
 	m_iSelectedBtnIdx = 0;
+	m_uiTerrainHandlesSSBO = 0;
 
-	InitializeShaders();
+	if (!m_bHeadless)
+	{
+		InitializeShaders();
+	}
 }
 
 CBaseTerrain::~CBaseTerrain()
@@ -31,10 +40,11 @@ CBaseTerrain::~CBaseTerrain()
 	safe_delete(m_pGeoMapGrid);
 	safe_delete(m_pTerrainShader);
 	safe_delete(m_pWorldTranslation);
+	safe_delete(m_pWorldFile);
 
 	if (m_uiTerrainHandlesSSBO)
 	{
-		glDeleteBuffers(1, &m_uiTerrainHandlesSSBO);
+		CGLState::DeleteBuffers(1, &m_uiTerrainHandlesSSBO);
 	}
 }
 
@@ -51,6 +61,11 @@ void CBaseTerrain::InitializeTerrain(GLint iTerrainSize, GLint iPatchSize, GLflo
 	m_pGeoMapGrid->CreateGeoMipGrid(m_iTerrainSize, m_iTerrainSize, m_iPatchSize, this);
 }
 
+bool CBaseTerrain::IsHeadless() const
+{
+	return (m_bHeadless);
+}
+
 void CBaseTerrain::InitializeShaders()
 {
 	m_pTerrainShader->AttachShader("shaders/terrain/terrain.vert");
@@ -135,64 +150,71 @@ void CBaseTerrain::UpdateVertexBuffer()
 	GetGeoMipGrid()->UpdateVertexBuffer();
 }
 
+void CBaseTerrain::SetHeights(const GLfloat* pHeights, bool bUpdatePatchMetrics)
+{
+	if (pHeights != m_pMapGrid->GetBaseAddr())
+	{
+		std::memcpy(m_pMapGrid->GetBaseAddr(), pHeights, static_cast<size_t>(m_iTerrainSize) * m_iTerrainSize * sizeof(GLfloat));
+	}
+
+	m_pGeoMapGrid->SetHeights(pHeights, bUpdatePatchMetrics);
+}
+
 void CBaseTerrain::SetLightDirection(const SVector3Df& v3LightDir)
 {
 	m_v3LightDir = v3LightDir;
-	m_pTerrainShader->Use();
-	SVector3Df ReversedLightDir = m_v3LightDir * -1.0f;
-	ReversedLightDir = ReversedLightDir.normalize();
-	m_pTerrainShader->setVec3("v3LightDirection", ReversedLightDir);
+
+	// The shaders read the light from SceneConstants, which is filled from the scene
+	if (CObject::pScene)
+	{
+		CObject::pScene->v3LightDir = v3LightDir;
+	}
 }
 
 void CBaseTerrain::Render()
 {
+	PROFILE_SCOPE("Terrain");
+
 	auto rCamera = CCameraManager::Instance().GetCurrentCamera();
 
 	// Bind SSBO to index 0
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_uiTerrainHandlesSSBO);
-	glEnable(GL_BLEND);
-	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
+	CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_uiTerrainHandlesSSBO);
+	CGLState::Enable(GL_BLEND);
+	CGLState::BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
 
 	// Render geometry
 	m_pGeoMapGrid->Render(rCamera->GetPosition(), rCamera->GetViewProjMatrix());
-	glDisable(GL_BLEND);
+	CGLState::Disable(GL_BLEND);
 
 	// Unbind SSBO from index 0
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0); // Critical for safety
+	CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0); // Critical for safety
 }
 
 void CBaseTerrain::Update()
 {
-	auto rCamera = CCameraManager::Instance().GetCurrentCamera();
-
-	CMatrix4Df matVewProj = rCamera->GetViewProjMatrix();
-	CMatrix4Df matView = rCamera->GetMatrix();
+	// Upload the layers decoded since the last frame
+	if (ms_pTerrainTextureSet && ms_pTerrainTextureSet->ProcessUploads())
+	{
+		DoBindlesslyTexturesSetup();
+	}
 
 	SSceneElements* scene = CObject::pScene;
 	m_v3LightDir = scene->v3LightDir;
 
+	// Camera matrices, camera position and light come from the SceneConstants block
 	m_pTerrainShader->Use();
 
-	// Vertex Shader
-	m_pTerrainShader->setMat4("ViewMatrix", matVewProj);
-
 	// Tessellation Control Shader
-	m_pTerrainShader->setVec3("v3CameraPos", scene->pCamera->GetPosition());
 	m_pTerrainShader->setFloat("fTessMultiplier", 0.5f);
 
 	// Tessellation Evaluation Shader
-	m_pTerrainShader->setMat4("mat4ViewProj", matVewProj);
-	m_pTerrainShader->setVec3("v3CameraPos", scene->pCamera->GetPosition());
 	SVector3Df v3PlaneNormal(0.0f, 1.0f, 0.0f);
 	SVector3Df v3PointOnPlane(0.0f, 0.0f, 0.0f);
 	float fDot = -v3PlaneNormal.dot(v3PointOnPlane);
 	m_pTerrainShader->setVec4("v4ClipPlane", v3PlaneNormal.x, v3PlaneNormal.y, v3PlaneNormal.z, fDot);
 
 	// Fragment Shader
-	m_pTerrainShader->setVec3("v3LightDirection", scene->v3LightDir);
-	m_pTerrainShader->setVec3("v3LightColor", scene->v3LightColor);
 	m_pTerrainShader->setVec3("v3AmbientColor", SVector3Df(0.5f));
-	m_pTerrainShader->setVec3("v3CameraPosition", scene->pCamera->GetPosition());
 	m_pTerrainShader->setFloat("fShininess", 0.2f);
 }
 
@@ -260,7 +282,7 @@ float CBaseTerrain::GetHeightInterpolated(GLfloat fX, GLfloat fZ) const
 	const float X0Z1Height = GetHeight(cast_intf(fX), cast_intf(fZ) + 1);
 	const float X1Z1Height = GetHeight(cast_intf(fX) + 1, cast_intf(fZ) + 1);
 
-	const float fFactorX = fX - std::floorf(fX);
+	const float fFactorX = fX - std::floor(fX);
 
 	const float fInterpolatedBottom = (X1Z0Height - X0Z0Height) * fFactorX + X0Z0Height;
 	const float fInterpolatedTop = (X1Z1Height - X0Z1Height) * fFactorX + X0Z1Height;
@@ -312,7 +334,7 @@ SVector3Df CBaseTerrain::ConstrainCameraToTerrain()
 	}
 
 	v3NewCamPos.y = GetWorldHeight(v3CamPos.x, v3CamPos.z) + 35.0f;
-	float fSmoothHeight = std::sinf(v3CamPos.x * 4.0f) + std::cosf(v3CamPos.z * 4.0f);
+	float fSmoothHeight = std::sin(v3CamPos.x * 4.0f) + std::cos(v3CamPos.z * 4.0f);
 	fSmoothHeight /= 35.0f;
 
 	v3NewCamPos.y += fSmoothHeight;
@@ -331,18 +353,107 @@ void CBaseTerrain::DoBindlesslyTexturesSetup()
 {
 	m_vTextureHandles.clear();
 
-	// Collect all texture handles (including eraser at index 0)
+	// Collect all texture handles (including eraser at index 0), layers still decoding use the placeholder
 	for (auto& tex : ms_pTerrainTextureSet->GetTextures())
 	{
-		if (tex.m_pTexture)
-		{
-			m_vTextureHandles.push_back(tex.m_pTexture->GetHandle()); // Assuming CTexture has GetHandle()
-		}
+		CTexture* pTexture = tex.m_pTexture ? tex.m_pTexture : ms_pTerrainTextureSet->GetPlaceholderTexture();
+		m_vTextureHandles.push_back(pTexture->GetHandle());
 	}
 
 	// Create and fill SSBO
-	glGenBuffers(1, &m_uiTerrainHandlesSSBO);
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiTerrainHandlesSSBO);
+	if (!m_uiTerrainHandlesSSBO)
+	{
+		glGenBuffers(1, &m_uiTerrainHandlesSSBO);
+	}
+	CGLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, m_uiTerrainHandlesSSBO);
 	glBufferData(GL_SHADER_STORAGE_BUFFER, m_vTextureHandles.size() * sizeof(GLuint64), m_vTextureHandles.data(), GL_STATIC_READ);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_uiTerrainHandlesSSBO);
+	CGLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_uiTerrainHandlesSSBO);
+
+	// Nothing samples the replaced layers past this point
+	ms_pTerrainTextureSet->ReleaseRetiredTextures();
+}
+
+bool CBaseTerrain::SaveWorld(const std::string& stFileName)
+{
+	// The mapping would keep the file locked while it's rewritten
+	if (m_pWorldFile->IsOpen())
+	{
+		m_pWorldFile->Close();
+	}
+
+	return (CTerrainWorldFile::Save(stFileName, this));
+}
+
+bool CBaseTerrain::LoadWorld(const std::string& stFileName)
+{
+	// Rejects malformed headers, the current terrain is left untouched
+	if (!m_pWorldFile->Open(stFileName))
+	{
+		return (false);
+	}
+
+	const TTerrainFileHeader& header = m_pWorldFile->GetHeader();
+
+	// Heights are the only required section, check them before anything is torn down.
+	// Patch bounds and LOD errors fall back to a rebuild, textures and splat maps are optional
+	const GLfloat* pHeights = m_pWorldFile->GetHeights();
+	if (!pHeights)
+	{
+		sys_err("CBaseTerrain::LoadWorld: %s has no valid height section", stFileName.c_str());
+		m_pWorldFile->Close();
+		return (false);
+	}
+
+	std::vector<TTerrainTexture> vTextures;
+	const bool bHasTextures = m_pWorldFile->ReadTextureSet(vTextures) && !vTextures.empty();
+
+	// The vertex positions and texture coordinates depend on the scales too
+	if (header.iTerrainSize != m_iTerrainSize || header.iPatchSize != m_iPatchSize ||
+		header.fWorldScale != m_fWorldScale || header.fTextureScale != m_fTextureScale)
+	{
+		m_pGeoMapGrid->Destroy();
+		InitializeTerrain(header.iTerrainSize, header.iPatchSize, header.fWorldScale, header.fTextureScale);
+	}
+
+	SetHeights(pHeights, false);
+
+	// Patch bounds and LOD errors are copied from the mapping into the grid, recomputed only when they don't fit it
+	bool bMetricsLoaded = m_pWorldFile->GetMinMaxLevels() == static_cast<GLint>(m_pGeoMapGrid->GetPatchBounds().size());
+	for (GLint i = 0; bMetricsLoaded && i < m_pWorldFile->GetMinMaxLevels(); i++)
+	{
+		GLint iWidth = 0, iDepth = 0;
+		const SVector2Df* pNodes = m_pWorldFile->GetMinMaxLevel(i, iWidth, iDepth);
+		bMetricsLoaded = m_pGeoMapGrid->SetPatchBoundsLevel(i, pNodes, iWidth, iDepth);
+	}
+
+	size_t iErrorsCount = 0;
+	const GLfloat* pErrors = m_pWorldFile->GetLodErrors(iErrorsCount);
+	bMetricsLoaded = bMetricsLoaded && m_pGeoMapGrid->SetLodErrors(pErrors, iErrorsCount);
+
+	if (!bMetricsLoaded)
+	{
+		sys_log("CBaseTerrain::LoadWorld: %s patch bounds or LOD errors don't match the grid, recomputing them", stFileName.c_str());
+		m_pGeoMapGrid->UpdatePatchMetrics();
+	}
+
+	if (bHasTextures)
+	{
+		ms_pTerrainTextureSet->Load(vTextures, stFileName);
+		DoBindlesslyTexturesSetup();
+	}
+
+	size_t iSplatSize = 0;
+	const uint8_t* pSplat = m_pWorldFile->GetSection(TERRAIN_SECTION_SPLAT, iSplatSize);
+	if (pSplat && !m_pGeoMapGrid->LoadSplatmaps(pSplat, iSplatSize))
+	{
+		sys_err("CBaseTerrain::LoadWorld: Failed to load the splat maps of %s", stFileName.c_str());
+	}
+
+	sys_log("CBaseTerrain::LoadWorld: Loaded %s (%dx%d, patch %d)", stFileName.c_str(), header.iTerrainSize, header.iTerrainSize, header.iPatchSize);
+	return (true);
+}
+
+CTerrainWorldFile* CBaseTerrain::GetWorldFile()
+{
+	return (m_pWorldFile);
 }
@@ -8,13 +8,17 @@
 #include "texture_set.h"
 #include "../../LibImageUI/imgui.h"
 
+class CTerrainWorldFile;
+
 class CBaseTerrain : public CSingleton<CBaseTerrain>, public CObject
 {
 public:
-	CBaseTerrain();
+	// A headless terrain never touches GL (no shader, no buffers, no textures), for tools and benchmarks without a context
+	explicit CBaseTerrain(bool bHeadless = false);
 	~CBaseTerrain();
 
 	void InitializeTerrain(GLint iTerrainSize, GLint iPatchSize, GLfloat fWorldScale, GLfloat fTextureScale);
+	bool IsHeadless() const;
 
 	GLint GetSize() const;
 	GLint GetPatchSize() const;
@@ -35,6 +39,9 @@ public:
 
 	void UpdateVertexBuffer();
 
+	// Heights are row major, GetSize() * GetSize(). Updates the height map and the grid vertices
+	void SetHeights(const GLfloat* pHeights, bool bUpdatePatchMetrics = true);
+
 	float GetHeightInterpolated(GLfloat fX, GLfloat fZ) const;
 	float GetWorldSize() const;
 	float GetWorldHeight(GLfloat fX, GLfloat fZ) const;
@@ -57,6 +64,11 @@ public:
 
 	void DoBindlesslyTexturesSetup();
 
+	// .terrain world container (see terrain_file.h)
+	bool SaveWorld(const std::string& stFileName);
+	bool LoadWorld(const std::string& stFileName);
+	CTerrainWorldFile* GetWorldFile();
+
 private:
 	void InitializeShaders();
 
@@ -77,8 +89,10 @@ private:
 	CGeoMipGrid* m_pGeoMapGrid;
 	SVector3Df m_v3LightDir;
 	CWorldTranslation* m_pWorldTranslation;
+	CTerrainWorldFile* m_pWorldFile; // Stays mapped so sections can be read on demand
 	
 	GLint m_iSelectedBtnIdx;
+	bool m_bHeadless;
 
 	static CTerrainTextureSet* ms_pTerrainTextureSet;
 
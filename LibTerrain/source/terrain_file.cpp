@@ -0,0 +1,436 @@
+#include "stdafx.h"
+#include "terrain_file.h"
+#include "terrain.h"
+#include "splat_file.h"
+#include <fstream>
+#include <cstring>
+#include <cfloat>
+#include <cmath>
+
+#if defined(_WIN64)
+#undef max
+#undef min
+#undef minmax
+#endif
+
+namespace
+{
+	typedef struct SPendingSection
+	{
+		ETerrainSection eType;
+		std::vector<uint8_t> vData;
+	} TPendingSection;
+
+	inline size_t AlignUp(size_t iValue)
+	{
+		return ((iValue + TERRAIN_FILE_ALIGNMENT - 1) & ~(TERRAIN_FILE_ALIGNMENT - 1));
+	}
+
+	inline bool IsPowerOfTwoPlusOne(int32_t iValue)
+	{
+		return (iValue >= 3 && ((iValue - 1) & (iValue - 2)) == 0);
+	}
+
+	inline void AppendBytes(std::vector<uint8_t>& vOut, const void* pData, size_t iSize)
+	{
+		const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+		vOut.insert(vOut.end(), pBytes, pBytes + iSize);
+	}
+}
+
+CTerrainWorldFile::CTerrainWorldFile()
+{
+	m_pHeader = nullptr;
+	m_pSections = nullptr;
+}
+
+CTerrainWorldFile::~CTerrainWorldFile()
+{
+	Close();
+}
+
+void CTerrainWorldFile::BuildMinMax(const CGeoMipGrid* pGrid, std::vector<uint8_t>& vOut)
+{
+	TTerrainMinMaxHeader header{};
+	std::vector<SVector2Df> vNodes;
+
+	for (const TPatchBoundsLevel& bounds : pGrid->GetPatchBounds())
+	{
+		if (header.uiLevels >= TERRAIN_MINMAX_MAX_LEVELS)
+		{
+			break;
+		}
+
+		TTerrainMinMaxLevel& level = header.Levels[header.uiLevels++];
+		level.uiWidth = static_cast<uint32_t>(bounds.iWidth);
+		level.uiDepth = static_cast<uint32_t>(bounds.iDepth);
+		level.uiOffset = sizeof(TTerrainMinMaxHeader) + vNodes.size() * sizeof(SVector2Df);
+		vNodes.insert(vNodes.end(), bounds.vNodes.begin(), bounds.vNodes.end());
+	}
+
+	// Sized up front, inserting into the cleared vector trips GCC's -Wstringop-overflow
+	const size_t iNodesSize = vNodes.size() * sizeof(vNodes[0]);
+	vOut.assign(sizeof(header) + iNodesSize, 0);
+	std::memcpy(vOut.data(), &header, sizeof(header));
+	if (!vNodes.empty())
+	{
+		std::memcpy(vOut.data() + sizeof(header), vNodes.data(), iNodesSize);
+	}
+}
+
+void CTerrainWorldFile::BuildLodErrors(const CGeoMipGrid* pGrid, std::vector<uint8_t>& vOut)
+{
+	const std::vector<GLfloat>& vErrors = pGrid->GetLodErrors();
+
+	vOut.clear();
+	AppendBytes(vOut, vErrors.data(), vErrors.size() * sizeof(GLfloat));
+}
+
+void CTerrainWorldFile::BuildTextureSet(CTerrainTextureSet* pTextureSet, std::vector<uint8_t>& vOut)
+{
+	vOut.clear();
+
+	// Skip the eraser at index 0, it's created by the texture set itself
+	const uint32_t uiCount = pTextureSet ? static_cast<uint32_t>(pTextureSet->GetTexturesCount() - 1) : 0;
+	AppendBytes(vOut, &uiCount, sizeof(uiCount));
+
+	for (uint32_t i = 1; i <= uiCount; i++)
+	{
+		const TTerrainTexture& tex = pTextureSet->GetTexture(i);
+
+		TTerrainFileTexture record{};
+		std::memcpy(record.szFileName, tex.m_stFileName.c_str(), std::min(tex.m_stFileName.size(), sizeof(record.szFileName) - 1));
+		record.fUScale = tex.m_fUScale;
+		record.fVScale = tex.m_fVScale;
+		record.fUOffset = tex.m_fUOffset;
+		record.fVOffset = tex.m_fVOffset;
+		record.uiIsSplat = tex.m_bIsSplat ? 1 : 0;
+		record.uiHeightMin = tex.m_uiHeightMin;
+		record.uiHeightMax = tex.m_uiHeightMax;
+		record.fSlopeMin = tex.m_fSlopeMin;
+		record.fSlopeMax = tex.m_fSlopeMax;
+		record.fCurvatureMin = tex.m_fCurvatureMin;
+		record.fCurvatureMax = tex.m_fCurvatureMax;
+		record.fRuleBlend = tex.m_fRuleBlend;
+
+		AppendBytes(vOut, &record, sizeof(record));
+	}
+}
+
+bool CTerrainWorldFile::Save(const std::string& stFileName, CBaseTerrain* pTerrain)
+{
+	CGeoMipGrid* pGrid = pTerrain->GetGeoMipGrid();
+	const GLint iSize = pGrid->GetWidth();
+	const GLint iPatchSize = pGrid->GetPatchSize();
+
+	if (iSize <= 1 || pGrid->GetDepth() != iSize)
+	{
+		sys_err("CTerrainWorldFile::Save: Terrain is not initialized or not square (%d x %d)", iSize, pGrid->GetDepth());
+		return (false);
+	}
+
+	// Heights live in the vertices, the map grid is only the initial state
+	std::vector<GLfloat> vHeights;
+	pGrid->CopyHeights(vHeights);
+
+	std::vector<TPendingSection> vSections(5);
+	vSections[0].eType = TERRAIN_SECTION_HEIGHTS;
+	AppendBytes(vSections[0].vData, vHeights.data(), vHeights.size() * sizeof(GLfloat));
+
+	vSections[1].eType = TERRAIN_SECTION_MINMAX;
+	BuildMinMax(pGrid, vSections[1].vData);
+
+	vSections[2].eType = TERRAIN_SECTION_SPLAT;
+	pGrid->EncodeSplatmaps(vSections[2].vData);
+
+	vSections[3].eType = TERRAIN_SECTION_TEXTURE_SET;
+	BuildTextureSet(CBaseTerrain::GetTextureSet(), vSections[3].vData);
+
+	vSections[4].eType = TERRAIN_SECTION_LOD_ERROR;
+	BuildLodErrors(pGrid, vSections[4].vData);
+
+	TTerrainFileHeader header{};
+	header.uiMagic = TERRAIN_FILE_MAGIC;
+	header.uiVersion = TERRAIN_FILE_VERSION;
+	header.uiSectionCount = static_cast<uint32_t>(vSections.size());
+	header.iTerrainSize = iSize;
+	header.iPatchSize = iPatchSize;
+	header.iMaxLOD = pGrid->GetMaxLOD();
+	header.fWorldScale = pTerrain->GetWorldScale();
+	header.fTextureScale = pTerrain->GetTextureScale();
+
+	std::vector<TTerrainSectionEntry> vEntries(vSections.size());
+	size_t iOffset = AlignUp(sizeof(TTerrainFileHeader) + vEntries.size() * sizeof(TTerrainSectionEntry));
+
+	for (size_t i = 0; i < vSections.size(); i++)
+	{
+		vEntries[i].uiType = vSections[i].eType;
+		vEntries[i].uiVersion = TERRAIN_FILE_VERSION;
+		vEntries[i].uiOffset = iOffset;
+		vEntries[i].uiSize = vSections[i].vData.size();
+		iOffset = AlignUp(iOffset + vSections[i].vData.size());
+	}
+
+	std::ofstream file(stFileName, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		sys_err("CTerrainWorldFile::Save: Failed to open %s for writing", stFileName.c_str());
+		return (false);
+	}
+
+	static const char s_Padding[TERRAIN_FILE_ALIGNMENT] = {};
+	size_t iWritten = 0;
+
+	auto Write = [&](const void* pData, size_t iBytes)
+		{
+			file.write(static_cast<const char*>(pData), static_cast<std::streamsize>(iBytes));
+			iWritten += iBytes;
+		};
+
+	Write(&header, sizeof(header));
+	Write(vEntries.data(), vEntries.size() * sizeof(TTerrainSectionEntry));
+
+	for (size_t i = 0; i < vSections.size(); i++)
+	{
+		Write(s_Padding, vEntries[i].uiOffset - iWritten);
+		Write(vSections[i].vData.data(), vSections[i].vData.size());
+	}
+	Write(s_Padding, AlignUp(iWritten) - iWritten);
+
+	if (!file.good())
+	{
+		sys_err("CTerrainWorldFile::Save: Failed to write %s", stFileName.c_str());
+		return (false);
+	}
+
+	sys_log("CTerrainWorldFile::Save: Saved %s (%zu bytes, %u sections)", stFileName.c_str(), iWritten, header.uiSectionCount);
+	return (true);
+}
+
+bool CTerrainWorldFile::Open(const std::string& stFileName)
+{
+	Close();
+
+	if (!m_File.Open(stFileName))
+	{
+		return (false);
+	}
+
+	const TTerrainFileHeader* pHeader = reinterpret_cast<const TTerrainFileHeader*>(m_File.GetRange(0, sizeof(TTerrainFileHeader)));
+	if (!pHeader || pHeader->uiMagic != TERRAIN_FILE_MAGIC)
+	{
+		sys_err("CTerrainWorldFile::Open: %s is not a terrain file", stFileName.c_str());
+		Close();
+		return (false);
+	}
+
+	if (pHeader->uiVersion != TERRAIN_FILE_VERSION)
+	{
+		sys_err("CTerrainWorldFile::Open: %s has unsupported version %u", stFileName.c_str(), pHeader->uiVersion);
+		Close();
+		return (false);
+	}
+
+	if (!ValidateHeader(*pHeader, stFileName))
+	{
+		Close();
+		return (false);
+	}
+
+	const TTerrainSectionEntry* pSections = reinterpret_cast<const TTerrainSectionEntry*>(m_File.GetRange(sizeof(TTerrainFileHeader), pHeader->uiSectionCount * sizeof(TTerrainSectionEntry)));
+	if (!pSections)
+	{
+		sys_err("CTerrainWorldFile::Open: %s section table is truncated", stFileName.c_str());
+		Close();
+		return (false);
+	}
+
+	for (uint32_t i = 0; i < pHeader->uiSectionCount; i++)
+	{
+		if (!m_File.GetRange(pSections[i].uiOffset, pSections[i].uiSize))
+		{
+			sys_err("CTerrainWorldFile::Open: %s section %u is out of range", stFileName.c_str(), i);
+			Close();
+			return (false);
+		}
+	}
+
+	m_pHeader = pHeader;
+	m_pSections = pSections;
+	return (true);
+}
+
+bool CTerrainWorldFile::ValidateHeader(const TTerrainFileHeader& header, const std::string& stFileName)
+{
+	if (!IsPowerOfTwoPlusOne(header.iTerrainSize) || header.iTerrainSize > TERRAIN_FILE_MAX_SIZE)
+	{
+		sys_err("CTerrainWorldFile::ValidateHeader: %s has an invalid terrain size %d (2^n + 1, at most %d)", stFileName.c_str(), header.iTerrainSize, TERRAIN_FILE_MAX_SIZE);
+		return (false);
+	}
+
+	// Both are 2^n + 1, a patch that isn't larger than the terrain always divides it
+	if (!IsPowerOfTwoPlusOne(header.iPatchSize) || header.iPatchSize > header.iTerrainSize)
+	{
+		sys_err("CTerrainWorldFile::ValidateHeader: %s has an invalid patch size %d for terrain size %d", stFileName.c_str(), header.iPatchSize, header.iTerrainSize);
+		return (false);
+	}
+
+	if (!std::isfinite(header.fWorldScale) || header.fWorldScale <= 0.0f || !std::isfinite(header.fTextureScale) || header.fTextureScale <= 0.0f)
+	{
+		sys_err("CTerrainWorldFile::ValidateHeader: %s has invalid scales (world %f, texture %f)", stFileName.c_str(), header.fWorldScale, header.fTextureScale);
+		return (false);
+	}
+
+	return (true);
+}
+
+void CTerrainWorldFile::Close()
+{
+	m_File.Close();
+	m_pHeader = nullptr;
+	m_pSections = nullptr;
+}
+
+bool CTerrainWorldFile::IsOpen() const
+{
+	return (m_pHeader != nullptr);
+}
+
+const TTerrainFileHeader& CTerrainWorldFile::GetHeader() const
+{
+	return (*m_pHeader);
+}
+
+const uint8_t* CTerrainWorldFile::GetSection(ETerrainSection eType, size_t& iSize) const
+{
+	iSize = 0;
+
+	if (!m_pHeader)
+	{
+		return (nullptr);
+	}
+
+	for (uint32_t i = 0; i < m_pHeader->uiSectionCount; i++)
+	{
+		if (m_pSections[i].uiType == eType)
+		{
+			iSize = static_cast<size_t>(m_pSections[i].uiSize);
+			return (m_File.GetData() + m_pSections[i].uiOffset);
+		}
+	}
+
+	return (nullptr);
+}
+
+const GLfloat* CTerrainWorldFile::GetHeights() const
+{
+	size_t iSize = 0;
+	const uint8_t* pData = GetSection(TERRAIN_SECTION_HEIGHTS, iSize);
+
+	const size_t iExpected = static_cast<size_t>(m_pHeader ? m_pHeader->iTerrainSize : 0) * (m_pHeader ? m_pHeader->iTerrainSize : 0) * sizeof(GLfloat);
+	if (!pData || iSize != iExpected)
+	{
+		return (nullptr);
+	}
+
+	return (reinterpret_cast<const GLfloat*>(pData));
+}
+
+GLint CTerrainWorldFile::GetMinMaxLevels() const
+{
+	size_t iSize = 0;
+	const uint8_t* pData = GetSection(TERRAIN_SECTION_MINMAX, iSize);
+	if (!pData || iSize < sizeof(TTerrainMinMaxHeader))
+	{
+		return (0);
+	}
+
+	return (static_cast<GLint>(reinterpret_cast<const TTerrainMinMaxHeader*>(pData)->uiLevels));
+}
+
+const SVector2Df* CTerrainWorldFile::GetMinMaxLevel(GLint iLevel, GLint& iWidth, GLint& iDepth) const
+{
+	size_t iSize = 0;
+	const uint8_t* pData = GetSection(TERRAIN_SECTION_MINMAX, iSize);
+	if (!pData || iSize < sizeof(TTerrainMinMaxHeader))
+	{
+		return (nullptr);
+	}
+
+	const TTerrainMinMaxHeader* pHeader = reinterpret_cast<const TTerrainMinMaxHeader*>(pData);
+	if (iLevel < 0 || iLevel >= static_cast<GLint>(std::min(pHeader->uiLevels, TERRAIN_MINMAX_MAX_LEVELS)))
+	{
+		return (nullptr);
+	}
+
+	const TTerrainMinMaxLevel& level = pHeader->Levels[iLevel];
+	const size_t iLevelSize = static_cast<size_t>(level.uiWidth) * level.uiDepth * sizeof(SVector2Df);
+	if (level.uiOffset < sizeof(TTerrainMinMaxHeader) || level.uiOffset % alignof(SVector2Df) != 0 || level.uiOffset > iSize || iLevelSize > iSize - level.uiOffset)
+	{
+		return (nullptr);
+	}
+
+	iWidth = static_cast<GLint>(level.uiWidth);
+	iDepth = static_cast<GLint>(level.uiDepth);
+	return (reinterpret_cast<const SVector2Df*>(pData + level.uiOffset));
+}
+
+const GLfloat* CTerrainWorldFile::GetLodErrors(size_t& iCount) const
+{
+	size_t iSize = 0;
+	const uint8_t* pData = GetSection(TERRAIN_SECTION_LOD_ERROR, iSize);
+	if (!pData || iSize % sizeof(GLfloat) != 0)
+	{
+		iCount = 0;
+		return (nullptr);
+	}
+
+	iCount = iSize / sizeof(GLfloat);
+	return (reinterpret_cast<const GLfloat*>(pData));
+}
+
+bool CTerrainWorldFile::ReadTextureSet(std::vector<TTerrainTexture>& vTextures) const
+{
+	vTextures.clear();
+
+	size_t iSize = 0;
+	const uint8_t* pData = GetSection(TERRAIN_SECTION_TEXTURE_SET, iSize);
+	if (!pData || iSize < sizeof(uint32_t))
+	{
+		return (false);
+	}
+
+	uint32_t uiCount = 0;
+	std::memcpy(&uiCount, pData, sizeof(uiCount));
+	if (sizeof(uint32_t) + static_cast<size_t>(uiCount) * sizeof(TTerrainFileTexture) > iSize)
+	{
+		sys_err("CTerrainWorldFile::ReadTextureSet: Texture set section is truncated");
+		return (false);
+	}
+
+	const TTerrainFileTexture* pRecords = reinterpret_cast<const TTerrainFileTexture*>(pData + sizeof(uint32_t));
+	vTextures.resize(uiCount);
+
+	for (uint32_t i = 0; i < uiCount; i++)
+	{
+		const TTerrainFileTexture& record = pRecords[i];
+		TTerrainTexture& tex = vTextures[i];
+
+		tex.m_stFileName.assign(record.szFileName, strnlen(record.szFileName, sizeof(record.szFileName)));
+		tex.m_uiTextureID = i + 1;
+		tex.m_fUScale = record.fUScale;
+		tex.m_fVScale = record.fVScale;
+		tex.m_fUOffset = record.fUOffset;
+		tex.m_fVOffset = record.fVOffset;
+		tex.m_bIsSplat = record.uiIsSplat != 0;
+		tex.m_uiHeightMin = record.uiHeightMin;
+		tex.m_uiHeightMax = record.uiHeightMax;
+		tex.m_fSlopeMin = record.fSlopeMin;
+		tex.m_fSlopeMax = record.fSlopeMax;
+		tex.m_fCurvatureMin = record.fCurvatureMin;
+		tex.m_fCurvatureMax = record.fCurvatureMax;
+		tex.m_fRuleBlend = record.fRuleBlend;
+	}
+
+	return (true);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "../../LibGL/source/mapped_file.h"
+#include "texture_set.h"
+
+/*
+ * .terrain world container
+ *
+ * [TTerrainFileHeader][TTerrainSectionEntry x sections][sections, each aligned to TERRAIN_FILE_ALIGNMENT]
+ *
+ * The file is memory mapped on open, nothing is parsed until a section is requested,
+ * and every section is page aligned. The loader copies the heights, patch bounds and LOD
+ * errors from the mapping into the grid, no section is used in place.
+ */
+enum ETerrainSection : uint32_t
+{
+	TERRAIN_SECTION_NONE,
+	TERRAIN_SECTION_HEIGHTS,		// GLfloat[size * size], row major
+	TERRAIN_SECTION_MINMAX,			// TTerrainMinMaxHeader + SVector2Df (min, max) per node, level 0 is per patch
+	TERRAIN_SECTION_SPLAT,			// CSplatFile blob
+	TERRAIN_SECTION_TEXTURE_SET,	// uint32_t count + TTerrainFileTexture[count]
+	TERRAIN_SECTION_LOD_ERROR,		// GLfloat[patches * (max LOD + 1)], max height deviation of each LOD
+};
+
+constexpr uint32_t TERRAIN_FILE_MAGIC = 0x4E525254; // "TRRN"
+constexpr uint32_t TERRAIN_FILE_VERSION = 1;
+constexpr size_t TERRAIN_FILE_ALIGNMENT = 4096;
+constexpr uint32_t TERRAIN_MINMAX_MAX_LEVELS = 16;
+constexpr int32_t TERRAIN_FILE_MAX_SIZE = 8193;		// 2^13 + 1, 256 MB of heights
+
+#pragma pack(push, 1)
+typedef struct STerrainFileHeader
+{
+	uint32_t uiMagic;
+	uint32_t uiVersion;
+	uint32_t uiSectionCount;
+	int32_t iTerrainSize;
+	int32_t iPatchSize;
+	int32_t iMaxLOD;
+	float fWorldScale;
+	float fTextureScale;
+	uint32_t uiReserved[8];
+} TTerrainFileHeader;
+
+typedef struct STerrainSectionEntry
+{
+	uint32_t uiType;
+	uint32_t uiVersion;
+	uint64_t uiOffset;
+	uint64_t uiSize;
+	uint64_t uiReserved;
+} TTerrainSectionEntry;
+
+typedef struct STerrainMinMaxLevel
+{
+	uint32_t uiWidth;
+	uint32_t uiDepth;
+	uint64_t uiOffset;		// From the start of the section
+} TTerrainMinMaxLevel;
+
+typedef struct STerrainMinMaxHeader
+{
+	uint32_t uiLevels;
+	uint32_t uiReserved;
+	TTerrainMinMaxLevel Levels[TERRAIN_MINMAX_MAX_LEVELS];
+} TTerrainMinMaxHeader;
+
+typedef struct STerrainFileTexture
+{
+	char szFileName[256];
+	float fUScale;
+	float fVScale;
+	float fUOffset;
+	float fVOffset;
+	uint32_t uiIsSplat;
+	uint32_t uiHeightMin;
+	uint32_t uiHeightMax;
+	float fSlopeMin;
+	float fSlopeMax;
+	float fCurvatureMin;
+	float fCurvatureMax;
+	float fRuleBlend;
+} TTerrainFileTexture;
+#pragma pack(pop)
+
+class CBaseTerrain;
+class CGeoMipGrid;
+
+class CTerrainWorldFile
+{
+public:
+	CTerrainWorldFile();
+	~CTerrainWorldFile();
+
+	static bool Save(const std::string& stFileName, CBaseTerrain* pTerrain);
+
+	bool Open(const std::string& stFileName);
+	void Close();
+	bool IsOpen() const;
+
+	const TTerrainFileHeader& GetHeader() const;
+
+	// Raw section view inside the mapping, nullptr if the file has no such section
+	const uint8_t* GetSection(ETerrainSection eType, size_t& iSize) const;
+
+	const GLfloat* GetHeights() const;
+
+	// In place views of the stored patch bounds and LOD errors (see CGeoMipGrid::GetPatchBounds), nullptr when malformed
+	GLint GetMinMaxLevels() const;
+	const SVector2Df* GetMinMaxLevel(GLint iLevel, GLint& iWidth, GLint& iDepth) const;
+	const GLfloat* GetLodErrors(size_t& iCount) const;
+
+	bool ReadTextureSet(std::vector<TTerrainTexture>& vTextures) const;
+
+protected:
+	// Sizes must be 2^n + 1 with the patch size dividing the terrain, scales positive and finite
+	static bool ValidateHeader(const TTerrainFileHeader& header, const std::string& stFileName);
+
+	// Written from the grid, which keeps both up to date while the terrain is edited
+	static void BuildMinMax(const CGeoMipGrid* pGrid, std::vector<uint8_t>& vOut);
+	static void BuildLodErrors(const CGeoMipGrid* pGrid, std::vector<uint8_t>& vOut);
+	static void BuildTextureSet(CTerrainTextureSet* pTextureSet, std::vector<uint8_t>& vOut);
+
+private:
+	CMappedFile m_File;
+	const TTerrainFileHeader* m_pHeader;
+	const TTerrainSectionEntry* m_pSections;
+};
@@ -1,31 +1,51 @@
 #include "stdafx.h"
 #include "texture_set.h"
+#include "../../LibGL/source/texture_registry.h"
 #include <fstream>
 
 CTerrainTextureSet::CTerrainTextureSet()
 {
+	// Shared by every layer that is still decoding
+	m_pPlaceholderTexture = new CTexture(GL_TEXTURE_2D);
+	m_pPlaceholderTexture->GenerateColoredTexture2D(4, 4, SVector4Df(0.5f, 0.5f, 0.5f, 1.0f));
+	m_pPlaceholderTexture->MakeResident();
+
+	m_bBindingsDirty = false;
+	m_uiRevision = 0;
+
 	Create();
 }
 
 CTerrainTextureSet::~CTerrainTextureSet()
 {
 	Clear();
+	safe_delete(m_pPlaceholderTexture);
 }
 
 void CTerrainTextureSet::Clear()
 {
-	safe_delete(m_tErrorTexture.m_pTexture);
+	// Results still in flight are dropped when they arrive
+	m_mPendingLayers.clear();
+	m_bBindingsDirty = true;
+	m_uiRevision++;
+
+	ReleaseRetiredTextures();
+	CTextureRegistry::Release(m_tErrorTexture.m_pTexture);
 	for (auto& it : m_vTextures)
 	{
-		safe_delete(it.m_pTexture);
+		CTextureRegistry::Release(it.m_pTexture);
 	}
 	m_vTextures.clear();
 }
 
 void CTerrainTextureSet::Create()
 {
-	m_tErrorTexture.m_pTexture = new CTexture("resources/textureset/error.png", GL_TEXTURE_2D);
-	m_tErrorTexture.m_pTexture->Load();
+	bool bCreated = false;
+	m_tErrorTexture.m_pTexture = CTextureRegistry::Acquire("resources/textureset/error.png", GL_TEXTURE_2D, bCreated);
+	if (bCreated)
+	{
+		m_tErrorTexture.m_pTexture->Load();
+	}
 	m_tErrorTexture.m_pTexture->MakeResident();
 	m_tErrorTexture.m_uiTextureID = m_tErrorTexture.m_pTexture->GetTextureID();
 
@@ -37,7 +57,7 @@ void CTerrainTextureSet::Create()
 void CTerrainTextureSet::AddEmptyTexture()
 {
 	TTerrainTexture EraserTexture;
-	EraserTexture.m_pTexture = new CTexture(GL_TEXTURE_2D);
+	EraserTexture.m_pTexture = CTextureRegistry::Adopt(new CTexture(GL_TEXTURE_2D));
 	EraserTexture.m_pTexture->GenerateColoredTexture2D(TERRAIN_PATCH_SIZE, TERRAIN_PATCH_SIZE, SVector4Df(0.0f, 1.0f, 0.3f, 0.1f));
 	EraserTexture.m_pTexture->MakeResident();
 	m_vTextures.emplace_back(EraserTexture);
@@ -73,12 +93,33 @@ bool CTerrainTextureSet::RemoveTexture(size_t iIndex)
 		return (false);
 	}
 
-	// Extract entry FIRST
-	TTerrainTexture texture = m_vTextures[iIndex];
-	safe_delete(texture.m_pTexture);
+	// Dropped after the bindless table is rebuilt without it, like a reloaded layer
+	if (m_vTextures[iIndex].m_pTexture)
+	{
+		m_vRetiredTextures.push_back(m_vTextures[iIndex].m_pTexture);
+	}
 
 	m_vTextures.erase(m_vTextures.begin() + iIndex);
 
+	// Pending layers after the removed one moved down
+	for (auto it = m_mPendingLayers.begin(); it != m_mPendingLayers.end();)
+	{
+		if (it->second == iIndex)
+		{
+			it = m_mPendingLayers.erase(it);
+			continue;
+		}
+
+		if (it->second > iIndex)
+		{
+			it->second--;
+		}
+		++it;
+	}
+
+	m_bBindingsDirty = true;
+	m_uiRevision++;
+
 	// Now delete safely
 
 	return (true);
@@ -182,6 +223,13 @@ bool CTerrainTextureSet::Load(const std::string& stFileName)
 			texture.m_uiHeightMin = data["begin"].get<GLuint>();
 			texture.m_uiHeightMax = data["end"].get<GLuint>();
 
+			// Auto splat rules, older texture sets don't have them
+			texture.m_fSlopeMin = data.value("slope_min", 0.0f);
+			texture.m_fSlopeMax = data.value("slope_max", TERRAIN_SLOPE_MAX);
+			texture.m_fCurvatureMin = data.value("curvature_min", -TERRAIN_CURVATURE_LIMIT);
+			texture.m_fCurvatureMax = data.value("curvature_max", TERRAIN_CURVATURE_LIMIT);
+			texture.m_fRuleBlend = data.value("rule_blend", 0.1f);
+
 			SetTexture(i + 1, texture);
 		}
 
@@ -197,40 +245,169 @@ bool CTerrainTextureSet::Load(const std::string& stFileName)
 	}
 }
 
+bool CTerrainTextureSet::Load(const TTexturesVector& vTextures, const std::string& stSourceName)
+{
+	Clear();
+	Create();
+
+	m_vTextures.resize(vTextures.size() + 1); // +1 for the eraser at index 0
+
+	for (size_t i = 0; i < vTextures.size(); ++i)
+	{
+		SetTexture(i + 1, vTextures[i]);
+	}
+
+	m_stFileName.assign(stSourceName);
+
+	sys_log("CTerrainTextureSet::Load: Succeed To Load %zu Textures From %s", vTextures.size(), m_stFileName.c_str());
+	return (true);
+}
+
 void CTerrainTextureSet::Reload()
 {
 	for (size_t i = 1; i < m_vTextures.size(); ++i)
 	{
-		TTerrainTexture& tex = m_vTextures[i];
+		RequestTexture(i, true);
+	}
+}
+
+void CTerrainTextureSet::UpdateTextureTransform(TTerrainTexture& tex)
+{
+	CMatrix4Df matScale{};
+	matScale.InitScaleTransform(m_fTerrainTexCoordBase * tex.m_fUScale, -m_fTerrainTexCoordBase * tex.m_fVScale, 1.0f);
+
+	CMatrix4Df matTranslate{};
+	matTranslate.InitTranslationTransform(tex.m_fUOffset, -tex.m_fVOffset, 0.0f);
+
+	tex.m_matTransform = matTranslate * matScale;
+}
+
+void CTerrainTextureSet::RequestTexture(size_t iIndex, bool bFromDisk)
+{
+	TTerrainTexture& tex = m_vTextures[iIndex];
+
+	// A newer request for the same layer wins over the one in flight
+	for (auto it = m_mPendingLayers.begin(); it != m_mPendingLayers.end();)
+	{
+		it = (it->second == iIndex) ? m_mPendingLayers.erase(it) : std::next(it);
+	}
+
+	// The bindless table still holds the old handle, it's released once the table is rebuilt
+	if (tex.m_pTexture)
+	{
+		// Meshes sharing the old texture keep it, the next lookup of the file gets the fresh upload
+		if (bFromDisk)
+		{
+			CTextureRegistry::Forget(tex.m_pTexture);
+		}
+
+		m_vRetiredTextures.push_back(tex.m_pTexture);
+		tex.m_pTexture = nullptr;
+	}
+	tex.m_uiTextureID = 0;
+
+	UpdateTextureTransform(tex);
+	m_bBindingsDirty = true;
+
+	// Already uploaded by a mesh or another layer, no decode needed
+	CTexture* pShared = bFromDisk ? nullptr : CTextureRegistry::AcquireExisting(tex.m_stFileName, GL_TEXTURE_2D);
+	if (pShared)
+	{
+		if (pShared->GetTextureID())
+		{
+			tex.m_pTexture = pShared;
+			tex.m_pTexture->MakeResident();
+			tex.m_uiTextureID = tex.m_pTexture->GetTextureID();
+			return;
+		}
+
+		CTextureRegistry::Release(pShared);
+	}
+
+	m_mPendingLayers[m_DecodeQueue.Submit(tex.m_stFileName)] = iIndex;
+}
+
+bool CTerrainTextureSet::ProcessUploads(size_t iMaxUploads)
+{
+	std::vector<TDecodedImage> vDecoded;
+	m_DecodeQueue.Poll(vDecoded, iMaxUploads);
 
-		// Reset and reload the texture
-		if (tex.m_pTexture)
+	for (auto& image : vDecoded)
+	{
+		auto it = m_mPendingLayers.find(image.uiTicket);
+		if (it == m_mPendingLayers.end())
 		{
-			safe_delete(tex.m_pTexture);
+			continue; // Layer was removed, reloaded or the set was cleared
 		}
 
-		tex.m_pTexture = new CTexture(tex.m_stFileName, GL_TEXTURE_2D);
+		const size_t iIndex = it->second;
+		m_mPendingLayers.erase(it);
+
+		TTerrainTexture& tex = m_vTextures[iIndex];
 
-		if (!tex.m_pTexture->Load())
+		if (!image.bSuccess)
 		{
-			sys_err("CTerrainTextureSet::Reload: Failed to reload texture '%s'", tex.m_stFileName.c_str());
-			safe_delete(tex.m_pTexture);  // Clear invalid texture
+			sys_err("CTerrainTextureSet::ProcessUploads: Failed to load texture '%s' - %s", image.stFileName.c_str(), image.stError.c_str());
 			continue;
 		}
 
-		tex.m_pTexture->MakeResident();
+		// Someone else may have registered the file while we were decoding, their upload wins
+		bool bCreated = false;
+		tex.m_pTexture = CTextureRegistry::Acquire(tex.m_stFileName, GL_TEXTURE_2D, bCreated);
 
+		if (bCreated && image.bCompressed)
+		{
+			if (!tex.m_pTexture->LoadCompressed(image.compressed))
+			{
+				sys_err("CTerrainTextureSet::ProcessUploads: Failed to upload compressed texture '%s'", image.stFileName.c_str());
+				CTextureRegistry::Forget(tex.m_pTexture);
+				CTextureRegistry::Release(tex.m_pTexture);
+				continue;
+			}
+		}
+		else if (bCreated)
+		{
+			tex.m_pTexture->LoadRaw(image.iWidth, image.iHeight, image.iChannelsBPP, image.vPixels.data());
+		}
+		tex.m_pTexture->MakeResident();
 		tex.m_uiTextureID = tex.m_pTexture->GetTextureID();
 
-		// Recompute the transformation matrix
-		CMatrix4Df matScale{};
-		matScale.InitScaleTransform(m_fTerrainTexCoordBase * tex.m_fUScale, -m_fTerrainTexCoordBase * tex.m_fVScale, 1.0f);
+		m_bBindingsDirty = true;
+	}
+
+	const bool bBindingsDirty = m_bBindingsDirty;
+	m_bBindingsDirty = false;
+	return (bBindingsDirty);
+}
+
+void CTerrainTextureSet::WaitForPendingTextures()
+{
+	m_DecodeQueue.Wait();
+	ProcessUploads(0);
+}
+
+bool CTerrainTextureSet::IsLoading() const
+{
+	return (!m_mPendingLayers.empty());
+}
 
-		CMatrix4Df matTranslate{};
-		matTranslate.InitTranslationTransform(tex.m_fUOffset, -tex.m_fVOffset, 0.0f);
+CTexture* CTerrainTextureSet::GetPlaceholderTexture()
+{
+	return (m_pPlaceholderTexture);
+}
 
-		tex.m_matTransform = matTranslate * matScale;
+void CTerrainTextureSet::ReleaseRetiredTextures()
+{
+	for (CTexture*& pTexture : m_vRetiredTextures)
+	{
+		CTextureRegistry::Release(pTexture);
 	}
+	m_vRetiredTextures.clear();
+}
+
+GLuint CTerrainTextureSet::GetRevision() const
+{
+	return (m_uiRevision);
 }
 
 bool CTerrainTextureSet::SetTexture(size_t iIndex, const TTerrainTexture& Texture)
@@ -252,28 +429,15 @@ bool CTerrainTextureSet::SetTexture(size_t iIndex, const TTerrainTexture& Textur
 	tex.m_bIsSplat = Texture.m_bIsSplat;
 	tex.m_uiHeightMin = Texture.m_uiHeightMin;
 	tex.m_uiHeightMax = Texture.m_uiHeightMax;
+	tex.m_fSlopeMin = Texture.m_fSlopeMin;
+	tex.m_fSlopeMax = Texture.m_fSlopeMax;
+	tex.m_fCurvatureMin = Texture.m_fCurvatureMin;
+	tex.m_fCurvatureMax = Texture.m_fCurvatureMax;
+	tex.m_fRuleBlend = Texture.m_fRuleBlend;
+	m_uiRevision++;
 
-	// Create and load the new texture
-	tex.m_pTexture = new CTexture(tex.m_stFileName, GL_TEXTURE_2D);
-	if (!tex.m_pTexture->Load())
-	{
-		sys_err("CTerrainTextureSet::SetTexture: Failed to load texture '%s'", tex.m_stFileName.c_str());
-		safe_delete(tex.m_pTexture);  // Clear invalid texture
-		return false;
-	}
-
-	tex.m_pTexture->MakeResident();
-
-	tex.m_uiTextureID = tex.m_pTexture->GetTextureID();
-
-	// Calculate transformation matrix
-	CMatrix4Df matScale{};
-	matScale.InitScaleTransform(m_fTerrainTexCoordBase * tex.m_fUScale, -m_fTerrainTexCoordBase * tex.m_fVScale, 1.0f);
-
-	CMatrix4Df matTranslate{};
-	matTranslate.InitTranslationTransform(tex.m_fUOffset, -tex.m_fVOffset, 0.0f);
-
-	tex.m_matTransform = matTranslate * matScale;
+	// Decoded in the background, uploaded by ProcessUploads()
+	RequestTexture(iIndex);
 
 	return (true);
 }
@@ -305,28 +469,10 @@ bool CTerrainTextureSet::SetTexture(size_t iIndex,
 	tex.m_bIsSplat = bIsSplat;
 	tex.m_uiHeightMin = uiHeightMin;
 	tex.m_uiHeightMax = uiHeightMax;
+	m_uiRevision++;
 
-	// Create and load the new texture
-	tex.m_pTexture = new CTexture(tex.m_stFileName, GL_TEXTURE_2D);
-	if (!tex.m_pTexture->Load())
-	{
-		sys_err("CTerrainTextureSet::SetTexture: Failed to load texture '%s'", tex.m_stFileName.c_str());
-		safe_delete(tex.m_pTexture);  // Clear invalid texture
-		return false;
-	}
-
-	tex.m_pTexture->MakeResident();
-
-	tex.m_uiTextureID = tex.m_pTexture->GetTextureID();
-
-	// Calculate transformation matrix
-	CMatrix4Df matScale{};
-	matScale.InitScaleTransform(m_fTerrainTexCoordBase * tex.m_fUScale, -m_fTerrainTexCoordBase * tex.m_fVScale, 1.0f);
-
-	CMatrix4Df matTranslate{};
-	matTranslate.InitTranslationTransform(tex.m_fUOffset, -tex.m_fVOffset, 0.0f);
-
-	tex.m_matTransform = matTranslate * matScale;
+	// Decoded in the background, uploaded by ProcessUploads()
+	RequestTexture(iIndex);
 
 	return (true);
 }
@@ -413,11 +559,13 @@ bool CTerrainTextureSet::IsValidImage(const std::string& filePath)
 void CTerrainTextureSet::ResizeTextures(size_t iNum)
 {
 	m_vTextures.resize(iNum);
+	m_uiRevision++;
 }
 
 void CTerrainTextureSet::IncreaseTexturesNum(size_t iNum)
 {
 	m_vTextures.resize(m_vTextures.size() + iNum);
+	m_uiRevision++;
 }
 
 CTerrainTextureSet::TTexturesVector& CTerrainTextureSet::GetTextures()
@@ -5,6 +5,8 @@
 #include <vector>
 #include <map>
 #include "../../LibGL/source/texture.h"
+#include "../../LibGL/source/image_decoder.h"
+#include <unordered_map>
 #include "../../LibMath/source/stdafx.h"
 #include <nlohmann/json.hpp> // Requires JSON for Modern C++ library
 #include "terrain.h"
@@ -20,6 +22,14 @@ enum ETerrainData
 	CELL_SIZE = 1,
 };
 
+// Decoded layers uploaded per ProcessUploads() call, keeps the mip generation spread over frames
+constexpr size_t TERRAIN_TEXTURE_UPLOADS_PER_FRAME = 4;
+
+// Auto splat rule limits, bounds at or beyond these never fade a layer out
+constexpr GLuint TERRAIN_HEIGHT_UNBOUNDED = 65535;
+constexpr GLfloat TERRAIN_SLOPE_MAX = 90.0f;
+constexpr GLfloat TERRAIN_CURVATURE_LIMIT = 1000.0f;
+
 typedef struct STerrainTexture
 {
 	std::string m_stFileName;
@@ -32,6 +42,11 @@ typedef struct STerrainTexture
 	bool m_bIsSplat;
 	GLuint m_uiHeightMin;
 	GLuint m_uiHeightMax;
+	GLfloat m_fSlopeMin;		// Degrees
+	GLfloat m_fSlopeMax;
+	GLfloat m_fCurvatureMin;	// Height laplacian, negative on ridges, positive in valleys
+	GLfloat m_fCurvatureMax;
+	GLfloat m_fRuleBlend;		// Band edge softness, fraction of the band width
 	CMatrix4Df m_matTransform;
 
 	STerrainTexture()
@@ -45,7 +60,12 @@ typedef struct STerrainTexture
 		m_fVOffset = 0.0f;
 		m_bIsSplat = true;
 		m_uiHeightMin = 0;
-		m_uiHeightMax = 65535; // Check Later
+		m_uiHeightMax = TERRAIN_HEIGHT_UNBOUNDED; // Check Later
+		m_fSlopeMin = 0.0f;
+		m_fSlopeMax = TERRAIN_SLOPE_MAX;
+		m_fCurvatureMin = -TERRAIN_CURVATURE_LIMIT;
+		m_fCurvatureMax = TERRAIN_CURVATURE_LIMIT;
+		m_fRuleBlend = 0.1f;
 		m_matTransform.InitIdentity();
 	}
 
@@ -60,6 +80,11 @@ typedef struct STerrainTexture
 			{"is_splat", m_bIsSplat},
 			{"begin", m_uiHeightMin},
 			{"end", m_uiHeightMax},
+			{"slope_min", m_fSlopeMin},
+			{"slope_max", m_fSlopeMax},
+			{"curvature_min", m_fCurvatureMin},
+			{"curvature_max", m_fCurvatureMax},
+			{"rule_blend", m_fRuleBlend},
 		};
 	}
 
@@ -118,6 +143,7 @@ public:
 
 	bool Save(const std::string& stFileName);
 	bool Load(const std::string& stFileName);
+	bool Load(const TTexturesVector& vTextures, const std::string& stSourceName);
 
 	void Reload();
 
@@ -153,12 +179,35 @@ public:
 
 	CTexture* GetEraserTexture();
 
+	// Layers are decoded on worker threads and bound to the placeholder until their upload
+	// Returns true when the layer handles changed and the bindless table must be rebuilt
+	bool ProcessUploads(size_t iMaxUploads = TERRAIN_TEXTURE_UPLOADS_PER_FRAME);
+	void WaitForPendingTextures();
+	bool IsLoading() const;
+	CTexture* GetPlaceholderTexture();
+
+	// Textures replaced by a reload stay resident until the bindless table stops pointing at them
+	void ReleaseRetiredTextures();
+
+	// Bumped by every change of the layers list or of a layer's settings
+	GLuint GetRevision() const;
+
 protected:
 	void AddEmptyTexture();
+	// bFromDisk skips the registry and decodes the file again, Reload picks up edited files that way
+	void RequestTexture(size_t iIndex, bool bFromDisk = false);
+	void UpdateTextureTransform(TTerrainTexture& tex);
 
 private:
 	TTexturesVector m_vTextures;
 	TTerrainTexture m_tErrorTexture;
 	std::string m_stFileName;
 	GLfloat m_fTerrainTexCoordBase;
+
+	CImageDecodeQueue m_DecodeQueue;
+	std::unordered_map<uint64_t, size_t> m_mPendingLayers; // Decode ticket -> layer index
+	std::vector<CTexture*> m_vRetiredTextures;
+	CTexture* m_pPlaceholderTexture;
+	bool m_bBindingsDirty;
+	GLuint m_uiRevision;
 };
\ No newline at end of file
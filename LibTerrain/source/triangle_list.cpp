@@ -20,15 +20,15 @@ void CTriangleList::Destroy()
 {
 	if (m_iVAO > 0)
 	{
-		glDeleteVertexArrays(1, &m_iVAO);
+		CGLState::DeleteVertexArrays(1, &m_iVAO);
 	}
 	if (m_iVBO > 0)
 	{
-		glDeleteBuffers(1, &m_iVBO);
+		CGLState::DeleteBuffers(1, &m_iVBO);
 	}
 	if (m_iIdxBuf > 0)
 	{
-		glDeleteBuffers(1, &m_iIdxBuf);
+		CGLState::DeleteBuffers(1, &m_iIdxBuf);
 	}
 }
 
@@ -40,9 +40,9 @@ void CTriangleList::CreateTriangleList(GLint Width, GLint Depth, const CBaseTerr
 	CreateGLState();
 	PopulateBuffers(pTerrain);
 
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	CGLState::BindVertexArray(0);
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+	CGLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
 	sys_log("CTriangleList::CreateTriangleList Created Triangle List Size: %d, Width: %d, Depth: %d", Width * Depth, Width, Depth);
 }
@@ -50,13 +50,13 @@ void CTriangleList::CreateTriangleList(GLint Width, GLint Depth, const CBaseTerr
 void CTriangleList::CreateGLState()
 {
 	glGenVertexArrays(1, &m_iVAO);
-	glBindVertexArray(m_iVAO);
+	CGLState::BindVertexArray(m_iVAO);
 
 	glGenBuffers(1, &m_iVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_iVBO);
 
 	glGenBuffers(1, &m_iIdxBuf);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIdxBuf);
+	CGLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIdxBuf);
 
 	const GLint POS_LOC = 0;
 	const GLint	TEX_LOC = 1;
@@ -197,9 +197,9 @@ void CTriangleList::Render()
 		exit(1);
 	}
 
-	glBindVertexArray(m_iVAO);
+	CGLState::BindVertexArray(m_iVAO);
 	glDrawElements(GL_TRIANGLES, (m_iDepth - 1) * (m_iWidth - 1) * 6, GL_UNSIGNED_INT, nullptr);
-	glBindVertexArray(0);
+	CGLState::BindVertexArray(0);
 }
 
 CWaterTriangleList::CWaterTriangleList()
@@ -220,15 +220,15 @@ void CWaterTriangleList::Destroy()
 {
 	if (m_iVAO > 0)
 	{
-		glDeleteVertexArrays(1, &m_iVAO);
+		CGLState::DeleteVertexArrays(1, &m_iVAO);
 	}
 	if (m_iVBO > 0)
 	{
-		glDeleteBuffers(1, &m_iVBO);
+		CGLState::DeleteBuffers(1, &m_iVBO);
 	}
 	if (m_iIdxBuf > 0)
 	{
-		glDeleteBuffers(1, &m_iIdxBuf);
+		CGLState::DeleteBuffers(1, &m_iIdxBuf);
 	}
 }
 
@@ -249,9 +249,9 @@ void CWaterTriangleList::CreateTriangleList(GLint Width, GLint Depth, float fWor
 	CreateGLState();
 	PopulateBuffers(fWorldScale);
 
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	CGLState::BindVertexArray(0);
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+	CGLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
 	sys_log("CWaterTriangleList::CreateTriangleList Created Triangle List Size: %d, Width: %d, Depth: %d", Width * Depth, Width, Depth);
 
@@ -260,13 +260,13 @@ void CWaterTriangleList::CreateTriangleList(GLint Width, GLint Depth, float fWor
 void CWaterTriangleList::CreateGLState()
 {
 	glGenVertexArrays(1, &m_iVAO);
-	glBindVertexArray(m_iVAO);
+	CGLState::BindVertexArray(m_iVAO);
 
 	glGenBuffers(1, &m_iVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_iVBO);
 
 	glGenBuffers(1, &m_iIdxBuf);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIdxBuf);
+	CGLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iIdxBuf);
 
 	const GLint POS_LOC = 0;
 	const GLint	TEX_LOC = 1;
@@ -398,9 +398,9 @@ void CWaterTriangleList::Render()
 		exit(1);
 	}
 
-	glBindVertexArray(m_iVAO);
+	CGLState::BindVertexArray(m_iVAO);
 	glDrawElements(GL_TRIANGLES, (m_iDepth - 1) * (m_iWidth - 1) * 6, GL_UNSIGNED_INT, nullptr);
-	glBindVertexArray(0);
+	CGLState::BindVertexArray(0);
 }
 
 void CWaterTriangleList::CircleBrush(GLint iX, GLint iZ, GLfloat fSize, GLfloat fRadius, GLfloat fNewHeight)
@@ -432,8 +432,8 @@ void CWaterTriangleList::CircleBrush(GLint iX, GLint iZ, GLfloat fSize, GLfloat
 
 void CWaterTriangleList::UpdateVertexBuffer()
 {
-	glBindBuffer(GL_ARRAY_BUFFER, m_iVBO);  // Bind the vertex buffer
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, m_iVBO);  // Bind the vertex buffer
 	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(m_vVertices[0]) * m_vVertices.size(), m_vVertices.data());
-	glBindBuffer(GL_ARRAY_BUFFER, 0);  // Unbind after update
+	CGLState::BindBuffer(GL_ARRAY_BUFFER, 0);  // Unbind after update
 }
 